@@ -30,6 +30,8 @@
 
 #include "file_access_compressed.h"
 
+#include "core/object/worker_thread_pool.h"
+
 void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, uint32_t p_block_size) {
 	magic = p_magic.ascii().get_data();
 	magic = (magic + "    ").substr(0, 4);
@@ -38,18 +40,127 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 	block_size = p_block_size;
 }
 
-#define WRITE_FIT(m_bytes)                                  \
-	{                                                       \
-		if (write_pos + (m_bytes) > write_max) {            \
-			write_max = write_pos + (m_bytes);              \
-		}                                                   \
-		if (write_max > write_buffer_size) {                \
-			write_buffer_size = next_power_of_2(write_max); \
-			buffer.resize(write_buffer_size);               \
-			write_ptr = buffer.ptrw();                      \
-		}                                                   \
+// Blocks are only (de)compressed in parallel when there is enough data for it to pay off.
+static const uint64_t PARALLEL_MIN_SIZE = 256 * 1024;
+// Amount of data decompressed ahead when reading sequentially, and compressed at once when writing.
+static const uint32_t BATCH_SIZE = 256 * 1024;
+
+void FileAccessCompressed::_process_block_task(void *p_userdata, uint32_t p_index) {
+	const BlockTaskGroup *group = (const BlockTaskGroup *)p_userdata;
+	BlockTask &task = group->tasks[p_index];
+	if (group->compress) {
+		task.result = Compression::compress(task.dst, task.src, task.src_size, group->mode);
+	} else {
+		task.result = Compression::decompress(task.dst, task.dst_size, task.src, task.src_size, group->mode);
+	}
+}
+
+void FileAccessCompressed::_process_block_tasks(BlockTask *p_tasks, uint32_t p_count, uint64_t p_total_size, bool p_compress) const {
+	BlockTaskGroup group;
+	group.tasks = p_tasks;
+	group.mode = cmode;
+	group.compress = p_compress;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (p_count < 2 || p_total_size < PARALLEL_MIN_SIZE || pool == nullptr || pool->get_thread_count() < 2) {
+		for (uint32_t i = 0; i < p_count; i++) {
+			_process_block_task(&group, i);
+		}
+		return;
+	}
+
+	WorkerThreadPool::GroupID group_task = pool->add_native_group_task(&_process_block_task, &group, p_count, -1, true, SNAME("FileAccessCompressed"));
+	pool->wait_for_group_task_completion(group_task);
+}
+
+uint32_t FileAccessCompressed::_get_read_block_size(uint32_t p_block) const {
+	return p_block == read_block_count - 1 ? read_total % block_size : block_size;
+}
+
+uint32_t FileAccessCompressed::_get_read_ahead_blocks() const {
+	return MAX(BATCH_SIZE / block_size, 1u);
+}
+
+bool FileAccessCompressed::_decompress_read_blocks(uint32_t p_from, uint32_t p_count) const {
+	// Blocks are stored one after another, so they can be read at once.
+	const uint64_t from_offset = read_blocks[p_from].offset;
+	const uint64_t to_offset = read_blocks[p_from + p_count - 1].offset + read_blocks[p_from + p_count - 1].csize;
+	comp_buffer.resize(to_offset - from_offset);
+	f->seek(from_offset);
+	if (f->get_buffer(comp_buffer.ptrw(), comp_buffer.size()) != uint64_t(comp_buffer.size())) {
+		return false;
+	}
+
+	LocalVector<Vector<uint8_t>> blocks;
+	LocalVector<BlockTask> tasks;
+	blocks.resize(p_count);
+	tasks.resize(p_count);
+	uint64_t total_size = 0;
+	for (uint32_t i = 0; i < p_count; i++) {
+		const ReadBlock &rb = read_blocks[p_from + i];
+		blocks[i].resize(_get_read_block_size(p_from + i));
+		tasks[i].src = comp_buffer.ptr() + (rb.offset - from_offset);
+		tasks[i].src_size = rb.csize;
+		tasks[i].dst = blocks[i].ptrw();
+		tasks[i].dst_size = blocks[i].size();
+		total_size += blocks[i].size();
+	}
+
+	_process_block_tasks(tasks.ptr(), p_count, total_size, false);
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		if (tasks[i].result == -1) {
+			return false;
+		}
+		CachedBlock &cached = block_cache[p_from + i];
+		cached.data = blocks[i];
+		cached.last_used = ++block_cache_tick;
+	}
+
+	// Evict the least recently used blocks, keeping enough room for read-ahead.
+	const uint32_t capacity = _get_read_ahead_blocks() * 2;
+	while (block_cache.size() > capacity) {
+		uint32_t oldest = p_from;
+		uint64_t oldest_tick = UINT64_MAX;
+		for (const KeyValue<uint32_t, CachedBlock> &E : block_cache) {
+			if (E.value.last_used < oldest_tick) {
+				oldest = E.key;
+				oldest_tick = E.value.last_used;
+			}
+		}
+		block_cache.erase(oldest);
+	}
+
+	return true;
+}
+
+bool FileAccessCompressed::_load_read_block(uint32_t p_block) const {
+	CachedBlock *cached = block_cache.getptr(p_block);
+	if (!cached) {
+		uint32_t count = 1;
+		if (p_block == read_block + 1) {
+			// Reading sequentially, decompress the next blocks too.
+			const uint32_t read_ahead = _get_read_ahead_blocks();
+			while (count < read_ahead && p_block + count < read_block_count && !block_cache.has(p_block + count)) {
+				count++;
+			}
+		}
+
+		if (!_decompress_read_blocks(p_block, count)) {
+			return false;
+		}
+		cached = block_cache.getptr(p_block);
 	}
 
+	cached->last_used = ++block_cache_tick;
+	buffer = cached->data;
+	read_ptr = buffer.ptr();
+	read_block = p_block;
+	read_block_size = buffer.size();
+	read_pos = 0;
+	return true;
+}
+
 Error FileAccessCompressed::open_after_magic(Ref<FileAccess> p_base) {
 	f = p_base;
 	cmode = (Compression::Mode)f->get_32();
@@ -61,30 +172,21 @@ Error FileAccessCompressed::open_after_magic(Ref<FileAccess> p_base) {
 	read_total = f->get_32();
 	uint32_t bc = (read_total / block_size) + 1;
 	uint64_t acc_ofs = f->get_position() + bc * 4;
-	uint32_t max_bs = 0;
 	for (uint32_t i = 0; i < bc; i++) {
 		ReadBlock rb;
 		rb.offset = acc_ofs;
 		rb.csize = f->get_32();
 		acc_ofs += rb.csize;
-		max_bs = MAX(max_bs, rb.csize);
 		read_blocks.push_back(rb);
 	}
 
-	comp_buffer.resize(max_bs);
-	buffer.resize(block_size);
-	read_ptr = buffer.ptrw();
-	f->get_buffer(comp_buffer.ptrw(), read_blocks[0].csize);
 	at_end = false;
 	read_eof = false;
 	read_block_count = bc;
-	read_block_size = read_blocks.size() == 1 ? read_total : block_size;
-
-	int ret = Compression::decompress(buffer.ptrw(), read_block_size, comp_buffer.ptr(), read_blocks[0].csize, cmode);
-	read_block = 0;
-	read_pos = 0;
+	block_cache.clear();
 
-	return ret == -1 ? ERR_FILE_CORRUPT : OK;
+	bool ok = _load_read_block(0);
+	return ok ? OK : ERR_FILE_CORRUPT;
 }
 
 Error FileAccessCompressed::open_internal(const String &p_path, int p_mode_flags) {
@@ -100,13 +202,11 @@ Error FileAccessCompressed::open_internal(const String &p_path, int p_mode_flags
 	}
 
 	if (p_mode_flags & WRITE) {
-		buffer.clear();
 		writing = true;
 		write_pos = 0;
-		write_buffer_size = 256;
-		buffer.resize(256);
 		write_max = 0;
-		write_ptr = buffer.ptrw();
+		write_blocks.clear();
+		write_full_blocks.clear();
 
 		//don't store anything else unless it's done saving!
 	} else {
@@ -123,6 +223,70 @@ Error FileAccessCompressed::open_internal(const String &p_path, int p_mode_flags
 	return OK;
 }
 
+uint8_t *FileAccessCompressed::_get_write_block(uint32_t p_block) {
+	if (write_blocks.size() <= p_block) {
+		write_blocks.resize(p_block + 1);
+	}
+
+	WriteBlock &wb = write_blocks[p_block];
+	if (wb.compressed) {
+		// Only full blocks are compressed while writing.
+		Vector<uint8_t> data;
+		data.resize(block_size);
+		int ret = Compression::decompress(data.ptrw(), block_size, wb.data.ptr(), wb.data.size(), cmode);
+		ERR_FAIL_COND_V_MSG(ret != int(block_size), nullptr, "Failed to decompress block being written.");
+		wb.data = data;
+		wb.compressed = false;
+	} else if (wb.data.is_empty()) {
+		wb.data.resize(block_size);
+	}
+
+	return wb.data.ptrw();
+}
+
+void FileAccessCompressed::_compress_write_blocks(const LocalVector<uint32_t> &p_blocks) {
+	LocalVector<uint32_t> indices;
+	LocalVector<Vector<uint8_t>> compressed;
+	LocalVector<BlockTask> tasks;
+	uint64_t total_size = 0;
+
+	for (uint32_t block_idx : p_blocks) {
+		WriteBlock &wb = write_blocks[block_idx];
+		if (wb.compressed || wb.queued) {
+			continue;
+		}
+		wb.queued = true;
+
+		const uint32_t size = block_idx == write_max / block_size ? write_max % block_size : block_size;
+		Vector<uint8_t> dst;
+		dst.resize(Compression::get_max_compressed_buffer_size(size, cmode));
+
+		BlockTask task;
+		task.src = wb.data.ptr();
+		task.src_size = size;
+		task.dst_size = dst.size();
+		indices.push_back(block_idx);
+		compressed.push_back(dst);
+		tasks.push_back(task);
+		total_size += size;
+	}
+
+	for (uint32_t i = 0; i < tasks.size(); i++) {
+		tasks[i].dst = compressed[i].ptrw();
+	}
+
+	_process_block_tasks(tasks.ptr(), tasks.size(), total_size, true);
+
+	for (uint32_t i = 0; i < tasks.size(); i++) {
+		WriteBlock &wb = write_blocks[indices[i]];
+		wb.queued = false;
+		ERR_CONTINUE_MSG(tasks[i].result < 0, "Failed to compress block.");
+		compressed[i].resize(tasks[i].result);
+		wb.data = compressed[i];
+		wb.compressed = true;
+	}
+}
+
 void FileAccessCompressed::_close() {
 	if (f.is_null()) {
 		return;
@@ -138,36 +302,34 @@ void FileAccessCompressed::_close() {
 		f->store_32(uint32_t(write_max)); //max amount of data written 4
 		uint32_t bc = (write_max / block_size) + 1;
 
+		// Compress whatever is left, including the (possibly empty) last block.
+		LocalVector<uint32_t> remaining;
 		for (uint32_t i = 0; i < bc; i++) {
-			f->store_32(0); //compressed sizes, will update later
+			if (i >= write_blocks.size() || !write_blocks[i].compressed) {
+				_get_write_block(i);
+				remaining.push_back(i);
+			}
 		}
+		_compress_write_blocks(remaining);
 
-		Vector<int> block_sizes;
 		for (uint32_t i = 0; i < bc; i++) {
-			uint32_t bl = i == (bc - 1) ? write_max % block_size : block_size;
-			uint8_t *bp = &write_ptr[i * block_size];
-
-			Vector<uint8_t> cblock;
-			cblock.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
-			int s = Compression::compress(cblock.ptrw(), bp, bl, cmode);
-
-			f->store_buffer(cblock.ptr(), s);
-			block_sizes.push_back(s);
+			f->store_32(uint32_t(write_blocks[i].data.size())); //compressed sizes
 		}
-
-		f->seek(16); //ok write block sizes
 		for (uint32_t i = 0; i < bc; i++) {
-			f->store_32(uint32_t(block_sizes[i]));
+			f->store_buffer(write_blocks[i].data.ptr(), write_blocks[i].data.size());
 		}
-		f->seek_end();
 		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //magic at the end too
 
-		buffer.clear();
+		write_blocks.clear();
+		write_full_blocks.clear();
+		writing = false;
 
 	} else {
 		comp_buffer.clear();
 		buffer.clear();
 		read_blocks.clear();
+		block_cache.clear();
+		read_ptr = nullptr;
 	}
 	f.unref();
 }
@@ -202,23 +364,16 @@ void FileAccessCompressed::seek(uint64_t p_position) {
 
 	} else {
 		ERR_FAIL_COND(p_position > read_total);
-		if (p_position == read_total) {
-			at_end = true;
-		} else {
-			at_end = false;
-			read_eof = false;
-			uint32_t block_idx = p_position / block_size;
-			if (block_idx != read_block) {
-				read_block = block_idx;
-				f->seek(read_blocks[read_block].offset);
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				ERR_FAIL_COND_MSG(ret == -1, "Compressed file is corrupt.");
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-			}
+		at_end = p_position == read_total;
+		read_eof = false;
 
-			read_pos = p_position % block_size;
+		// Seeking to the very end may point past the last block.
+		uint32_t block_idx = MIN(p_position / block_size, uint64_t(read_block_count - 1));
+		if (block_idx != read_block) {
+			ERR_FAIL_COND_MSG(!_load_read_block(block_idx), "Compressed file is corrupt.");
 		}
+
+		read_pos = p_position - uint64_t(block_idx) * block_size;
 	}
 }
 
@@ -268,32 +423,31 @@ uint64_t FileAccessCompressed::get_buffer(uint8_t *p_dst, uint64_t p_length) con
 		return 0;
 	}
 
-	for (uint64_t i = 0; i < p_length; i++) {
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
+	uint64_t dst_pos = 0;
+	while (dst_pos < p_length) {
 		if (read_pos >= read_block_size) {
-			read_block++;
-
-			if (read_block < read_block_count) {
-				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				ERR_FAIL_COND_V_MSG(ret == -1, -1, "Compressed file is corrupt.");
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-				read_pos = 0;
-
-			} else {
-				read_block--;
-				at_end = true;
-				if (i + 1 < p_length) {
-					read_eof = true;
-				}
-				return i + 1;
+			if (read_block + 1 >= read_block_count) {
+				break;
 			}
+			//read another block of compressed data
+			ERR_FAIL_COND_V_MSG(!_load_read_block(read_block + 1), -1, "Compressed file is corrupt.");
+			continue;
+		}
+
+		const uint64_t to_copy = MIN(p_length - dst_pos, read_block_size - read_pos);
+		memcpy(p_dst + dst_pos, read_ptr + read_pos, to_copy);
+		dst_pos += to_copy;
+		read_pos += to_copy;
+	}
+
+	if (read_pos >= read_block_size && read_block + 1 >= read_block_count) {
+		at_end = true;
+		if (dst_pos < p_length) {
+			read_eof = true;
 		}
 	}
 
-	return p_length;
+	return dst_pos;
 }
 
 Error FileAccessCompressed::get_error() const {
@@ -304,16 +458,36 @@ void FileAccessCompressed::flush() {
 	ERR_FAIL_COND_MSG(f.is_null(), "File must be opened before use.");
 	ERR_FAIL_COND_MSG(!writing, "File has not been opened in write mode.");
 
-	// compressed files keep data in memory till close()
+	// compressed files keep the compressed blocks in memory till close(), as the block table goes first
 }
 
 void FileAccessCompressed::store_buffer(const uint8_t *p_src, uint64_t p_length) {
 	ERR_FAIL_COND_MSG(f.is_null(), "File must be opened before use.");
 	ERR_FAIL_COND_MSG(!writing, "File has not been opened in write mode.");
 
-	WRITE_FIT(p_length);
-	memcpy(write_ptr + write_pos, p_src, p_length);
-	write_pos += p_length;
+	while (p_length > 0) {
+		const uint32_t block_idx = write_pos / block_size;
+		const uint32_t block_ofs = write_pos % block_size;
+		uint8_t *block = _get_write_block(block_idx);
+		ERR_FAIL_NULL(block);
+
+		const uint32_t to_copy = MIN(p_length, uint64_t(block_size - block_ofs));
+		memcpy(block + block_ofs, p_src, to_copy);
+		p_src += to_copy;
+		p_length -= to_copy;
+		write_pos += to_copy;
+		write_max = MAX(write_max, write_pos);
+
+		if (block_ofs + to_copy == block_size) {
+			write_full_blocks.push_back(block_idx);
+		}
+	}
+
+	// Compress filled blocks in batches, so they can be compressed in parallel.
+	if (write_full_blocks.size() >= MAX(BATCH_SIZE / block_size, 1u)) {
+		_compress_write_blocks(write_full_blocks);
+		write_full_blocks.clear();
+	}
 }
 
 bool FileAccessCompressed::file_exists(const String &p_name) {
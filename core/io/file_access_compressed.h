@@ -32,25 +32,61 @@
 
 #include "core/io/compression.h"
 #include "core/io/file_access.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 
 class FileAccessCompressed : public FileAccess {
 	Compression::Mode cmode = Compression::MODE_ZSTD;
 	bool writing = false;
 	uint64_t write_pos = 0;
-	uint8_t *write_ptr = nullptr;
-	uint32_t write_buffer_size = 0;
 	uint64_t write_max = 0;
 	uint32_t block_size = 0;
 	mutable bool read_eof = false;
 	mutable bool at_end = false;
 
+	// Blocks are compressed as soon as they are filled, so only the compressed data
+	// has to be kept until close(). Writing into a compressed block decompresses it again.
+	struct WriteBlock {
+		Vector<uint8_t> data;
+		bool compressed = false;
+		bool queued = false;
+	};
+
+	LocalVector<WriteBlock> write_blocks;
+	LocalVector<uint32_t> write_full_blocks;
+
 	struct ReadBlock {
 		uint32_t csize;
 		uint64_t offset;
 	};
 
+	// Decompressed blocks are kept in a small cache, so seeking back and forth
+	// doesn't decompress the same blocks over and over.
+	struct CachedBlock {
+		Vector<uint8_t> data;
+		uint64_t last_used = 0;
+	};
+
+	mutable HashMap<uint32_t, CachedBlock> block_cache;
+	mutable uint64_t block_cache_tick = 0;
+
+	// A block compressed or decompressed by _process_block_tasks(), possibly on another thread.
+	struct BlockTask {
+		const uint8_t *src = nullptr;
+		uint32_t src_size = 0;
+		uint8_t *dst = nullptr;
+		uint32_t dst_size = 0;
+		int result = -1;
+	};
+
+	struct BlockTaskGroup {
+		BlockTask *tasks = nullptr;
+		Compression::Mode mode = Compression::MODE_ZSTD;
+		bool compress = false;
+	};
+
 	mutable Vector<uint8_t> comp_buffer;
-	uint8_t *read_ptr = nullptr;
+	mutable const uint8_t *read_ptr = nullptr;
 	mutable uint32_t read_block = 0;
 	uint32_t read_block_count = 0;
 	mutable uint32_t read_block_size = 0;
@@ -62,6 +98,17 @@ class FileAccessCompressed : public FileAccess {
 	mutable Vector<uint8_t> buffer;
 	Ref<FileAccess> f;
 
+	static void _process_block_task(void *p_userdata, uint32_t p_index);
+	void _process_block_tasks(BlockTask *p_tasks, uint32_t p_count, uint64_t p_total_size, bool p_compress) const;
+
+	uint32_t _get_read_block_size(uint32_t p_block) const;
+	uint32_t _get_read_ahead_blocks() const;
+	bool _decompress_read_blocks(uint32_t p_from, uint32_t p_count) const;
+	bool _load_read_block(uint32_t p_block) const;
+
+	uint8_t *_get_write_block(uint32_t p_block);
+	void _compress_write_blocks(const LocalVector<uint32_t> &p_blocks);
+
 	void _close();
 
 public:
@@ -33,13 +33,24 @@
 #include "core/config/project_settings.h"
 #include "core/error/error_list.h"
 #include "core/error/error_macros.h"
+#include "core/io/image_compress_scheduler.h"
 #include "core/io/image_loader.h"
 #include "core/io/resource_loader.h"
 #include "core/math/math_funcs.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/hash_map.h"
 #include "core/variant/dictionary.h"
 
 #include <cmath>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGE_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define IMAGE_SIMD_NEON
+#include <arm_neon.h>
+#endif
 
 const char *Image::format_names[Image::FORMAT_MAX] = {
 	"Lum8",
@@ -795,6 +806,62 @@ Image::Format Image::get_format() const {
 	return format;
 }
 
+// Processes the range [p_from, p_to) of rows (or columns) of the destination image.
+typedef void (*ImageRangeFunc)(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from, uint32_t p_to);
+
+// Below this amount of destination pixels, distributing the work costs more than it saves.
+static const uint64_t IMAGE_PARALLEL_MIN_PIXELS = 256 * 256;
+
+struct ImageParallelJob {
+	ImageRangeFunc func = nullptr;
+	const uint8_t *src = nullptr;
+	uint8_t *dst = nullptr;
+	uint32_t src_width = 0;
+	uint32_t src_height = 0;
+	uint32_t dst_width = 0;
+	uint32_t dst_height = 0;
+	uint32_t count = 0;
+	uint32_t items_per_task = 0;
+};
+
+static void _process_parallel_task(void *p_userdata, uint32_t p_index) {
+	const ImageParallelJob *job = (const ImageParallelJob *)p_userdata;
+	uint32_t from = p_index * job->items_per_task;
+	uint32_t to = MIN(from + job->items_per_task, job->count);
+	job->func(job->src, job->dst, job->src_width, job->src_height, job->dst_width, job->dst_height, from, to);
+}
+
+static void _process_parallel(ImageRangeFunc p_func, const uint8_t *p_src, uint8_t *p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_count) {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	// Waiting on a group from inside a pool thread can deadlock when every other thread is blocked the same way.
+	if (pool == nullptr || pool->get_thread_count() < 2 || pool->get_thread_index() != -1 || p_count < 2 || uint64_t(p_dst_width) * p_dst_height < IMAGE_PARALLEL_MIN_PIXELS) {
+		p_func(p_src, p_dst, p_src_width, p_src_height, p_dst_width, p_dst_height, 0, p_count);
+		return;
+	}
+
+	ImageParallelJob job;
+	job.func = p_func;
+	job.src = p_src;
+	job.dst = p_dst;
+	job.src_width = p_src_width;
+	job.src_height = p_src_height;
+	job.dst_width = p_dst_width;
+	job.dst_height = p_dst_height;
+	job.count = p_count;
+
+	// A few tasks per thread, so threads finishing early can pick up more work.
+	uint32_t task_count = MIN(p_count, uint32_t(pool->get_thread_count()) * 4);
+	job.items_per_task = (p_count + task_count - 1) / task_count;
+	task_count = (p_count + job.items_per_task - 1) / job.items_per_task;
+
+	WorkerThreadPool::GroupID group_task = pool->add_native_group_task(&_process_parallel_task, &job, task_count, -1, true, SNAME("ImageProcess"));
+	pool->wait_for_group_task_completion(group_task);
+}
+
+static void _process_rows(ImageRangeFunc p_func, const uint8_t *p_src, uint8_t *p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+	_process_parallel(p_func, p_src, p_dst, p_src_width, p_src_height, p_dst_width, p_dst_height, p_dst_height);
+}
+
 static double _bicubic_interp_kernel(double x) {
 	x = ABS(x);
 
@@ -810,7 +877,7 @@ static double _bicubic_interp_kernel(double x) {
 }
 
 template <int CC, typename T>
-static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row) {
 	// get source image size
 	int width = p_src_width;
 	int height = p_src_height;
@@ -825,7 +892,7 @@ static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_
 	int xmax = width - 1;
 	// temporary pointer
 
-	for (uint32_t y = 0; y < p_dst_height; y++) {
+	for (uint32_t y = p_from_row; y < p_to_row; y++) {
 		// Y coordinates
 		oy = (double)y * yfac - 0.5f;
 		oy1 = (int)oy;
@@ -897,13 +964,13 @@ static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_
 }
 
 template <int CC, typename T>
-static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row) {
 	constexpr uint32_t FRAC_BITS = 8;
 	constexpr uint32_t FRAC_LEN = (1 << FRAC_BITS);
 	constexpr uint32_t FRAC_HALF = (FRAC_LEN >> 1);
 	constexpr uint32_t FRAC_MASK = FRAC_LEN - 1;
 
-	for (uint32_t i = 0; i < p_dst_height; i++) {
+	for (uint32_t i = p_from_row; i < p_to_row; i++) {
 		// Add 0.5 in order to interpolate based on pixel center
 		uint32_t src_yofs_up_fp = (i + 0.5) * p_src_height * FRAC_LEN / p_dst_height;
 		// Calculate nearest src pixel center above current, and truncate to get y index
@@ -985,8 +1052,8 @@ static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict
 }
 
 template <int CC, typename T>
-static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
-	for (uint32_t i = 0; i < p_dst_height; i++) {
+static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row) {
+	for (uint32_t i = p_from_row; i < p_to_row; i++) {
 		uint32_t src_yofs = i * p_src_height / p_dst_height;
 		uint32_t y_ofs = src_yofs * p_src_width * CC;
 
@@ -1011,117 +1078,125 @@ static float _lanczos(float p_x) {
 	return Math::abs(p_x) >= LANCZOS_TYPE ? 0 : Math::sincn(p_x) * Math::sincn(p_x / LANCZOS_TYPE);
 }
 
+// First pass, processing whole columns of the intermediate buffer (source height x destination width).
 template <int CC, typename T>
-static void _scale_lanczos(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+static void _scale_lanczos_horizontal(const uint8_t *__restrict p_src, uint8_t *__restrict p_buffer, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_column, uint32_t p_to_column) {
 	int32_t src_width = p_src_width;
 	int32_t src_height = p_src_height;
-	int32_t dst_height = p_dst_height;
 	int32_t dst_width = p_dst_width;
 
-	uint32_t buffer_size = src_height * dst_width * CC;
-	float *buffer = memnew_arr(float, buffer_size); // Store the first pass in a buffer
+	float x_scale = float(src_width) / float(dst_width);
 
-	{ // FIRST PASS (horizontal)
+	float scale_factor = MAX(x_scale, 1); // A larger kernel is required only when downscaling
+	int32_t half_kernel = LANCZOS_TYPE * scale_factor;
 
-		float x_scale = float(src_width) / float(dst_width);
+	float *kernel = memnew_arr(float, half_kernel * 2);
 
-		float scale_factor = MAX(x_scale, 1); // A larger kernel is required only when downscaling
-		int32_t half_kernel = LANCZOS_TYPE * scale_factor;
+	for (int32_t buffer_x = p_from_column; buffer_x < int32_t(p_to_column); buffer_x++) {
+		// The corresponding point on the source image
+		float src_x = (buffer_x + 0.5f) * x_scale; // Offset by 0.5 so it uses the pixel's center
+		int32_t start_x = MAX(0, int32_t(src_x) - half_kernel + 1);
+		int32_t end_x = MIN(src_width - 1, int32_t(src_x) + half_kernel);
 
-		float *kernel = memnew_arr(float, half_kernel * 2);
+		// Create the kernel used by all the pixels of the column
+		for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
+			kernel[target_x - start_x] = _lanczos((target_x + 0.5f - src_x) / scale_factor);
+		}
 
-		for (int32_t buffer_x = 0; buffer_x < dst_width; buffer_x++) {
-			// The corresponding point on the source image
-			float src_x = (buffer_x + 0.5f) * x_scale; // Offset by 0.5 so it uses the pixel's center
-			int32_t start_x = MAX(0, int32_t(src_x) - half_kernel + 1);
-			int32_t end_x = MIN(src_width - 1, int32_t(src_x) + half_kernel);
+		for (int32_t buffer_y = 0; buffer_y < src_height; buffer_y++) {
+			float pixel[CC] = { 0 };
+			float weight = 0;
 
-			// Create the kernel used by all the pixels of the column
 			for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
-				kernel[target_x - start_x] = _lanczos((target_x + 0.5f - src_x) / scale_factor);
-			}
-
-			for (int32_t buffer_y = 0; buffer_y < src_height; buffer_y++) {
-				float pixel[CC] = { 0 };
-				float weight = 0;
+				float lanczos_val = kernel[target_x - start_x];
+				weight += lanczos_val;
 
-				for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
-					float lanczos_val = kernel[target_x - start_x];
-					weight += lanczos_val;
+				const T *__restrict src_data = ((const T *)p_src) + (buffer_y * src_width + target_x) * CC;
 
-					const T *__restrict src_data = ((const T *)p_src) + (buffer_y * src_width + target_x) * CC;
-
-					for (uint32_t i = 0; i < CC; i++) {
-						if constexpr (sizeof(T) == 2) { //half float
-							pixel[i] += Math::half_to_float(src_data[i]) * lanczos_val;
-						} else {
-							pixel[i] += src_data[i] * lanczos_val;
-						}
+				for (uint32_t i = 0; i < CC; i++) {
+					if constexpr (sizeof(T) == 2) { //half float
+						pixel[i] += Math::half_to_float(src_data[i]) * lanczos_val;
+					} else {
+						pixel[i] += src_data[i] * lanczos_val;
 					}
 				}
+			}
 
-				float *dst_data = ((float *)buffer) + (buffer_y * dst_width + buffer_x) * CC;
+			float *dst_data = ((float *)p_buffer) + (buffer_y * dst_width + buffer_x) * CC;
 
-				for (uint32_t i = 0; i < CC; i++) {
-					dst_data[i] = pixel[i] / weight; // Normalize the sum of all the samples
-				}
+			for (uint32_t i = 0; i < CC; i++) {
+				dst_data[i] = pixel[i] / weight; // Normalize the sum of all the samples
 			}
 		}
+	}
 
-		memdelete_arr(kernel);
-	} // End of first pass
+	memdelete_arr(kernel);
+}
 
-	{ // SECOND PASS (vertical + result)
+// Second pass, reading the intermediate buffer and writing rows of the result.
+template <int CC, typename T>
+static void _scale_lanczos_vertical(const uint8_t *__restrict p_buffer, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row) {
+	int32_t src_height = p_src_height;
+	int32_t dst_height = p_dst_height;
+	int32_t dst_width = p_dst_width;
 
-		float y_scale = float(src_height) / float(dst_height);
+	float y_scale = float(src_height) / float(dst_height);
 
-		float scale_factor = MAX(y_scale, 1);
-		int32_t half_kernel = LANCZOS_TYPE * scale_factor;
+	float scale_factor = MAX(y_scale, 1);
+	int32_t half_kernel = LANCZOS_TYPE * scale_factor;
 
-		float *kernel = memnew_arr(float, half_kernel * 2);
+	float *kernel = memnew_arr(float, half_kernel * 2);
 
-		for (int32_t dst_y = 0; dst_y < dst_height; dst_y++) {
-			float buffer_y = (dst_y + 0.5f) * y_scale;
-			int32_t start_y = MAX(0, int32_t(buffer_y) - half_kernel + 1);
-			int32_t end_y = MIN(src_height - 1, int32_t(buffer_y) + half_kernel);
+	for (int32_t dst_y = p_from_row; dst_y < int32_t(p_to_row); dst_y++) {
+		float buffer_y = (dst_y + 0.5f) * y_scale;
+		int32_t start_y = MAX(0, int32_t(buffer_y) - half_kernel + 1);
+		int32_t end_y = MIN(src_height - 1, int32_t(buffer_y) + half_kernel);
 
-			for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
-				kernel[target_y - start_y] = _lanczos((target_y + 0.5f - buffer_y) / scale_factor);
-			}
+		for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
+			kernel[target_y - start_y] = _lanczos((target_y + 0.5f - buffer_y) / scale_factor);
+		}
 
-			for (int32_t dst_x = 0; dst_x < dst_width; dst_x++) {
-				float pixel[CC] = { 0 };
-				float weight = 0;
+		for (int32_t dst_x = 0; dst_x < dst_width; dst_x++) {
+			float pixel[CC] = { 0 };
+			float weight = 0;
 
-				for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
-					float lanczos_val = kernel[target_y - start_y];
-					weight += lanczos_val;
+			for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
+				float lanczos_val = kernel[target_y - start_y];
+				weight += lanczos_val;
 
-					float *buffer_data = ((float *)buffer) + (target_y * dst_width + dst_x) * CC;
+				const float *buffer_data = ((const float *)p_buffer) + (target_y * dst_width + dst_x) * CC;
 
-					for (uint32_t i = 0; i < CC; i++) {
-						pixel[i] += buffer_data[i] * lanczos_val;
-					}
+				for (uint32_t i = 0; i < CC; i++) {
+					pixel[i] += buffer_data[i] * lanczos_val;
 				}
+			}
 
-				T *dst_data = ((T *)p_dst) + (dst_y * dst_width + dst_x) * CC;
+			T *dst_data = ((T *)p_dst) + (dst_y * dst_width + dst_x) * CC;
 
-				for (uint32_t i = 0; i < CC; i++) {
-					pixel[i] /= weight;
-
-					if constexpr (sizeof(T) == 1) { //byte
-						dst_data[i] = CLAMP(Math::fast_ftoi(pixel[i]), 0, 255);
-					} else if constexpr (sizeof(T) == 2) { //half float
-						dst_data[i] = Math::make_half_float(pixel[i]);
-					} else { // float
-						dst_data[i] = pixel[i];
-					}
+			for (uint32_t i = 0; i < CC; i++) {
+				pixel[i] /= weight;
+
+				if constexpr (sizeof(T) == 1) { //byte
+					dst_data[i] = CLAMP(Math::fast_ftoi(pixel[i]), 0, 255);
+				} else if constexpr (sizeof(T) == 2) { //half float
+					dst_data[i] = Math::make_half_float(pixel[i]);
+				} else { // float
+					dst_data[i] = pixel[i];
 				}
 			}
 		}
+	}
+
+	memdelete_arr(kernel);
+}
+
+template <int CC, typename T>
+static void _scale_lanczos(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+	uint32_t buffer_size = p_src_height * p_dst_width * CC;
+	float *buffer = memnew_arr(float, buffer_size); // Store the first pass in a buffer
 
-		memdelete_arr(kernel);
-	} // End of second pass
+	_process_parallel(_scale_lanczos_horizontal<CC, T>, p_src, (uint8_t *)buffer, p_src_width, p_src_height, p_dst_width, p_src_height, p_dst_width);
+	_process_parallel(_scale_lanczos_vertical<CC, T>, (const uint8_t *)buffer, p_dst, p_src_width, p_src_height, p_dst_width, p_dst_height, p_dst_height);
 
 	memdelete_arr(buffer);
 }
@@ -1212,47 +1287,47 @@ void Image::resize(int p_width, int p_height, Interpolation p_interpolation) {
 			if (format >= FORMAT_L8 && format <= FORMAT_RGBA8) {
 				switch (get_format_pixel_size(format)) {
 					case 1:
-						_scale_nearest<1, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_nearest<1, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 2:
-						_scale_nearest<2, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_nearest<2, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 3:
-						_scale_nearest<3, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_nearest<3, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 4:
-						_scale_nearest<4, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_nearest<4, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			} else if (format >= FORMAT_RF && format <= FORMAT_RGBAF) {
 				switch (get_format_pixel_size(format)) {
 					case 4:
-						_scale_nearest<1, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_nearest<1, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 8:
-						_scale_nearest<2, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_nearest<2, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 12:
-						_scale_nearest<3, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_nearest<3, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 16:
-						_scale_nearest<4, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_nearest<4, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 
 			} else if (format >= FORMAT_RH && format <= FORMAT_RGBAH) {
 				switch (get_format_pixel_size(format)) {
 					case 2:
-						_scale_nearest<1, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_nearest<1, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 4:
-						_scale_nearest<2, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_nearest<2, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 6:
-						_scale_nearest<3, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_nearest<3, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 8:
-						_scale_nearest<4, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_nearest<4, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			}
@@ -1299,46 +1374,46 @@ void Image::resize(int p_width, int p_height, Interpolation p_interpolation) {
 				if (format >= FORMAT_L8 && format <= FORMAT_RGBA8) {
 					switch (get_format_pixel_size(format)) {
 						case 1:
-							_scale_bilinear<1, uint8_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_process_rows(_scale_bilinear<1, uint8_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 2:
-							_scale_bilinear<2, uint8_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_process_rows(_scale_bilinear<2, uint8_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 3:
-							_scale_bilinear<3, uint8_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_process_rows(_scale_bilinear<3, uint8_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 4:
-							_scale_bilinear<4, uint8_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_process_rows(_scale_bilinear<4, uint8_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 					}
 				} else if (format >= FORMAT_RF && format <= FORMAT_RGBAF) {
 					switch (get_format_pixel_size(format)) {
 						case 4:
-							_scale_bilinear<1, float>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_process_rows(_scale_bilinear<1, float>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 8:
-							_scale_bilinear<2, float>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_process_rows(_scale_bilinear<2, float>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 12:
-							_scale_bilinear<3, float>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_process_rows(_scale_bilinear<3, float>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 16:
-							_scale_bilinear<4, float>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_process_rows(_scale_bilinear<4, float>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 					}
 				} else if (format >= FORMAT_RH && format <= FORMAT_RGBAH) {
 					switch (get_format_pixel_size(format)) {
 						case 2:
-							_scale_bilinear<1, uint16_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_process_rows(_scale_bilinear<1, uint16_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 4:
-							_scale_bilinear<2, uint16_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_process_rows(_scale_bilinear<2, uint16_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 6:
-							_scale_bilinear<3, uint16_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_process_rows(_scale_bilinear<3, uint16_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 8:
-							_scale_bilinear<4, uint16_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_process_rows(_scale_bilinear<4, uint16_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 					}
 				}
@@ -1355,46 +1430,46 @@ void Image::resize(int p_width, int p_height, Interpolation p_interpolation) {
 			if (format >= FORMAT_L8 && format <= FORMAT_RGBA8) {
 				switch (get_format_pixel_size(format)) {
 					case 1:
-						_scale_cubic<1, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_cubic<1, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 2:
-						_scale_cubic<2, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_cubic<2, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 3:
-						_scale_cubic<3, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_cubic<3, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 4:
-						_scale_cubic<4, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_cubic<4, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			} else if (format >= FORMAT_RF && format <= FORMAT_RGBAF) {
 				switch (get_format_pixel_size(format)) {
 					case 4:
-						_scale_cubic<1, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_cubic<1, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 8:
-						_scale_cubic<2, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_cubic<2, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 12:
-						_scale_cubic<3, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_cubic<3, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 16:
-						_scale_cubic<4, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_cubic<4, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			} else if (format >= FORMAT_RH && format <= FORMAT_RGBAH) {
 				switch (get_format_pixel_size(format)) {
 					case 2:
-						_scale_cubic<1, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_cubic<1, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 4:
-						_scale_cubic<2, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_cubic<2, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 6:
-						_scale_cubic<3, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_cubic<3, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 8:
-						_scale_cubic<4, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_process_rows(_scale_cubic<4, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			}
@@ -1796,20 +1871,65 @@ bool Image::_can_modify(Format p_format) const {
 template <typename Component, int CC, bool renormalize,
 		void (*average_func)(Component &, const Component &, const Component &, const Component &, const Component &),
 		void (*renormalize_func)(Component *)>
-static void _generate_po2_mipmap(const Component *p_src, Component *p_dst, uint32_t p_width, uint32_t p_height) {
+static void _generate_po2_mipmap(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_width, uint32_t p_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row) {
 	// Fast power of 2 mipmap generation.
-	uint32_t dst_w = MAX(p_width >> 1, 1u);
-	uint32_t dst_h = MAX(p_height >> 1, 1u);
+	const Component *src = (const Component *)p_src;
+	Component *dst = (Component *)p_dst;
+	uint32_t dst_w = p_dst_width;
 
 	int right_step = (p_width == 1) ? 0 : CC;
 	int down_step = (p_height == 1) ? 0 : (p_width * CC);
 
-	for (uint32_t i = 0; i < dst_h; i++) {
-		const Component *rup_ptr = &p_src[i * 2 * down_step];
+	for (uint32_t i = p_from_row; i < p_to_row; i++) {
+		const Component *rup_ptr = &src[i * 2 * down_step];
 		const Component *rdown_ptr = rup_ptr + down_step;
-		Component *dst_ptr = &p_dst[i * dst_w * CC];
+		Component *dst_ptr = &dst[i * dst_w * CC];
 		uint32_t count = dst_w;
 
+#if defined(IMAGE_SIMD_SSE2) || defined(IMAGE_SIMD_NEON)
+		// Vectorized paths for the most common formats, producing the same results as the scalar loop below.
+		if constexpr (CC == 4 && !renormalize && std::is_same_v<Component, uint8_t>) {
+			if (right_step != 0) {
+				// Two destination pixels (four source pixels per row) at a time.
+				for (; count >= 2; count -= 2) {
+#ifdef IMAGE_SIMD_SSE2
+					const __m128i zero = _mm_setzero_si128();
+					__m128i up = _mm_loadu_si128((const __m128i *)rup_ptr);
+					__m128i down = _mm_loadu_si128((const __m128i *)rdown_ptr);
+					__m128i sum_lo = _mm_add_epi16(_mm_unpacklo_epi8(up, zero), _mm_unpacklo_epi8(down, zero)); // Pixels 0 and 1.
+					__m128i sum_hi = _mm_add_epi16(_mm_unpackhi_epi8(up, zero), _mm_unpackhi_epi8(down, zero)); // Pixels 2 and 3.
+					__m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(sum_lo, sum_hi), _mm_unpackhi_epi64(sum_lo, sum_hi));
+					sum = _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+					_mm_storel_epi64((__m128i *)dst_ptr, _mm_packus_epi16(sum, zero));
+#else
+					uint8x16_t up = vld1q_u8(rup_ptr);
+					uint8x16_t down = vld1q_u8(rdown_ptr);
+					uint16x8_t sum_lo = vaddl_u8(vget_low_u8(up), vget_low_u8(down)); // Pixels 0 and 1.
+					uint16x8_t sum_hi = vaddl_u8(vget_high_u8(up), vget_high_u8(down)); // Pixels 2 and 3.
+					uint16x8_t sum = vaddq_u16(vcombine_u16(vget_low_u16(sum_lo), vget_low_u16(sum_hi)), vcombine_u16(vget_high_u16(sum_lo), vget_high_u16(sum_hi)));
+					vst1_u8(dst_ptr, vrshrn_n_u16(sum, 2));
+#endif
+					dst_ptr += CC * 2;
+					rup_ptr += right_step * 4;
+					rdown_ptr += right_step * 4;
+				}
+			}
+		} else if constexpr (CC == 4 && !renormalize && std::is_same_v<Component, float>) {
+			for (; count; count--) {
+#ifdef IMAGE_SIMD_SSE2
+				__m128 sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_loadu_ps(rup_ptr), _mm_loadu_ps(rup_ptr + right_step)), _mm_loadu_ps(rdown_ptr)), _mm_loadu_ps(rdown_ptr + right_step));
+				_mm_storeu_ps(dst_ptr, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+				float32x4_t sum = vaddq_f32(vaddq_f32(vaddq_f32(vld1q_f32(rup_ptr), vld1q_f32(rup_ptr + right_step)), vld1q_f32(rdown_ptr)), vld1q_f32(rdown_ptr + right_step));
+				vst1q_f32(dst_ptr, vmulq_n_f32(sum, 0.25f));
+#endif
+				dst_ptr += CC;
+				rup_ptr += right_step * 2;
+				rdown_ptr += right_step * 2;
+			}
+		}
+#endif
+
 		while (count) {
 			count--;
 			for (int j = 0; j < CC; j++) {
@@ -1828,87 +1948,82 @@ static void _generate_po2_mipmap(const Component *p_src, Component *p_dst, uint3
 }
 
 void Image::_generate_mipmap_from_format(Image::Format p_format, const uint8_t *p_src, uint8_t *p_dst, uint32_t p_width, uint32_t p_height, bool p_renormalize) {
-	const float *src_float = reinterpret_cast<const float *>(p_src);
-	float *dst_float = reinterpret_cast<float *>(p_dst);
-
-	const uint16_t *src_u16 = reinterpret_cast<const uint16_t *>(p_src);
-	uint16_t *dst_u16 = reinterpret_cast<uint16_t *>(p_dst);
-
-	const uint32_t *src_u32 = reinterpret_cast<const uint32_t *>(p_src);
-	uint32_t *dst_u32 = reinterpret_cast<uint32_t *>(p_dst);
+	ImageRangeFunc func = nullptr;
 
 	switch (p_format) {
 		case Image::FORMAT_L8:
 		case Image::FORMAT_R8:
-			_generate_po2_mipmap<uint8_t, 1, false, Image::average_4_uint8, Image::renormalize_uint8>(p_src, p_dst, p_width, p_height);
+			func = _generate_po2_mipmap<uint8_t, 1, false, Image::average_4_uint8, Image::renormalize_uint8>;
 			break;
 		case Image::FORMAT_LA8:
-			_generate_po2_mipmap<uint8_t, 2, false, Image::average_4_uint8, Image::renormalize_uint8>(p_src, p_dst, p_width, p_height);
+			func = _generate_po2_mipmap<uint8_t, 2, false, Image::average_4_uint8, Image::renormalize_uint8>;
 			break;
 		case Image::FORMAT_RG8:
-			_generate_po2_mipmap<uint8_t, 2, false, Image::average_4_uint8, Image::renormalize_uint8>(p_src, p_dst, p_width, p_height);
+			func = _generate_po2_mipmap<uint8_t, 2, false, Image::average_4_uint8, Image::renormalize_uint8>;
 			break;
 		case Image::FORMAT_RGB8: {
 			if (p_renormalize) {
-				_generate_po2_mipmap<uint8_t, 3, true, Image::average_4_uint8, Image::renormalize_uint8>(p_src, p_dst, p_width, p_height);
+				func = _generate_po2_mipmap<uint8_t, 3, true, Image::average_4_uint8, Image::renormalize_uint8>;
 			} else {
-				_generate_po2_mipmap<uint8_t, 3, false, Image::average_4_uint8, Image::renormalize_uint8>(p_src, p_dst, p_width, p_height);
+				func = _generate_po2_mipmap<uint8_t, 3, false, Image::average_4_uint8, Image::renormalize_uint8>;
 			}
 		} break;
 		case Image::FORMAT_RGBA8: {
 			if (p_renormalize) {
-				_generate_po2_mipmap<uint8_t, 4, true, Image::average_4_uint8, Image::renormalize_uint8>(p_src, p_dst, p_width, p_height);
+				func = _generate_po2_mipmap<uint8_t, 4, true, Image::average_4_uint8, Image::renormalize_uint8>;
 			} else {
-				_generate_po2_mipmap<uint8_t, 4, false, Image::average_4_uint8, Image::renormalize_uint8>(p_src, p_dst, p_width, p_height);
+				func = _generate_po2_mipmap<uint8_t, 4, false, Image::average_4_uint8, Image::renormalize_uint8>;
 			}
 		} break;
 		case Image::FORMAT_RF:
-			_generate_po2_mipmap<float, 1, false, Image::average_4_float, Image::renormalize_float>(src_float, dst_float, p_width, p_height);
+			func = _generate_po2_mipmap<float, 1, false, Image::average_4_float, Image::renormalize_float>;
 			break;
 		case Image::FORMAT_RGF:
-			_generate_po2_mipmap<float, 2, false, Image::average_4_float, Image::renormalize_float>(src_float, dst_float, p_width, p_height);
+			func = _generate_po2_mipmap<float, 2, false, Image::average_4_float, Image::renormalize_float>;
 			break;
 		case Image::FORMAT_RGBF: {
 			if (p_renormalize) {
-				_generate_po2_mipmap<float, 3, true, Image::average_4_float, Image::renormalize_float>(src_float, dst_float, p_width, p_height);
+				func = _generate_po2_mipmap<float, 3, true, Image::average_4_float, Image::renormalize_float>;
 			} else {
-				_generate_po2_mipmap<float, 3, false, Image::average_4_float, Image::renormalize_float>(src_float, dst_float, p_width, p_height);
+				func = _generate_po2_mipmap<float, 3, false, Image::average_4_float, Image::renormalize_float>;
 			}
 		} break;
 		case Image::FORMAT_RGBAF: {
 			if (p_renormalize) {
-				_generate_po2_mipmap<float, 4, true, Image::average_4_float, Image::renormalize_float>(src_float, dst_float, p_width, p_height);
+				func = _generate_po2_mipmap<float, 4, true, Image::average_4_float, Image::renormalize_float>;
 			} else {
-				_generate_po2_mipmap<float, 4, false, Image::average_4_float, Image::renormalize_float>(src_float, dst_float, p_width, p_height);
+				func = _generate_po2_mipmap<float, 4, false, Image::average_4_float, Image::renormalize_float>;
 			}
 		} break;
 		case Image::FORMAT_RH:
-			_generate_po2_mipmap<uint16_t, 1, false, Image::average_4_half, Image::renormalize_half>(src_u16, dst_u16, p_width, p_height);
+			func = _generate_po2_mipmap<uint16_t, 1, false, Image::average_4_half, Image::renormalize_half>;
 			break;
 		case Image::FORMAT_RGH:
-			_generate_po2_mipmap<uint16_t, 2, false, Image::average_4_half, Image::renormalize_half>(src_u16, dst_u16, p_width, p_height);
+			func = _generate_po2_mipmap<uint16_t, 2, false, Image::average_4_half, Image::renormalize_half>;
 			break;
 		case Image::FORMAT_RGBH: {
 			if (p_renormalize) {
-				_generate_po2_mipmap<uint16_t, 3, true, Image::average_4_half, Image::renormalize_half>(src_u16, dst_u16, p_width, p_height);
+				func = _generate_po2_mipmap<uint16_t, 3, true, Image::average_4_half, Image::renormalize_half>;
 			} else {
-				_generate_po2_mipmap<uint16_t, 3, false, Image::average_4_half, Image::renormalize_half>(src_u16, dst_u16, p_width, p_height);
+				func = _generate_po2_mipmap<uint16_t, 3, false, Image::average_4_half, Image::renormalize_half>;
 			}
 		} break;
 		case Image::FORMAT_RGBAH: {
 			if (p_renormalize) {
-				_generate_po2_mipmap<uint16_t, 4, true, Image::average_4_half, Image::renormalize_half>(src_u16, dst_u16, p_width, p_height);
+				func = _generate_po2_mipmap<uint16_t, 4, true, Image::average_4_half, Image::renormalize_half>;
 			} else {
-				_generate_po2_mipmap<uint16_t, 4, false, Image::average_4_half, Image::renormalize_half>(src_u16, dst_u16, p_width, p_height);
+				func = _generate_po2_mipmap<uint16_t, 4, false, Image::average_4_half, Image::renormalize_half>;
 			}
 		} break;
 		case Image::FORMAT_RGBE9995:
-			_generate_po2_mipmap<uint32_t, 1, false, Image::average_4_rgbe9995, Image::renormalize_rgbe9995>(src_u32, dst_u32, p_width, p_height);
+			func = _generate_po2_mipmap<uint32_t, 1, false, Image::average_4_rgbe9995, Image::renormalize_rgbe9995>;
 			break;
 
 		default:
 			return;
 	}
+
+	_process_rows(func, p_src, p_dst, p_width, p_height, MAX(p_width >> 1, 1u), MAX(p_height >> 1, 1u));
 }
 
 void Image::shrink_x2() {
@@ -2736,6 +2851,9 @@ Error Image::compress_from_channels(CompressMode p_mode, UsedChannels p_channels
 		}
 	}
 
+	// Encoders work on RGBA8 (or half float for HDR) copies of the image, and output at most as much.
+	ImageCompressScheduler::MemoryReservation memory_reservation(get_image_data_size(width, height, format >= FORMAT_RF ? FORMAT_RGBAH : FORMAT_RGBA8, mipmaps) * 2);
+
 	switch (p_mode) {
 		case COMPRESS_S3TC: {
 			ERR_FAIL_NULL_V(_image_compress_bc_func, ERR_UNAVAILABLE);
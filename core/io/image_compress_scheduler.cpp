@@ -0,0 +1,159 @@
+/**************************************************************************/
+/*  image_compress_scheduler.cpp                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "image_compress_scheduler.h"
+
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
+
+BinaryMutex ImageCompressScheduler::memory_mutex;
+ConditionVariable ImageCompressScheduler::memory_cond;
+uint64_t ImageCompressScheduler::memory_budget = 0;
+uint64_t ImageCompressScheduler::memory_in_flight = 0;
+
+// Rough amount of pixels per job, so small mip levels don't turn into lots of tiny jobs.
+static const uint32_t PIXELS_PER_JOB = 256 * 256;
+
+void ImageCompressScheduler::set_memory_budget(uint64_t p_bytes) {
+	MutexLock lock(memory_mutex);
+	memory_budget = p_bytes;
+	memory_cond.notify_all();
+}
+
+uint64_t ImageCompressScheduler::get_memory_budget() {
+	MutexLock lock(memory_mutex);
+	return memory_budget;
+}
+
+void ImageCompressScheduler::reserve_memory(uint64_t p_bytes) {
+	MutexLock lock(memory_mutex);
+	while (memory_budget != 0 && memory_in_flight != 0 && memory_in_flight + p_bytes > memory_budget) {
+		memory_cond.wait(lock);
+	}
+	memory_in_flight += p_bytes;
+}
+
+void ImageCompressScheduler::release_memory(uint64_t p_bytes) {
+	MutexLock lock(memory_mutex);
+	DEV_ASSERT(memory_in_flight >= p_bytes);
+	memory_in_flight -= p_bytes;
+	memory_cond.notify_all();
+}
+
+void ImageCompressScheduler::_compress_job(void *p_userdata, uint32_t p_index) {
+	const CompressData *data = (const CompressData *)p_userdata;
+	data->func(data->jobs[p_index], data->userdata);
+}
+
+void ImageCompressScheduler::compress(const Image *p_image, int p_width, int p_height, Image::Format p_target_format, uint8_t *p_dst, CompressFunc p_func, void *p_userdata) {
+	ERR_FAIL_NULL(p_image);
+	ERR_FAIL_NULL(p_func);
+
+	const uint32_t block = Image::get_format_block_size(p_target_format);
+	const int64_t block_bytes = Image::get_image_data_size(block, block, p_target_format, false);
+	const int pixel_size = Image::get_format_pixel_size(p_image->get_format());
+	const int mipmap_count = p_image->has_mipmaps() ? Image::get_image_required_mipmaps(p_width, p_height, p_target_format) : 0;
+
+	// Mip levels which aren't a multiple of the block size are padded, and need to stay alive until all jobs are done.
+	LocalVector<Vector<uint8_t>> padded_mipmaps;
+	LocalVector<Job> jobs;
+
+	for (int i = 0; i <= mipmap_count; i++) {
+		int dst_w, dst_h;
+		const int64_t dst_ofs = Image::get_image_mipmap_offset_and_dimensions(p_width, p_height, p_target_format, i, dst_w, dst_h);
+		const uint32_t block_w = (dst_w + block - 1) / block * block;
+		const uint32_t block_h = (dst_h + block - 1) / block * block;
+
+		int64_t src_ofs, src_size;
+		int src_w, src_h;
+		p_image->get_mipmap_offset_size_and_dimensions(i, src_ofs, src_size, src_w, src_h);
+		const uint8_t *src = p_image->ptr() + src_ofs;
+
+		// Pad to whole blocks by smearing the edge pixels.
+		if (uint32_t(src_w) != block_w || uint32_t(src_h) != block_h) {
+			Vector<uint8_t> padded;
+			padded.resize(block_w * block_h * pixel_size);
+			uint8_t *ptrw = padded.ptrw();
+
+			const uint32_t copy_w = MIN(uint32_t(src_w), block_w);
+			const uint32_t copy_h = MIN(uint32_t(src_h), block_h);
+
+			uint32_t x = 0, y = 0;
+			for (y = 0; y < copy_h; y++) {
+				memcpy(ptrw + block_w * y * pixel_size, src + src_w * y * pixel_size, copy_w * pixel_size);
+
+				// First, smear in x.
+				for (x = copy_w; x < block_w; x++) {
+					memcpy(ptrw + (block_w * y + x) * pixel_size, ptrw + (block_w * y + x - 1) * pixel_size, pixel_size);
+				}
+			}
+
+			// Then, smear in y.
+			for (; y < block_h; y++) {
+				memcpy(ptrw + block_w * y * pixel_size, ptrw + block_w * (y - 1) * pixel_size, block_w * pixel_size);
+			}
+
+			padded_mipmaps.push_back(padded);
+			src = padded_mipmaps[padded_mipmaps.size() - 1].ptr();
+		}
+
+		const uint32_t block_rows = block_h / block;
+		const uint32_t blocks_per_row = block_w / block;
+		const uint32_t rows_per_job = MAX(1u, PIXELS_PER_JOB / (block_w * block));
+
+		for (uint32_t row = 0; row < block_rows; row += rows_per_job) {
+			Job job;
+			job.src = src + row * block * block_w * pixel_size;
+			job.dst = p_dst + dst_ofs + row * blocks_per_row * block_bytes;
+			job.width = block_w;
+			job.height = MIN(rows_per_job, block_rows - row) * block;
+			job.mipmap = i;
+			jobs.push_back(job);
+		}
+	}
+
+	CompressData data;
+	data.jobs = jobs.ptr();
+	data.func = p_func;
+	data.userdata = p_userdata;
+
+	// When already running on a pool thread (e.g. several textures being imported in parallel), compress
+	// inline: waiting on a group task there could starve the pool while other threads wait for memory.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (jobs.size() == 1 || pool == nullptr || pool->get_thread_count() < 2 || pool->get_thread_index() != -1) {
+		for (uint32_t i = 0; i < jobs.size(); i++) {
+			_compress_job(&data, i);
+		}
+		return;
+	}
+
+	WorkerThreadPool::GroupID group_task = pool->add_native_group_task(&_compress_job, &data, jobs.size(), -1, true, SNAME("ImageCompress"));
+	pool->wait_for_group_task_completion(group_task);
+}
@@ -0,0 +1,94 @@
+/**************************************************************************/
+/*  image_compress_scheduler.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/io/image.h"
+#include "core/os/condition_variable.h"
+#include "core/os/mutex.h"
+
+// Shared scheduler for block compression encoders.
+//
+// Mip levels are padded to whole blocks and split into strips of block rows,
+// which are compressed in parallel on the WorkerThreadPool (or inline, when
+// called from a pool thread which is already one of many). It also keeps
+// track of the memory used by images being compressed, so importing many
+// large textures at once doesn't exhaust memory.
+class ImageCompressScheduler {
+public:
+	// A strip of block rows of a single mip level.
+	struct Job {
+		const uint8_t *src = nullptr; // First source pixel of the strip.
+		uint8_t *dst = nullptr; // First destination block of the strip.
+		uint32_t width = 0; // In pixels, a multiple of the block width.
+		uint32_t height = 0; // In pixels, a multiple of the block height.
+		uint32_t mipmap = 0;
+	};
+
+	typedef void (*CompressFunc)(const Job &p_job, void *p_userdata);
+
+private:
+	static BinaryMutex memory_mutex;
+	static ConditionVariable memory_cond;
+	static uint64_t memory_budget;
+	static uint64_t memory_in_flight;
+
+	struct CompressData {
+		const Job *jobs = nullptr;
+		CompressFunc func = nullptr;
+		void *userdata = nullptr;
+	};
+
+	static void _compress_job(void *p_userdata, uint32_t p_index);
+
+public:
+	// Zero means unlimited.
+	static void set_memory_budget(uint64_t p_bytes);
+	static uint64_t get_memory_budget();
+
+	// Blocks until p_bytes fit in the memory budget. A request larger than the whole
+	// budget is let through once nothing else is in flight.
+	static void reserve_memory(uint64_t p_bytes);
+	static void release_memory(uint64_t p_bytes);
+
+	// Holds a reservation for the duration of a scope.
+	class MemoryReservation {
+		uint64_t bytes = 0;
+
+	public:
+		explicit MemoryReservation(uint64_t p_bytes) :
+				bytes(p_bytes) { reserve_memory(bytes); }
+		~MemoryReservation() { release_memory(bytes); }
+	};
+
+	// Compresses all mip levels of p_image into p_dst, which must be laid out as an image of
+	// p_width x p_height in p_target_format, with the same mipmaps as p_image.
+	static void compress(const Image *p_image, int p_width, int p_height, Image::Format p_target_format, uint8_t *p_dst, CompressFunc p_func, void *p_userdata);
+};
@@ -1579,7 +1579,7 @@ void ResourceFormatSaverBinaryInstance::_pad_buffer(Ref<FileAccess> f, int p_byt
 	}
 }
 
-void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const Variant &p_property, HashMap<Ref<Resource>, int> &resource_map, HashMap<Ref<Resource>, int> &external_resources, HashMap<StringName, int> &string_map, const PropertyInfo &p_hint) {
+void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const Variant &p_property, const HashMap<ObjectID, ResourceRef> &p_resource_refs, HashMap<StringName, int> &string_map, const PropertyInfo &p_hint) {
 	switch (p_property.get_type()) {
 		case Variant::NIL: {
 			f->store_32(VARIANT_NIL);
@@ -1828,24 +1828,27 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 		} break;
 		case Variant::OBJECT: {
 			f->store_32(VARIANT_OBJECT);
-			Ref<Resource> res = p_property;
-			if (res.is_null() || res->get_meta(SNAME("_skip_save_"), false)) {
+			// Only the object ID is read here, the resource itself may be in use on another thread.
+			const ObjectID id = p_property;
+			const ResourceRef *ref = p_resource_refs.getptr(id);
+			if (!ref || ref->kind == ResourceRef::EMPTY) {
 				f->store_32(OBJECT_EMPTY);
 				return; // Don't save it.
 			}
 
-			if (!res->is_built_in()) {
-				f->store_32(OBJECT_EXTERNAL_RESOURCE_INDEX);
-				f->store_32(uint32_t(external_resources[res]));
-			} else {
-				if (!resource_map.has(res)) {
+			switch (ref->kind) {
+				case ResourceRef::EXTERNAL: {
+					f->store_32(OBJECT_EXTERNAL_RESOURCE_INDEX);
+					f->store_32(uint32_t(ref->index));
+				} break;
+				case ResourceRef::INTERNAL: {
+					f->store_32(OBJECT_INTERNAL_RESOURCE);
+					f->store_32(uint32_t(ref->index));
+				} break;
+				default: {
 					f->store_32(OBJECT_EMPTY);
 					ERR_FAIL_MSG("Resource was not pre cached for the resource section, most likely due to circular reference.");
 				}
-
-				f->store_32(OBJECT_INTERNAL_RESOURCE);
-				f->store_32(uint32_t(resource_map[res]));
-				//internal resource
 			}
 
 		} break;
@@ -1867,8 +1870,8 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 			d.get_key_list(&keys);
 
 			for (const Variant &E : keys) {
-				write_variant(f, E, resource_map, external_resources, string_map);
-				write_variant(f, d[E], resource_map, external_resources, string_map);
+				write_variant(f, E, p_resource_refs, string_map);
+				write_variant(f, d[E], p_resource_refs, string_map);
 			}
 
 		} break;
@@ -1877,7 +1880,7 @@ void ResourceFormatSaverBinaryInstance::write_variant(Ref<FileAccess> f, const V
 			Array a = p_property;
 			f->store_32(uint32_t(a.size()));
 			for (const Variant &var : a) {
-				write_variant(f, var, resource_map, external_resources, string_map);
+				write_variant(f, var, p_resource_refs, string_map);
 			}
 
 		} break;
@@ -2095,6 +2098,49 @@ void ResourceFormatSaverBinaryInstance::_find_resources(const Variant &p_variant
 	}
 }
 
+void ResourceFormatSaverBinaryInstance::_gather_resource_refs(const Variant &p_variant) {
+	switch (p_variant.get_type()) {
+		case Variant::OBJECT: {
+			Ref<Resource> res = p_variant;
+			if (res.is_null() || resource_refs.has(res->get_instance_id())) {
+				return;
+			}
+
+			ResourceRef ref;
+			if (res->get_meta(SNAME("_skip_save_"), false)) {
+				ref.kind = ResourceRef::EMPTY;
+			} else if (!res->is_built_in()) {
+				ref.kind = ResourceRef::EXTERNAL;
+				const int *index = external_resources.getptr(res);
+				ref.index = index ? *index : 0;
+			} else if (resource_map.has(res)) {
+				ref.kind = ResourceRef::INTERNAL;
+				ref.index = resource_map[res];
+			} else {
+				ref.kind = ResourceRef::NOT_CACHED;
+			}
+			resource_refs.insert(res->get_instance_id(), ref);
+		} break;
+		case Variant::ARRAY: {
+			Array varray = p_variant;
+			for (const Variant &v : varray) {
+				_gather_resource_refs(v);
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary d = p_variant;
+			List<Variant> keys;
+			d.get_key_list(&keys);
+			for (const Variant &E : keys) {
+				_gather_resource_refs(E);
+				_gather_resource_refs(d[E]);
+			}
+		} break;
+		default: {
+		}
+	}
+}
+
 void ResourceFormatSaverBinaryInstance::save_unicode_string(Ref<FileAccess> p_f, const String &p_string, bool p_bit_on_len) {
 	CharString utf8 = p_string.utf8();
 	if (p_bit_on_len) {
@@ -2125,23 +2171,118 @@ static String _resource_get_class(Ref<Resource> p_resource) {
 	}
 }
 
-Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Resource> &p_resource, uint32_t p_flags) {
-	Resource::seed_scene_unique_id(p_path.hash());
+uint32_t ResourceFormatSaverBinaryInstance::_hash_variant(const Variant &p_variant, uint32_t p_hash) const {
+	p_hash = hash_murmur3_one_32(p_variant.get_type(), p_hash);
+	switch (p_variant.get_type()) {
+		case Variant::OBJECT: {
+			// Built-in resources hash by their (deduplicated) index, so identical subtrees hash equally.
+			Ref<Resource> res = p_variant;
+			if (res.is_null()) {
+				return p_hash;
+			}
+			HashMap<Ref<Resource>, int>::ConstIterator E = resource_map.find(res);
+			if (E) {
+				return hash_murmur3_one_32(E->value, p_hash);
+			}
+			return hash_murmur3_one_64(uint64_t(res.ptr()), p_hash);
+		}
+		case Variant::ARRAY: {
+			Array varray = p_variant;
+			p_hash = hash_murmur3_one_32(varray.size(), p_hash);
+			for (const Variant &v : varray) {
+				p_hash = _hash_variant(v, p_hash);
+			}
+			return p_hash;
+		}
+		case Variant::DICTIONARY: {
+			Dictionary d = p_variant;
+			List<Variant> keys;
+			d.get_key_list(&keys);
+			p_hash = hash_murmur3_one_32(keys.size(), p_hash);
+			for (const Variant &E : keys) {
+				p_hash = _hash_variant(E, p_hash);
+				p_hash = _hash_variant(d[E], p_hash);
+			}
+			return p_hash;
+		}
+		default: {
+			return hash_murmur3_one_32(p_variant.hash(), p_hash);
+		}
+	}
+}
 
-	Error err;
-	Ref<FileAccess> f;
-	if (p_flags & ResourceSaver::FLAG_COMPRESS) {
-		Ref<FileAccessCompressed> fac;
-		fac.instantiate();
-		fac->configure("RSCC");
-		f = fac;
-		err = fac->open_internal(p_path, FileAccess::WRITE);
-	} else {
-		f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+bool ResourceFormatSaverBinaryInstance::_variant_equals(const Variant &p_a, const Variant &p_b) const {
+	if (p_a.get_type() != p_b.get_type()) {
+		return false;
 	}
 
-	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Cannot create file '%s'.", p_path));
+	switch (p_a.get_type()) {
+		case Variant::OBJECT: {
+			Ref<Resource> res_a = p_a;
+			Ref<Resource> res_b = p_b;
+			if (res_a == res_b) {
+				return true;
+			}
+			if (res_a.is_null() || res_b.is_null()) {
+				return false;
+			}
+			HashMap<Ref<Resource>, int>::ConstIterator A = resource_map.find(res_a);
+			HashMap<Ref<Resource>, int>::ConstIterator B = resource_map.find(res_b);
+			return A && B && A->value == B->value;
+		}
+		case Variant::ARRAY: {
+			Array array_a = p_a;
+			Array array_b = p_b;
+			if (array_a.size() != array_b.size() || !array_a.is_same_typed(array_b)) {
+				return false;
+			}
+			for (int i = 0; i < array_a.size(); i++) {
+				if (!_variant_equals(array_a[i], array_b[i])) {
+					return false;
+				}
+			}
+			return true;
+		}
+		case Variant::DICTIONARY: {
+			Dictionary dict_a = p_a;
+			Dictionary dict_b = p_b;
+			if (dict_a.size() != dict_b.size()) {
+				return false;
+			}
+			List<Variant> keys_a;
+			List<Variant> keys_b;
+			dict_a.get_key_list(&keys_a);
+			dict_b.get_key_list(&keys_b);
+			// Key order is preserved on load, so it has to match as well.
+			for (List<Variant>::ConstIterator A = keys_a.begin(), B = keys_b.begin(); A != keys_a.end(); ++A, ++B) {
+				if (!_variant_equals(*A, *B) || !_variant_equals(dict_a[*A], dict_b[*B])) {
+					return false;
+				}
+			}
+			return true;
+		}
+		default: {
+			return p_a.hash_compare(p_b);
+		}
+	}
+}
+
+bool ResourceFormatSaverBinaryInstance::_resource_data_equals(const ResourceData &p_a, const ResourceData &p_b) const {
+	if (p_a.type != p_b.type || p_a.properties.size() != p_b.properties.size()) {
+		return false;
+	}
+	for (List<Property>::ConstIterator A = p_a.properties.begin(), B = p_b.properties.begin(); A != p_a.properties.end(); ++A, ++B) {
+		if (A->name_idx != B->name_idx || !_variant_equals(A->value, B->value)) {
+			return false;
+		}
+	}
+	return true;
+}
 
+Error ResourceFormatSaverBinaryInstance::prepare_save(const String &p_path, const Ref<Resource> &p_resource, uint32_t p_flags, bool p_copy_containers) {
+	Resource::seed_scene_unique_id(p_path.hash());
+
+	save_flags = p_flags;
 	relative_paths = p_flags & ResourceSaver::FLAG_RELATIVE_PATHS;
 	skip_editor = p_flags & ResourceSaver::FLAG_OMIT_EDITOR_PROPERTIES;
 	bundle_resources = p_flags & ResourceSaver::FLAG_BUNDLE_RESOURCES;
@@ -2152,149 +2293,135 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Re
 		takeover_paths = false;
 	}
 
+	// Taking over paths gives every built-in resource its own entry in the file, which merging would break.
+	const bool deduplicate = (p_flags & ResourceSaver::FLAG_DEDUPLICATE_SUBRESOURCES) && !takeover_paths;
+
 	local_path = p_path.get_base_dir();
 	path = ProjectSettings::get_singleton()->localize_path(p_path);
 
 	_find_resources(p_resource, true);
 
-	if (!(p_flags & ResourceSaver::FLAG_COMPRESS)) {
-		//save header compressed
-		static const uint8_t header[4] = { 'R', 'S', 'R', 'C' };
-		f->store_buffer(header, 4);
+	save_type = _resource_get_class(p_resource);
+	script_class = String();
+	if (!p_resource->is_class("PackedScene")) {
+		Ref<Script> s = p_resource->get_script();
+		if (s.is_valid()) {
+			script_class = s->get_global_name();
+		}
 	}
+	save_uid = ResourceSaver::get_resource_id_for_path(p_path, true);
 
-	if (big_endian) {
-		f->store_32(1);
-		f->set_big_endian(true);
-	} else {
-		f->store_32(0);
-	}
+	// Content hash -> indices into `resources`, only used when deduplicating.
+	HashMap<uint32_t, LocalVector<int>> content_index;
+	Vector<ResourceData *> resource_data_ptrs;
+	Vector<Ref<Resource>> canonical_resources;
 
-	f->store_32(0); //64 bits file, false for now
-	f->store_32(VERSION_MAJOR);
-	f->store_32(VERSION_MINOR);
-	f->store_32(FORMAT_VERSION);
+	for (const Ref<Resource> &E : saved_resources) {
+		Dictionary missing_resource_properties = E->get_meta(META_MISSING_RESOURCES, Dictionary());
 
-	if (f->get_error() != OK && f->get_error() != ERR_FILE_EOF) {
-		return ERR_CANT_CREATE;
-	}
+		ResourceData rd;
+		rd.type = _resource_get_class(E);
 
-	save_unicode_string(f, _resource_get_class(p_resource));
-	f->store_64(0); //offset to import metadata
+		List<PropertyInfo> property_list;
+		E->get_property_list(&property_list);
 
-	String script_class;
-	{
-		uint32_t format_flags = FORMAT_FLAG_NAMED_SCENE_IDS | FORMAT_FLAG_UIDS;
-#ifdef REAL_T_IS_DOUBLE
-		format_flags |= FORMAT_FLAG_REAL_T_IS_DOUBLE;
-#endif
-		if (!p_resource->is_class("PackedScene")) {
-			Ref<Script> s = p_resource->get_script();
-			if (s.is_valid()) {
-				script_class = s->get_global_name();
-				if (!script_class.is_empty()) {
-					format_flags |= ResourceFormatSaverBinaryInstance::FORMAT_FLAG_HAS_SCRIPT_CLASS;
-				}
+		for (const PropertyInfo &F : property_list) {
+			if (skip_editor && F.name.begins_with("__editor")) {
+				continue;
+			}
+			if (F.name == META_PROPERTY_MISSING_RESOURCES) {
+				continue;
 			}
-		}
-
-		f->store_32(format_flags);
-	}
-	ResourceUID::ID uid = ResourceSaver::get_resource_id_for_path(p_path, true);
-	f->store_64(uint64_t(uid));
-	if (!script_class.is_empty()) {
-		save_unicode_string(f, script_class);
-	}
-
-	for (int i = 0; i < ResourceFormatSaverBinaryInstance::RESERVED_FIELDS; i++) {
-		f->store_32(0); // reserved
-	}
 
-	List<ResourceData> resources;
+			if ((F.usage & PROPERTY_USAGE_STORAGE) || missing_resource_properties.has(F.name)) {
+				Property p;
+				p.name_idx = get_string_index(F.name);
 
-	{
-		for (const Ref<Resource> &E : saved_resources) {
-			Dictionary missing_resource_properties = E->get_meta(META_MISSING_RESOURCES, Dictionary());
+				if (F.usage & PROPERTY_USAGE_RESOURCE_NOT_PERSISTENT) {
+					NonPersistentKey npk;
+					npk.base = E;
+					npk.property = F.name;
+					if (non_persistent_map.has(npk)) {
+						p.value = non_persistent_map[npk];
+					}
+				} else {
+					p.value = E->get(F.name);
+				}
 
-			ResourceData &rd = resources.push_back(ResourceData())->get();
-			rd.type = _resource_get_class(E);
+				if (F.type == Variant::OBJECT && missing_resource_properties.has(F.name)) {
+					// Was this missing resource overridden? If so do not save the old value.
+					Ref<Resource> res = p.value;
+					if (res.is_null()) {
+						p.value = missing_resource_properties[F.name];
+					}
+				}
 
-			List<PropertyInfo> property_list;
-			E->get_property_list(&property_list);
+				Variant default_value = ClassDB::class_get_default_property_value(E->get_class(), F.name);
 
-			for (const PropertyInfo &F : property_list) {
-				if (skip_editor && F.name.begins_with("__editor")) {
-					continue;
-				}
-				if (F.name == META_PROPERTY_MISSING_RESOURCES) {
+				if (default_value.get_type() != Variant::NIL && bool(Variant::evaluate(Variant::OP_EQUAL, p.value, default_value))) {
 					continue;
 				}
 
-				if ((F.usage & PROPERTY_USAGE_STORAGE) || missing_resource_properties.has(F.name)) {
-					Property p;
-					p.name_idx = get_string_index(F.name);
-
-					if (F.usage & PROPERTY_USAGE_RESOURCE_NOT_PERSISTENT) {
-						NonPersistentKey npk;
-						npk.base = E;
-						npk.property = F.name;
-						if (non_persistent_map.has(npk)) {
-							p.value = non_persistent_map[npk];
-						}
-					} else {
-						p.value = E->get(F.name);
-					}
-
-					if (F.type == Variant::OBJECT && missing_resource_properties.has(F.name)) {
-						// Was this missing resource overridden? If so do not save the old value.
-						Ref<Resource> res = p.value;
-						if (res.is_null()) {
-							p.value = missing_resource_properties[F.name];
-						}
-					}
-
-					Variant default_value = ClassDB::class_get_default_property_value(E->get_class(), F.name);
+				if (p_copy_containers && (p.value.get_type() == Variant::ARRAY || p.value.get_type() == Variant::DICTIONARY)) {
+					// Arrays and dictionaries are shared, not copy-on-write; the caller may keep modifying them while writing.
+					p.value = p.value.duplicate(true);
+				}
 
-					if (default_value.get_type() != Variant::NIL && bool(Variant::evaluate(Variant::OP_EQUAL, p.value, default_value))) {
-						continue;
-					}
+				p.pi = F;
 
-					p.pi = F;
+				rd.properties.push_back(p);
+			}
+		}
 
-					rd.properties.push_back(p);
+		// Sub-resources are always found before the resources referencing them,
+		// so identical subtrees collapse bottom-up. The main resource and resources
+		// which are expected to be unique per scene are never merged.
+		if (deduplicate && E != p_resource && E->is_built_in() && !E->is_local_to_scene()) {
+			uint32_t h = hash_murmur3_one_32(rd.type.hash());
+			for (const Property &p : rd.properties) {
+				h = hash_murmur3_one_32(p.name_idx, h);
+				h = _hash_variant(p.value, h);
+			}
+			h = hash_fmix32(h);
+
+			LocalVector<int> &candidates = content_index[h];
+			int found = -1;
+			for (int candidate : candidates) {
+				if (_resource_data_equals(*resource_data_ptrs[candidate], rd)) {
+					found = candidate;
+					break;
 				}
 			}
+
+			if (found != -1) {
+				// Saved through its identical copy, so it's as clean as if it had been saved itself.
+				resource_map[E] = found;
+#ifdef TOOLS_ENABLED
+				E->set_edited(false);
+#endif
+				continue;
+			}
+			candidates.push_back(resources.size());
 		}
-	}
 
-	f->store_32(uint32_t(strings.size())); //string table size
-	for (int i = 0; i < strings.size(); i++) {
-		save_unicode_string(f, strings[i]);
+		resource_map[E] = resources.size();
+		resource_data_ptrs.push_back(&resources.push_back(rd)->get());
+		canonical_resources.push_back(E);
 	}
 
-	// save external resource table
-	f->store_32(external_resources.size()); //amount of external resources
-	Vector<Ref<Resource>> save_order;
-	save_order.resize(external_resources.size());
-
+	// External resource table.
+	external_data.resize(external_resources.size());
 	for (const KeyValue<Ref<Resource>, int> &E : external_resources) {
-		save_order.write[E.value] = E.key;
+		ExternalResourceData &erd = external_data.write[E.value];
+		erd.type = E.key->get_save_class();
+		erd.path = relative_paths ? local_path.path_to_file(E.key->get_path()) : E.key->get_path();
+		erd.uid = ResourceSaver::get_resource_id_for_path(E.key->get_path(), false);
 	}
 
-	for (int i = 0; i < save_order.size(); i++) {
-		save_unicode_string(f, save_order[i]->get_save_class());
-		String res_path = save_order[i]->get_path();
-		res_path = relative_paths ? local_path.path_to_file(res_path) : res_path;
-		save_unicode_string(f, res_path);
-		ResourceUID::ID ruid = ResourceSaver::get_resource_id_for_path(save_order[i]->get_path(), false);
-		f->store_64(uint64_t(ruid));
-	}
-	// save internal resource table
-	f->store_32(uint32_t(saved_resources.size())); //amount of internal resources
-	Vector<uint64_t> ofs_pos;
+	// Internal resource table.
 	HashSet<String> used_unique_ids;
 
-	for (Ref<Resource> &r : saved_resources) {
+	for (Ref<Resource> &r : canonical_resources) {
 		if (r->is_built_in()) {
 			if (!r->get_scene_unique_id().is_empty()) {
 				if (used_unique_ids.has(r->get_scene_unique_id())) {
@@ -2306,9 +2433,9 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Re
 		}
 	}
 
-	HashMap<Ref<Resource>, int> resource_map;
 	int res_index = 0;
-	for (Ref<Resource> &r : saved_resources) {
+	for (Ref<Resource> &r : canonical_resources) {
+		ResourceData &rd = *resource_data_ptrs[res_index++];
 		if (r->is_built_in()) {
 			if (r->get_scene_unique_id().is_empty()) {
 				String new_id;
@@ -2324,7 +2451,7 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Re
 				used_unique_ids.insert(new_id);
 			}
 
-			save_unicode_string(f, "local://" + r->get_scene_unique_id());
+			rd.path = "local://" + r->get_scene_unique_id();
 			if (takeover_paths) {
 				r->set_path(p_path + "::" + r->get_scene_unique_id(), true);
 			}
@@ -2332,11 +2459,101 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Re
 			r->set_edited(false);
 #endif
 		} else {
-			save_unicode_string(f, r->get_path()); //actual external
+			rd.path = r->get_path(); //actual external
+		}
+	}
+
+	// Resolve every resource referenced by the gathered properties now, so write_prepared() only reads this snapshot.
+	for (const ResourceData &rd : resources) {
+		for (const Property &p : rd.properties) {
+			_gather_resource_refs(p.value);
+		}
+	}
+
+	return OK;
+}
+
+Error ResourceFormatSaverBinaryInstance::write_prepared(const String &p_path) {
+	Error err;
+	Ref<FileAccess> f;
+	if (save_flags & ResourceSaver::FLAG_COMPRESS) {
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		fac->configure("RSCC");
+		f = fac;
+		err = fac->open_internal(p_path, FileAccess::WRITE);
+	} else {
+		f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	}
+
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Cannot create file '%s'.", p_path));
+
+	if (!(save_flags & ResourceSaver::FLAG_COMPRESS)) {
+		//save header compressed
+		static const uint8_t header[4] = { 'R', 'S', 'R', 'C' };
+		f->store_buffer(header, 4);
+	}
+
+	if (big_endian) {
+		f->store_32(1);
+		f->set_big_endian(true);
+	} else {
+		f->store_32(0);
+	}
+
+	f->store_32(0); //64 bits file, false for now
+	f->store_32(VERSION_MAJOR);
+	f->store_32(VERSION_MINOR);
+	f->store_32(FORMAT_VERSION);
+
+	if (f->get_error() != OK && f->get_error() != ERR_FILE_EOF) {
+		return ERR_CANT_CREATE;
+	}
+
+	save_unicode_string(f, save_type);
+	f->store_64(0); //offset to import metadata
+
+	{
+		uint32_t format_flags = FORMAT_FLAG_NAMED_SCENE_IDS | FORMAT_FLAG_UIDS;
+#ifdef REAL_T_IS_DOUBLE
+		format_flags |= FORMAT_FLAG_REAL_T_IS_DOUBLE;
+#endif
+		if (!script_class.is_empty()) {
+			format_flags |= ResourceFormatSaverBinaryInstance::FORMAT_FLAG_HAS_SCRIPT_CLASS;
 		}
+
+		f->store_32(format_flags);
+	}
+	f->store_64(uint64_t(save_uid));
+	if (!script_class.is_empty()) {
+		save_unicode_string(f, script_class);
+	}
+
+	for (int i = 0; i < ResourceFormatSaverBinaryInstance::RESERVED_FIELDS; i++) {
+		f->store_32(0); // reserved
+	}
+
+	f->store_32(uint32_t(strings.size())); //string table size
+	for (int i = 0; i < strings.size(); i++) {
+		save_unicode_string(f, strings[i]);
+	}
+
+	// save external resource table
+	f->store_32(external_data.size()); //amount of external resources
+	for (const ExternalResourceData &erd : external_data) {
+		save_unicode_string(f, erd.type);
+		save_unicode_string(f, erd.path);
+		f->store_64(uint64_t(erd.uid));
+	}
+
+	// save internal resource table
+	f->store_32(uint32_t(resources.size())); //amount of internal resources
+	Vector<uint64_t> ofs_pos;
+
+	for (const ResourceData &rd : resources) {
+		save_unicode_string(f, rd.path);
 		ofs_pos.push_back(f->get_position());
 		f->store_64(0); //offset in 64 bits
-		resource_map[r] = res_index++;
 	}
 
 	Vector<uint64_t> ofs_table;
@@ -2349,7 +2566,7 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Re
 
 		for (const Property &p : rd.properties) {
 			f->store_32(uint32_t(p.name_idx));
-			write_variant(f, p.value, resource_map, external_resources, string_map, p.pi);
+			write_variant(f, p.value, resource_refs, string_map, p.pi);
 		}
 	}
 
@@ -2369,6 +2586,14 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Re
 	return OK;
 }
 
+Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Resource> &p_resource, uint32_t p_flags) {
+	Error err = prepare_save(p_path, p_resource, p_flags);
+	if (err != OK) {
+		return err;
+	}
+	return write_prepared(p_path);
+}
+
 Error ResourceFormatSaverBinaryInstance::set_uid(const String &p_path, ResourceUID::ID p_uid) {
 	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
 	ERR_FAIL_COND_V_MSG(f.is_null(), ERR_CANT_OPEN, vformat("Cannot open file '%s'.", p_path));
@@ -2491,6 +2716,54 @@ Error ResourceFormatSaverBinary::save(const Ref<Resource> &p_resource, const Str
 	return saver.save(local_path, p_resource, p_flags);
 }
 
+void ResourceFormatSaverBinary::_threaded_save_task(void *p_userdata) {
+	ThreadedSave *ts = (ThreadedSave *)p_userdata;
+	const String temp_path = ts->path + ".tmp";
+
+	ts->error = ts->saver.write_prepared(temp_path);
+
+	Ref<DirAccess> da = DirAccess::create_for_path(ts->path);
+	if (ts->error == OK) {
+		// Only replace the previous file once the new one is complete.
+		ts->error = da->rename(temp_path, ts->path);
+	} else if (da->file_exists(temp_path)) {
+		da->remove(temp_path);
+	}
+}
+
+WorkerThreadPool::TaskID ResourceFormatSaverBinary::save_threaded(const Ref<Resource> &p_resource, const String &p_path, uint32_t p_flags) {
+	ERR_FAIL_COND_V(p_resource.is_null(), WorkerThreadPool::INVALID_TASK_ID);
+
+	ThreadedSave *ts = memnew(ThreadedSave);
+	ts->path = ProjectSettings::get_singleton()->localize_path(p_path);
+	ts->error = ts->saver.prepare_save(ts->path, p_resource, p_flags, true);
+	if (ts->error != OK) {
+		memdelete(ts);
+		ERR_FAIL_V_MSG(WorkerThreadPool::INVALID_TASK_ID, vformat("Cannot prepare resource for saving to '%s'.", p_path));
+	}
+
+	MutexLock lock(threaded_save_mutex);
+	WorkerThreadPool::TaskID task = WorkerThreadPool::get_singleton()->add_native_task(&ResourceFormatSaverBinary::_threaded_save_task, ts, false, "Save " + ts->path);
+	threaded_saves.insert(task, ts);
+	return task;
+}
+
+Error ResourceFormatSaverBinary::wait_for_threaded_save(WorkerThreadPool::TaskID p_task) {
+	ThreadedSave *ts = nullptr;
+	{
+		MutexLock lock(threaded_save_mutex);
+		HashMap<WorkerThreadPool::TaskID, ThreadedSave *>::Iterator E = threaded_saves.find(p_task);
+		ERR_FAIL_COND_V_MSG(!E, ERR_INVALID_PARAMETER, "Invalid threaded save task.");
+		ts = E->value;
+		threaded_saves.remove(E);
+	}
+
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(p_task);
+	Error err = ts->error;
+	memdelete(ts);
+	return err;
+}
+
 Error ResourceFormatSaverBinary::set_uid(const String &p_path, ResourceUID::ID p_uid) {
 	String local_path = ProjectSettings::get_singleton()->localize_path(p_path);
 	ResourceFormatSaverBinaryInstance saver;
@@ -33,6 +33,7 @@
 #include "core/io/file_access.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
+#include "core/object/worker_thread_pool.h"
 
 class ResourceLoaderBinary {
 	bool translation_remapped = false;
@@ -155,13 +156,51 @@ class ResourceFormatSaverBinaryInstance {
 
 	struct ResourceData {
 		String type;
+		String path; // "local://<id>" for built-in resources.
 		List<Property> properties;
 	};
 
+	struct ExternalResourceData {
+		String type;
+		String path;
+		ResourceUID::ID uid = ResourceUID::INVALID_ID;
+	};
+
+	// Filled by prepare_save() on the calling thread, so write_prepared()
+	// doesn't need to query the resources being saved.
+	uint32_t save_flags = 0;
+	String save_type;
+	String script_class;
+	ResourceUID::ID save_uid = ResourceUID::INVALID_ID;
+	List<ResourceData> resources;
+	Vector<ExternalResourceData> external_data;
+	HashMap<Ref<Resource>, int> resource_map;
+
 	static void _pad_buffer(Ref<FileAccess> f, int p_bytes);
 	void _find_resources(const Variant &p_variant, bool p_main = false);
 	static void save_unicode_string(Ref<FileAccess> f, const String &p_string, bool p_bit_on_len = false);
 	int get_string_index(const String &p_string);
+	void _gather_resource_refs(const Variant &p_variant);
+
+	uint32_t _hash_variant(const Variant &p_variant, uint32_t p_hash) const;
+	bool _variant_equals(const Variant &p_a, const Variant &p_b) const;
+	bool _resource_data_equals(const ResourceData &p_a, const ResourceData &p_b) const;
+
+public:
+	// How a resource referenced by a property is written, resolved on the calling thread.
+	struct ResourceRef {
+		enum Kind {
+			EMPTY,
+			EXTERNAL,
+			INTERNAL,
+			NOT_CACHED,
+		};
+		Kind kind = EMPTY;
+		int index = 0;
+	};
+
+private:
+	HashMap<ObjectID, ResourceRef> resource_refs;
 
 public:
 	enum {
@@ -174,14 +213,33 @@ public:
 		RESERVED_FIELDS = 11
 	};
 	Error save(const String &p_path, const Ref<Resource> &p_resource, uint32_t p_flags = 0);
+	// Split version of save(): prepare_save() must run on the thread owning the resource,
+	// write_prepared() can run on any thread and may target a different (e.g. temporary) path.
+	Error prepare_save(const String &p_path, const Ref<Resource> &p_resource, uint32_t p_flags = 0, bool p_copy_containers = false);
+	Error write_prepared(const String &p_path);
 	Error set_uid(const String &p_path, ResourceUID::ID p_uid);
-	static void write_variant(Ref<FileAccess> f, const Variant &p_property, HashMap<Ref<Resource>, int> &resource_map, HashMap<Ref<Resource>, int> &external_resources, HashMap<StringName, int> &string_map, const PropertyInfo &p_hint = PropertyInfo());
+	static void write_variant(Ref<FileAccess> f, const Variant &p_property, const HashMap<ObjectID, ResourceRef> &p_resource_refs, HashMap<StringName, int> &string_map, const PropertyInfo &p_hint = PropertyInfo());
 };
 
 class ResourceFormatSaverBinary : public ResourceFormatSaver {
+	struct ThreadedSave {
+		ResourceFormatSaverBinaryInstance saver;
+		String path;
+		Error error = OK;
+	};
+
+	Mutex threaded_save_mutex;
+	HashMap<WorkerThreadPool::TaskID, ThreadedSave *> threaded_saves;
+
+	static void _threaded_save_task(void *p_userdata);
+
 public:
 	static ResourceFormatSaverBinary *singleton;
 	virtual Error save(const Ref<Resource> &p_resource, const String &p_path, uint32_t p_flags = 0) override;
+	// Snapshots the resource on the calling thread and writes it on a worker thread to a temporary
+	// file, which replaces p_path once complete. Every task must be passed to wait_for_threaded_save().
+	WorkerThreadPool::TaskID save_threaded(const Ref<Resource> &p_resource, const String &p_path, uint32_t p_flags = 0);
+	Error wait_for_threaded_save(WorkerThreadPool::TaskID p_task);
 	virtual Error set_uid(const String &p_path, ResourceUID::ID p_uid) override;
 	virtual bool recognize(const Ref<Resource> &p_resource) const override;
 	virtual void get_recognized_extensions(const Ref<Resource> &p_resource, List<String> *p_extensions) const override;
@@ -149,6 +149,9 @@ public:
 
 	virtual Error import(ResourceUID::ID p_source_id, const String &p_source_file, const String &p_save_path, const HashMap<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files = nullptr, Variant *r_metadata = nullptr) = 0;
 	virtual bool can_import_threaded() const { return false; }
+	// Adds the files other than p_source_file that the import result depends on. Returns false if they can't
+	// be known before importing, in which case the result is never taken from the import cache.
+	virtual bool get_import_dependencies(const String &p_source_file, const HashMap<StringName, Variant> &p_options, List<String> *r_dependencies) const { return false; }
 	virtual void import_threaded_begin() {}
 	virtual void import_threaded_end() {}
 
@@ -0,0 +1,318 @@
+/**************************************************************************/
+/*  packed_math.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "packed_math.h"
+
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PACKED_MATH_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+// Double precision vectors are only available on 64-bit ARM.
+#define PACKED_MATH_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// The same operations are written for scalars and for two-lane double vectors,
+// so each kernel is a single generic lambda used by both the vector loop and the scalar tail.
+
+_FORCE_INLINE_ double _add(double p_a, double p_b) {
+	return p_a + p_b;
+}
+_FORCE_INLINE_ double _sub(double p_a, double p_b) {
+	return p_a - p_b;
+}
+_FORCE_INLINE_ double _mul(double p_a, double p_b) {
+	return p_a * p_b;
+}
+// `p_a < p_min ? p_min : p_a`, keeping NaN values of `p_a`.
+_FORCE_INLINE_ double _raise_to(double p_a, double p_min) {
+	return p_a < p_min ? p_min : p_a;
+}
+// `p_a > p_max ? p_max : p_a`, keeping NaN values of `p_a`.
+_FORCE_INLINE_ double _lower_to(double p_a, double p_max) {
+	return p_a > p_max ? p_max : p_a;
+}
+_FORCE_INLINE_ double _splat(double p_value) {
+	return p_value;
+}
+
+#if defined(PACKED_MATH_SIMD_SSE2)
+
+#define PACKED_MATH_SIMD
+typedef __m128d Lanes;
+
+_FORCE_INLINE_ Lanes _add(Lanes p_a, Lanes p_b) {
+	return _mm_add_pd(p_a, p_b);
+}
+_FORCE_INLINE_ Lanes _sub(Lanes p_a, Lanes p_b) {
+	return _mm_sub_pd(p_a, p_b);
+}
+_FORCE_INLINE_ Lanes _mul(Lanes p_a, Lanes p_b) {
+	return _mm_mul_pd(p_a, p_b);
+}
+// `maxpd` returns its second operand when the comparison is false, which keeps NaN values of `p_a`.
+_FORCE_INLINE_ Lanes _raise_to(Lanes p_a, Lanes p_min) {
+	return _mm_max_pd(p_min, p_a);
+}
+_FORCE_INLINE_ Lanes _lower_to(Lanes p_a, Lanes p_max) {
+	return _mm_min_pd(p_max, p_a);
+}
+_FORCE_INLINE_ Lanes _splat_lanes(double p_value) {
+	return _mm_set1_pd(p_value);
+}
+_FORCE_INLINE_ double _sum_lanes(Lanes p_a) {
+	return _mm_cvtsd_f64(_mm_add_sd(p_a, _mm_unpackhi_pd(p_a, p_a)));
+}
+
+_FORCE_INLINE_ void _load(const double *p_src, Lanes &r_lo, Lanes &r_hi) {
+	r_lo = _mm_loadu_pd(p_src);
+	r_hi = _mm_loadu_pd(p_src + 2);
+}
+_FORCE_INLINE_ void _load(const float *p_src, Lanes &r_lo, Lanes &r_hi) {
+	__m128 v = _mm_loadu_ps(p_src);
+	r_lo = _mm_cvtps_pd(v);
+	r_hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+}
+_FORCE_INLINE_ void _store(double *p_dst, Lanes p_lo, Lanes p_hi) {
+	_mm_storeu_pd(p_dst, p_lo);
+	_mm_storeu_pd(p_dst + 2, p_hi);
+}
+_FORCE_INLINE_ void _store(float *p_dst, Lanes p_lo, Lanes p_hi) {
+	_mm_storeu_ps(p_dst, _mm_movelh_ps(_mm_cvtpd_ps(p_lo), _mm_cvtpd_ps(p_hi)));
+}
+
+#elif defined(PACKED_MATH_SIMD_NEON)
+
+#define PACKED_MATH_SIMD
+typedef float64x2_t Lanes;
+
+_FORCE_INLINE_ Lanes _add(Lanes p_a, Lanes p_b) {
+	return vaddq_f64(p_a, p_b);
+}
+_FORCE_INLINE_ Lanes _sub(Lanes p_a, Lanes p_b) {
+	return vsubq_f64(p_a, p_b);
+}
+_FORCE_INLINE_ Lanes _mul(Lanes p_a, Lanes p_b) {
+	return vmulq_f64(p_a, p_b);
+}
+// `vmaxq_f64` propagates NaN from either operand, so select explicitly.
+_FORCE_INLINE_ Lanes _raise_to(Lanes p_a, Lanes p_min) {
+	return vbslq_f64(vcltq_f64(p_a, p_min), p_min, p_a);
+}
+_FORCE_INLINE_ Lanes _lower_to(Lanes p_a, Lanes p_max) {
+	return vbslq_f64(vcgtq_f64(p_a, p_max), p_max, p_a);
+}
+_FORCE_INLINE_ Lanes _splat_lanes(double p_value) {
+	return vdupq_n_f64(p_value);
+}
+_FORCE_INLINE_ double _sum_lanes(Lanes p_a) {
+	return vgetq_lane_f64(p_a, 0) + vgetq_lane_f64(p_a, 1);
+}
+
+_FORCE_INLINE_ void _load(const double *p_src, Lanes &r_lo, Lanes &r_hi) {
+	r_lo = vld1q_f64(p_src);
+	r_hi = vld1q_f64(p_src + 2);
+}
+_FORCE_INLINE_ void _load(const float *p_src, Lanes &r_lo, Lanes &r_hi) {
+	float32x4_t v = vld1q_f32(p_src);
+	r_lo = vcvt_f64_f32(vget_low_f32(v));
+	r_hi = vcvt_high_f64_f32(v);
+}
+_FORCE_INLINE_ void _store(double *p_dst, Lanes p_lo, Lanes p_hi) {
+	vst1q_f64(p_dst, p_lo);
+	vst1q_f64(p_dst + 2, p_hi);
+}
+_FORCE_INLINE_ void _store(float *p_dst, Lanes p_lo, Lanes p_hi) {
+	vst1q_f32(p_dst, vcvt_high_f32_f64(vcvt_f32_f64(p_lo), p_hi));
+}
+
+#endif
+
+// Replaces each element `x` of `p_dst` with `p_op(x, splat)`, where `splat` turns scalar parameters into the matching operand type.
+template <typename T, typename Op>
+void _transform(T *p_dst, int64_t p_count, const Op &p_op) {
+	int64_t i = 0;
+#ifdef PACKED_MATH_SIMD
+	// Four elements per step, as two pairs of doubles.
+	for (; i + 4 <= p_count; i += 4) {
+		Lanes lo, hi;
+		_load(p_dst + i, lo, hi);
+		_store(p_dst + i, p_op(lo, _splat_lanes), p_op(hi, _splat_lanes));
+	}
+#endif
+	for (; i < p_count; i++) {
+		p_dst[i] = (T)p_op((double)p_dst[i], _splat);
+	}
+}
+
+// Replaces each element `x` of `p_dst` with `p_op(x, y, splat)`, where `y` is the matching element of `p_src`.
+template <typename T, typename Op>
+void _transform(T *p_dst, const T *p_src, int64_t p_count, const Op &p_op) {
+	int64_t i = 0;
+#ifdef PACKED_MATH_SIMD
+	for (; i + 4 <= p_count; i += 4) {
+		Lanes lo, hi, src_lo, src_hi;
+		_load(p_dst + i, lo, hi);
+		_load(p_src + i, src_lo, src_hi);
+		_store(p_dst + i, p_op(lo, src_lo, _splat_lanes), p_op(hi, src_hi, _splat_lanes));
+	}
+#endif
+	for (; i < p_count; i++) {
+		p_dst[i] = (T)p_op((double)p_dst[i], (double)p_src[i], _splat);
+	}
+}
+
+template <typename T>
+double _dot(const T *p_a, const T *p_b, int64_t p_count) {
+	double sum = 0.0;
+	int64_t i = 0;
+#ifdef PACKED_MATH_SIMD
+	Lanes sum_lo = _splat_lanes(0.0);
+	Lanes sum_hi = _splat_lanes(0.0);
+	for (; i + 4 <= p_count; i += 4) {
+		Lanes a_lo, a_hi, b_lo, b_hi;
+		_load(p_a + i, a_lo, a_hi);
+		_load(p_b + i, b_lo, b_hi);
+		sum_lo = _add(sum_lo, _mul(a_lo, b_lo));
+		sum_hi = _add(sum_hi, _mul(a_hi, b_hi));
+	}
+	sum = _sum_lanes(_add(sum_lo, sum_hi));
+#endif
+	for (; i < p_count; i++) {
+		sum += (double)p_a[i] * (double)p_b[i];
+	}
+	return sum;
+}
+
+template <typename T>
+void _add_scalar(T *p_dst, int64_t p_count, double p_value) {
+	_transform(p_dst, p_count, [p_value](auto p_x, auto p_splat) { return _add(p_x, p_splat(p_value)); });
+}
+
+template <typename T>
+void _multiply_scalar(T *p_dst, int64_t p_count, double p_value) {
+	_transform(p_dst, p_count, [p_value](auto p_x, auto p_splat) { return _mul(p_x, p_splat(p_value)); });
+}
+
+template <typename T>
+void _multiply_add(T *p_dst, int64_t p_count, double p_scale, double p_offset) {
+	_transform(p_dst, p_count, [p_scale, p_offset](auto p_x, auto p_splat) { return _add(_mul(p_x, p_splat(p_scale)), p_splat(p_offset)); });
+}
+
+template <typename T>
+void _clamp(T *p_dst, int64_t p_count, double p_min, double p_max) {
+	_transform(p_dst, p_count, [p_min, p_max](auto p_x, auto p_splat) { return _lower_to(_raise_to(p_x, p_splat(p_min)), p_splat(p_max)); });
+}
+
+template <typename T>
+void _add(T *p_dst, const T *p_src, int64_t p_count) {
+	_transform(p_dst, p_src, p_count, [](auto p_x, auto p_y, auto) { return _add(p_x, p_y); });
+}
+
+template <typename T>
+void _multiply(T *p_dst, const T *p_src, int64_t p_count) {
+	_transform(p_dst, p_src, p_count, [](auto p_x, auto p_y, auto) { return _mul(p_x, p_y); });
+}
+
+template <typename T>
+void _lerp(T *p_dst, const T *p_to, int64_t p_count, double p_weight) {
+	// Same order of operations as `Math::lerp()`.
+	_transform(p_dst, p_to, p_count, [p_weight](auto p_x, auto p_y, auto p_splat) { return _add(p_x, _mul(_sub(p_y, p_x), p_splat(p_weight))); });
+}
+
+} // namespace
+
+void PackedMath::add_scalar(float *p_dst, int64_t p_count, double p_value) {
+	_add_scalar(p_dst, p_count, p_value);
+}
+
+void PackedMath::add_scalar(double *p_dst, int64_t p_count, double p_value) {
+	_add_scalar(p_dst, p_count, p_value);
+}
+
+void PackedMath::multiply_scalar(float *p_dst, int64_t p_count, double p_value) {
+	_multiply_scalar(p_dst, p_count, p_value);
+}
+
+void PackedMath::multiply_scalar(double *p_dst, int64_t p_count, double p_value) {
+	_multiply_scalar(p_dst, p_count, p_value);
+}
+
+void PackedMath::multiply_add(float *p_dst, int64_t p_count, double p_scale, double p_offset) {
+	_multiply_add(p_dst, p_count, p_scale, p_offset);
+}
+
+void PackedMath::multiply_add(double *p_dst, int64_t p_count, double p_scale, double p_offset) {
+	_multiply_add(p_dst, p_count, p_scale, p_offset);
+}
+
+void PackedMath::clamp(float *p_dst, int64_t p_count, double p_min, double p_max) {
+	_clamp(p_dst, p_count, p_min, p_max);
+}
+
+void PackedMath::clamp(double *p_dst, int64_t p_count, double p_min, double p_max) {
+	_clamp(p_dst, p_count, p_min, p_max);
+}
+
+void PackedMath::add(float *p_dst, const float *p_src, int64_t p_count) {
+	_add(p_dst, p_src, p_count);
+}
+
+void PackedMath::add(double *p_dst, const double *p_src, int64_t p_count) {
+	_add(p_dst, p_src, p_count);
+}
+
+void PackedMath::multiply(float *p_dst, const float *p_src, int64_t p_count) {
+	_multiply(p_dst, p_src, p_count);
+}
+
+void PackedMath::multiply(double *p_dst, const double *p_src, int64_t p_count) {
+	_multiply(p_dst, p_src, p_count);
+}
+
+void PackedMath::lerp(float *p_dst, const float *p_to, int64_t p_count, double p_weight) {
+	_lerp(p_dst, p_to, p_count, p_weight);
+}
+
+void PackedMath::lerp(double *p_dst, const double *p_to, int64_t p_count, double p_weight) {
+	_lerp(p_dst, p_to, p_count, p_weight);
+}
+
+double PackedMath::dot(const float *p_a, const float *p_b, int64_t p_count) {
+	return _dot(p_a, p_b, p_count);
+}
+
+double PackedMath::dot(const double *p_a, const double *p_b, int64_t p_count) {
+	return _dot(p_a, p_b, p_count);
+}
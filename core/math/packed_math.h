@@ -0,0 +1,60 @@
+/**************************************************************************/
+/*  packed_math.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/typedefs.h"
+
+// Element-wise operations on contiguous arrays of floats or doubles, used by the bulk methods of packed arrays.
+// Math is done in double precision, so results on float arrays match applying the same operation
+// to each element through Variant, as scripts would.
+class PackedMath {
+public:
+	static void add_scalar(float *p_dst, int64_t p_count, double p_value);
+	static void add_scalar(double *p_dst, int64_t p_count, double p_value);
+	static void multiply_scalar(float *p_dst, int64_t p_count, double p_value);
+	static void multiply_scalar(double *p_dst, int64_t p_count, double p_value);
+	static void multiply_add(float *p_dst, int64_t p_count, double p_scale, double p_offset);
+	static void multiply_add(double *p_dst, int64_t p_count, double p_scale, double p_offset);
+	// Same semantics as the `clamp()` utility function, including when `p_min` is greater than `p_max`.
+	static void clamp(float *p_dst, int64_t p_count, double p_min, double p_max);
+	static void clamp(double *p_dst, int64_t p_count, double p_min, double p_max);
+
+	static void add(float *p_dst, const float *p_src, int64_t p_count);
+	static void add(double *p_dst, const double *p_src, int64_t p_count);
+	static void multiply(float *p_dst, const float *p_src, int64_t p_count);
+	static void multiply(double *p_dst, const double *p_src, int64_t p_count);
+	static void lerp(float *p_dst, const float *p_to, int64_t p_count, double p_weight);
+	static void lerp(double *p_dst, const double *p_to, int64_t p_count, double p_weight);
+
+	// Summation order differs from a sequential loop, so the result may differ in the last bits.
+	static double dot(const float *p_a, const float *p_b, int64_t p_count);
+	static double dot(const double *p_a, const double *p_b, int64_t p_count);
+};
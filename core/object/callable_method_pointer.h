@@ -74,6 +74,11 @@ public:
 	virtual CompareLessFunc get_compare_less_func() const;
 
 	virtual uint32_t hash() const;
+
+	// True for callables created with callable_mp() and callable_mp_static().
+	static bool is_method_pointer(const CallableCustom *p_custom) {
+		return p_custom->get_compare_equal_func() == compare_equal;
+	}
 };
 
 template <typename T, typename R, typename... P>
@@ -58,6 +58,63 @@
 		mutex.unlock();                           \
 	}
 
+static_assert(sizeof(CallQueue::Page) == CallQueue::PAGE_SIZE_BYTES);
+
+// Reserves room for a message after its link, in the page of whatever lane is free first.
+CallQueue::Link *CallQueue::_alloc_link(uint32_t p_room) {
+	const uint32_t room = sizeof(Link) + p_room;
+
+	uint32_t index = Thread::get_caller_id() % LANE_COUNT;
+	while (lanes[index].busy.load(std::memory_order_relaxed) || lanes[index].busy.exchange(true, std::memory_order_acquire)) {
+		index = (index + 1) % LANE_COUNT;
+	}
+	Lane &lane = lanes[index];
+
+	if (!lane.page || lane.bytes + room > uint32_t(PAGE_SIZE_BYTES)) {
+		if (lane_pages.increment() > max_pages) {
+			lane_pages.decrement();
+			lane.busy.store(false, std::memory_order_release);
+			return nullptr;
+		}
+		max_lane_pages.exchange_if_greater(lane_pages.get());
+
+		Page *page = allocator->alloc();
+		PageHeader *header = memnew_placement(page->data, PageHeader);
+		header->refcount.set(1);
+		if (lane.page) {
+			_unref_page(lane.page);
+		}
+		lane.page = page;
+		lane.bytes = PAGE_HEADER_BYTES;
+	}
+
+	Link *link = memnew_placement(&lane.page->data[lane.bytes], Link);
+	link->page_offset = lane.bytes;
+	((PageHeader *)lane.page->data)->refcount.increment();
+	lane.bytes += room;
+
+	lane.busy.store(false, std::memory_order_release);
+	return link;
+}
+
+void CallQueue::_publish_link(Link *p_link) {
+	Link *prev = tail.exchange(p_link, std::memory_order_acq_rel);
+	prev->next.store(p_link, std::memory_order_release);
+}
+
+void CallQueue::_release_link(Link *p_link) {
+	if (p_link != &stub) {
+		_unref_page((Page *)((uint8_t *)p_link - p_link->page_offset));
+	}
+}
+
+void CallQueue::_unref_page(Page *p_page) {
+	if (((PageHeader *)p_page->data)->refcount.decrement() == 0) {
+		allocator->free(p_page);
+		lane_pages.decrement();
+	}
+}
+
 void CallQueue::_add_page() {
 	if (pages_used == page_bytes.size()) {
 		pages.push_back(allocator->alloc());
@@ -86,25 +143,39 @@ Error CallQueue::push_set(Object *p_object, const StringName &p_prop, const Vari
 Error CallQueue::push_callablep(const Callable &p_callable, const Variant **p_args, int p_argcount, bool p_show_error) {
 	uint32_t room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
 
-	ERR_FAIL_COND_V_MSG(room_needed > uint32_t(PAGE_SIZE_BYTES), ERR_INVALID_PARAMETER, "Message is too large to fit on a page (" + itos(PAGE_SIZE_BYTES) + " bytes), consider passing less arguments.");
+	const uint32_t room_available = multi_producer ? PAGE_SIZE_BYTES - PAGE_HEADER_BYTES - sizeof(Link) : PAGE_SIZE_BYTES;
 
-	LOCK_MUTEX;
+	ERR_FAIL_COND_V_MSG(room_needed > room_available, ERR_INVALID_PARAMETER, "Message is too large to fit on a page (" + itos(room_available) + " bytes), consider passing less arguments.");
 
-	_ensure_first_page();
-
-	if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
-		if (pages_used == max_pages) {
+	Link *link = nullptr;
+	uint8_t *buffer_end = nullptr;
+	if (multi_producer) {
+		link = _alloc_link(room_needed);
+		if (!link) {
 			fprintf(stderr, "Failed method: %s. Message queue out of memory. %s\n", String(p_callable).utf8().get_data(), error_text.utf8().get_data());
 			statistics();
-			UNLOCK_MUTEX;
 			return ERR_OUT_OF_MEMORY;
 		}
-		_add_page();
-	}
+		buffer_end = (uint8_t *)(link + 1);
+	} else {
+		LOCK_MUTEX;
+
+		_ensure_first_page();
+
+		if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
+			if (pages_used == max_pages) {
+				fprintf(stderr, "Failed method: %s. Message queue out of memory. %s\n", String(p_callable).utf8().get_data(), error_text.utf8().get_data());
+				statistics();
+				UNLOCK_MUTEX;
+				return ERR_OUT_OF_MEMORY;
+			}
+			_add_page();
+		}
 
-	Page *page = pages[pages_used - 1];
+		Page *page = pages[pages_used - 1];
 
-	uint8_t *buffer_end = &page->data[page_bytes[pages_used - 1]];
+		buffer_end = &page->data[page_bytes[pages_used - 1]];
+	}
 
 	Message *msg = memnew_placement(buffer_end, Message);
 	msg->args = p_argcount;
@@ -126,36 +197,53 @@ Error CallQueue::push_callablep(const Callable &p_callable, const Variant **p_ar
 		*v = *p_args[i];
 	}
 
-	page_bytes[pages_used - 1] += room_needed;
+	if (link) {
+		_publish_link(link);
+	} else {
+		page_bytes[pages_used - 1] += room_needed;
 
-	UNLOCK_MUTEX;
+		UNLOCK_MUTEX;
+	}
 
 	return OK;
 }
 
 Error CallQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	LOCK_MUTEX;
 	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
 
-	_ensure_first_page();
-
-	if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
-		if (pages_used == max_pages) {
-			String type;
-			if (ObjectDB::get_instance(p_id)) {
-				type = ObjectDB::get_instance(p_id)->get_class();
-			}
-			fprintf(stderr, "Failed set: %s: %s target ID: %s. Message queue out of memory. %s\n", type.utf8().get_data(), String(p_prop).utf8().get_data(), itos(p_id).utf8().get_data(), error_text.utf8().get_data());
+	Link *link = nullptr;
+	uint8_t *buffer_end = nullptr;
+	if (multi_producer) {
+		link = _alloc_link(room_needed);
+		if (!link) {
+			fprintf(stderr, "Failed set: %s target ID: %s. Message queue out of memory. %s\n", String(p_prop).utf8().get_data(), itos(p_id).utf8().get_data(), error_text.utf8().get_data());
 			statistics();
-
-			UNLOCK_MUTEX;
 			return ERR_OUT_OF_MEMORY;
 		}
-		_add_page();
-	}
+		buffer_end = (uint8_t *)(link + 1);
+	} else {
+		LOCK_MUTEX;
+
+		_ensure_first_page();
+
+		if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
+			if (pages_used == max_pages) {
+				String type;
+				if (ObjectDB::get_instance(p_id)) {
+					type = ObjectDB::get_instance(p_id)->get_class();
+				}
+				fprintf(stderr, "Failed set: %s: %s target ID: %s. Message queue out of memory. %s\n", type.utf8().get_data(), String(p_prop).utf8().get_data(), itos(p_id).utf8().get_data(), error_text.utf8().get_data());
+				statistics();
+
+				UNLOCK_MUTEX;
+				return ERR_OUT_OF_MEMORY;
+			}
+			_add_page();
+		}
 
-	Page *page = pages[pages_used - 1];
-	uint8_t *buffer_end = &page->data[page_bytes[pages_used - 1]];
+		Page *page = pages[pages_used - 1];
+		buffer_end = &page->data[page_bytes[pages_used - 1]];
+	}
 
 	Message *msg = memnew_placement(buffer_end, Message);
 	msg->args = 1;
@@ -167,31 +255,48 @@ Error CallQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant
 	Variant *v = memnew_placement(buffer_end, Variant);
 	*v = p_value;
 
-	page_bytes[pages_used - 1] += room_needed;
-	UNLOCK_MUTEX;
+	if (link) {
+		_publish_link(link);
+	} else {
+		page_bytes[pages_used - 1] += room_needed;
+		UNLOCK_MUTEX;
+	}
 
 	return OK;
 }
 
 Error CallQueue::push_notification(ObjectID p_id, int p_notification) {
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
-	LOCK_MUTEX;
 	uint32_t room_needed = sizeof(Message);
 
-	_ensure_first_page();
-
-	if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
-		if (pages_used == max_pages) {
+	Link *link = nullptr;
+	uint8_t *buffer_end = nullptr;
+	if (multi_producer) {
+		link = _alloc_link(room_needed);
+		if (!link) {
 			fprintf(stderr, "Failed notification: %d target ID: %s. Message queue out of memory. %s\n", p_notification, itos(p_id).utf8().get_data(), error_text.utf8().get_data());
 			statistics();
-			UNLOCK_MUTEX;
 			return ERR_OUT_OF_MEMORY;
 		}
-		_add_page();
-	}
+		buffer_end = (uint8_t *)(link + 1);
+	} else {
+		LOCK_MUTEX;
 
-	Page *page = pages[pages_used - 1];
-	uint8_t *buffer_end = &page->data[page_bytes[pages_used - 1]];
+		_ensure_first_page();
+
+		if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
+			if (pages_used == max_pages) {
+				fprintf(stderr, "Failed notification: %d target ID: %s. Message queue out of memory. %s\n", p_notification, itos(p_id).utf8().get_data(), error_text.utf8().get_data());
+				statistics();
+				UNLOCK_MUTEX;
+				return ERR_OUT_OF_MEMORY;
+			}
+			_add_page();
+		}
+
+		Page *page = pages[pages_used - 1];
+		buffer_end = &page->data[page_bytes[pages_used - 1]];
+	}
 
 	Message *msg = memnew_placement(buffer_end, Message);
 
@@ -200,8 +305,12 @@ Error CallQueue::push_notification(ObjectID p_id, int p_notification) {
 	//msg->target;
 	msg->notification = p_notification;
 
-	page_bytes[pages_used - 1] += room_needed;
-	UNLOCK_MUTEX;
+	if (link) {
+		_publish_link(link);
+	} else {
+		page_bytes[pages_used - 1] += room_needed;
+		UNLOCK_MUTEX;
+	}
 
 	return OK;
 }
@@ -223,7 +332,90 @@ void CallQueue::_call_function(const Callable &p_callable, const Variant *p_args
 	}
 }
 
+void CallQueue::_process_message(Message *p_message) {
+	Object *target = p_message->callable.get_object();
+
+	switch (p_message->type & FLAG_MASK) {
+		case TYPE_CALL: {
+			if (target || (p_message->type & FLAG_NULL_IS_OK)) {
+				Variant *args = (Variant *)(p_message + 1);
+				_call_function(p_message->callable, args, p_message->args, p_message->type & FLAG_SHOW_ERROR);
+			}
+		} break;
+		case TYPE_NOTIFICATION: {
+			if (target) {
+				target->notification(p_message->notification);
+			}
+		} break;
+		case TYPE_SET: {
+			if (target) {
+				Variant *arg = (Variant *)(p_message + 1);
+				target->set(p_message->callable.get_method(), *arg);
+			}
+		} break;
+	}
+
+	_destroy_message(p_message);
+}
+
+void CallQueue::_destroy_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int k = 0; k < p_message->args; k++) {
+			args[k].~Variant();
+		}
+	}
+
+	p_message->~Message();
+}
+
+Error CallQueue::_flush_multi_producer() {
+	{
+		MutexLock lock(mutex);
+		if (flushing) {
+			return ERR_BUSY;
+		}
+		flushing = true;
+	}
+
+	while (true) {
+		// Also empty while a producer is between swapping the tail and linking its message.
+		// Nothing is lost then, it's just left for the next flush.
+		Link *next = head->next.load(std::memory_order_acquire);
+		if (!next) {
+			break;
+		}
+
+		_process_message((Message *)(next + 1));
+
+		_release_link(head);
+		head = next;
+	}
+
+	MutexLock lock(mutex);
+	flushing = false;
+	return OK;
+}
+
+void CallQueue::_clear_multi_producer() {
+	while (true) {
+		Link *next = head->next.load(std::memory_order_acquire);
+		if (!next) {
+			break;
+		}
+
+		_destroy_message((Message *)(next + 1));
+
+		_release_link(head);
+		head = next;
+	}
+}
+
 Error CallQueue::flush() {
+	if (multi_producer) {
+		return _flush_multi_producer();
+	}
+
 	LOCK_MUTEX;
 
 	if (pages.size() == 0) {
@@ -257,38 +449,9 @@ Error CallQueue::flush() {
 		//pre-advance so this function is reentrant
 		offset += advance;
 
-		Object *target = message->callable.get_object();
-
 		UNLOCK_MUTEX;
 
-		switch (message->type & FLAG_MASK) {
-			case TYPE_CALL: {
-				if (target || (message->type & FLAG_NULL_IS_OK)) {
-					Variant *args = (Variant *)(message + 1);
-					_call_function(message->callable, args, message->args, message->type & FLAG_SHOW_ERROR);
-				}
-			} break;
-			case TYPE_NOTIFICATION: {
-				if (target) {
-					target->notification(message->notification);
-				}
-			} break;
-			case TYPE_SET: {
-				if (target) {
-					Variant *arg = (Variant *)(message + 1);
-					target->set(message->callable.get_method(), *arg);
-				}
-			} break;
-		}
-
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int k = 0; k < message->args; k++) {
-				args[k].~Variant();
-			}
-		}
-
-		message->~Message();
+		_process_message(message);
 
 		LOCK_MUTEX;
 		if (offset == page_bytes[i]) {
@@ -306,6 +469,11 @@ Error CallQueue::flush() {
 }
 
 void CallQueue::clear() {
+	if (multi_producer) {
+		_clear_multi_producer();
+		return;
+	}
+
 	LOCK_MUTEX;
 
 	if (pages.size() == 0) {
@@ -329,14 +497,7 @@ void CallQueue::clear() {
 
 			offset += advance;
 
-			if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-				Variant *args = (Variant *)(message + 1);
-				for (int k = 0; k < message->args; k++) {
-					args[k].~Variant();
-				}
-			}
-
-			message->~Message();
+			_destroy_message(message);
 		}
 	}
 
@@ -347,83 +508,116 @@ void CallQueue::clear() {
 }
 
 void CallQueue::statistics() {
-	LOCK_MUTEX;
 	HashMap<StringName, int> set_count;
 	HashMap<int, int> notify_count;
 	HashMap<Callable, int> call_count;
 	int null_count = 0;
 
-	for (uint32_t i = 0; i < pages_used; i++) {
-		uint32_t offset = 0;
-		while (offset < page_bytes[i]) {
-			Page *page = pages[i];
+	auto count_message = [&](const Message *p_message) {
+		Object *target = p_message->callable.get_object();
 
-			//lock on each iteration, so a call can re-add itself to the message queue
+		bool null_target = true;
+		switch (p_message->type & FLAG_MASK) {
+			case TYPE_CALL: {
+				if (target || (p_message->type & FLAG_NULL_IS_OK)) {
+					if (!call_count.has(p_message->callable)) {
+						call_count[p_message->callable] = 0;
+					}
 
-			Message *message = (Message *)&page->data[offset];
+					call_count[p_message->callable]++;
+					null_target = false;
+				}
+			} break;
+			case TYPE_NOTIFICATION: {
+				if (target) {
+					if (!notify_count.has(p_message->notification)) {
+						notify_count[p_message->notification] = 0;
+					}
 
-			uint32_t advance = sizeof(Message);
-			if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-				advance += sizeof(Variant) * message->args;
+					notify_count[p_message->notification]++;
+					null_target = false;
+				}
+			} break;
+			case TYPE_SET: {
+				if (target) {
+					StringName t = p_message->callable.get_method();
+					if (!set_count.has(t)) {
+						set_count[t] = 0;
+					}
+
+					set_count[t]++;
+					null_target = false;
+				}
+			} break;
+		}
+		if (null_target) {
+			// Object was deleted.
+			fprintf(stdout, "Object was deleted while awaiting a callback.\n");
+
+			null_count++;
+		}
+	};
+
+	uint32_t total_pages = 0;
+
+	if (multi_producer) {
+		// Only the flushing thread may walk the messages, as it frees them. Take its place while counting;
+		// producers keep appending meanwhile, which is safe. If a flush is running (this may even be
+		// called from a message it processes), only the page count can be reported.
+		{
+			MutexLock lock(mutex);
+			if (flushing) {
+				fprintf(stdout, "TOTAL PAGES: %d (%d bytes).\n", lane_pages.get(), lane_pages.get() * PAGE_SIZE_BYTES);
+				fprintf(stdout, "Messages are being flushed, they can't be counted.\n");
+				return;
 			}
+			flushing = true;
+		}
 
-			Object *target = message->callable.get_object();
+		for (Link *link = head->next.load(std::memory_order_acquire); link; link = link->next.load(std::memory_order_acquire)) {
+			count_message((const Message *)(link + 1));
+		}
+		total_pages = lane_pages.get();
 
-			bool null_target = true;
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					if (target || (message->type & FLAG_NULL_IS_OK)) {
-						if (!call_count.has(message->callable)) {
-							call_count[message->callable] = 0;
-						}
+		MutexLock lock(mutex);
+		flushing = false;
+	} else {
+		LOCK_MUTEX;
 
-						call_count[message->callable]++;
-						null_target = false;
-					}
-				} break;
-				case TYPE_NOTIFICATION: {
-					if (target) {
-						if (!notify_count.has(message->notification)) {
-							notify_count[message->notification] = 0;
-						}
-
-						notify_count[message->notification]++;
-						null_target = false;
-					}
-				} break;
-				case TYPE_SET: {
-					if (target) {
-						StringName t = message->callable.get_method();
-						if (!set_count.has(t)) {
-							set_count[t] = 0;
-						}
-
-						set_count[t]++;
-						null_target = false;
-					}
-				} break;
-			}
-			if (null_target) {
-				// Object was deleted.
-				fprintf(stdout, "Object was deleted while awaiting a callback.\n");
+		for (uint32_t i = 0; i < pages_used; i++) {
+			uint32_t offset = 0;
+			while (offset < page_bytes[i]) {
+				Page *page = pages[i];
 
-				null_count++;
-			}
+				//lock on each iteration, so a call can re-add itself to the message queue
 
-			offset += advance;
+				Message *message = (Message *)&page->data[offset];
 
-			if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-				Variant *args = (Variant *)(message + 1);
-				for (int k = 0; k < message->args; k++) {
-					args[k].~Variant();
+				uint32_t advance = sizeof(Message);
+				if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+					advance += sizeof(Variant) * message->args;
 				}
-			}
 
-			message->~Message();
+				count_message(message);
+
+				offset += advance;
+
+				if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+					Variant *args = (Variant *)(message + 1);
+					for (int k = 0; k < message->args; k++) {
+						args[k].~Variant();
+					}
+				}
+
+				message->~Message();
+			}
 		}
+		total_pages = pages_used;
+
+		UNLOCK_MUTEX;
 	}
 
-	fprintf(stdout, "TOTAL PAGES: %d (%d bytes).\n", pages_used, pages_used * PAGE_SIZE_BYTES);
+	fprintf(stdout, "TOTAL PAGES: %d (%d bytes).\n", total_pages, total_pages * PAGE_SIZE_BYTES);
 	fprintf(stdout, "NULL count: %d.\n", null_count);
 
 	for (const KeyValue<StringName, int> &E : set_count) {
@@ -437,8 +631,6 @@ void CallQueue::statistics() {
 	for (const KeyValue<int, int> &E : notify_count) {
 		fprintf(stdout, "NOTIFY %d: %d.\n", E.key, E.value);
 	}
-
-	UNLOCK_MUTEX;
 }
 
 bool CallQueue::is_flushing() const {
@@ -446,6 +638,10 @@ bool CallQueue::is_flushing() const {
 }
 
 bool CallQueue::has_messages() const {
+	if (multi_producer) {
+		return head->next.load(std::memory_order_acquire) != nullptr;
+	}
+
 	if (pages_used == 0) {
 		return false;
 	}
@@ -457,10 +653,14 @@ bool CallQueue::has_messages() const {
 }
 
 int CallQueue::get_max_buffer_usage() const {
+	if (multi_producer) {
+		return max_lane_pages.get() * PAGE_SIZE_BYTES;
+	}
+
 	return pages.size() * PAGE_SIZE_BYTES;
 }
 
-CallQueue::CallQueue(Allocator *p_custom_allocator, uint32_t p_max_pages, const String &p_error_text) {
+CallQueue::CallQueue(Allocator *p_custom_allocator, uint32_t p_max_pages, const String &p_error_text, bool p_multi_producer) {
 	if (p_custom_allocator) {
 		allocator = p_custom_allocator;
 		allocator_is_custom = true;
@@ -470,6 +670,10 @@ CallQueue::CallQueue(Allocator *p_custom_allocator, uint32_t p_max_pages, const
 	}
 	max_pages = p_max_pages;
 	error_text = p_error_text;
+	multi_producer = p_multi_producer;
+	if (multi_producer) {
+		lanes = memnew_arr(Lane, LANE_COUNT);
+	}
 }
 
 CallQueue::~CallQueue() {
@@ -478,6 +682,15 @@ CallQueue::~CallQueue() {
 	for (uint32_t i = 0; i < pages.size(); i++) {
 		allocator->free(pages[i]);
 	}
+	if (multi_producer) {
+		_release_link(head);
+		for (uint32_t i = 0; i < LANE_COUNT; i++) {
+			if (lanes[i].page) {
+				_unref_page(lanes[i].page);
+			}
+		}
+		memdelete_arr(lanes);
+	}
 	if (!allocator_is_custom) {
 		memdelete(allocator);
 	}
@@ -506,7 +719,8 @@ void MessageQueue::set_thread_singleton_override(CallQueue *p_thread_singleton)
 MessageQueue::MessageQueue() :
 		CallQueue(nullptr,
 				int(GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_mb", PROPERTY_HINT_RANGE, "1,512,1,or_greater"), 32)) * 1024 * 1024 / PAGE_SIZE_BYTES,
-				"Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_mb' in project settings.") {
+				"Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_mb' in project settings.",
+				true) {
 	ERR_FAIL_COND_MSG(main_singleton != nullptr, "A MessageQueue singleton already exists.");
 	main_singleton = this;
 }
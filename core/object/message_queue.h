@@ -31,6 +31,7 @@
 #pragma once
 
 #include "core/object/object_id.h"
+#include "core/os/thread.h"
 #include "core/os/thread_safe.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/paged_allocator.h"
@@ -42,9 +43,7 @@ class CallQueue {
 	friend class MessageQueue;
 
 public:
-	enum {
-		PAGE_SIZE_BYTES = 4096
-	};
+	static constexpr uint32_t PAGE_SIZE_BYTES = 4096;
 
 	struct Page {
 		uint8_t data[PAGE_SIZE_BYTES];
@@ -89,6 +88,44 @@ private:
 		};
 	};
 
+	// Multi-producer mode, where pushing never takes the mutex.
+	// Producers claim one of the lanes for as long as it takes to reserve room in its page, so threads
+	// get pages of their own and only contend on the tail of the message list, where each message is
+	// linked in push order. Only one thread may flush.
+	static constexpr uint32_t LANE_COUNT = 16;
+
+	struct Link {
+		std::atomic<Link *> next = nullptr;
+		uint32_t page_offset = 0;
+	};
+
+	struct PageHeader {
+		SafeNumeric<uint32_t> refcount; // Messages not consumed yet, plus one while the lane still writes to the page.
+	};
+	static constexpr uint32_t PAGE_HEADER_BYTES = 8;
+
+	struct Lane {
+		std::atomic_bool busy = false;
+		uint32_t bytes = 0;
+		Page *page = nullptr;
+		uint8_t padding[MAX(Thread::CACHE_LINE_BYTES, 2 * sizeof(Page *)) - 2 * sizeof(Page *)];
+	};
+
+	bool multi_producer = false;
+	Lane *lanes = nullptr;
+	Link stub;
+	Link *head = &stub; // Last message consumed, kept until the next one is.
+	std::atomic<Link *> tail = &stub;
+	SafeNumeric<uint32_t> lane_pages;
+	SafeNumeric<uint32_t> max_lane_pages;
+
+	Link *_alloc_link(uint32_t p_room);
+	void _publish_link(Link *p_link);
+	void _release_link(Link *p_link);
+	void _unref_page(Page *p_page);
+	Error _flush_multi_producer();
+	void _clear_multi_producer();
+
 	_FORCE_INLINE_ void _ensure_first_page() {
 		if (unlikely(pages.is_empty())) {
 			pages.push_back(allocator->alloc());
@@ -100,6 +137,8 @@ private:
 	void _add_page();
 
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
+	void _process_message(Message *p_message);
+	static void _destroy_message(Message *p_message);
 
 	String error_text;
 
@@ -152,7 +191,7 @@ public:
 	bool is_flushing() const;
 	int get_max_buffer_usage() const;
 
-	CallQueue(Allocator *p_custom_allocator = nullptr, uint32_t p_max_pages = 8192, const String &p_error_text = String());
+	CallQueue(Allocator *p_custom_allocator = nullptr, uint32_t p_max_pages = 8192, const String &p_error_text = String(), bool p_multi_producer = false);
 	virtual ~CallQueue();
 };
 
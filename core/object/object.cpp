@@ -32,6 +32,7 @@
 
 #include "core/extension/gdextension_manager.h"
 #include "core/io/resource.h"
+#include "core/object/callable_method_pointer.h"
 #include "core/object/class_db.h"
 #include "core/object/message_queue.h"
 #include "core/object/script_language.h"
@@ -1188,35 +1189,34 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		return ERR_UNAVAILABLE;
 	}
 
+	if (s->slot_map.is_empty()) {
+		return OK;
+	}
+
 	// If this is a ref-counted object, prevent it from being destroyed during signal emission,
 	// which is needed in certain edge cases; e.g., https://github.com/godotengine/godot/issues/73889.
 	Ref<RefCounted> rc = Ref<RefCounted>(Object::cast_to<RefCounted>(this));
 
 	// Ensure that disconnecting the signal or even deleting the object
 	// will not affect the signal calling.
-	Callable *slot_callables = (Callable *)alloca(sizeof(Callable) * s->slot_map.size());
-	uint32_t *slot_flags = (uint32_t *)alloca(sizeof(uint32_t) * s->slot_map.size());
-	uint32_t slot_count = 0;
-
-	for (const KeyValue<Callable, SignalData::Slot> &slot_kv : s->slot_map) {
-		memnew_placement(&slot_callables[slot_count], Callable(slot_kv.value.conn.callable));
-		slot_flags[slot_count] = slot_kv.value.conn.flags;
-		++slot_count;
-	}
-
-	DEV_ASSERT(slot_count == s->slot_map.size());
-
-	// Disconnect all one-shot connections before emitting to prevent recursion.
-	for (uint32_t i = 0; i < slot_count; ++i) {
-		bool disconnect = slot_flags[i] & CONNECT_ONE_SHOT;
+	SignalData::SlotCache *cache = s->slot_cache;
+	cache->refcount.ref();
+	const SignalData::SlotCache::CachedSlot *slots = cache->slots.ptr();
+	const uint32_t slot_count = cache->slots.size();
+
+	if (cache->has_one_shot) {
+		// Disconnect all one-shot connections before emitting to prevent recursion.
+		for (uint32_t i = 0; i < slot_count; ++i) {
+			bool disconnect = slots[i].flags & CONNECT_ONE_SHOT;
 #ifdef TOOLS_ENABLED
-		if (disconnect && (slot_flags[i] & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
-			// This signal was connected from the editor, and is being edited. Just don't disconnect for now.
-			disconnect = false;
-		}
+			if (disconnect && (slots[i].flags & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
+				// This signal was connected from the editor, and is being edited. Just don't disconnect for now.
+				disconnect = false;
+			}
 #endif
-		if (disconnect) {
-			_disconnect(p_name, slot_callables[i]);
+			if (disconnect) {
+				_disconnect(p_name, slots[i].callable);
+			}
 		}
 	}
 
@@ -1225,10 +1225,11 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 	Error err = OK;
 
 	for (uint32_t i = 0; i < slot_count; ++i) {
-		const Callable &callable = slot_callables[i];
-		const uint32_t &flags = slot_flags[i];
+		const Callable &callable = slots[i].callable;
+		const uint32_t &flags = slots[i].flags;
+		const CallableCustom *method_pointer = slots[i].method_pointer;
 
-		if (!callable.is_valid()) {
+		if (method_pointer ? !ObjectDB::get_instance(slots[i].target) : !callable.is_valid()) {
 			// Target might have been deleted during signal callback, this is expected and OK.
 			continue;
 		}
@@ -1242,7 +1243,12 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 			Callable::CallError ce;
 			_emitting = true;
 			Variant ret;
-			callable.callp(args, argc, ret, ce);
+			if (method_pointer) {
+				// Already validated, skip the checks done by Callable::callp().
+				method_pointer->call(args, argc, ret, ce);
+			} else {
+				callable.callp(args, argc, ret, ce);
+			}
 			_emitting = false;
 
 			if (ce.error != Callable::CallError::CALL_OK) {
@@ -1262,13 +1268,64 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		}
 	}
 
-	for (uint32_t i = 0; i < slot_count; ++i) {
-		slot_callables[i].~Callable();
-	}
+	SignalData::release_slot_cache(cache);
 
 	return err;
 }
 
+void Object::SignalData::update_slot_cache() {
+	invalidate_slot_cache();
+	if (slot_map.is_empty()) {
+		return;
+	}
+
+	slot_cache = memnew(SlotCache);
+	slot_cache->refcount.init();
+	slot_cache->slots.resize(slot_map.size());
+
+	uint32_t slot_count = 0;
+	for (const KeyValue<Callable, Slot> &slot_kv : slot_map) {
+		SlotCache::CachedSlot &cached = slot_cache->slots[slot_count++];
+		cached.callable = slot_kv.value.conn.callable;
+		cached.flags = slot_kv.value.conn.flags;
+		slot_cache->has_one_shot = slot_cache->has_one_shot || (cached.flags & CONNECT_ONE_SHOT);
+
+		// Resolve the target once here instead of on every call. Objects are
+		// never reused under the same ID, so checking it is enough later on.
+		if (cached.callable.is_custom() && CallableCustomMethodPointerBase::is_method_pointer(cached.callable.get_custom())) {
+			cached.target = cached.callable.get_custom()->get_object();
+			if (cached.target.is_valid()) {
+				cached.method_pointer = cached.callable.get_custom();
+			}
+		}
+	}
+
+	DEV_ASSERT(slot_count == slot_map.size());
+}
+
+void Object::SignalData::invalidate_slot_cache() {
+	if (slot_cache) {
+		release_slot_cache(slot_cache);
+		slot_cache = nullptr;
+	}
+}
+
+void Object::SignalData::release_slot_cache(SlotCache *p_cache) {
+	if (p_cache->refcount.unref()) {
+		memdelete(p_cache);
+	}
+}
+
+void Object::SignalData::operator=(const SignalData &p_other) {
+	if (this == &p_other) {
+		return;
+	}
+	user = p_other.user;
+	slot_map = p_other.slot_map;
+	removable = p_other.removable;
+	update_slot_cache();
+}
+
 void Object::_add_user_signal(const String &p_name, const Array &p_args) {
 	// this version of add_user_signal is meant to be used from scripts or external apis
 	// without access to ADD_SIGNAL in bind_methods
@@ -1479,6 +1536,7 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, ui
 
 	//use callable version as key, so binds can be ignored
 	s->slot_map[*p_callable.get_base_comparator()] = slot;
+	s->update_slot_cache();
 
 	return OK;
 }
@@ -1554,6 +1612,7 @@ bool Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 	}
 
 	s->slot_map.erase(*p_callable.get_base_comparator());
+	s->update_slot_cache();
 
 	if (s->slot_map.is_empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
 		//not user signal, delete
@@ -38,6 +38,7 @@
 #include "core/templates/hash_map.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/rb_map.h"
 #include "core/templates/safe_refcount.h"
 #include "core/variant/callable_bind.h"
@@ -606,9 +607,39 @@ private:
 			List<Connection>::Element *cE = nullptr;
 		};
 
+		// Flat copy of the slots, rebuilt whenever the connections change.
+		// Emissions only read it, so several threads can emit the signal at
+		// once. They keep a reference to it, so connecting or disconnecting
+		// from a callback does not affect them.
+		struct SlotCache {
+			struct CachedSlot {
+				Callable callable;
+				// Set for callable_mp() slots, which are called directly after
+				// checking that the target object is still alive.
+				const CallableCustom *method_pointer = nullptr;
+				ObjectID target;
+				uint32_t flags = 0;
+			};
+
+			SafeRefCount refcount;
+			LocalVector<CachedSlot> slots;
+			bool has_one_shot = false;
+		};
+
 		MethodInfo user;
 		HashMap<Callable, Slot, HashableHasher<Callable>> slot_map;
+		SlotCache *slot_cache = nullptr;
 		bool removable = false;
+
+		void update_slot_cache();
+		void invalidate_slot_cache();
+		static void release_slot_cache(SlotCache *p_cache);
+
+		SignalData() {}
+		SignalData(const SignalData &p_other) :
+				user(p_other.user), slot_map(p_other.slot_map), removable(p_other.removable) { update_slot_cache(); }
+		void operator=(const SignalData &p_other);
+		~SignalData() { invalidate_slot_cache(); }
 	};
 
 	HashMap<StringName, SignalData> signal_map;
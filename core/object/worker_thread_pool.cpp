@@ -38,13 +38,8 @@
 WorkerThreadPool::Task *const WorkerThreadPool::ThreadData::YIELDING = (Task *)1;
 
 HashMap<StringName, WorkerThreadPool *> WorkerThreadPool::named_pools;
-
-void WorkerThreadPool::Task::free_template_userdata() {
-	ERR_FAIL_NULL(template_userdata);
-	ERR_FAIL_NULL(native_func_userdata);
-	BaseTemplateUserdata *btu = (BaseTemplateUserdata *)native_func_userdata;
-	memdelete(btu);
-}
+HashMap<StringName, WorkerThreadPool::PoolSettings> WorkerThreadPool::named_pool_settings;
+void (*WorkerThreadPool::named_pool_created_callback)(const StringName &p_name) = nullptr;
 
 WorkerThreadPool *WorkerThreadPool::singleton = nullptr;
 
@@ -52,7 +47,121 @@ WorkerThreadPool *WorkerThreadPool::singleton = nullptr;
 thread_local WorkerThreadPool::UnlockableLocks WorkerThreadPool::unlockable_locks[MAX_UNLOCKABLE_LOCKS];
 #endif
 
-void WorkerThreadPool::_process_task(Task *p_task) {
+static _FORCE_INLINE_ uint64_t _pack_group_range(uint32_t p_begin, uint32_t p_end) {
+	return uint64_t(p_begin) | (uint64_t(p_end) << 32);
+}
+
+// Returns whether this call processed the last elements of the group.
+bool WorkerThreadPool::_process_group_elements(Group *p_group, uint32_t p_range) {
+	std::atomic<uint64_t> &own_bounds = p_group->ranges[p_range].bounds;
+	const uint32_t range_count = p_group->ranges.size();
+	bool completed = false;
+
+	while (true) {
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		uint64_t bounds = own_bounds.load(std::memory_order_acquire);
+		while (true) {
+			begin = bounds & 0xFFFFFFFF;
+			end = bounds >> 32;
+			if (begin >= end) {
+				break;
+			}
+			// Batches shrink along with the range, so what's left at the end can still be stolen.
+			const uint32_t batch = MAX(1u, (end - begin) / 8);
+			if (own_bounds.compare_exchange_weak(bounds, _pack_group_range(begin + batch, end), std::memory_order_acq_rel, std::memory_order_acquire)) {
+				end = begin + batch;
+				break;
+			}
+		}
+
+		if (begin >= end) {
+			// Out of work, so take the back half of some other range.
+			// Only the owner refills its range, and only once it's empty, so nobody else can be changing it now.
+			bool stolen = false;
+			for (uint32_t i = 1; i < range_count && !stolen; i++) {
+				std::atomic<uint64_t> &victim_bounds = p_group->ranges[(p_range + i) % range_count].bounds;
+				uint64_t victim = victim_bounds.load(std::memory_order_acquire);
+				while (true) {
+					const uint32_t victim_begin = victim & 0xFFFFFFFF;
+					const uint32_t victim_end = victim >> 32;
+					if (victim_begin >= victim_end) {
+						break;
+					}
+					const uint32_t middle = victim_begin + (victim_end - victim_begin) / 2;
+					if (victim_bounds.compare_exchange_weak(victim, _pack_group_range(victim_begin, middle), std::memory_order_acq_rel, std::memory_order_acquire)) {
+						own_bounds.store(_pack_group_range(middle, victim_end), std::memory_order_release);
+						group_steals.increment();
+						stolen = true;
+						break;
+					}
+				}
+			}
+			if (!stolen) {
+				break;
+			}
+			continue;
+		}
+
+		for (uint32_t i = begin; i < end; i++) {
+			if (p_group->native_func) {
+				p_group->native_func(p_group->native_func_userdata, i);
+			} else if (p_group->template_userdata) {
+				p_group->template_userdata->callback_indexed(i);
+			} else {
+				p_group->callable.call(i);
+			}
+		}
+
+		// This is the only way to ensure posting is done when all tasks are really complete.
+		if (p_group->completed_index.add(end - begin) == p_group->max) {
+			completed = true;
+		}
+	}
+
+	return completed;
+}
+
+void WorkerThreadPool::_complete_group(Group *p_group) {
+	if (p_group->template_userdata) {
+		memdelete(p_group->template_userdata); // This is no longer needed at this point, so get rid of it.
+		p_group->template_userdata = nullptr;
+	}
+
+	{
+		MutexLock task_lock(task_mutex);
+		p_group->completed.set_to(true);
+		if (!p_group->dependents.is_empty()) {
+			_release_dependents(p_group->dependents);
+		}
+	}
+	p_group->done_semaphore.post();
+}
+
+// Must be called with the mutex locked.
+void WorkerThreadPool::_release_dependents(LocalVector<Task *> &p_dependents) {
+	LocalVector<Task *> dependents = std::move(p_dependents);
+	for (Task *dependent : dependents) {
+		DEV_ASSERT(dependent->pending_dependencies > 0);
+		dependent->pending_dependencies--;
+		if (dependent->pending_dependencies > 0) {
+			continue;
+		}
+		if (threads.size() == 0) {
+			task_mutex.unlock();
+			_process_task(dependent);
+			task_mutex.lock();
+		} else {
+			_enqueue_tasks(&dependent, 1, dependent->priority);
+		}
+	}
+}
+
+void WorkerThreadPool::_process_task(Task *p_task, Task **r_next_task) {
+	if (r_next_task) {
+		*r_next_task = nullptr;
+	}
+
 #ifdef THREADS_ENABLED
 	int pool_thread_index = thread_ids[Thread::get_caller_id()];
 	ThreadData &curr_thread = threads[pool_thread_index];
@@ -84,50 +193,30 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 #endif
 
 #ifdef THREADS_ENABLED
-	bool low_priority = p_task->low_priority;
+	bool low_priority = p_task->priority == TASK_PRIORITY_LOW;
 #endif
 
+	const bool measure_time = settings.measure_task_times;
+	const uint64_t run_begin = measure_time ? OS::get_singleton()->get_ticks_usec() : 0;
+	uint64_t run_usec = 0;
+
 	if (p_task->group) {
 		// Handling a group
-		bool do_post = false;
-
-		while (true) {
-			uint32_t work_index = p_task->group->index.postincrement();
-
-			if (work_index >= p_task->group->max) {
-				break;
-			}
-			if (p_task->native_group_func) {
-				p_task->native_group_func(p_task->native_func_userdata, work_index);
-			} else if (p_task->template_userdata) {
-				p_task->template_userdata->callback_indexed(work_index);
-			} else {
-				p_task->callable.call(work_index);
-			}
-
-			// This is the only way to ensure posting is done when all tasks are really complete.
-			uint32_t completed_amount = p_task->group->completed_index.increment();
-
-			if (completed_amount == p_task->group->max) {
-				do_post = true;
-			}
+		Group *group = p_task->group;
+		if (_process_group_elements(group, p_task->group_range)) {
+			_complete_group(group);
 		}
-
-		if (do_post && p_task->template_userdata) {
-			memdelete(p_task->template_userdata); // This is no longer needed at this point, so get rid of it.
+		if (measure_time) {
+			run_usec = OS::get_singleton()->get_ticks_usec() - run_begin;
 		}
 
-		if (do_post) {
-			p_task->group->done_semaphore.post();
-			p_task->group->completed.set_to(true);
-		}
-		uint32_t max_users = p_task->group->tasks_used + 1; // Add 1 because the thread waiting for it is also user. Read before to avoid another thread freeing task after increment.
-		uint32_t finished_users = p_task->group->finished.increment();
+		uint32_t max_users = group->tasks_used + 1; // Add 1 because the thread waiting for it is also user. Read before to avoid another thread freeing task after increment.
+		uint32_t finished_users = group->finished.increment();
 
 		if (finished_users == max_users) {
 			// Get rid of the group, because nobody else is using it.
 			MutexLock task_lock(task_mutex);
-			group_allocator.free(p_task->group);
+			group_allocator.free(group);
 		}
 
 		// For groups, tasks get rid of themselves.
@@ -143,6 +232,9 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		} else {
 			p_task->callable.call();
 		}
+		if (measure_time) {
+			run_usec = OS::get_singleton()->get_ticks_usec() - run_begin;
+		}
 
 		task_mutex.lock();
 		p_task->completed = true;
@@ -157,8 +249,13 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 				threads[i].signaled = true;
 			}
 		}
+		if (!p_task->dependents.is_empty()) {
+			_release_dependents(p_task->dependents);
+		}
 	}
 
+	_record_task_run(measure_time, run_usec);
+
 #ifdef THREADS_ENABLED
 	{
 		curr_thread.current_task = prev_task;
@@ -172,6 +269,12 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 			}
 		}
 
+		if (r_next_task && !prev_task && runlevel == RUNLEVEL_NORMAL) {
+			// Pick the next task while the mutex is still held, instead of locking it again from the thread loop.
+			curr_thread.signaled = false;
+			*r_next_task = _pop_task(&curr_thread);
+		}
+
 		task_mutex.unlock();
 	}
 
@@ -183,6 +286,19 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 void WorkerThreadPool::_thread_function(void *p_user) {
 	ThreadData *thread_data = (ThreadData *)p_user;
 
+	const Vector<int> &cpus = thread_data->pool->settings.cpu_affinity;
+	if (!cpus.is_empty()) {
+		Error err = thread_data->pool->settings.pin_threads ? Thread::set_affinity({ cpus[thread_data->index % cpus.size()] }) : Thread::set_affinity(cpus);
+		if (err != OK) {
+			print_verbose(vformat("WorkerThreadPool: Couldn't set the CPU affinity of thread %d.", thread_data->index));
+		}
+	}
+	if (thread_data->pool->settings.thread_priority != Thread::PRIORITY_NORMAL) {
+		if (Thread::set_current_priority(thread_data->pool->settings.thread_priority) != OK) {
+			print_verbose(vformat("WorkerThreadPool: Couldn't set the priority of thread %d.", thread_data->index));
+		}
+	}
+
 	while (true) {
 		Task *task_to_process = nullptr;
 		{
@@ -195,21 +311,98 @@ void WorkerThreadPool::_thread_function(void *p_user) {
 
 			thread_data->signaled = false;
 
-			if (thread_data->pool->task_queue.first()) {
-				task_to_process = thread_data->pool->task_queue.first()->self();
-				thread_data->pool->task_queue.remove(thread_data->pool->task_queue.first());
-			} else {
+			thread_data->pool->sleeping_threads++;
+			task_to_process = thread_data->pool->_pop_task(thread_data);
+			if (!task_to_process) {
 				thread_data->cond_var.wait(lock);
 			}
+			thread_data->pool->sleeping_threads--;
 		}
 
-		if (task_to_process) {
-			thread_data->pool->_process_task(task_to_process);
+		while (task_to_process) {
+			thread_data->pool->_process_task(task_to_process, &task_to_process);
+		}
+	}
+}
+
+static _FORCE_INLINE_ uint32_t _telemetry_bucket(uint64_t p_usec) {
+	return MIN(nearest_shift(MIN(p_usec, uint64_t(UINT32_MAX))), uint32_t(WorkerThreadPool::Telemetry::HISTOGRAM_BUCKETS - 1));
+}
+
+// Must be called with the mutex locked.
+WorkerThreadPool::Task *WorkerThreadPool::_pop_task(ThreadData *p_thread_data) {
+	bool stolen = false;
+	Task *task = _take_queued_task(p_thread_data, stolen);
+	if (task) {
+		telemetry.queued_tasks--;
+		if (stolen) {
+			telemetry.steals++;
 		}
+		if (settings.measure_task_times) {
+			const uint64_t wait_usec = OS::get_singleton()->get_ticks_usec() - task->queued_usec;
+			telemetry.average_wait_usec += (wait_usec - telemetry.average_wait_usec) / 64.0;
+			telemetry.wait_usec_histogram[_telemetry_bucket(wait_usec)]++;
+		}
+	}
+	return task;
+}
+
+// Must be called with the mutex locked.
+void WorkerThreadPool::_record_task_run(bool p_measured, uint64_t p_run_usec) {
+	telemetry.processed_tasks++;
+	if (p_measured) {
+		telemetry.average_run_usec += (p_run_usec - telemetry.average_run_usec) / 64.0;
+		telemetry.run_usec_histogram[_telemetry_bucket(p_run_usec)]++;
 	}
 }
 
-void WorkerThreadPool::_post_tasks(Task **p_tasks, uint32_t p_count, bool p_high_priority, MutexLock<BinaryMutex> &p_lock) {
+// Must be called with the mutex locked.
+WorkerThreadPool::Task *WorkerThreadPool::_take_queued_task(ThreadData *p_thread_data, bool &r_stolen) {
+	SelfList<Task> *elem = critical_task_queue.first();
+	if (elem) {
+		critical_task_queue.remove(elem);
+		return elem->self();
+	}
+
+	if (local_queued_tasks) {
+		MutexLock local_lock(p_thread_data->local_queue_mutex);
+		elem = p_thread_data->local_queue.last();
+		if (elem) {
+			p_thread_data->local_queue.remove(elem);
+			local_queued_tasks--;
+			return elem->self();
+		}
+	}
+
+	elem = task_queue.first();
+	if (elem) {
+		task_queue.remove(elem);
+		return elem->self();
+	}
+
+	if (local_queued_tasks) {
+		// Steal from the oldest end, where tasks are the least likely to be hot in the caches of their thread.
+		for (uint32_t i = 1; i < threads.size(); i++) {
+			ThreadData &victim = threads[(p_thread_data->index + i) % threads.size()];
+			MutexLock local_lock(victim.local_queue_mutex);
+			elem = victim.local_queue.first();
+			if (elem) {
+				victim.local_queue.remove(elem);
+				local_queued_tasks--;
+				r_stolen = true;
+				return elem->self();
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+bool WorkerThreadPool::_has_queued_tasks() const {
+	return critical_task_queue.first() || task_queue.first() || local_queued_tasks;
+}
+
+void WorkerThreadPool::_post_tasks(Task **p_tasks, uint32_t p_count, TaskPriority p_priority, MutexLock<BinaryMutex> &p_lock) {
 	// Fall back to processing on the calling thread if there are no worker threads.
 	// Separated into its own variable to make it easier to extend this logic
 	// in custom builds.
@@ -227,29 +420,62 @@ void WorkerThreadPool::_post_tasks(Task **p_tasks, uint32_t p_count, bool p_high
 		control_cond_var.wait(p_lock);
 	}
 
+	_enqueue_tasks(p_tasks, p_count, p_priority);
+}
+
+// Must be called with the mutex locked.
+void WorkerThreadPool::_enqueue_tasks(Task **p_tasks, uint32_t p_count, TaskPriority p_priority) {
 	uint32_t to_process = 0;
 	uint32_t to_promote = 0;
 
 	ThreadData *caller_pool_thread = thread_ids.has(Thread::get_caller_id()) ? &threads[thread_ids[Thread::get_caller_id()]] : nullptr;
 
+	const uint64_t now = settings.measure_task_times ? OS::get_singleton()->get_ticks_usec() : 0;
+	telemetry.queued_tasks += p_count;
+
 	for (uint32_t i = 0; i < p_count; i++) {
-		p_tasks[i]->low_priority = !p_high_priority;
-		if (p_high_priority || low_priority_threads_used < max_low_priority_threads) {
-			task_queue.add_last(&p_tasks[i]->task_elem);
-			if (!p_high_priority) {
-				low_priority_threads_used++;
-			}
-			to_process++;
-		} else {
-			// Too many threads using low priority, must go to queue.
-			low_priority_task_queue.add_last(&p_tasks[i]->task_elem);
-			to_promote++;
+		p_tasks[i]->queued_usec = now;
+		p_tasks[i]->priority = p_priority;
+		switch (p_priority) {
+			case TASK_PRIORITY_LOW: {
+				if (low_priority_threads_used < max_low_priority_threads) {
+					task_queue.add_last(&p_tasks[i]->task_elem);
+					low_priority_threads_used++;
+					to_process++;
+				} else {
+					// Too many threads using low priority, must go to queue.
+					low_priority_task_queue.add_last(&p_tasks[i]->task_elem);
+					to_promote++;
+				}
+			} break;
+			case TASK_PRIORITY_HIGH: {
+				// Tasks spawned by pool threads stay with them, unless some other thread steals them.
+				if (caller_pool_thread) {
+					_push_local_task(caller_pool_thread, p_tasks[i]);
+				} else {
+					task_queue.add_last(&p_tasks[i]->task_elem);
+				}
+				to_process++;
+			} break;
+			case TASK_PRIORITY_CRITICAL: {
+				critical_task_queue.add_last(&p_tasks[i]->task_elem);
+				to_process++;
+			} break;
 		}
 	}
 
 	_notify_threads(caller_pool_thread, to_process, to_promote);
 }
 
+// Doesn't need the task mutex. Still, the caller must wake up a thread afterwards if sleeping_threads is nonzero.
+void WorkerThreadPool::_push_local_task(ThreadData *p_thread_data, Task *p_task) {
+	MutexLock local_lock(p_thread_data->local_queue_mutex);
+	p_thread_data->local_queue.add_last(&p_task->task_elem);
+	// Counted in the same sequentially consistent order as sleeping_threads, so either the pusher sees the sleeper,
+	// or the sleeper sees the task before waiting.
+	local_queued_tasks++;
+}
+
 void WorkerThreadPool::_notify_threads(const ThreadData *p_current_thread_data, uint32_t p_process_count, uint32_t p_promote_count) {
 	uint32_t to_process = p_process_count;
 	uint32_t to_promote = p_promote_count;
@@ -276,7 +502,7 @@ void WorkerThreadPool::_notify_threads(const ThreadData *p_current_thread_data,
 		}
 		if (th.current_task) {
 			// Good thread for promoting low-prio?
-			if (to_promote && th.awaited_task && th.current_task->low_priority) {
+			if (to_promote && th.awaited_task && th.current_task->priority == TASK_PRIORITY_LOW) {
 				if (likely(&th != p_current_thread_data)) {
 					th.cond_var.notify_one();
 				}
@@ -327,10 +553,26 @@ bool WorkerThreadPool::_try_promote_low_priority_task() {
 }
 
 WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority, const String &p_description) {
-	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description);
+	return _add_task(Callable(), p_func, p_userdata, nullptr, _to_priority(p_high_priority), p_description);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *), void *p_userdata, TaskPriority p_priority, const String &p_description) {
+	return _add_task(Callable(), p_func, p_userdata, nullptr, p_priority, p_description);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_task_after(const Vector<TaskID> &p_dependencies, void (*p_func)(void *), void *p_userdata, TaskPriority p_priority, const String &p_description) {
+	return _add_task(Callable(), p_func, p_userdata, nullptr, p_priority, p_description, p_dependencies.ptr(), p_dependencies.size());
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_task_after(const Vector<TaskID> &p_dependencies, const Callable &p_action, TaskPriority p_priority, const String &p_description) {
+	return _add_task(p_action, nullptr, nullptr, nullptr, p_priority, p_description, p_dependencies.ptr(), p_dependencies.size());
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::when_all(const Vector<TaskID> &p_dependencies) {
+	return _add_task(Callable(), &WorkerThreadPool::_when_all_func, nullptr, nullptr, TASK_PRIORITY_HIGH, "when_all", p_dependencies.ptr(), p_dependencies.size());
 }
 
-WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description) {
+WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, TaskPriority p_priority, const String &p_description, const TaskID *p_dependencies, uint32_t p_dependency_count) {
 	MutexLock<BinaryMutex> lock(task_mutex);
 
 	// Get a free task
@@ -342,15 +584,56 @@ WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable,
 	task->native_func_userdata = p_userdata;
 	task->description = p_description;
 	task->template_userdata = p_template_userdata;
+	task->priority = p_priority;
 	tasks.insert(id, task);
 
-	_post_tasks(&task, 1, p_high_priority, lock);
+	for (uint32_t i = 0; i < p_dependency_count; i++) {
+		Task **dependency_taskp = tasks.getptr(p_dependencies[i]);
+		if (dependency_taskp) {
+			if (!(*dependency_taskp)->completed) {
+				(*dependency_taskp)->dependents.push_back(task);
+				task->pending_dependencies++;
+			}
+			continue;
+		}
+		Group **dependency_groupp = groups.getptr(p_dependencies[i]);
+		if (dependency_groupp) {
+			if (!(*dependency_groupp)->completed.is_set()) {
+				(*dependency_groupp)->dependents.push_back(task);
+				task->pending_dependencies++;
+			}
+			continue;
+		}
+		// Otherwise it's been awaited already, so it's completed.
+		ERR_CONTINUE_MSG(p_dependencies[i] < 1 || p_dependencies[i] >= id, "Invalid Task ID.");
+	}
+
+	if (task->pending_dependencies > 0) {
+		return id;
+	}
+
+	ThreadData *caller_pool_thread = p_priority == TASK_PRIORITY_HIGH && runlevel == RUNLEVEL_NORMAL && thread_ids.has(Thread::get_caller_id()) ? &threads[thread_ids[Thread::get_caller_id()]] : nullptr;
+	if (!caller_pool_thread) {
+		_post_tasks(&task, 1, p_priority, lock);
+		return id;
+	}
+
+	// Fork/join from a pool thread: the task goes to its own queue without holding the task mutex,
+	// which is then only taken again if some thread has to be woken up for it.
+	task->queued_usec = settings.measure_task_times ? OS::get_singleton()->get_ticks_usec() : 0;
+	telemetry.queued_tasks++;
+	lock.temp_unlock();
+	_push_local_task(caller_pool_thread, task);
+	if (sleeping_threads) {
+		lock.temp_relock();
+		_notify_threads(caller_pool_thread, 1, 0);
+	} // Otherwise, the lock is left released, which its destructor knows about.
 
 	return id;
 }
 
 WorkerThreadPool::TaskID WorkerThreadPool::add_task(const Callable &p_action, bool p_high_priority, const String &p_description) {
-	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description);
+	return _add_task(p_action, nullptr, nullptr, nullptr, _to_priority(p_high_priority), p_description);
 }
 
 bool WorkerThreadPool::is_task_completed(TaskID p_task_id) const {
@@ -481,8 +764,8 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 				if (was_signaled) {
 					// This thread was awaken for some additional reason, but it's about to exit.
 					// Let's find out what may be pending and forward the requests.
-					uint32_t to_process = task_queue.first() ? 1 : 0;
-					uint32_t to_promote = p_caller_pool_thread->current_task->low_priority && low_priority_task_queue.first() ? 1 : 0;
+					uint32_t to_process = _has_queued_tasks() ? 1 : 0;
+					uint32_t to_promote = p_caller_pool_thread->current_task->priority == TASK_PRIORITY_LOW && low_priority_task_queue.first() ? 1 : 0;
 					if (to_process || to_promote) {
 						// This thread must be left alone since it won't loop again.
 						p_caller_pool_thread->signaled = true;
@@ -493,17 +776,14 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 				break;
 			}
 
-			if (p_caller_pool_thread->current_task->low_priority && low_priority_task_queue.first()) {
+			if (p_caller_pool_thread->current_task->priority == TASK_PRIORITY_LOW && low_priority_task_queue.first()) {
 				if (_try_promote_low_priority_task()) {
 					_notify_threads(p_caller_pool_thread, 1, 0);
 				}
 			}
 
-			if (p_caller_pool_thread->pool->task_queue.first()) {
-				task_to_process = task_queue.first()->self();
-				task_queue.remove(task_queue.first());
-			}
-
+			sleeping_threads++;
+			task_to_process = _pop_task(p_caller_pool_thread);
 			if (!task_to_process) {
 				p_caller_pool_thread->awaited_task = p_task;
 
@@ -516,6 +796,7 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 
 				p_caller_pool_thread->awaited_task = nullptr;
 			}
+			sleeping_threads--;
 		}
 
 		if (relock_unlockables && this == singleton) {
@@ -547,7 +828,7 @@ bool WorkerThreadPool::_handle_runlevel(ThreadData *p_thread_data, MutexLock<Bin
 		} break;
 		case RUNLEVEL_PRE_EXIT_LANGUAGES: {
 			if (!p_thread_data->pre_exited_languages) {
-				if (!task_queue.first() && !low_priority_task_queue.first()) {
+				if (!_has_queued_tasks() && !low_priority_task_queue.first()) {
 					p_thread_data->pre_exited_languages = true;
 					runlevel_data.pre_exit_languages.num_idle_threads++;
 					control_cond_var.notify_all();
@@ -610,7 +891,7 @@ void WorkerThreadPool::notify_yield_over(TaskID p_task_id) {
 	td.cond_var.notify_one();
 }
 
-WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description) {
+WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, TaskPriority p_priority, const String &p_description) {
 	ERR_FAIL_COND_V(p_elements < 0, INVALID_TASK_ID);
 	if (p_tasks < 0) {
 		p_tasks = MAX(1u, threads.size());
@@ -629,22 +910,34 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 		group->completed.set_to(true);
 		group->done_semaphore.post();
 		group->tasks_used = 0;
+		group->ranges.resize(1);
+		group->ranges[0].bounds.store(0, std::memory_order_relaxed);
 		p_tasks = 0;
 		if (p_template_userdata) {
 			memdelete(p_template_userdata);
 		}
 
 	} else {
+		group->callable = p_callable;
+		group->native_func = p_func;
+		group->native_func_userdata = p_userdata;
+		group->template_userdata = p_template_userdata;
 		group->tasks_used = p_tasks;
+
+		// The last range is left empty for the waiter, which may help if it's a pool thread.
+		group->ranges.resize(p_tasks + 1);
+		for (int i = 0; i <= p_tasks; i++) {
+			const uint32_t begin = MIN(uint64_t(p_elements) * i / p_tasks, uint64_t(p_elements));
+			const uint32_t end = MIN(uint64_t(p_elements) * (i + 1) / p_tasks, uint64_t(p_elements));
+			group->ranges[i].bounds.store(_pack_group_range(begin, end), std::memory_order_relaxed);
+		}
+
 		tasks_posted = (Task **)alloca(sizeof(Task *) * p_tasks);
 		for (int i = 0; i < p_tasks; i++) {
 			Task *task = task_allocator.alloc();
-			task->native_group_func = p_func;
-			task->native_func_userdata = p_userdata;
 			task->description = p_description;
 			task->group = group;
-			task->callable = p_callable;
-			task->template_userdata = p_template_userdata;
+			task->group_range = i;
 			tasks_posted[i] = task;
 			// No task ID is used.
 		}
@@ -652,17 +945,21 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 
 	groups[id] = group;
 
-	_post_tasks(tasks_posted, p_tasks, p_high_priority, lock);
+	_post_tasks(tasks_posted, p_tasks, p_priority, lock);
 
 	return id;
 }
 
 WorkerThreadPool::GroupID WorkerThreadPool::add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description) {
-	return _add_group_task(Callable(), p_func, p_userdata, nullptr, p_elements, p_tasks, p_high_priority, p_description);
+	return _add_group_task(Callable(), p_func, p_userdata, nullptr, p_elements, p_tasks, _to_priority(p_high_priority), p_description);
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks, TaskPriority p_priority, const String &p_description) {
+	return _add_group_task(Callable(), p_func, p_userdata, nullptr, p_elements, p_tasks, p_priority, p_description);
 }
 
 WorkerThreadPool::GroupID WorkerThreadPool::add_group_task(const Callable &p_action, int p_elements, int p_tasks, bool p_high_priority, const String &p_description) {
-	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, p_high_priority, p_description);
+	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, _to_priority(p_high_priority), p_description);
 }
 
 uint32_t WorkerThreadPool::get_group_processed_element_count(GroupID p_group) const {
@@ -694,6 +991,26 @@ void WorkerThreadPool::wait_for_group_task_completion(GroupID p_group) {
 	{
 		Group *group = *groupp;
 
+		bool holds_unlockable_locks = false;
+		for (uint32_t i = 0; i < MAX_UNLOCKABLE_LOCKS; i++) {
+			holds_unlockable_locks = holds_unlockable_locks || unlockable_locks[i].ulock;
+		}
+		if (get_thread_index() != -1 && !holds_unlockable_locks) {
+			// Instead of blocking a pool thread, have it process whatever elements are still unclaimed.
+			// Group elements must be able to run on any pool thread, so this is as good as any other.
+			bool safe_for_nodes_backup = is_current_thread_safe_for_nodes();
+			CallQueue *call_queue_backup = MessageQueue::get_singleton() != MessageQueue::get_main_singleton() ? MessageQueue::get_singleton() : nullptr;
+			set_current_thread_safe_for_nodes(false);
+			MessageQueue::set_thread_singleton_override(nullptr);
+
+			if (_process_group_elements(group, group->tasks_used)) {
+				_complete_group(group);
+			}
+
+			set_current_thread_safe_for_nodes(safe_for_nodes_backup);
+			MessageQueue::set_thread_singleton_override(call_queue_backup);
+		}
+
 		if (this == singleton) {
 			_unlock_unlockable_mutexes();
 		}
@@ -758,19 +1075,32 @@ void WorkerThreadPool::thread_exit_unlock_allowance_zone(uint32_t p_zone_id) {
 #endif
 
 void WorkerThreadPool::init(int p_thread_count, float p_low_priority_task_ratio) {
+	PoolSettings pool_settings;
+	pool_settings.thread_count = p_thread_count;
+	pool_settings.low_priority_task_ratio = p_low_priority_task_ratio;
+	init(pool_settings);
+}
+
+void WorkerThreadPool::init(const PoolSettings &p_settings) {
 	ERR_FAIL_COND(threads.size() > 0);
 
 	runlevel = RUNLEVEL_NORMAL;
+	settings = p_settings;
 
-	if (p_thread_count < 0) {
-		p_thread_count = OS::get_singleton()->get_default_thread_pool_size();
+	int thread_count = settings.thread_count;
+	if (thread_count < 0) {
+		thread_count = settings.cpu_affinity.is_empty() ? OS::get_singleton()->get_default_thread_pool_size() : settings.cpu_affinity.size();
 	}
 
-	max_low_priority_threads = CLAMP(p_thread_count * p_low_priority_task_ratio, 1, p_thread_count - 1);
+	max_low_priority_threads = CLAMP(thread_count * settings.low_priority_task_ratio, 1, thread_count - 1);
 
-	print_verbose(vformat("WorkerThreadPool: %d threads, %d max low-priority.", p_thread_count, max_low_priority_threads));
+	if (settings.cpu_affinity.is_empty()) {
+		print_verbose(vformat("WorkerThreadPool: %d threads, %d max low-priority.", thread_count, max_low_priority_threads));
+	} else {
+		print_verbose(vformat("WorkerThreadPool: %d threads, %d max low-priority, %s on CPUs %s.", thread_count, max_low_priority_threads, settings.pin_threads ? "pinned" : "running", String(Variant(settings.cpu_affinity))));
+	}
 
-	threads.resize(p_thread_count);
+	threads.resize(thread_count);
 
 	for (uint32_t i = 0; i < threads.size(); i++) {
 		threads[i].index = i;
@@ -825,6 +1155,11 @@ void WorkerThreadPool::finish() {
 		for (KeyValue<TaskID, Task *> &E : tasks) {
 			task_allocator.free(E.value);
 		}
+		for (ThreadData &data : threads) {
+			data.local_queue.clear();
+		}
+		local_queued_tasks = 0;
+		telemetry.queued_tasks = 0;
 	}
 
 	threads.clear();
@@ -846,13 +1181,72 @@ WorkerThreadPool *WorkerThreadPool::get_named_pool(const StringName &p_name) {
 	if (pool_ptr) {
 		return *pool_ptr;
 	} else {
+		PoolSettings pool_settings;
+		const PoolSettings *settings_ptr = named_pool_settings.getptr(p_name);
+		if (settings_ptr) {
+			pool_settings = *settings_ptr;
+		} else if (singleton) {
+			// Keep the process within the CPUs it was given.
+			pool_settings.cpu_affinity = singleton->settings.cpu_affinity;
+			pool_settings.measure_task_times = singleton->settings.measure_task_times;
+		}
+
 		WorkerThreadPool *pool = memnew(WorkerThreadPool(false));
-		pool->init();
+		pool->init(pool_settings);
 		named_pools[p_name] = pool;
+		if (named_pool_created_callback) {
+			named_pool_created_callback(p_name);
+		}
 		return pool;
 	}
 }
 
+void WorkerThreadPool::set_named_pool_settings(const StringName &p_name, const PoolSettings &p_settings) {
+	ERR_FAIL_COND_MSG(named_pools.has(p_name), vformat("Named pool '%s' already exists, its settings can't be changed anymore.", p_name));
+	named_pool_settings[p_name] = p_settings;
+}
+
+Vector<int> WorkerThreadPool::parse_cpu_list(const String &p_list, int p_cpu_count) {
+	const int cpu_count = p_cpu_count == -1 ? OS::get_singleton()->get_processor_count() : p_cpu_count;
+	Vector<int> cpus;
+	LocalVector<bool> listed;
+	listed.resize(cpu_count);
+	for (bool &cpu_listed : listed) {
+		cpu_listed = false;
+	}
+
+	const Vector<String> items = p_list.split(",", false);
+	for (const String &item : items) {
+		const String range = item.strip_edges();
+		const int dash = range.find_char('-');
+		const String first = dash == -1 ? range : range.substr(0, dash).strip_edges();
+		const String last = dash == -1 ? range : range.substr(dash + 1).strip_edges();
+		ERR_FAIL_COND_V_MSG(!first.is_valid_int() || !last.is_valid_int(), Vector<int>(), vformat("Invalid CPU list: '%s'.", p_list));
+
+		const int from = first.to_int();
+		const int to = last.to_int();
+		ERR_FAIL_COND_V_MSG(from < 0 || to < from, Vector<int>(), vformat("Invalid CPU range in list: '%s'.", range));
+		ERR_FAIL_COND_V_MSG(to >= cpu_count, Vector<int>(), vformat("CPU range '%s' goes beyond the %d CPUs of the system.", range, cpu_count));
+		for (int cpu = from; cpu <= to; cpu++) {
+			if (!listed[cpu]) {
+				listed[cpu] = true;
+				cpus.push_back(cpu);
+			}
+		}
+	}
+	return cpus;
+}
+
+WorkerThreadPool::Telemetry WorkerThreadPool::get_telemetry() const {
+	Telemetry result;
+	{
+		MutexLock task_lock(task_mutex);
+		result = telemetry;
+	}
+	result.steals += group_steals.get();
+	return result;
+}
+
 WorkerThreadPool::WorkerThreadPool(bool p_singleton) {
 	if (p_singleton) {
 		singleton = this;
@@ -869,5 +1263,6 @@ WorkerThreadPool::~WorkerThreadPool() {
 			memdelete(E.value);
 		}
 		named_pools.clear();
+		named_pool_settings.clear();
 	}
 }
@@ -50,6 +50,35 @@ public:
 	typedef int64_t TaskID;
 	typedef int64_t GroupID;
 
+	enum TaskPriority {
+		TASK_PRIORITY_LOW, // Throttled, so long-running background work can't take over every thread.
+		TASK_PRIORITY_HIGH,
+		TASK_PRIORITY_CRITICAL, // Runs ahead of anything else queued. Meant for short tasks a frame is waiting on.
+	};
+
+	struct PoolSettings {
+		int thread_count = -1; // Defaults to the size of the affinity set if there's one, or to the OS default otherwise.
+		float low_priority_task_ratio = 0.3;
+		Thread::Priority thread_priority = Thread::PRIORITY_NORMAL;
+		Vector<int> cpu_affinity; // Logical CPUs the threads may run on. Empty for no restriction.
+		bool pin_threads = false; // Binds each thread to a single CPU of the affinity set, in turn.
+		bool measure_task_times = false; // Fills in the wait and run times of the telemetry, at the cost of reading the clock for every task.
+	};
+
+	struct Telemetry {
+		// Bucket 0 counts durations under 1 usec, bucket i those from 2^(i-1) usec, and the last one anything longer.
+		static const int HISTOGRAM_BUCKETS = 16;
+
+		uint32_t queued_tasks = 0;
+		uint64_t processed_tasks = 0;
+		uint64_t steals = 0; // Tasks taken from the queue of another thread, plus group elements taken from another task.
+		// Only measured if the pool's measure_task_times setting is enabled.
+		double average_wait_usec = 0; // Time from posting to starting, as a moving average.
+		double average_run_usec = 0;
+		uint64_t wait_usec_histogram[HISTOGRAM_BUCKETS] = {};
+		uint64_t run_usec_histogram[HISTOGRAM_BUCKETS] = {};
+	};
+
 private:
 	struct Task;
 
@@ -60,35 +89,50 @@ private:
 	};
 
 	struct Group {
+		// Elements are split into one range per task, plus a spare one for a pool thread helping while it waits.
+		// A task consumes its own range from the front and, once it runs dry, steals the back half of another one,
+		// so threads only touch shared state when the work is running out.
+		struct Range {
+			std::atomic<uint64_t> bounds; // Begin in the low 32 bits, end in the high ones.
+			uint8_t padding[MAX(Thread::CACHE_LINE_BYTES, 2 * sizeof(uint64_t)) - sizeof(std::atomic<uint64_t>)];
+		};
+
 		GroupID self = -1;
-		SafeNumeric<uint32_t> index;
+		Callable callable;
+		void (*native_func)(void *, uint32_t) = nullptr;
+		void *native_func_userdata = nullptr;
+		BaseTemplateUserdata *template_userdata = nullptr;
+		LocalVector<Range> ranges;
 		SafeNumeric<uint32_t> completed_index;
 		uint32_t max = 0;
 		Semaphore done_semaphore;
 		SafeFlag completed;
 		SafeNumeric<uint32_t> finished;
 		uint32_t tasks_used = 0;
+		LocalVector<Task *> dependents; // Tasks waiting for this group to complete.
 	};
 
 	struct Task {
 		TaskID self = -1;
 		Callable callable;
 		void (*native_func)(void *) = nullptr;
-		void (*native_group_func)(void *, uint32_t) = nullptr;
 		void *native_func_userdata = nullptr;
 		String description;
 		Semaphore done_semaphore; // For user threads awaiting.
 		bool completed : 1;
 		bool pending_notify_yield_over : 1;
 		Group *group = nullptr;
+		uint32_t group_range = 0;
 		SelfList<Task> task_elem;
 		uint32_t waiting_pool = 0;
 		uint32_t waiting_user = 0;
-		bool low_priority = false;
+		TaskPriority priority = TASK_PRIORITY_HIGH;
 		BaseTemplateUserdata *template_userdata = nullptr;
 		int pool_thread_index = -1;
+		uint32_t pending_dependencies = 0; // Not posted until this drops to zero.
+		LocalVector<Task *> dependents; // Tasks waiting for this one to complete.
+		uint64_t queued_usec = 0;
 
-		void free_template_userdata();
 		Task() :
 				completed(false),
 				pending_notify_yield_over(false),
@@ -103,6 +147,9 @@ private:
 
 	SelfList<Task>::List low_priority_task_queue;
 	SelfList<Task>::List task_queue;
+	SelfList<Task>::List critical_task_queue;
+	std::atomic<uint32_t> local_queued_tasks = 0; // Across the queues of all the threads.
+	std::atomic<uint32_t> sleeping_threads = 0; // Counted before their last look at the queues, so pushes made without the mutex can tell whether someone must be woken up.
 
 	BinaryMutex task_mutex;
 
@@ -117,6 +164,12 @@ private:
 		bool exited_languages : 1;
 		Task *current_task = nullptr;
 		Task *awaited_task = nullptr; // Null if not awaiting the condition variable, or special value (YIELDING).
+		// High priority tasks posted from this thread. It takes the newest ones first, while the other
+		// threads steal from the oldest end, which keeps fork/join work hot in the caches of its thread.
+		// It has its own lock, so the owner can push to it without taking the task mutex. When both are needed,
+		// the task mutex goes first.
+		SelfList<Task>::List local_queue;
+		BinaryMutex local_queue_mutex;
 		ConditionVariable cond_var;
 		WorkerThreadPool *pool = nullptr;
 
@@ -162,19 +215,33 @@ private:
 
 	uint32_t max_low_priority_threads = 0;
 	uint32_t low_priority_threads_used = 0;
-	uint32_t notify_index = 0; // For rotating across threads, no help distributing load.
+	uint32_t notify_index = 0; // For rotating across threads when waking them up. Load is then balanced by stealing.
 
 	uint64_t last_task = 1;
 
+	PoolSettings settings;
+	Telemetry telemetry; // Updated with the mutex locked.
+	SafeNumeric<uint64_t> group_steals;
+
 	static HashMap<StringName, WorkerThreadPool *> named_pools;
+	static HashMap<StringName, PoolSettings> named_pool_settings;
 
 	static void _thread_function(void *p_user);
 
-	void _process_task(Task *task);
+	void _process_task(Task *task, Task **r_next_task = nullptr);
+	bool _process_group_elements(Group *p_group, uint32_t p_range);
+	void _complete_group(Group *p_group);
 
-	void _post_tasks(Task **p_tasks, uint32_t p_count, bool p_high_priority, MutexLock<BinaryMutex> &p_lock);
+	void _post_tasks(Task **p_tasks, uint32_t p_count, TaskPriority p_priority, MutexLock<BinaryMutex> &p_lock);
+	void _enqueue_tasks(Task **p_tasks, uint32_t p_count, TaskPriority p_priority);
+	void _push_local_task(ThreadData *p_thread_data, Task *p_task);
+	void _release_dependents(LocalVector<Task *> &p_dependents);
 	void _notify_threads(const ThreadData *p_current_thread_data, uint32_t p_process_count, uint32_t p_promote_count);
 
+	Task *_pop_task(ThreadData *p_thread_data);
+	Task *_take_queued_task(ThreadData *p_thread_data, bool &r_stolen);
+	void _record_task_run(bool p_measured, uint64_t p_run_usec);
+	bool _has_queued_tasks() const;
 	bool _try_promote_low_priority_task();
 
 	static WorkerThreadPool *singleton;
@@ -188,8 +255,12 @@ private:
 	static thread_local UnlockableLocks unlockable_locks[MAX_UNLOCKABLE_LOCKS];
 #endif
 
-	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description);
-	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description);
+	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, TaskPriority p_priority, const String &p_description, const TaskID *p_dependencies = nullptr, uint32_t p_dependency_count = 0);
+	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, TaskPriority p_priority, const String &p_description);
+
+	static void _when_all_func(void *p_userdata) {}
+
+	_FORCE_INLINE_ static TaskPriority _to_priority(bool p_high_priority) { return p_high_priority ? TASK_PRIORITY_HIGH : TASK_PRIORITY_LOW; }
 
 	template <typename C, typename M, typename U>
 	struct TaskUserData : public BaseTemplateUserdata {
@@ -234,11 +305,37 @@ public:
 		ud->instance = p_instance;
 		ud->method = p_method;
 		ud->userdata = p_userdata;
-		return _add_task(Callable(), nullptr, nullptr, ud, p_high_priority, p_description);
+		return _add_task(Callable(), nullptr, nullptr, ud, _to_priority(p_high_priority), p_description);
+	}
+	template <typename C, typename M, typename U>
+	TaskID add_template_task(C *p_instance, M p_method, U p_userdata, TaskPriority p_priority, const String &p_description = String()) {
+		typedef TaskUserData<C, M, U> TUD;
+		TUD *ud = memnew(TUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_task(Callable(), nullptr, nullptr, ud, p_priority, p_description);
 	}
 	TaskID add_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority = false, const String &p_description = String());
+	TaskID add_native_task(void (*p_func)(void *), void *p_userdata, TaskPriority p_priority, const String &p_description = String());
 	TaskID add_task(const Callable &p_action, bool p_high_priority = false, const String &p_description = String());
 
+	// Tasks that are only posted once all the given tasks or groups have completed. The dependencies still
+	// have to be awaited as usual; one that has already been awaited is considered completed.
+	template <typename C, typename M, typename U>
+	TaskID add_template_task_after(const Vector<TaskID> &p_dependencies, C *p_instance, M p_method, U p_userdata, TaskPriority p_priority = TASK_PRIORITY_HIGH, const String &p_description = String()) {
+		typedef TaskUserData<C, M, U> TUD;
+		TUD *ud = memnew(TUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_task(Callable(), nullptr, nullptr, ud, p_priority, p_description, p_dependencies.ptr(), p_dependencies.size());
+	}
+	TaskID add_native_task_after(const Vector<TaskID> &p_dependencies, void (*p_func)(void *), void *p_userdata, TaskPriority p_priority = TASK_PRIORITY_HIGH, const String &p_description = String());
+	TaskID add_task_after(const Vector<TaskID> &p_dependencies, const Callable &p_action, TaskPriority p_priority = TASK_PRIORITY_HIGH, const String &p_description = String());
+	// Returns a task that completes once all the given tasks or groups have.
+	TaskID when_all(const Vector<TaskID> &p_dependencies);
+
 	bool is_task_completed(TaskID p_task_id) const;
 	Error wait_for_task_completion(TaskID p_task_id);
 
@@ -252,9 +349,19 @@ public:
 		ud->instance = p_instance;
 		ud->method = p_method;
 		ud->userdata = p_userdata;
-		return _add_group_task(Callable(), nullptr, nullptr, ud, p_elements, p_tasks, p_high_priority, p_description);
+		return _add_group_task(Callable(), nullptr, nullptr, ud, p_elements, p_tasks, _to_priority(p_high_priority), p_description);
+	}
+	template <typename C, typename M, typename U>
+	GroupID add_template_group_task(C *p_instance, M p_method, U p_userdata, int p_elements, int p_tasks, TaskPriority p_priority, const String &p_description = String()) {
+		typedef GroupUserData<C, M, U> GroupUD;
+		GroupUD *ud = memnew(GroupUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_group_task(Callable(), nullptr, nullptr, ud, p_elements, p_tasks, p_priority, p_description);
 	}
 	GroupID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
+	GroupID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks, TaskPriority p_priority, const String &p_description = String());
 	GroupID add_group_task(const Callable &p_action, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
 	uint32_t get_group_processed_element_count(GroupID p_group) const;
 	bool is_group_task_completed(GroupID p_group) const;
@@ -270,6 +377,15 @@ public:
 
 	// Note: Do not use this unless you know what you are doing, and it is absolutely necessary. Main thread pool (`get_singleton()`) should be preferred instead.
 	static WorkerThreadPool *get_named_pool(const StringName &p_name);
+	// Settings for a named pool created from now on. Without any, named pools share the affinity set of the main pool.
+	static void set_named_pool_settings(const StringName &p_name, const PoolSettings &p_settings);
+	static void (*named_pool_created_callback)(const StringName &p_name);
+
+	// Parses CPU lists such as "0-3,8,10-11". CPUs must be below p_cpu_count, which defaults to the processor count of the system.
+	static Vector<int> parse_cpu_list(const String &p_list, int p_cpu_count = -1);
+
+	const PoolSettings &get_settings() const { return settings; }
+	Telemetry get_telemetry() const;
 
 	static WorkerThreadPool *get_singleton() { return singleton; }
 	int get_thread_index() const;
@@ -288,6 +404,7 @@ public:
 #endif
 
 	void init(int p_thread_count = -1, float p_low_priority_task_ratio = 0.3);
+	void init(const PoolSettings &p_settings);
 	void exit_languages_threads();
 	void finish();
 	WorkerThreadPool(bool p_singleton = true);
@@ -0,0 +1,247 @@
+/**************************************************************************/
+/*  frame_arena.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "frame_arena.h"
+
+#include "core/templates/safe_refcount.h"
+
+#include <string.h>
+
+// Every block starts with this header, which keeps the data aligned to 16 bytes.
+struct FrameArenaBlock {
+	uint64_t size;
+	uint32_t heap; // Allocated with Memory::alloc_static().
+	uint32_t buffer; // Index of the buffer it was allocated from.
+};
+
+struct FrameArenaChunk {
+	FrameArenaChunk *next;
+	size_t capacity;
+	size_t used;
+};
+
+struct FrameArenaBuffer {
+	FrameArenaChunk *chunk = nullptr; // Newest first, allocations only come from this one.
+	size_t reserved = 0;
+	size_t rewind_capacity = 0;
+	uint64_t frame = 0;
+	uint32_t live = 0; // Blocks not freed yet. The buffer is only rewound once there are none.
+};
+
+struct FrameArenaThread {
+	FrameArenaBuffer buffers[2];
+
+	~FrameArenaThread();
+};
+
+static constexpr size_t BLOCK_HEADER_SIZE = sizeof(FrameArenaBlock);
+static constexpr size_t CHUNK_HEADER_SIZE = (sizeof(FrameArenaChunk) + 15) & ~size_t(15);
+
+static_assert(BLOCK_HEADER_SIZE == 16);
+
+static SafeNumeric<uint64_t> current_frame;
+static SafeNumeric<uint64_t> reserved_bytes;
+
+static thread_local FrameArenaThread thread_arena;
+
+static _FORCE_INLINE_ uint8_t *_chunk_data(const FrameArenaChunk *p_chunk) {
+	return (uint8_t *)p_chunk + CHUNK_HEADER_SIZE;
+}
+
+static void _free_chunks(FrameArenaBuffer &r_buffer) {
+	FrameArenaChunk *chunk = r_buffer.chunk;
+	while (chunk) {
+		FrameArenaChunk *next = chunk->next;
+		memfree(chunk);
+		chunk = next;
+	}
+	reserved_bytes.sub(r_buffer.reserved);
+	r_buffer.chunk = nullptr;
+	r_buffer.reserved = 0;
+}
+
+FrameArenaThread::~FrameArenaThread() {
+	_free_chunks(buffers[0]);
+	_free_chunks(buffers[1]);
+}
+
+static void _rewind(FrameArenaBuffer &r_buffer) {
+	if (!r_buffer.chunk) {
+		return;
+	}
+	if (r_buffer.chunk->next) {
+		// Replace the chunks with a single one big enough for all of them, allocated on next use.
+		r_buffer.rewind_capacity = r_buffer.reserved;
+		_free_chunks(r_buffer);
+	} else {
+		r_buffer.chunk->used = 0;
+	}
+}
+
+static _FORCE_INLINE_ uint32_t _get_buffer_index() {
+	const uint64_t frame = current_frame.get();
+	const uint32_t index = frame & 1;
+	FrameArenaBuffer &buffer = thread_arena.buffers[index];
+	if (unlikely(buffer.frame != frame)) {
+		// Threads which don't follow Main::iteration() (like the physics thread, or long tasks),
+		// and nested iterations, may still use blocks of two frames ago. Keep appending to the
+		// buffer then, it's rewound on the first frame change after they are all freed.
+		if (buffer.live == 0) {
+			_rewind(buffer);
+		}
+		buffer.frame = frame;
+	}
+	return index;
+}
+
+static FrameArenaChunk *_add_chunk(FrameArenaBuffer &r_buffer, size_t p_min_capacity) {
+	if (r_buffer.reserved + p_min_capacity > FrameArena::MAX_BUFFER_SIZE) {
+		return nullptr;
+	}
+
+	// Grow geometrically, so a busy frame needs few chunks.
+	size_t capacity = MAX(MAX(FrameArena::CHUNK_SIZE, r_buffer.reserved), r_buffer.rewind_capacity);
+	capacity = MAX(MIN(capacity, FrameArena::MAX_BUFFER_SIZE - r_buffer.reserved), p_min_capacity);
+	r_buffer.rewind_capacity = 0;
+
+	FrameArenaChunk *chunk = (FrameArenaChunk *)memalloc(CHUNK_HEADER_SIZE + capacity);
+	ERR_FAIL_NULL_V(chunk, nullptr);
+	chunk->next = r_buffer.chunk;
+	chunk->capacity = capacity;
+	chunk->used = 0;
+
+	r_buffer.chunk = chunk;
+	r_buffer.reserved += capacity;
+	reserved_bytes.add(capacity);
+	return chunk;
+}
+
+// Whether the block is the latest allocation of this thread in the current frame.
+static _FORCE_INLINE_ bool _is_top(const FrameArenaBuffer &p_buffer, const FrameArenaBlock *p_header) {
+	const FrameArenaChunk *chunk = p_buffer.chunk;
+	return chunk && (const uint8_t *)p_header + BLOCK_HEADER_SIZE + p_header->size == _chunk_data(chunk) + chunk->used;
+}
+
+void FrameArena::begin_frame() {
+	current_frame.increment();
+}
+
+uint64_t FrameArena::get_frame() {
+	return current_frame.get();
+}
+
+void *FrameArena::alloc(size_t p_bytes) {
+	const size_t size = (p_bytes + 15) & ~size_t(15);
+	const size_t total = BLOCK_HEADER_SIZE + size;
+
+	const uint32_t index = _get_buffer_index();
+	FrameArenaBuffer &buffer = thread_arena.buffers[index];
+	FrameArenaChunk *chunk = buffer.chunk;
+	if (unlikely(!chunk || chunk->used + total > chunk->capacity)) {
+		chunk = _add_chunk(buffer, total);
+	}
+
+	FrameArenaBlock *header;
+	if (likely(chunk)) {
+		header = (FrameArenaBlock *)(_chunk_data(chunk) + chunk->used);
+		chunk->used += total;
+		header->heap = 0;
+		header->buffer = index;
+		buffer.live++;
+	} else {
+		header = (FrameArenaBlock *)memalloc(total);
+		ERR_FAIL_NULL_V(header, nullptr);
+		header->heap = 1;
+	}
+	header->size = size;
+	return (uint8_t *)header + BLOCK_HEADER_SIZE;
+}
+
+void *FrameArena::realloc(void *p_memory, size_t p_bytes) {
+	if (!p_memory) {
+		return alloc(p_bytes);
+	}
+	if (p_bytes == 0) {
+		free(p_memory);
+		return nullptr;
+	}
+
+	FrameArenaBlock *header = (FrameArenaBlock *)((uint8_t *)p_memory - BLOCK_HEADER_SIZE);
+	const size_t size = (p_bytes + 15) & ~size_t(15);
+
+	if (header->heap) {
+		header = (FrameArenaBlock *)memrealloc(header, BLOCK_HEADER_SIZE + size);
+		ERR_FAIL_NULL_V(header, nullptr);
+		header->size = size;
+		return (uint8_t *)header + BLOCK_HEADER_SIZE;
+	}
+
+	if (size <= header->size) {
+		return p_memory;
+	}
+
+	FrameArenaBuffer &buffer = thread_arena.buffers[header->buffer];
+	if (_is_top(buffer, header) && buffer.chunk->used + size - header->size <= buffer.chunk->capacity) {
+		// Latest allocation, grow in place.
+		buffer.chunk->used += size - header->size;
+		header->size = size;
+		return p_memory;
+	}
+
+	void *mem = alloc(p_bytes);
+	if (likely(mem)) {
+		memcpy(mem, p_memory, header->size);
+		free(p_memory);
+	}
+	return mem;
+}
+
+void FrameArena::free(void *p_memory) {
+	if (!p_memory) {
+		return;
+	}
+
+	FrameArenaBlock *header = (FrameArenaBlock *)((uint8_t *)p_memory - BLOCK_HEADER_SIZE);
+	if (header->heap) {
+		memfree(header);
+		return;
+	}
+
+	FrameArenaBuffer &buffer = thread_arena.buffers[header->buffer];
+	DEV_ASSERT(buffer.live > 0);
+	buffer.live--;
+	if (_is_top(buffer, header)) {
+		buffer.chunk->used -= BLOCK_HEADER_SIZE + header->size;
+	}
+}
+
+uint64_t FrameArena::get_reserved_bytes() {
+	return reserved_bytes.get();
+}
@@ -0,0 +1,85 @@
+/**************************************************************************/
+/*  frame_arena.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/os/memory.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Linear allocator for scratch memory that is only needed during a frame.
+//
+// Every thread has two buffers, used in alternate frames. Main::iteration() calls
+// begin_frame(), and the first allocation a thread makes in a frame rewinds the buffer
+// it used two frames before, if all blocks allocated from it were freed. Otherwise that
+// buffer keeps growing until they are, so memory stays valid until it's freed even on
+// threads not in step with the main loop, or across nested iterations.
+//
+// free() only reclaims the latest allocation of the calling thread, so nested scratch
+// buffers are popped as they go out of scope. Once a buffer holds MAX_BUFFER_SIZE bytes,
+// more allocations fall back to Memory::alloc_static() until the buffer is rewound.
+//
+// Use it through FrameLocalVector and FrameHashMap, for local variables only. Memory must
+// be freed by the thread that allocated it. Never keep frame memory in members.
+class FrameArena {
+public:
+	static constexpr size_t CHUNK_SIZE = 64 * 1024;
+	static constexpr size_t MAX_BUFFER_SIZE = 16 * 1024 * 1024;
+
+	static void begin_frame();
+	static uint64_t get_frame();
+
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_memory, size_t p_bytes);
+	static void free(void *p_memory);
+
+	// Bytes held by the buffers of all threads.
+	static uint64_t get_reserved_bytes();
+};
+
+template <typename T>
+class FrameTypedAllocator {
+public:
+	template <typename... Args>
+	_FORCE_INLINE_ T *new_allocation(const Args &&...p_args) { return memnew_placement(FrameArena::alloc(sizeof(T)), T(p_args...)); }
+	_FORCE_INLINE_ void delete_allocation(T *p_allocation) {
+		p_allocation->~T();
+		FrameArena::free(p_allocation);
+	}
+};
+
+template <typename T, typename U = uint32_t, bool force_trivial = false>
+using FrameLocalVector = LocalVector<T, U, force_trivial, false, FrameArena>;
+
+// Only the elements come from the arena, the bucket arrays are allocated normally.
+template <typename TKey, typename TValue,
+		typename Hasher = HashMapHasherDefault,
+		typename Comparator = HashMapComparatorDefault<TKey>>
+using FrameHashMap = HashMap<TKey, TValue, Hasher, Comparator, FrameTypedAllocator<HashMapElement<TKey, TValue>>>;
@@ -32,6 +32,10 @@
 
 #include "core/templates/safe_refcount.h"
 
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+#include "core/os/size_class_allocator.h"
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 
@@ -64,6 +68,18 @@ SafeNumeric<uint64_t> Memory::max_usage;
 
 SafeNumeric<uint64_t> Memory::alloc_count;
 
+// With the size class allocator, allocation counts and usage are kept per thread
+// by the allocator instead of in the atomics above, and summed when read.
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+#define MEMORY_SYSTEM_ALLOC(m_size) SizeClassAllocator::alloc(m_size)
+#define MEMORY_SYSTEM_REALLOC(m_mem, m_size) SizeClassAllocator::realloc(m_mem, m_size)
+#define MEMORY_SYSTEM_FREE(m_mem) SizeClassAllocator::free(m_mem)
+#else
+#define MEMORY_SYSTEM_ALLOC(m_size) malloc(m_size)
+#define MEMORY_SYSTEM_REALLOC(m_mem, m_size) realloc(m_mem, m_size)
+#define MEMORY_SYSTEM_FREE(m_mem) free(m_mem)
+#endif
+
 void *Memory::alloc_aligned_static(size_t p_bytes, size_t p_alignment) {
 	DEV_ASSERT(is_power_of_2(p_alignment));
 
@@ -103,11 +119,13 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 	bool prepad = p_pad_align;
 #endif
 
-	void *mem = malloc(p_bytes + (prepad ? DATA_OFFSET : 0));
+	void *mem = MEMORY_SYSTEM_ALLOC(p_bytes + (prepad ? DATA_OFFSET : 0));
 
 	ERR_FAIL_NULL_V(mem, nullptr);
 
+#ifndef SIZE_CLASS_ALLOCATOR_ENABLED
 	alloc_count.increment();
+#endif
 
 	if (prepad) {
 		uint8_t *s8 = (uint8_t *)mem;
@@ -116,8 +134,12 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 		*s = p_bytes;
 
 #ifdef DEBUG_ENABLED
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+		SizeClassAllocator::track_usage(p_bytes);
+#else
 		uint64_t new_mem_usage = mem_usage.add(p_bytes);
 		max_usage.exchange_if_greater(new_mem_usage);
+#endif
 #endif
 		return s8 + DATA_OFFSET;
 	} else {
@@ -143,21 +165,25 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 		uint64_t *s = (uint64_t *)(mem + SIZE_OFFSET);
 
 #ifdef DEBUG_ENABLED
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+		SizeClassAllocator::track_usage((int64_t)p_bytes - (int64_t)*s);
+#else
 		if (p_bytes > *s) {
 			uint64_t new_mem_usage = mem_usage.add(p_bytes - *s);
 			max_usage.exchange_if_greater(new_mem_usage);
 		} else {
 			mem_usage.sub(*s - p_bytes);
 		}
+#endif
 #endif
 
 		if (p_bytes == 0) {
-			free(mem);
+			MEMORY_SYSTEM_FREE(mem);
 			return nullptr;
 		} else {
 			*s = p_bytes;
 
-			mem = (uint8_t *)realloc(mem, p_bytes + DATA_OFFSET);
+			mem = (uint8_t *)MEMORY_SYSTEM_REALLOC(mem, p_bytes + DATA_OFFSET);
 			ERR_FAIL_NULL_V(mem, nullptr);
 
 			s = (uint64_t *)(mem + SIZE_OFFSET);
@@ -167,7 +193,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 			return mem + DATA_OFFSET;
 		}
 	} else {
-		mem = (uint8_t *)realloc(mem, p_bytes);
+		mem = (uint8_t *)MEMORY_SYSTEM_REALLOC(mem, p_bytes);
 
 		ERR_FAIL_COND_V(mem == nullptr && p_bytes > 0, nullptr);
 
@@ -186,19 +212,25 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 	bool prepad = p_pad_align;
 #endif
 
+#ifndef SIZE_CLASS_ALLOCATOR_ENABLED
 	alloc_count.decrement();
+#endif
 
 	if (prepad) {
 		mem -= DATA_OFFSET;
 
 #ifdef DEBUG_ENABLED
 		uint64_t *s = (uint64_t *)(mem + SIZE_OFFSET);
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+		SizeClassAllocator::track_usage(-(int64_t)*s);
+#else
 		mem_usage.sub(*s);
+#endif
 #endif
 
-		free(mem);
+		MEMORY_SYSTEM_FREE(mem);
 	} else {
-		free(mem);
+		MEMORY_SYSTEM_FREE(mem);
 	}
 }
 
@@ -208,7 +240,11 @@ uint64_t Memory::get_mem_available() {
 
 uint64_t Memory::get_mem_usage() {
 #ifdef DEBUG_ENABLED
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+	return MAX(SizeClassAllocator::get_stats().tracked_usage, 0);
+#else
 	return mem_usage.get();
+#endif
 #else
 	return 0;
 #endif
@@ -216,6 +252,10 @@ uint64_t Memory::get_mem_usage() {
 
 uint64_t Memory::get_mem_max_usage() {
 #ifdef DEBUG_ENABLED
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+	// Usage is only summed when read, so the peak is the highest value seen by a read.
+	max_usage.exchange_if_greater(get_mem_usage());
+#endif
 	return max_usage.get();
 #else
 	return 0;
@@ -0,0 +1,605 @@
+/**************************************************************************/
+/*  size_class_allocator.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "size_class_allocator.h"
+
+#include "core/os/memory.h"
+#include "core/os/mutex.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+
+static constexpr uint32_t LARGE_SIZE_CLASS = UINT32_MAX;
+
+// Multiples of 16 up to 128, then four classes per doubling.
+static constexpr uint32_t class_sizes[SizeClassAllocator::SIZE_CLASS_COUNT] = {
+	16, 32, 48, 64, 80, 96, 112, 128,
+	160, 192, 224, 256,
+	320, 384, 448, 512,
+	640, 768, 896, 1024,
+	1280, 1536, 1792, 2048,
+	2560, 3072, 3584, 4096,
+	5120, 6144, 7168, 8192
+};
+
+// Size classes are multiples of 16 up to 1024 bytes and of 128 above,
+// so two small tables map any size to its class.
+struct SizeClassLookup {
+	static constexpr uint32_t BY_16_COUNT = 1024 / 16 + 1;
+	static constexpr uint32_t BY_128_COUNT = SizeClassAllocator::MAX_SMALL_SIZE / 128 + 1;
+
+	uint8_t by_16[BY_16_COUNT] = {};
+	uint8_t by_128[BY_128_COUNT] = {};
+
+	constexpr SizeClassLookup() {
+		uint32_t size_class = 0;
+		for (uint32_t i = 0; i < BY_16_COUNT; i++) {
+			while (class_sizes[size_class] < i * 16) {
+				size_class++;
+			}
+			by_16[i] = size_class;
+		}
+		size_class = 0;
+		for (uint32_t i = 0; i < BY_128_COUNT; i++) {
+			while (class_sizes[size_class] < i * 128) {
+				size_class++;
+			}
+			by_128[i] = size_class;
+		}
+	}
+};
+
+static constexpr SizeClassLookup size_class_lookup;
+
+struct FreeBlock {
+	FreeBlock *next;
+};
+
+// Start of every small span. Blocks are carved after it as they are needed.
+struct SpanHeader {
+	FreeBlock *free_list = nullptr; // Blocks given back to this span.
+	uint8_t *carve_pos = nullptr;
+	SpanHeader *prev = nullptr;
+	SpanHeader *next = nullptr;
+	uint32_t used = 0; // Blocks held by threads or their caches.
+	bool available = false; // Linked in the central list of its size class.
+};
+
+static_assert(sizeof(SpanHeader) <= SizeClassAllocator::SPAN_HEADER_SIZE);
+static_assert(SizeClassAllocator::SPAN_HEADER_SIZE % alignof(max_align_t) == 0);
+
+// Placed before every large block, which comes straight from malloc().
+struct LargeHeader {
+	size_t capacity = 0;
+};
+
+static constexpr size_t LARGE_HEADER_SIZE = sizeof(LargeHeader) > alignof(max_align_t) ? sizeof(LargeHeader) : alignof(max_align_t);
+
+// Maps each SPAN_SIZE aligned address range to the size class of the small span it holds, plus one.
+// Zero means that the range holds no small span, so any other pointer is a large block. Leaves are
+// allocated on first use and kept, so lookups don't need a lock.
+struct SpanMap {
+	static constexpr uint32_t SPAN_SHIFT = 17;
+	static constexpr uint32_t ADDRESS_BITS = sizeof(void *) == 8 ? 48 : 32;
+	static constexpr uint32_t INDEX_BITS = ADDRESS_BITS - SPAN_SHIFT;
+	static constexpr uint32_t LEAF_BITS = INDEX_BITS < 18 ? INDEX_BITS : 18;
+	static constexpr uint32_t ROOT_BITS = INDEX_BITS - LEAF_BITS;
+
+	struct Leaf {
+		std::atomic<uint8_t> entries[1 << LEAF_BITS];
+	};
+
+	std::atomic<Leaf *> root[1 << ROOT_BITS] = {};
+	BinaryMutex mutex;
+
+	_FORCE_INLINE_ uint32_t get(const void *p_memory) const {
+		const uintptr_t index = (uintptr_t)p_memory >> SPAN_SHIFT;
+		if (unlikely(index >> INDEX_BITS)) {
+			return 0;
+		}
+		const Leaf *leaf = root[index >> LEAF_BITS].load(std::memory_order_acquire);
+		if (!leaf) {
+			return 0;
+		}
+		return leaf->entries[index & ((1 << LEAF_BITS) - 1)].load(std::memory_order_relaxed);
+	}
+
+	bool set(const void *p_span, uint8_t p_value) {
+		const uintptr_t index = (uintptr_t)p_span >> SPAN_SHIFT;
+		if (unlikely(index >> INDEX_BITS)) {
+			return false;
+		}
+		std::atomic<Leaf *> &slot = root[index >> LEAF_BITS];
+		Leaf *leaf = slot.load(std::memory_order_acquire);
+		if (!leaf) {
+			MutexLock lock(mutex);
+			leaf = slot.load(std::memory_order_relaxed);
+			if (!leaf) {
+				void *mem = ::calloc(1, sizeof(Leaf));
+				if (unlikely(!mem)) {
+					return false;
+				}
+				leaf = memnew_placement(mem, Leaf);
+				slot.store(leaf, std::memory_order_release);
+			}
+		}
+		leaf->entries[index & ((1 << LEAF_BITS) - 1)].store(p_value, std::memory_order_relaxed);
+		return true;
+	}
+};
+
+static_assert(1 << SpanMap::SPAN_SHIFT == SizeClassAllocator::SPAN_SIZE);
+static_assert(SizeClassAllocator::SIZE_CLASS_COUNT < UINT8_MAX);
+
+struct CentralFreeList {
+	BinaryMutex mutex;
+	SpanHeader *available = nullptr; // Spans with free or uncarved blocks.
+	uint32_t available_count = 0;
+};
+
+struct ThreadCache {
+	struct Bin {
+		FreeBlock *head = nullptr;
+		uint32_t count = 0;
+	};
+
+	Bin bins[SizeClassAllocator::SIZE_CLASS_COUNT];
+
+	// Only written by the owning thread, read by get_stats().
+	std::atomic<int64_t> allocation_count = 0;
+	std::atomic<int64_t> tracked_usage = 0;
+
+	ThreadCache *prev = nullptr;
+	ThreadCache *next = nullptr;
+};
+
+struct ThreadCacheReleaser {
+	ThreadCache *cache = nullptr;
+	~ThreadCacheReleaser();
+};
+
+static SpanMap span_map;
+static CentralFreeList central_lists[SizeClassAllocator::SIZE_CLASS_COUNT];
+
+static BinaryMutex registry_mutex;
+static ThreadCache *registry_head = nullptr;
+static uint32_t registry_count = 0;
+
+// Counters of exited threads, and of frees done after a thread released its cache.
+static std::atomic<int64_t> retired_allocation_count = 0;
+static std::atomic<int64_t> retired_tracked_usage = 0;
+
+static std::atomic<uint64_t> span_bytes = 0;
+static std::atomic<uint64_t> large_bytes = 0;
+
+static thread_local ThreadCache *tls_cache = nullptr;
+static thread_local bool tls_cache_released = false;
+static thread_local ThreadCacheReleaser tls_cache_releaser;
+
+static SpanHeader *_create_span(uint32_t p_size_class) {
+	void *mem = nullptr;
+#ifdef _WIN32
+	mem = _aligned_malloc(SizeClassAllocator::SPAN_SIZE, SizeClassAllocator::SPAN_SIZE);
+#else
+	if (posix_memalign(&mem, SizeClassAllocator::SPAN_SIZE, SizeClassAllocator::SPAN_SIZE) != 0) {
+		mem = nullptr;
+	}
+#endif
+	if (unlikely(!mem)) {
+		return nullptr;
+	}
+
+	SpanHeader *span = memnew_placement(mem, SpanHeader);
+	span->carve_pos = (uint8_t *)mem + SizeClassAllocator::SPAN_HEADER_SIZE;
+	if (unlikely(!span_map.set(span, p_size_class + 1))) {
+#ifdef _WIN32
+		_aligned_free(mem);
+#else
+		::free(mem);
+#endif
+		return nullptr;
+	}
+	span_bytes.fetch_add(SizeClassAllocator::SPAN_SIZE, std::memory_order_relaxed);
+	return span;
+}
+
+static void _destroy_span(SpanHeader *p_span) {
+	span_map.set(p_span, 0);
+	span_bytes.fetch_sub(SizeClassAllocator::SPAN_SIZE, std::memory_order_relaxed);
+	p_span->~SpanHeader();
+#ifdef _WIN32
+	_aligned_free(p_span);
+#else
+	::free(p_span);
+#endif
+}
+
+static _FORCE_INLINE_ SpanHeader *_get_span(const void *p_memory) {
+	return (SpanHeader *)((uintptr_t)p_memory & ~(uintptr_t)(SizeClassAllocator::SPAN_SIZE - 1));
+}
+
+// Returns the size class of a block, or LARGE_SIZE_CLASS if it doesn't belong to a small span.
+static _FORCE_INLINE_ uint32_t _get_block_size_class(const void *p_memory) {
+	return span_map.get(p_memory) - 1; // Wraps to LARGE_SIZE_CLASS for unmapped ranges.
+}
+
+static _FORCE_INLINE_ LargeHeader *_get_large_header(const void *p_memory) {
+	return (LargeHeader *)((uint8_t *)p_memory - LARGE_HEADER_SIZE);
+}
+
+static _FORCE_INLINE_ uint32_t _get_batch_size(uint32_t p_size_class) {
+	// Move about 16 KiB at a time, at least 4 and at most 64 blocks.
+	return CLAMP(16384 / class_sizes[p_size_class], 4u, 64u);
+}
+
+static _FORCE_INLINE_ void _add_relaxed(std::atomic<int64_t> &r_counter, int64_t p_delta) {
+	r_counter.store(r_counter.load(std::memory_order_relaxed) + p_delta, std::memory_order_relaxed);
+}
+
+static ThreadCache *_create_thread_cache() {
+	if (tls_cache_released) {
+		// Thread-local destructors already ran on this thread.
+		return nullptr;
+	}
+
+	void *mem = ::malloc(sizeof(ThreadCache));
+	ERR_FAIL_NULL_V(mem, nullptr);
+	ThreadCache *cache = memnew_placement(mem, ThreadCache);
+
+	MutexLock lock(registry_mutex);
+	cache->next = registry_head;
+	if (registry_head) {
+		registry_head->prev = cache;
+	}
+	registry_head = cache;
+	registry_count++;
+
+	tls_cache = cache;
+	tls_cache_releaser.cache = cache;
+	return cache;
+}
+
+static _FORCE_INLINE_ ThreadCache *_get_thread_cache() {
+	ThreadCache *cache = tls_cache;
+	if (likely(cache)) {
+		return cache;
+	}
+	return _create_thread_cache();
+}
+
+static void _link_span(CentralFreeList &r_central, SpanHeader *p_span) {
+	p_span->prev = nullptr;
+	p_span->next = r_central.available;
+	if (r_central.available) {
+		r_central.available->prev = p_span;
+	}
+	r_central.available = p_span;
+	r_central.available_count++;
+	p_span->available = true;
+}
+
+static void _unlink_span(CentralFreeList &r_central, SpanHeader *p_span) {
+	if (p_span->prev) {
+		p_span->prev->next = p_span->next;
+	} else {
+		r_central.available = p_span->next;
+	}
+	if (p_span->next) {
+		p_span->next->prev = p_span->prev;
+	}
+	r_central.available_count--;
+	p_span->available = false;
+}
+
+// Fills a bin with up to one batch of blocks. Returns false if out of memory.
+static bool _refill_bin(ThreadCache::Bin &r_bin, uint32_t p_size_class, uint32_t p_count) {
+	CentralFreeList &central = central_lists[p_size_class];
+	const uint32_t block_size = class_sizes[p_size_class];
+
+	MutexLock lock(central.mutex);
+
+	while (r_bin.count < p_count) {
+		SpanHeader *span = central.available;
+		if (!span) {
+			if (r_bin.count > 0) {
+				// Don't start a new span for a partial batch.
+				break;
+			}
+			span = _create_span(p_size_class);
+			if (unlikely(!span)) {
+				return false;
+			}
+			_link_span(central, span);
+		}
+
+		const uint8_t *span_end = (const uint8_t *)span + SizeClassAllocator::SPAN_SIZE;
+		while (r_bin.count < p_count) {
+			FreeBlock *block;
+			if (span->free_list) {
+				block = span->free_list;
+				span->free_list = block->next;
+			} else if (span->carve_pos + block_size <= span_end) {
+				block = (FreeBlock *)span->carve_pos;
+				span->carve_pos += block_size;
+			} else {
+				break;
+			}
+			block->next = r_bin.head;
+			r_bin.head = block;
+			r_bin.count++;
+			span->used++;
+		}
+
+		if (!span->free_list && span->carve_pos + block_size > span_end) {
+			_unlink_span(central, span);
+		}
+	}
+
+	return true;
+}
+
+// Moves up to p_count blocks from a bin back to their spans. Spans left without used blocks are
+// returned to the system, except for one kept per size class so that alternating allocations and
+// frees don't create and destroy spans every time.
+static void _release_bin(ThreadCache::Bin &r_bin, uint32_t p_size_class, uint32_t p_count) {
+	FreeBlock *first = r_bin.head;
+	if (!first) {
+		return;
+	}
+	FreeBlock *last = first;
+	uint32_t moved = 1;
+	while (moved < p_count && last->next) {
+		last = last->next;
+		moved++;
+	}
+	r_bin.head = last->next;
+	r_bin.count -= moved;
+	last->next = nullptr;
+
+	CentralFreeList &central = central_lists[p_size_class];
+	MutexLock lock(central.mutex);
+	FreeBlock *block = first;
+	while (block) {
+		FreeBlock *next = block->next;
+		SpanHeader *span = _get_span(block);
+		block->next = span->free_list;
+		span->free_list = block;
+		span->used--;
+		if (!span->available) {
+			_link_span(central, span);
+		}
+		if (span->used == 0 && central.available_count > 1) {
+			_unlink_span(central, span);
+			_destroy_span(span);
+		}
+		block = next;
+	}
+}
+
+ThreadCacheReleaser::~ThreadCacheReleaser() {
+	if (!cache) {
+		return;
+	}
+
+	tls_cache = nullptr;
+	tls_cache_released = true;
+
+	for (uint32_t i = 0; i < SizeClassAllocator::SIZE_CLASS_COUNT; i++) {
+		_release_bin(cache->bins[i], i, UINT32_MAX);
+	}
+
+	MutexLock lock(registry_mutex);
+	if (cache->prev) {
+		cache->prev->next = cache->next;
+	} else {
+		registry_head = cache->next;
+	}
+	if (cache->next) {
+		cache->next->prev = cache->prev;
+	}
+	registry_count--;
+	retired_allocation_count.fetch_add(cache->allocation_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	retired_tracked_usage.fetch_add(cache->tracked_usage.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+	cache->~ThreadCache();
+	::free(cache);
+	cache = nullptr;
+}
+
+static void _count_allocations(ThreadCache *p_cache, int64_t p_delta) {
+	if (likely(p_cache)) {
+		_add_relaxed(p_cache->allocation_count, p_delta);
+	} else {
+		retired_allocation_count.fetch_add(p_delta, std::memory_order_relaxed);
+	}
+}
+
+static void *_alloc_large(size_t p_bytes) {
+	const size_t total = LARGE_HEADER_SIZE + p_bytes;
+	ERR_FAIL_COND_V(total < p_bytes, nullptr);
+
+	uint8_t *mem = (uint8_t *)::malloc(total);
+	if (unlikely(!mem)) {
+		return nullptr;
+	}
+	LargeHeader *header = memnew_placement(mem, LargeHeader);
+	header->capacity = p_bytes;
+	large_bytes.fetch_add(total, std::memory_order_relaxed);
+
+	_count_allocations(_get_thread_cache(), 1);
+	return mem + LARGE_HEADER_SIZE;
+}
+
+void *SizeClassAllocator::alloc(size_t p_bytes) {
+	if (unlikely(p_bytes > MAX_SMALL_SIZE)) {
+		return _alloc_large(p_bytes);
+	}
+
+	const uint32_t size_class = get_size_class(p_bytes);
+	ThreadCache *cache = _get_thread_cache();
+
+	if (unlikely(!cache)) {
+		// Late allocation while the thread exits, use the central list directly.
+		ThreadCache::Bin bin;
+		if (!_refill_bin(bin, size_class, 1)) {
+			return nullptr;
+		}
+		_count_allocations(nullptr, 1);
+		return bin.head;
+	}
+
+	ThreadCache::Bin &bin = cache->bins[size_class];
+	if (unlikely(!bin.head)) {
+		if (unlikely(!_refill_bin(bin, size_class, _get_batch_size(size_class)))) {
+			return nullptr;
+		}
+	}
+
+	FreeBlock *block = bin.head;
+	bin.head = block->next;
+	bin.count--;
+
+	_add_relaxed(cache->allocation_count, 1);
+	return block;
+}
+
+void SizeClassAllocator::free(void *p_memory) {
+	if (unlikely(!p_memory)) {
+		return;
+	}
+
+	ThreadCache *cache = _get_thread_cache();
+	_count_allocations(cache, -1);
+
+	const uint32_t size_class = _get_block_size_class(p_memory);
+	if (size_class == LARGE_SIZE_CLASS) {
+		LargeHeader *header = _get_large_header(p_memory);
+		large_bytes.fetch_sub(LARGE_HEADER_SIZE + header->capacity, std::memory_order_relaxed);
+		header->~LargeHeader();
+		::free(header);
+		return;
+	}
+
+	FreeBlock *block = (FreeBlock *)p_memory;
+
+	if (unlikely(!cache)) {
+		ThreadCache::Bin bin;
+		block->next = nullptr;
+		bin.head = block;
+		bin.count = 1;
+		_release_bin(bin, size_class, 1);
+		return;
+	}
+
+	ThreadCache::Bin &bin = cache->bins[size_class];
+	block->next = bin.head;
+	bin.head = block;
+	bin.count++;
+
+	const uint32_t batch = _get_batch_size(size_class);
+	if (unlikely(bin.count > batch * 2)) {
+		_release_bin(bin, size_class, batch);
+	}
+}
+
+void *SizeClassAllocator::realloc(void *p_memory, size_t p_bytes) {
+	if (!p_memory) {
+		return alloc(p_bytes);
+	}
+	if (p_bytes == 0) {
+		free(p_memory);
+		return nullptr;
+	}
+
+	const size_t usable = get_usable_size(p_memory);
+	if (p_bytes <= usable && p_bytes >= usable / 2) {
+		// Keep the block unless shrinking would free most of it.
+		return p_memory;
+	}
+
+	void *mem = alloc(p_bytes);
+	if (unlikely(!mem)) {
+		return nullptr;
+	}
+	memcpy(mem, p_memory, MIN(usable, p_bytes));
+	free(p_memory);
+	return mem;
+}
+
+size_t SizeClassAllocator::get_usable_size(const void *p_memory) {
+	const uint32_t size_class = _get_block_size_class(p_memory);
+	if (size_class == LARGE_SIZE_CLASS) {
+		return _get_large_header(p_memory)->capacity;
+	}
+	return class_sizes[size_class];
+}
+
+void SizeClassAllocator::track_usage(int64_t p_delta) {
+	ThreadCache *cache = _get_thread_cache();
+	if (likely(cache)) {
+		_add_relaxed(cache->tracked_usage, p_delta);
+	} else {
+		retired_tracked_usage.fetch_add(p_delta, std::memory_order_relaxed);
+	}
+}
+
+SizeClassAllocator::Stats SizeClassAllocator::get_stats() {
+	Stats stats;
+
+	MutexLock lock(registry_mutex);
+	int64_t allocation_count = retired_allocation_count.load(std::memory_order_relaxed);
+	int64_t tracked_usage = retired_tracked_usage.load(std::memory_order_relaxed);
+	for (const ThreadCache *cache = registry_head; cache; cache = cache->next) {
+		allocation_count += cache->allocation_count.load(std::memory_order_relaxed);
+		tracked_usage += cache->tracked_usage.load(std::memory_order_relaxed);
+	}
+	stats.thread_cache_count = registry_count;
+
+	// Counters of other threads may be slightly behind, don't report negative counts.
+	stats.allocation_count = MAX(allocation_count, 0);
+	stats.tracked_usage = tracked_usage;
+	stats.span_bytes = span_bytes.load(std::memory_order_relaxed);
+	stats.large_bytes = large_bytes.load(std::memory_order_relaxed);
+	return stats;
+}
+
+uint32_t SizeClassAllocator::get_size_class(size_t p_bytes) {
+	DEV_ASSERT(p_bytes <= MAX_SMALL_SIZE);
+	if (p_bytes <= 1024) {
+		return size_class_lookup.by_16[(p_bytes + 15) >> 4];
+	}
+	return size_class_lookup.by_128[(p_bytes + 127) >> 7];
+}
+
+size_t SizeClassAllocator::get_class_size(uint32_t p_size_class) {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_size_class, SIZE_CLASS_COUNT, 0);
+	return class_sizes[p_size_class];
+}
@@ -0,0 +1,72 @@
+/**************************************************************************/
+/*  size_class_allocator.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/typedefs.h"
+
+// Allocator backing Memory::alloc_static when built with `memory_allocator=size_class`.
+// It is always compiled, so tests and benchmarks can use it directly.
+//
+// Requests up to MAX_SMALL_SIZE bytes are rounded up to one of SIZE_CLASS_COUNT size
+// classes. Every thread keeps a free list per size class, and only takes the lock of
+// the central list of a class to move a batch of blocks in or out. Blocks are carved
+// from spans of SPAN_SIZE bytes, aligned to SPAN_SIZE and recorded in a map from address
+// to size class, so blocks need no header of their own. A span whose blocks have all been
+// given back is returned to the system. Larger requests go to malloc() with a small header.
+//
+// Allocation counters are kept per thread and only summed when read, see get_stats().
+class SizeClassAllocator {
+public:
+	static constexpr size_t SPAN_SIZE = 128 * 1024;
+	static constexpr size_t SPAN_HEADER_SIZE = 64;
+	static constexpr size_t MAX_SMALL_SIZE = 8192;
+	static constexpr uint32_t SIZE_CLASS_COUNT = 32;
+
+	struct Stats {
+		uint64_t allocation_count = 0; // Live allocations, small and large.
+		int64_t tracked_usage = 0; // Sum of track_usage() calls.
+		uint64_t span_bytes = 0; // Held in spans for small blocks.
+		uint64_t large_bytes = 0; // Allocated for large blocks, including headers.
+		uint32_t thread_cache_count = 0;
+	};
+
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_memory, size_t p_bytes);
+	static void free(void *p_memory);
+	static size_t get_usable_size(const void *p_memory);
+
+	// Adds to the usage counter of the calling thread.
+	static void track_usage(int64_t p_delta);
+	static Stats get_stats();
+
+	static uint32_t get_size_class(size_t p_bytes);
+	static size_t get_class_size(uint32_t p_size_class);
+};
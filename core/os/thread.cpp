@@ -96,6 +96,22 @@ Error Thread::set_name(const String &p_name) {
 	return ERR_UNAVAILABLE;
 }
 
+Error Thread::set_affinity(const Vector<int> &p_cpus) {
+	if (platform_functions.set_affinity) {
+		return platform_functions.set_affinity(p_cpus);
+	}
+
+	return ERR_UNAVAILABLE;
+}
+
+Error Thread::set_current_priority(Priority p_priority) {
+	if (platform_functions.set_current_priority) {
+		return platform_functions.set_current_priority(p_priority);
+	}
+
+	return ERR_UNAVAILABLE;
+}
+
 Thread::Thread() {
 }
 
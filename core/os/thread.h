@@ -60,6 +60,8 @@
 #endif
 
 class String;
+template <typename T>
+class Vector;
 
 class Thread {
 public:
@@ -89,6 +91,8 @@ public:
 		void (*init)() = nullptr;
 		void (*wrapper)(Thread::Callback, void *) = nullptr;
 		void (*term)() = nullptr;
+		Error (*set_affinity)(const Vector<int> &) = nullptr;
+		Error (*set_current_priority)(Thread::Priority) = nullptr;
 	};
 
 #if defined(__cpp_lib_hardware_interference_size) && !defined(ANDROID_ENABLED) // This would be OK with NDK >= 26.
@@ -135,6 +139,11 @@ public:
 	_FORCE_INLINE_ static bool is_main_thread() { return caller_id == MAIN_ID; } // Gain a tiny bit of perf here because there is no need to validate caller_id here, because only main thread will be set as 1.
 
 	static Error set_name(const String &p_name);
+	// Restricts the calling thread to the given logical CPUs.
+	static Error set_affinity(const Vector<int> &p_cpus);
+	// Changes the scheduling priority of the calling thread. Unlike Settings::priority, this is
+	// implemented on Linux and Windows, and only affects the threads that call it.
+	static Error set_current_priority(Priority p_priority);
 
 	ID start(Thread::Callback p_callback, void *p_user, const Settings &p_settings = Settings());
 	bool is_started() const;
@@ -148,6 +157,8 @@ public:
 #else // No threads.
 
 class String;
+template <typename T>
+class Vector;
 
 class Thread {
 public:
@@ -179,6 +190,8 @@ public:
 		void (*init)() = nullptr;
 		void (*wrapper)(Thread::Callback, void *) = nullptr;
 		void (*term)() = nullptr;
+		Error (*set_affinity)(const Vector<int> &) = nullptr;
+		Error (*set_current_priority)(Thread::Priority) = nullptr;
 	};
 
 private:
@@ -199,6 +212,8 @@ public:
 	_FORCE_INLINE_ static bool is_main_thread() { return true; }
 
 	static Error set_name(const String &p_name) { return ERR_UNAVAILABLE; }
+	static Error set_affinity(const Vector<int> &p_cpus) { return ERR_UNAVAILABLE; }
+	static Error set_current_priority(Priority p_priority) { return ERR_UNAVAILABLE; }
 
 	void start(Thread::Callback p_callback, void *p_user, const Settings &p_settings = Settings()) {}
 	bool is_started() const { return false; }
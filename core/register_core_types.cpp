@@ -310,6 +310,10 @@ void register_core_settings() {
 
 	GLOBAL_DEF("threading/worker_pool/max_threads", -1);
 	GLOBAL_DEF("threading/worker_pool/low_priority_thread_ratio", 0.3);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "threading/worker_pool/thread_priority", PROPERTY_HINT_ENUM, "Low,Normal,High"), 1);
+	GLOBAL_DEF("threading/worker_pool/cpu_affinity", "");
+	GLOBAL_DEF("threading/worker_pool/pin_threads", false);
+	GLOBAL_DEF("threading/worker_pool/measure_task_times", false);
 }
 
 void register_early_core_singletons() {
@@ -67,6 +67,30 @@ StringName _scs_create(const char *p_chr, bool p_static) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr), p_static) : StringName());
 }
 
+struct StringName::ThreadCache {
+	_Data *entries[THREAD_CACHE_LEN] = {};
+
+	void clear() {
+		for (_Data *&data : entries) {
+			if (data) {
+				_Data *released = data;
+				data = nullptr;
+				released->static_count.decrement();
+				StringName(released).unref();
+			}
+		}
+	}
+
+	~ThreadCache() {
+		// Names are destroyed in bulk on cleanup, don't touch them afterwards.
+		if (configured) {
+			clear();
+		}
+	}
+};
+
+thread_local StringName::ThreadCache StringName::thread_cache;
+
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
@@ -76,6 +100,9 @@ void StringName::setup() {
 }
 
 void StringName::cleanup() {
+	// Other threads are done by now, release the names this one cached.
+	thread_cache.clear();
+
 	MutexLock lock(mutex);
 
 #ifdef DEBUG_ENABLED
@@ -135,7 +162,7 @@ void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
+		MutexLock lock(_get_bucket_lock(_data->idx));
 
 		if (CoreGlobals::leak_reporting_enabled && _data->static_count.get() > 0) {
 			if (_data->cname) {
@@ -260,177 +287,153 @@ void StringName::assign_static_unique_class_name(StringName *ptr, const char *p_
 	}
 }
 
-StringName::StringName(const char *p_name, bool p_static) {
-	_data = nullptr;
-
-	ERR_FAIL_COND(!configured);
-
-	if (!p_name || p_name[0] == 0) {
-		return; //empty, ignore
+template <typename T>
+StringName::_Data *StringName::_thread_cache_find(uint32_t p_hash, const T &p_name) {
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		return nullptr; // Reference counting must go through the table.
 	}
+#endif
 
-	const uint32_t hash = String::hash(p_name);
-	const uint32_t idx = hash & STRING_TABLE_MASK;
-
-	MutexLock lock(mutex);
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->operator==(p_name)) {
-			break;
-		}
-		_data = _data->next;
+	_Data *data = thread_cache.entries[p_hash & THREAD_CACHE_MASK];
+	if (data && data->hash == p_hash && data->operator==(p_name)) {
+		// Can't fail, the cache holds a reference.
+		data->refcount.ref();
+		return data;
 	}
+	return nullptr;
+}
 
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
+void StringName::_thread_cache_store(_Data *p_data) {
 #ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
+	if (unlikely(debug_stringname)) {
+		return;
+	}
 #endif
+
+	_Data *&entry = thread_cache.entries[p_data->hash & THREAD_CACHE_MASK];
+	if (entry == p_data) {
 		return;
 	}
 
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
+	// The cached reference is counted as static too, so it is not reported as leaked.
+	p_data->refcount.ref();
+	p_data->static_count.increment();
 
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
+	_Data *evicted = entry;
+	entry = p_data;
+	if (evicted) {
+		evicted->static_count.decrement();
+		StringName(evicted).unref();
 	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
 }
 
-StringName::StringName(const StaticCString &p_static_string, bool p_static) {
-	_data = nullptr;
-
-	ERR_FAIL_COND(!configured);
-
-	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
+template <typename T>
+StringName::_Data *StringName::_find_in_bucket(uint32_t p_idx, uint32_t p_hash, const T &p_name) {
+	_Data *data = _table[p_idx];
 
-	const uint32_t hash = String::hash(p_static_string.ptr);
-	const uint32_t idx = hash & STRING_TABLE_MASK;
-
-	MutexLock lock(mutex);
-	_data = _table[idx];
-
-	while (_data) {
+	while (data) {
 		// compare hash first
-		if (_data->hash == hash && _data->operator==(p_static_string.ptr)) {
+		if (data->hash == p_hash && data->operator==(p_name)) {
 			break;
 		}
-		_data = _data->next;
+		data = data->next;
 	}
 
-	if (_data && _data->refcount.ref()) {
-		// exists
+	return data;
+}
+
+template <typename T>
+StringName::_Data *StringName::_intern(uint32_t p_hash, const T &p_name, const char *p_cname, bool p_static) {
+	_Data *data = _thread_cache_find(p_hash, p_name);
+	if (data) {
 		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
+			data->static_count.increment();
 		}
-#endif
-		return;
+		return data;
 	}
 
-	_data = memnew(_Data);
+	const uint32_t idx = p_hash & STRING_TABLE_MASK;
+
+	{
+		MutexLock lock(_get_bucket_lock(idx));
+		data = _find_in_bucket(idx, p_hash, p_name);
 
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
+		if (data && data->refcount.ref()) {
+			// exists
+			if (p_static) {
+				data->static_count.increment();
+			}
 #ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
+			if (unlikely(debug_stringname)) {
+				data->debug_references++;
+			}
 #endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
+		} else {
+			data = memnew(_Data);
+			if (p_cname) {
+				data->cname = p_cname;
+			} else {
+				data->name = p_name;
+			}
+			data->refcount.init();
+			data->static_count.set(p_static ? 1 : 0);
+			data->hash = p_hash;
+			data->idx = idx;
+			data->next = _table[idx];
+			data->prev = nullptr;
+
+#ifdef DEBUG_ENABLED
+			if (unlikely(debug_stringname)) {
+				// Keep in memory, force static.
+				data->refcount.ref();
+				data->static_count.increment();
+			}
+#endif
+			if (_table[idx]) {
+				_table[idx]->prev = data;
+			}
+			_table[idx] = data;
+		}
 	}
-	_table[idx] = _data;
+
+	// Outside of the lock, storing may release an evicted name.
+	_thread_cache_store(data);
+	return data;
 }
 
-StringName::StringName(const String &p_name, bool p_static) {
+StringName::StringName(const char *p_name, bool p_static) {
 	_data = nullptr;
 
 	ERR_FAIL_COND(!configured);
 
-	if (p_name.is_empty()) {
-		return;
+	if (!p_name || p_name[0] == 0) {
+		return; //empty, ignore
 	}
 
-	const uint32_t hash = p_name.hash();
-	const uint32_t idx = hash & STRING_TABLE_MASK;
+	_data = _intern(String::hash(p_name), p_name, nullptr, p_static);
+}
 
-	MutexLock lock(mutex);
-	_data = _table[idx];
+StringName::StringName(const StaticCString &p_static_string, bool p_static) {
+	_data = nullptr;
 
-	while (_data) {
-		if (_data->hash == hash && _data->operator==(p_name)) {
-			break;
-		}
-		_data = _data->next;
-	}
+	ERR_FAIL_COND(!configured);
 
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return;
-	}
+	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
+	_data = _intern(String::hash(p_static_string.ptr), p_static_string.ptr, p_static_string.ptr, p_static);
+}
 
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
+StringName::StringName(const String &p_name, bool p_static) {
+	_data = nullptr;
+
+	ERR_FAIL_COND(!configured);
+
+	if (p_name.is_empty()) {
+		return;
 	}
-	_table[idx] = _data;
+
+	_data = _intern(p_name.hash(), p_name, nullptr, p_static);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -442,18 +445,15 @@ StringName StringName::search(const char *p_name) {
 	}
 
 	const uint32_t hash = String::hash(p_name);
+	_Data *_data = _thread_cache_find(hash, p_name);
+	if (_data) {
+		return StringName(_data);
+	}
+
 	const uint32_t idx = hash & STRING_TABLE_MASK;
 
-	MutexLock lock(mutex);
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->operator==(p_name)) {
-			break;
-		}
-		_data = _data->next;
-	}
+	MutexLock lock(_get_bucket_lock(idx));
+	_data = _find_in_bucket(idx, hash, p_name);
 
 	if (_data && _data->refcount.ref()) {
 #ifdef DEBUG_ENABLED
@@ -476,43 +476,22 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	const uint32_t hash = String::hash(p_name);
-	const uint32_t idx = hash & STRING_TABLE_MASK;
-
-	MutexLock lock(mutex);
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->operator==(p_name)) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
-	}
-
-	return StringName(); //does not exist
+	return search(String(p_name));
 }
 
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name.is_empty(), StringName());
 
 	const uint32_t hash = p_name.hash();
-	const uint32_t idx = hash & STRING_TABLE_MASK;
+	_Data *_data = _thread_cache_find(hash, p_name);
+	if (_data) {
+		return StringName(_data);
+	}
 
-	MutexLock lock(mutex);
-	_Data *_data = _table[idx];
+	const uint32_t idx = hash & STRING_TABLE_MASK;
 
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->operator==(p_name)) {
-			break;
-		}
-		_data = _data->next;
-	}
+	MutexLock lock(_get_bucket_lock(idx));
+	_data = _find_in_bucket(idx, hash, p_name);
 
 	if (_data && _data->refcount.ref()) {
 #ifdef DEBUG_ENABLED
@@ -47,7 +47,16 @@ class StringName {
 	enum {
 		STRING_TABLE_BITS = 16,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		// Buckets are guarded by striped locks, so threads interning
+		// unrelated names do not serialize on a single mutex.
+		LOCK_STRIPE_BITS = 6,
+		LOCK_STRIPE_COUNT = 1 << LOCK_STRIPE_BITS,
+		LOCK_STRIPE_MASK = LOCK_STRIPE_COUNT - 1,
+		// Each thread keeps a reference to the names it interned recently,
+		// which can be found again without taking any lock.
+		THREAD_CACHE_LEN = 64,
+		THREAD_CACHE_MASK = THREAD_CACHE_LEN - 1,
 	};
 
 	struct _Data {
@@ -73,6 +82,28 @@ class StringName {
 
 	static inline _Data *_table[STRING_TABLE_LEN];
 
+	struct alignas(64) LockStripe {
+		BinaryMutex mutex;
+	};
+
+	static inline LockStripe lock_stripes[LOCK_STRIPE_COUNT];
+
+	_FORCE_INLINE_ static BinaryMutex &_get_bucket_lock(uint32_t p_idx) {
+		return lock_stripes[p_idx & LOCK_STRIPE_MASK].mutex;
+	}
+
+	struct ThreadCache;
+	static thread_local ThreadCache thread_cache;
+
+	template <typename T>
+	static _Data *_thread_cache_find(uint32_t p_hash, const T &p_name);
+	static void _thread_cache_store(_Data *p_data);
+
+	template <typename T>
+	static _Data *_find_in_bucket(uint32_t p_idx, uint32_t p_hash, const T &p_name);
+	template <typename T>
+	static _Data *_intern(uint32_t p_hash, const T &p_name, const char *p_cname, bool p_static);
+
 	_Data *_data = nullptr;
 
 	void unref();
@@ -299,12 +299,36 @@ Error String::parse_url(String &r_scheme, String &r_host, int &r_port, String &r
 	return OK;
 }
 
+char32_t *String::_get_static_char(char32_t p_char) {
+	struct alignas(max_align_t) Buffer {
+		uint8_t memory[CowData<char32_t>::_get_static_buffer_size(2)];
+	};
+	static Buffer buffers[STATIC_CHAR_COUNT];
+	static const bool initialized = []() {
+		for (char32_t c = 1; c < STATIC_CHAR_COUNT; c++) {
+			char32_t *data = CowData<char32_t>::_init_static_buffer(buffers[c].memory, 2);
+			data[0] = c;
+			data[1] = 0;
+		}
+		return true;
+	}();
+	(void)initialized;
+
+	DEV_ASSERT(p_char > 0 && p_char < STATIC_CHAR_COUNT);
+	return reinterpret_cast<char32_t *>(buffers[p_char].memory + CowData<char32_t>::DATA_OFFSET);
+}
+
 void String::parse_latin1(const StrRange<char> &p_cstr) {
 	if (p_cstr.len == 0) {
 		resize(0);
 		return;
 	}
 
+	if (p_cstr.len == 1 && *p_cstr.c_str != 0) {
+		_cowdata._ref_static(_get_static_char(static_cast<uint8_t>(*p_cstr.c_str)));
+		return;
+	}
+
 	resize(p_cstr.len + 1); // include 0
 
 	const char *src = p_cstr.c_str;
@@ -333,6 +357,11 @@ void String::parse_utf32(const char32_t &p_char) {
 		return;
 	}
 
+	if (p_char < STATIC_CHAR_COUNT) {
+		_cowdata._ref_static(_get_static_char(p_char));
+		return;
+	}
+
 	resize(2);
 
 	char32_t *dst = ptrw();
@@ -355,6 +384,11 @@ void String::parse_utf32(const char32_t &p_char) {
 // p_length > 0
 // p_length <= p_char strlen
 void String::copy_from_unchecked(const char32_t *p_char, const int p_length) {
+	if (p_length == 1 && *p_char != 0 && *p_char < STATIC_CHAR_COUNT) {
+		_cowdata._ref_static(_get_static_char(*p_char));
+		return;
+	}
+
 	resize(p_length + 1);
 
 	const char32_t *end = p_char + p_length;
@@ -1594,6 +1628,11 @@ String String::to_lower() const {
 }
 
 String String::chr(char32_t p_char) {
+	if (p_char > 0 && p_char < STATIC_CHAR_COUNT) {
+		String string;
+		string._cowdata._ref_static(_get_static_char(p_char));
+		return string;
+	}
 	char32_t c[2] = { p_char, 0 };
 	return String(c);
 }
@@ -265,6 +265,13 @@ class String {
 	static const char32_t _null;
 	static const char32_t _replacement_char;
 
+	// String has to stay a single pointer, as Variant stores it inline and GDExtension bindings rely on
+	// its size, so short strings can't be stored inline (that space holds two UTF-32 code points).
+	// Instead, one character strings in the Latin-1 range share static buffers rather than allocating
+	// their own, indexing and iterating over strings creates plenty of them.
+	static constexpr char32_t STATIC_CHAR_COUNT = 256;
+	static char32_t *_get_static_char(char32_t p_char);
+
 	// Known-length copy.
 	void parse_latin1(const StrRange<char> &p_cstr);
 	void parse_utf32(const StrRange<char32_t> &p_cstr);
@@ -101,6 +101,10 @@ private:
 	static constexpr size_t SIZE_OFFSET = ((REF_COUNT_OFFSET + sizeof(SafeNumeric<USize>)) % alignof(USize) == 0) ? (REF_COUNT_OFFSET + sizeof(SafeNumeric<USize>)) : ((REF_COUNT_OFFSET + sizeof(SafeNumeric<USize>)) + alignof(USize) - ((REF_COUNT_OFFSET + sizeof(SafeNumeric<USize>)) % alignof(USize)));
 	static constexpr size_t DATA_OFFSET = ((SIZE_OFFSET + sizeof(USize)) % alignof(max_align_t) == 0) ? (SIZE_OFFSET + sizeof(USize)) : ((SIZE_OFFSET + sizeof(USize)) + alignof(max_align_t) - ((SIZE_OFFSET + sizeof(USize)) % alignof(max_align_t)));
 
+	// Buffers with this reference count live in static memory. They are shared without ever being
+	// counted or freed, and copied on the first write like any other shared buffer.
+	static constexpr USize STATIC_REFCOUNT = USize(1) << (sizeof(USize) * 8 - 2);
+
 	mutable T *_ptr = nullptr;
 
 	// internal helpers
@@ -161,6 +165,21 @@ private:
 		return *out;
 	}
 
+	// Lays out a static buffer of `p_size` elements in `p_memory`, which must hold `_get_static_buffer_size(p_size)` bytes.
+	// The elements are left to the caller to construct.
+	static constexpr size_t _get_static_buffer_size(USize p_size) {
+		return DATA_OFFSET + p_size * sizeof(T);
+	}
+	static T *_init_static_buffer(uint8_t *p_memory, USize p_size) {
+		new (_get_refcount_ptr(p_memory)) SafeNumeric<USize>(STATIC_REFCOUNT);
+		*_get_size_ptr(p_memory) = p_size;
+		return _get_data_ptr(p_memory);
+	}
+	void _ref_static(T *p_data) {
+		_unref();
+		_ptr = p_data;
+	}
+
 	// Decrements the reference count. Deallocates the backing buffer if needed.
 	// After this function, _ptr is guaranteed to be NULL.
 	void _unref();
@@ -276,7 +295,7 @@ void CowData<T>::_unref() {
 	}
 
 	SafeNumeric<USize> *refc = _get_refcount();
-	if (refc->decrement() > 0) {
+	if (refc->get() == STATIC_REFCOUNT || refc->decrement() > 0) {
 		// Data is still in use elsewhere.
 		_ptr = nullptr;
 		return;
@@ -505,7 +524,8 @@ void CowData<T>::_ref(const CowData &p_from) {
 		return; //nothing to do
 	}
 
-	if (p_from._get_refcount()->conditional_increment() > 0) { // could reference
+	SafeNumeric<USize> *refc = p_from._get_refcount();
+	if (refc->get() == STATIC_REFCOUNT || refc->conditional_increment() > 0) { // could reference
 		_ptr = p_from._ptr;
 	}
 }
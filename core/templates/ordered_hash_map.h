@@ -0,0 +1,710 @@
+/**************************************************************************/
+/*  ordered_hash_map.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/templates/hash_map.h"
+
+#include <initializer_list>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+/**
+ * A compact insertion-ordered hash map, laid out like the CPython dict.
+ *
+ * Keys and values are stored in a dense entries array, together with their
+ * cached hash. The insertion order is kept in a separate array of 32-bit
+ * entry indices. An open addressing table of entry indices (linear probing,
+ * backward shift deletion) is used for lookups once the map holds more than
+ * MAX_LINEAR_ENTRIES entries; smaller maps are simply scanned.
+ *
+ * Entries are stored in segments that double in size, starting with
+ * MIN_CAPACITY entries. Nothing is allocated until the first insertion.
+ *
+ * Entries never move: pointers and references to keys and values stay valid
+ * until their own key is erased or the map is cleared, as with HashMap. This
+ * holds across insertions, erasures and sort(). Erasing frees the entry for
+ * reuse and leaves a hole in the order array, which iteration skips. Once
+ * holes outnumber the elements the order array is compacted, which only
+ * moves indices. Iterators point to entries too, so they also stay valid.
+ *
+ * The assignment operator copies the pairs from one map to the other.
+ */
+template <typename TKey, typename TValue,
+		typename Hasher = HashMapHasherDefault,
+		typename Comparator = HashMapComparatorDefault<TKey>>
+class OrderedHashMap {
+public:
+	// Maps up to this size are looked up with a linear scan.
+	static constexpr uint32_t MAX_LINEAR_ENTRIES = 8;
+	// Must be a power of two.
+	static constexpr uint32_t MIN_INDEX_CAPACITY = 16;
+	// Size of the first segment. Must be a power of two.
+	static constexpr uint32_t MIN_CAPACITY = 4;
+	// Marks erased entries.
+	static constexpr uint32_t DEAD_HASH = 0;
+
+private:
+	typedef KeyValue<TKey, TValue> MapKeyValue;
+
+	struct Entry {
+		uint32_t hash;
+		// Position in the order array, or the next free entry once erased.
+		uint32_t order_pos;
+		MapKeyValue data;
+	};
+
+	struct IndexSlot {
+		uint32_t hash;
+		uint32_t entry;
+	};
+
+	static constexpr uint32_t INVALID_ENTRY = UINT32_MAX;
+
+	static constexpr uint32_t _shift_of(uint32_t p_value) {
+		return p_value <= 1 ? 0 : 1 + _shift_of(p_value >> 1);
+	}
+
+	static constexpr uint32_t MIN_SHIFT = _shift_of(MIN_CAPACITY);
+	// Segment N holds `MIN_CAPACITY << N` entries, starting at entry `(MIN_CAPACITY << N) - MIN_CAPACITY`.
+	static constexpr uint32_t MAX_SEGMENTS = 31 - MIN_SHIFT;
+
+	Entry **segments = nullptr;
+	IndexSlot *index = nullptr;
+	// Entry indices in insertion order, INVALID_ENTRY for erased ones.
+	uint32_t *order = nullptr;
+
+	uint32_t index_mask = 0;
+	uint32_t index_shift = 0;
+	uint32_t capacity = 0;
+	// Entries handed out so far, including free ones.
+	uint32_t used = 0;
+	uint32_t free_entry = INVALID_ENTRY;
+	uint32_t order_capacity = 0;
+	// Order array positions in use, including holes.
+	uint32_t order_used = 0;
+	uint32_t num_elements = 0;
+
+	static _FORCE_INLINE_ uint32_t _log2(uint32_t p_value) {
+#if defined(__GNUC__) || defined(__clang__)
+		return 31 - __builtin_clz(p_value);
+#elif defined(_MSC_VER)
+		unsigned long bit;
+		_BitScanReverse(&bit, p_value);
+		return bit;
+#else
+		uint32_t bit = 0;
+		while (p_value >>= 1) {
+			bit++;
+		}
+		return bit;
+#endif
+	}
+
+	_FORCE_INLINE_ Entry *_get_entry(uint32_t p_entry) const {
+		const uint32_t offset = p_entry + MIN_CAPACITY;
+		const uint32_t segment = _log2(offset) - MIN_SHIFT;
+		return segments[segment] + (offset - (MIN_CAPACITY << segment));
+	}
+
+	_FORCE_INLINE_ uint32_t _hash(const TKey &p_key) const {
+		uint32_t hash = Hasher::hash(p_key);
+
+		if (unlikely(hash == DEAD_HASH)) {
+			hash = DEAD_HASH + 1;
+		}
+
+		return hash;
+	}
+
+	_FORCE_INLINE_ uint32_t _index_pos(uint32_t p_hash) const {
+		// Fibonacci hashing, so weak low bits in the hash do not cluster.
+		return (p_hash * 2654435769u) >> index_shift;
+	}
+
+	uint32_t _find_entry(const TKey &p_key, uint32_t p_hash) const {
+		if (index == nullptr) {
+			for (uint32_t i = 0; i < used; i++) {
+				const Entry *e = _get_entry(i);
+				if (e->hash == p_hash && Comparator::compare(e->data.key, p_key)) {
+					return i;
+				}
+			}
+			return INVALID_ENTRY;
+		}
+
+		uint32_t pos = _index_pos(p_hash);
+		while (true) {
+			const IndexSlot &slot = index[pos];
+			if (slot.entry == INVALID_ENTRY) {
+				return INVALID_ENTRY;
+			}
+			if (slot.hash == p_hash && Comparator::compare(_get_entry(slot.entry)->data.key, p_key)) {
+				return slot.entry;
+			}
+			pos = (pos + 1) & index_mask;
+		}
+	}
+
+	uint32_t _find_entry(const TKey &p_key) const {
+		if (num_elements == 0) {
+			return INVALID_ENTRY;
+		}
+		return _find_entry(p_key, _hash(p_key));
+	}
+
+	// Returns the first entry at or after the given order position.
+	_FORCE_INLINE_ uint32_t _next_in_order(uint32_t p_order_pos) const {
+		for (uint32_t i = p_order_pos; i < order_used; i++) {
+			if (order[i] != INVALID_ENTRY) {
+				return order[i];
+			}
+		}
+		return INVALID_ENTRY;
+	}
+
+	// Returns the last entry before the given order position.
+	_FORCE_INLINE_ uint32_t _prev_in_order(uint32_t p_order_pos) const {
+		for (uint32_t i = MIN(p_order_pos, order_used); i > 0; i--) {
+			if (order[i - 1] != INVALID_ENTRY) {
+				return order[i - 1];
+			}
+		}
+		return INVALID_ENTRY;
+	}
+
+	void _index_insert(uint32_t p_hash, uint32_t p_entry) {
+		uint32_t pos = _index_pos(p_hash);
+		while (index[pos].entry != INVALID_ENTRY) {
+			pos = (pos + 1) & index_mask;
+		}
+		index[pos].hash = p_hash;
+		index[pos].entry = p_entry;
+	}
+
+	void _index_remove(uint32_t p_hash, uint32_t p_entry) {
+		uint32_t pos = _index_pos(p_hash);
+		while (index[pos].entry != p_entry) {
+			pos = (pos + 1) & index_mask;
+		}
+
+		// Backward shift deletion: pull back every following slot that would
+		// otherwise become unreachable from its ideal position.
+		uint32_t next_pos = (pos + 1) & index_mask;
+		while (index[next_pos].entry != INVALID_ENTRY) {
+			const uint32_t ideal = _index_pos(index[next_pos].hash);
+			if (((next_pos - ideal) & index_mask) >= ((next_pos - pos) & index_mask)) {
+				index[pos] = index[next_pos];
+				pos = next_pos;
+			}
+			next_pos = (next_pos + 1) & index_mask;
+		}
+		index[pos].entry = INVALID_ENTRY;
+	}
+
+	void _rebuild_index(uint32_t p_min_elements) {
+		// Keep the load factor under 2/3.
+		uint32_t new_capacity = MIN_INDEX_CAPACITY;
+		while (new_capacity * 2 < p_min_elements * 3) {
+			new_capacity <<= 1;
+		}
+
+		if (index == nullptr || new_capacity != index_mask + 1) {
+			if (index != nullptr) {
+				Memory::free_static(index);
+			}
+			index = reinterpret_cast<IndexSlot *>(Memory::alloc_static(sizeof(IndexSlot) * new_capacity));
+			index_mask = new_capacity - 1;
+			index_shift = 32 - _log2(new_capacity);
+		}
+
+		// INVALID_ENTRY is all bits set.
+		memset(index, 0xFF, sizeof(IndexSlot) * (index_mask + 1));
+		for (uint32_t i = 0; i < used; i++) {
+			const Entry *e = _get_entry(i);
+			if (e->hash != DEAD_HASH) {
+				_index_insert(e->hash, i);
+			}
+		}
+	}
+
+	void _add_segment() {
+		if (segments == nullptr) {
+			segments = reinterpret_cast<Entry **>(Memory::alloc_static(sizeof(Entry *) * MAX_SEGMENTS));
+		}
+		const uint32_t segment = _log2(capacity + MIN_CAPACITY) - MIN_SHIFT;
+		CRASH_COND_MSG(segment >= MAX_SEGMENTS, "OrderedHashMap is full.");
+		const uint32_t segment_capacity = MIN_CAPACITY << segment;
+		segments[segment] = reinterpret_cast<Entry *>(Memory::alloc_static(sizeof(Entry) * segment_capacity));
+		capacity += segment_capacity;
+	}
+
+	void _reserve_order(uint32_t p_capacity) {
+		if (p_capacity <= order_capacity) {
+			return;
+		}
+		order = reinterpret_cast<uint32_t *>(Memory::realloc_static(order, sizeof(uint32_t) * p_capacity));
+		order_capacity = p_capacity;
+	}
+
+	// Closes the holes left in the order array by erase(). Entries do not move.
+	void _compact_order() {
+		uint32_t to = 0;
+		for (uint32_t from = 0; from < order_used; from++) {
+			const uint32_t entry = order[from];
+			if (entry == INVALID_ENTRY) {
+				continue;
+			}
+			order[to] = entry;
+			_get_entry(entry)->order_pos = to;
+			to++;
+		}
+		order_used = to;
+	}
+
+	uint32_t _insert(const TKey &p_key, const TValue &p_value, uint32_t p_hash) {
+		uint32_t pos;
+		if (free_entry != INVALID_ENTRY) {
+			pos = free_entry;
+			free_entry = _get_entry(pos)->order_pos;
+		} else {
+			if (unlikely(used == capacity)) {
+				_add_segment();
+			}
+			pos = used++;
+		}
+
+		if (unlikely(order_used == order_capacity)) {
+			_reserve_order(MAX(MIN_CAPACITY, order_capacity * 2));
+		}
+
+		Entry *e = _get_entry(pos);
+		memnew_placement(&e->data, MapKeyValue(p_key, p_value));
+		e->hash = p_hash;
+		e->order_pos = order_used;
+		order[order_used++] = pos;
+		num_elements++;
+
+		if (index != nullptr) {
+			if (num_elements * 3 > (index_mask + 1) * 2) {
+				_rebuild_index(num_elements);
+			} else {
+				_index_insert(p_hash, pos);
+			}
+		} else if (used > MAX_LINEAR_ENTRIES) {
+			_rebuild_index(num_elements);
+		}
+
+		return pos;
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	_FORCE_INLINE_ bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		for (uint32_t i = 0; i < used; i++) {
+			Entry *e = _get_entry(i);
+			if (e->hash != DEAD_HASH) {
+				e->data.~MapKeyValue();
+			}
+		}
+		used = 0;
+		free_entry = INVALID_ENTRY;
+		order_used = 0;
+		num_elements = 0;
+
+		if (index != nullptr) {
+			Memory::free_static(index);
+			index = nullptr;
+			index_mask = 0;
+			index_shift = 0;
+		}
+	}
+
+	// Sorts the elements by key, using Variant's `<` operator. Like
+	// HashMap::sort(), this is only meant to be used with Variant keys.
+	// Only the order array is rearranged, the entries stay in place.
+	void sort() {
+		if (num_elements < 2) {
+			return; // An empty or single element map is already sorted.
+		}
+
+		if (order_used != num_elements) {
+			_compact_order();
+		}
+
+		// Use insertion sort because we want this operation to be fast for the
+		// common case where the input is already sorted or nearly sorted.
+		bool sorted = true;
+		for (uint32_t i = 1; i < order_used; i++) {
+			const uint32_t inserting = order[i];
+			const TKey &key = _get_entry(inserting)->data.key;
+			uint32_t j = i;
+			while (j > 0 && _hashmap_variant_less_than(key, _get_entry(order[j - 1])->data.key)) {
+				order[j] = order[j - 1];
+				j--;
+			}
+			order[j] = inserting;
+			sorted = sorted && j == i;
+		}
+
+		if (!sorted) {
+			for (uint32_t i = 0; i < order_used; i++) {
+				_get_entry(order[i])->order_pos = i;
+			}
+		}
+	}
+
+	TValue &get(const TKey &p_key) {
+		const uint32_t pos = _find_entry(p_key);
+		CRASH_COND_MSG(pos == INVALID_ENTRY, "OrderedHashMap key not found.");
+		return _get_entry(pos)->data.value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		const uint32_t pos = _find_entry(p_key);
+		CRASH_COND_MSG(pos == INVALID_ENTRY, "OrderedHashMap key not found.");
+		return _get_entry(pos)->data.value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		const uint32_t pos = _find_entry(p_key);
+		if (pos == INVALID_ENTRY) {
+			return nullptr;
+		}
+		return &_get_entry(pos)->data.value;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		const uint32_t pos = _find_entry(p_key);
+		if (pos == INVALID_ENTRY) {
+			return nullptr;
+		}
+		return &_get_entry(pos)->data.value;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		return _find_entry(p_key) != INVALID_ENTRY;
+	}
+
+	bool erase(const TKey &p_key) {
+		if (num_elements == 0) {
+			return false;
+		}
+
+		const uint32_t hash = _hash(p_key);
+		const uint32_t pos = _find_entry(p_key, hash);
+		if (pos == INVALID_ENTRY) {
+			return false;
+		}
+
+		if (index != nullptr) {
+			_index_remove(hash, pos);
+		}
+
+		Entry *e = _get_entry(pos);
+		e->data.~MapKeyValue();
+		order[e->order_pos] = INVALID_ENTRY;
+		e->hash = DEAD_HASH;
+		e->order_pos = free_entry;
+		free_entry = pos;
+		num_elements--;
+
+		if (num_elements == 0) {
+			// Every entry is free, start over so small maps scan few entries.
+			used = 0;
+			free_entry = INVALID_ENTRY;
+			order_used = 0;
+			return true;
+		}
+
+		// Trailing holes can be reused right away.
+		while (order[order_used - 1] == INVALID_ENTRY) {
+			order_used--;
+		}
+
+		if (order_used > MAX_LINEAR_ENTRIES && order_used - num_elements > num_elements) {
+			_compact_order();
+		}
+
+		return true;
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	void reserve(uint32_t p_new_capacity) {
+		while (capacity < p_new_capacity) {
+			_add_segment();
+		}
+		_reserve_order(p_new_capacity);
+		if (p_new_capacity > MAX_LINEAR_ENTRIES && (index == nullptr || (index_mask + 1) * 2 < p_new_capacity * 3)) {
+			_rebuild_index(p_new_capacity);
+		}
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> &operator*() const {
+			return map->_get_entry(entry)->data;
+		}
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> *operator->() const { return &map->_get_entry(entry)->data; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			if (entry != INVALID_ENTRY) {
+				entry = map->_next_in_order(map->_get_entry(entry)->order_pos + 1);
+			}
+			return *this;
+		}
+		_FORCE_INLINE_ ConstIterator &operator--() {
+			if (entry != INVALID_ENTRY) {
+				entry = map->_prev_in_order(map->_get_entry(entry)->order_pos);
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return entry == b.entry; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return entry != b.entry; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return entry != INVALID_ENTRY;
+		}
+
+		_FORCE_INLINE_ ConstIterator(const OrderedHashMap *p_map, uint32_t p_entry) {
+			map = p_map;
+			entry = p_entry;
+		}
+		_FORCE_INLINE_ ConstIterator() {}
+		_FORCE_INLINE_ ConstIterator(const ConstIterator &p_it) {
+			map = p_it.map;
+			entry = p_it.entry;
+		}
+		_FORCE_INLINE_ void operator=(const ConstIterator &p_it) {
+			map = p_it.map;
+			entry = p_it.entry;
+		}
+
+	private:
+		const OrderedHashMap *map = nullptr;
+		uint32_t entry = INVALID_ENTRY;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<TKey, TValue> &operator*() const {
+			return map->_get_entry(entry)->data;
+		}
+		_FORCE_INLINE_ KeyValue<TKey, TValue> *operator->() const { return &map->_get_entry(entry)->data; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			if (entry != INVALID_ENTRY) {
+				entry = map->_next_in_order(map->_get_entry(entry)->order_pos + 1);
+			}
+			return *this;
+		}
+		_FORCE_INLINE_ Iterator &operator--() {
+			if (entry != INVALID_ENTRY) {
+				entry = map->_prev_in_order(map->_get_entry(entry)->order_pos);
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return entry == b.entry; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return entry != b.entry; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return entry != INVALID_ENTRY;
+		}
+
+		_FORCE_INLINE_ Iterator(OrderedHashMap *p_map, uint32_t p_entry) {
+			map = p_map;
+			entry = p_entry;
+		}
+		_FORCE_INLINE_ Iterator() {}
+		_FORCE_INLINE_ Iterator(const Iterator &p_it) {
+			map = p_it.map;
+			entry = p_it.entry;
+		}
+		_FORCE_INLINE_ void operator=(const Iterator &p_it) {
+			map = p_it.map;
+			entry = p_it.entry;
+		}
+
+		operator ConstIterator() const {
+			return ConstIterator(map, entry);
+		}
+
+	private:
+		OrderedHashMap *map = nullptr;
+		uint32_t entry = INVALID_ENTRY;
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		return Iterator(this, _next_in_order(0));
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator(this, INVALID_ENTRY);
+	}
+	_FORCE_INLINE_ Iterator last() {
+		return Iterator(this, _prev_in_order(order_used));
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) {
+		return Iterator(this, _find_entry(p_key));
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			erase(p_iter->key);
+		}
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator(this, _next_in_order(0));
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator(this, INVALID_ENTRY);
+	}
+	_FORCE_INLINE_ ConstIterator last() const {
+		return ConstIterator(this, _prev_in_order(order_used));
+	}
+
+	_FORCE_INLINE_ ConstIterator find(const TKey &p_key) const {
+		return ConstIterator(this, _find_entry(p_key));
+	}
+
+	// Returns the element at the given position in iteration order.
+	// This is constant time unless elements were erased from the middle.
+	Iterator get_at(uint32_t p_position) {
+		return Iterator(this, _position_to_entry(p_position));
+	}
+
+	ConstIterator get_at(uint32_t p_position) const {
+		return ConstIterator(this, _position_to_entry(p_position));
+	}
+
+private:
+	uint32_t _position_to_entry(uint32_t p_position) const {
+		if (p_position >= num_elements) {
+			return INVALID_ENTRY;
+		}
+		if (order_used == num_elements) {
+			return order[p_position]; // No holes.
+		}
+		for (uint32_t i = 0; i < order_used; i++) {
+			if (order[i] != INVALID_ENTRY) {
+				if (p_position == 0) {
+					return order[i];
+				}
+				p_position--;
+			}
+		}
+		return INVALID_ENTRY;
+	}
+
+public:
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		const uint32_t pos = _find_entry(p_key);
+		CRASH_COND(pos == INVALID_ENTRY);
+		return _get_entry(pos)->data.value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		const uint32_t hash = _hash(p_key);
+		uint32_t pos = num_elements == 0 ? INVALID_ENTRY : _find_entry(p_key, hash);
+		if (pos == INVALID_ENTRY) {
+			pos = _insert(p_key, TValue(), hash);
+		}
+		return _get_entry(pos)->data.value;
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value) {
+		const uint32_t hash = _hash(p_key);
+		uint32_t pos = num_elements == 0 ? INVALID_ENTRY : _find_entry(p_key, hash);
+		if (pos == INVALID_ENTRY) {
+			pos = _insert(p_key, p_value, hash);
+		} else {
+			_get_entry(pos)->data.value = p_value;
+		}
+		return Iterator(this, pos);
+	}
+
+	/* Constructors */
+
+	OrderedHashMap(const OrderedHashMap &p_other) {
+		reserve(p_other.num_elements);
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			_insert(E.key, E.value, _hash(E.key));
+		}
+	}
+
+	void operator=(const OrderedHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		clear();
+		reserve(p_other.num_elements);
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			_insert(E.key, E.value, _hash(E.key));
+		}
+	}
+
+	OrderedHashMap(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	OrderedHashMap() {}
+
+	OrderedHashMap(std::initializer_list<KeyValue<TKey, TValue>> p_init) {
+		reserve(p_init.size());
+		for (const KeyValue<TKey, TValue> &E : p_init) {
+			insert(E.key, E.value);
+		}
+	}
+
+	~OrderedHashMap() {
+		clear();
+
+		if (segments != nullptr) {
+			for (uint32_t i = 0; (MIN_CAPACITY << i) - MIN_CAPACITY < capacity; i++) {
+				Memory::free_static(segments[i]);
+			}
+			Memory::free_static(segments);
+		}
+		if (order != nullptr) {
+			Memory::free_static(order);
+		}
+	}
+};
@@ -0,0 +1,312 @@
+/**************************************************************************/
+/*  parallel.h                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/sort_array.h"
+
+// Data-parallel building blocks on top of the WorkerThreadPool.
+// Work is split into a few chunks per pool thread, and never into chunks smaller than the
+// given grain, so small inputs run inline on the calling thread with no task overhead.
+// Calling these from a pool thread is fine, waiting pool threads help with their own group.
+
+namespace Parallel {
+
+static constexpr int64_t DEFAULT_GRAIN = 2048;
+static constexpr int64_t CHUNKS_PER_THREAD = 4;
+
+template <typename T>
+struct Add {
+	_FORCE_INLINE_ T operator()(const T &p_a, const T &p_b) const { return p_a + p_b; }
+};
+
+// How many chunks a range of `p_count` elements is worth splitting into.
+inline int64_t get_chunk_count(int64_t p_count, int64_t p_grain = DEFAULT_GRAIN) {
+	const WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (!pool) {
+		return 1;
+	}
+	const int64_t threads = pool->get_thread_count();
+	if (threads <= 1 || p_count < p_grain * 2) {
+		return 1;
+	}
+	return MIN(p_count / MAX(p_grain, int64_t(1)), threads * CHUNKS_PER_THREAD);
+}
+
+template <typename F>
+struct _ChunkTask {
+	const F *func = nullptr;
+	int64_t begin = 0;
+	int64_t count = 0;
+	int64_t chunks = 0;
+
+	_FORCE_INLINE_ int64_t chunk_begin(int64_t p_chunk) const {
+		return begin + p_chunk * count / chunks;
+	}
+
+	static void process(void *p_userdata, uint32_t p_chunk) {
+		const _ChunkTask *task = static_cast<const _ChunkTask *>(p_userdata);
+		(*task->func)(task->chunk_begin(p_chunk), task->chunk_begin(p_chunk + 1), p_chunk);
+	}
+};
+
+// Calls `p_func(from, to, chunk)` for `p_chunks` consecutive, nearly equal slices of [p_begin, p_end).
+template <typename F>
+void for_chunks(int64_t p_begin, int64_t p_end, int64_t p_chunks, const F &p_func, const String &p_description = String()) {
+	if (p_end <= p_begin) {
+		return;
+	}
+	if (p_chunks <= 1) {
+		p_func(p_begin, p_end, 0);
+		return;
+	}
+
+	_ChunkTask<F> task;
+	task.func = &p_func;
+	task.begin = p_begin;
+	task.count = p_end - p_begin;
+	task.chunks = p_chunks;
+
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(&_ChunkTask<F>::process, &task, p_chunks, -1, true, p_description);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+}
+
+// Calls `p_func(from, to)` on slices covering [p_begin, p_end).
+template <typename F>
+void for_ranges(int64_t p_begin, int64_t p_end, const F &p_func, int64_t p_grain = DEFAULT_GRAIN) {
+	for_chunks(p_begin, p_end, get_chunk_count(p_end - p_begin, p_grain), [&p_func](int64_t p_from, int64_t p_to, int64_t) {
+		p_func(p_from, p_to);
+	});
+}
+
+// Calls `p_func(i)` for every index in [p_begin, p_end).
+template <typename F>
+void for_each(int64_t p_begin, int64_t p_end, const F &p_func, int64_t p_grain = DEFAULT_GRAIN) {
+	for_ranges(
+			p_begin, p_end, [&p_func](int64_t p_from, int64_t p_to) {
+				for (int64_t i = p_from; i < p_to; i++) {
+					p_func(i);
+				}
+			},
+			p_grain);
+}
+
+// Reduces [p_begin, p_end) with `p_range_func(from, to)` returning the partial result of a slice,
+// partial results are combined in order with `p_op`, which must be associative.
+template <typename T, typename F, typename Op>
+T reduce_ranges(int64_t p_begin, int64_t p_end, const T &p_identity, const F &p_range_func, const Op &p_op, int64_t p_grain = DEFAULT_GRAIN) {
+	const int64_t chunks = get_chunk_count(p_end - p_begin, p_grain);
+	if (chunks <= 1) {
+		return p_end > p_begin ? p_op(p_identity, p_range_func(p_begin, p_end)) : p_identity;
+	}
+
+	LocalVector<T> partials;
+	partials.resize(chunks);
+	for_chunks(p_begin, p_end, chunks, [&](int64_t p_from, int64_t p_to, int64_t p_chunk) {
+		partials[p_chunk] = p_range_func(p_from, p_to);
+	});
+
+	T result = p_identity;
+	for (const T &partial : partials) {
+		result = p_op(result, partial);
+	}
+	return result;
+}
+
+template <typename T, typename Op = Add<T>>
+T reduce(const T *p_array, int64_t p_len, const T &p_identity = T(), const Op &p_op = Op(), int64_t p_grain = DEFAULT_GRAIN) {
+	return reduce_ranges(
+			0, p_len, p_identity, [&](int64_t p_from, int64_t p_to) {
+				T result = p_array[p_from];
+				for (int64_t i = p_from + 1; i < p_to; i++) {
+					result = p_op(result, p_array[i]);
+				}
+				return result;
+			},
+			p_op, p_grain);
+}
+
+// Prefix sums, `p_src` and `p_dst` may be the same array.
+// Runs in two passes: every chunk is reduced, then rescanned starting from the sum of the chunks before it.
+template <typename T, typename Op>
+void _scan(const T *p_src, T *p_dst, int64_t p_len, const T &p_identity, const Op &p_op, bool p_inclusive, int64_t p_grain) {
+	const int64_t chunks = get_chunk_count(p_len, p_grain);
+
+	LocalVector<T> offsets;
+	offsets.resize(chunks);
+	offsets[0] = p_identity;
+	if (chunks > 1) {
+		for_chunks(0, p_len, chunks, [&](int64_t p_from, int64_t p_to, int64_t p_chunk) {
+			// The sum of the last chunk is never needed.
+			if (p_chunk + 1 == chunks) {
+				return;
+			}
+			T sum = p_src[p_from];
+			for (int64_t i = p_from + 1; i < p_to; i++) {
+				sum = p_op(sum, p_src[i]);
+			}
+			offsets[p_chunk + 1] = sum;
+		});
+		for (int64_t i = 1; i < chunks; i++) {
+			offsets[i] = p_op(offsets[i - 1], offsets[i]);
+		}
+	}
+
+	for_chunks(0, p_len, chunks, [&](int64_t p_from, int64_t p_to, int64_t p_chunk) {
+		T running = offsets[p_chunk];
+		for (int64_t i = p_from; i < p_to; i++) {
+			if (p_inclusive) {
+				running = p_op(running, p_src[i]);
+				p_dst[i] = running;
+			} else {
+				const T value = p_src[i];
+				p_dst[i] = running;
+				running = p_op(running, value);
+			}
+		}
+	});
+}
+
+template <typename T, typename Op = Add<T>>
+void inclusive_scan(const T *p_src, T *p_dst, int64_t p_len, const T &p_identity = T(), const Op &p_op = Op(), int64_t p_grain = DEFAULT_GRAIN) {
+	_scan(p_src, p_dst, p_len, p_identity, p_op, true, p_grain);
+}
+
+template <typename T, typename Op = Add<T>>
+void exclusive_scan(const T *p_src, T *p_dst, int64_t p_len, const T &p_identity = T(), const Op &p_op = Op(), int64_t p_grain = DEFAULT_GRAIN) {
+	_scan(p_src, p_dst, p_len, p_identity, p_op, false, p_grain);
+}
+
+// Number of elements of the first run among the first `p_count` elements of the merge of both runs.
+// Ties go to the first run, which keeps the merge stable.
+template <typename T, typename Comparator>
+int64_t _merge_split(const T *p_a, int64_t p_len_a, const T *p_b, int64_t p_len_b, int64_t p_count, const Comparator &p_compare) {
+	int64_t lo = MAX(int64_t(0), p_count - p_len_b);
+	int64_t hi = MIN(p_count, p_len_a);
+	while (lo < hi) {
+		const int64_t i = (lo + hi) / 2;
+		if (!p_compare(p_b[p_count - i - 1], p_a[i])) {
+			lo = i + 1;
+		} else {
+			hi = i;
+		}
+	}
+	return lo;
+}
+
+// Parallel merge sort: chunks are sorted with SortArray, then merged pairwise until a single run is left.
+// Every merge round is split over the output, so all threads stay busy up to the last round.
+// Like SortArray, the result is not stable.
+template <typename T, typename Comparator = _DefaultComparator<T>>
+void sort(T *p_array, int64_t p_len, const Comparator &p_compare = Comparator(), int64_t p_grain = DEFAULT_GRAIN) {
+	int64_t chunks = get_chunk_count(p_len, p_grain);
+	// Merging is simpler with a power of two amount of runs.
+	while (chunks & (chunks - 1)) {
+		chunks &= chunks - 1;
+	}
+
+	if (chunks <= 1) {
+		SortArray<T, Comparator> sorter;
+		sorter.compare = p_compare;
+		sorter.sort(p_array, p_len);
+		return;
+	}
+
+	for_chunks(0, p_len, chunks, [&](int64_t p_from, int64_t p_to, int64_t) {
+		SortArray<T, Comparator> sorter;
+		sorter.compare = p_compare;
+		sorter.sort_range(p_from, p_to, p_array);
+	});
+
+	LocalVector<T> buffer;
+	buffer.resize(p_len);
+	T *src = p_array;
+	T *dst = buffer.ptr();
+
+	// Where every output slice starts in the first run of its merge. Computed up front, merging moves elements out of the runs.
+	LocalVector<int64_t> splits;
+	splits.resize(chunks);
+
+	for (int64_t runs_per_merge = 2; runs_per_merge <= chunks; runs_per_merge *= 2) {
+		// Output slice `chunk` lies entirely within the merge of runs `[first, first + runs_per_merge)`.
+		auto merge_bounds = [&](int64_t p_chunk, int64_t &r_a_begin, int64_t &r_b_begin, int64_t &r_b_end) {
+			const int64_t first = p_chunk - p_chunk % runs_per_merge;
+			r_a_begin = first * p_len / chunks;
+			r_b_begin = (first + runs_per_merge / 2) * p_len / chunks;
+			r_b_end = (first + runs_per_merge) * p_len / chunks;
+		};
+
+		for_chunks(0, p_len, chunks, [&](int64_t p_from, int64_t, int64_t p_chunk) {
+			int64_t a_begin, b_begin, b_end;
+			merge_bounds(p_chunk, a_begin, b_begin, b_end);
+			splits[p_chunk] = a_begin + _merge_split(src + a_begin, b_begin - a_begin, src + b_begin, b_end - b_begin, p_from - a_begin, p_compare);
+		});
+
+		for_chunks(0, p_len, chunks, [&](int64_t p_from, int64_t p_to, int64_t p_chunk) {
+			int64_t a_begin, b_begin, b_end;
+			merge_bounds(p_chunk, a_begin, b_begin, b_end);
+
+			// The end of this slice is where the next one starts, unless that one belongs to the next merge.
+			const bool last_in_merge = (p_chunk + 1) % runs_per_merge == 0;
+			int64_t i = splits[p_chunk];
+			int64_t j = b_begin + (p_from - a_begin) - (i - a_begin);
+			const int64_t i_end = last_in_merge ? b_begin : splits[p_chunk + 1];
+			const int64_t j_end = last_in_merge ? b_end : b_begin + (p_to - a_begin) - (i_end - a_begin);
+
+			T *out = dst + p_from;
+			while (i < i_end && j < j_end) {
+				if (p_compare(src[j], src[i])) {
+					*out++ = std::move(src[j++]);
+				} else {
+					*out++ = std::move(src[i++]);
+				}
+			}
+			while (i < i_end) {
+				*out++ = std::move(src[i++]);
+			}
+			while (j < j_end) {
+				*out++ = std::move(src[j++]);
+			}
+		});
+		SWAP(src, dst);
+	}
+
+	if (src != p_array) {
+		for_chunks(0, p_len, chunks, [&](int64_t p_from, int64_t p_to, int64_t) {
+			for (int64_t i = p_from; i < p_to; i++) {
+				p_array[i] = std::move(src[i]);
+			}
+		});
+	}
+}
+
+} // namespace Parallel
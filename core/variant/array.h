@@ -144,6 +144,7 @@ public:
 	Variant pick_random() const;
 
 	void sort();
+	void sort_parallel();
 	void sort_custom(const Callable &p_callable);
 	void shuffle();
 	int bsearch(const Variant &p_value, bool p_before = true) const;
@@ -30,7 +30,7 @@
 
 #include "dictionary.h"
 
-#include "core/templates/hash_map.h"
+#include "core/templates/ordered_hash_map.h"
 #include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 // required in this order by VariantInternal, do not remove this comment.
@@ -39,10 +39,12 @@
 #include "core/variant/type_info.h"
 #include "core/variant/variant_internal.h"
 
+typedef OrderedHashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator> DictionaryMap;
+
 struct DictionaryPrivate {
 	SafeRefCount refcount;
 	Variant *read_only = nullptr; // If enabled, a pointer is used to a temporary value that is used to return read-only values.
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator> variant_map;
+	DictionaryMap variant_map;
 };
 
 void Dictionary::get_key_list(List<Variant> *p_keys) const {
@@ -56,33 +58,32 @@ void Dictionary::get_key_list(List<Variant> *p_keys) const {
 }
 
 Variant Dictionary::get_key_at_index(int p_index) const {
-	int index = 0;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
-		if (index == p_index) {
-			return E.key;
-		}
-		index++;
+	if (p_index < 0) {
+		return Variant();
 	}
-
-	return Variant();
+	DictionaryMap::ConstIterator E = _p->variant_map.get_at(p_index);
+	if (!E) {
+		return Variant();
+	}
+	return E->key;
 }
 
 Variant Dictionary::get_value_at_index(int p_index) const {
-	int index = 0;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
-		if (index == p_index) {
-			return E.value;
-		}
-		index++;
+	if (p_index < 0) {
+		return Variant();
 	}
-
-	return Variant();
+	DictionaryMap::ConstIterator E = _p->variant_map.get_at(p_index);
+	if (!E) {
+		return Variant();
+	}
+	return E->value;
 }
 
 Variant &Dictionary::operator[](const Variant &p_key) {
 	if (unlikely(_p->read_only)) {
-		if (likely(_p->variant_map.has(p_key))) {
-			*_p->read_only = _p->variant_map[p_key];
+		const Variant *value = _p->variant_map.getptr(p_key);
+		if (likely(value)) {
+			*_p->read_only = *value;
 		} else {
 			*_p->read_only = Variant();
 		}
@@ -99,7 +100,7 @@ const Variant &Dictionary::operator[](const Variant &p_key) const {
 }
 
 const Variant *Dictionary::getptr(const Variant &p_key) const {
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::ConstIterator E(_p->variant_map.find(p_key));
+	DictionaryMap::ConstIterator E(_p->variant_map.find(p_key));
 	if (!E) {
 		return nullptr;
 	}
@@ -107,7 +108,7 @@ const Variant *Dictionary::getptr(const Variant &p_key) const {
 }
 
 Variant *Dictionary::getptr(const Variant &p_key) {
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::Iterator E(_p->variant_map.find(p_key));
+	DictionaryMap::Iterator E(_p->variant_map.find(p_key));
 	if (!E) {
 		return nullptr;
 	}
@@ -120,7 +121,7 @@ Variant *Dictionary::getptr(const Variant &p_key) {
 }
 
 Variant Dictionary::get_valid(const Variant &p_key) const {
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::ConstIterator E(_p->variant_map.find(p_key));
+	DictionaryMap::ConstIterator E(_p->variant_map.find(p_key));
 
 	if (!E) {
 		return Variant();
@@ -205,7 +206,7 @@ bool Dictionary::recursive_equal(const Dictionary &p_dictionary, int recursion_c
 	}
 	recursion_count++;
 	for (const KeyValue<Variant, Variant> &this_E : _p->variant_map) {
-		HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::ConstIterator other_E(p_dictionary._p->variant_map.find(this_E.key));
+		DictionaryMap::ConstIterator other_E(p_dictionary._p->variant_map.find(this_E.key));
 		if (!other_E || !this_E.value.hash_compare(other_E->value, recursion_count, false)) {
 			return false;
 		}
@@ -329,7 +330,7 @@ const Variant *Dictionary::next(const Variant *p_key) const {
 		}
 		return nullptr;
 	}
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::Iterator E = _p->variant_map.find(*p_key);
+	DictionaryMap::Iterator E = _p->variant_map.find(*p_key);
 
 	if (!E) {
 		return nullptr;
@@ -365,6 +366,8 @@ Dictionary Dictionary::recursive_duplicate(bool p_deep, int recursion_count) con
 		return n;
 	}
 
+	n._p->variant_map.reserve(_p->variant_map.size());
+
 	if (p_deep) {
 		recursion_count++;
 		for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
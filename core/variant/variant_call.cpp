@@ -34,10 +34,12 @@
 #include "core/debugger/engine_debugger.h"
 #include "core/io/compression.h"
 #include "core/io/marshalls.h"
+#include "core/math/packed_math.h"
 #include "core/object/class_db.h"
 #include "core/os/os.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
+#include "core/templates/parallel.h"
 
 typedef void (*VariantFunc)(Variant &r_ret, Variant &p_self, const Variant **p_args);
 typedef void (*VariantConstructFunc)(Variant &r_ret, const Variant **p_args);
@@ -667,6 +669,36 @@ static _FORCE_INLINE_ void vc_ptrcall(void (*method)(T *, P...), void *p_base, c
 		p_instance->set(p_index, p_value);                                                                      \
 	}
 
+#define VARCALL_PACKED_FLOAT_ARRAY_MATH(m_packed_type)                                                               \
+	static void func_##m_packed_type##_add_scalar(m_packed_type *p_instance, double p_value) {                       \
+		PackedMath::add_scalar(p_instance->ptrw(), p_instance->size(), p_value);                                     \
+	}                                                                                                                \
+	static void func_##m_packed_type##_multiply_scalar(m_packed_type *p_instance, double p_value) {                  \
+		PackedMath::multiply_scalar(p_instance->ptrw(), p_instance->size(), p_value);                                \
+	}                                                                                                                \
+	static void func_##m_packed_type##_multiply_add(m_packed_type *p_instance, double p_scale, double p_offset) {    \
+		PackedMath::multiply_add(p_instance->ptrw(), p_instance->size(), p_scale, p_offset);                         \
+	}                                                                                                                \
+	static void func_##m_packed_type##_clamp(m_packed_type *p_instance, double p_min, double p_max) {                \
+		PackedMath::clamp(p_instance->ptrw(), p_instance->size(), p_min, p_max);                                     \
+	}                                                                                                                \
+	static void func_##m_packed_type##_add_array(m_packed_type *p_instance, const m_packed_type &p_array) {          \
+		ERR_FAIL_COND_MSG(p_array.size() != p_instance->size(), "Both arrays must have the same size.");             \
+		PackedMath::add(p_instance->ptrw(), p_array.ptr(), p_instance->size());                                      \
+	}                                                                                                                \
+	static void func_##m_packed_type##_multiply_array(m_packed_type *p_instance, const m_packed_type &p_array) {     \
+		ERR_FAIL_COND_MSG(p_array.size() != p_instance->size(), "Both arrays must have the same size.");             \
+		PackedMath::multiply(p_instance->ptrw(), p_array.ptr(), p_instance->size());                                 \
+	}                                                                                                                \
+	static void func_##m_packed_type##_lerp(m_packed_type *p_instance, const m_packed_type &p_to, double p_weight) { \
+		ERR_FAIL_COND_MSG(p_to.size() != p_instance->size(), "Both arrays must have the same size.");                \
+		PackedMath::lerp(p_instance->ptrw(), p_to.ptr(), p_instance->size(), p_weight);                              \
+	}                                                                                                                \
+	static double func_##m_packed_type##_dot(m_packed_type *p_instance, const m_packed_type &p_array) {              \
+		ERR_FAIL_COND_V_MSG(p_array.size() != p_instance->size(), 0.0, "Both arrays must have the same size.");      \
+		return PackedMath::dot(p_instance->ptr(), p_array.ptr(), p_instance->size());                                \
+	}
+
 struct _VariantCall {
 	VARCALL_ARRAY_GETTER_SETTER(PackedByteArray, uint8_t)
 	VARCALL_ARRAY_GETTER_SETTER(PackedColorArray, Color)
@@ -680,6 +712,27 @@ struct _VariantCall {
 	VARCALL_ARRAY_GETTER_SETTER(PackedVector4Array, Vector4)
 	VARCALL_ARRAY_GETTER_SETTER(Array, Variant)
 
+	VARCALL_PACKED_FLOAT_ARRAY_MATH(PackedFloat32Array)
+	VARCALL_PACKED_FLOAT_ARRAY_MATH(PackedFloat64Array)
+
+	// Vector3 is three consecutive real_t values, so component-wise operations work on the flattened array.
+	static void func_PackedVector3Array_add_array(PackedVector3Array *p_instance, const PackedVector3Array &p_array) {
+		ERR_FAIL_COND_MSG(p_array.size() != p_instance->size(), "Both arrays must have the same size.");
+		PackedMath::add((real_t *)p_instance->ptrw(), (const real_t *)p_array.ptr(), p_instance->size() * 3);
+	}
+	static void func_PackedVector3Array_multiply_scalar(PackedVector3Array *p_instance, double p_value) {
+		PackedMath::multiply_scalar((real_t *)p_instance->ptrw(), p_instance->size() * 3, p_value);
+	}
+	static void func_PackedVector3Array_lerp(PackedVector3Array *p_instance, const PackedVector3Array &p_to, double p_weight) {
+		ERR_FAIL_COND_MSG(p_to.size() != p_instance->size(), "Both arrays must have the same size.");
+		PackedMath::lerp((real_t *)p_instance->ptrw(), (const real_t *)p_to.ptr(), p_instance->size() * 3, p_weight);
+	}
+
+	template <typename T>
+	static void func_PackedArray_sort_parallel(T *p_instance) {
+		Parallel::sort(p_instance->ptrw(), p_instance->size());
+	}
+
 	static String func_PackedByteArray_get_string_from_ascii(PackedByteArray *p_instance) {
 		String s;
 		if (p_instance->size() > 0) {
@@ -2342,6 +2395,7 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(Array, pop_front, sarray(), varray());
 	bind_method(Array, pop_at, sarray("position"), varray());
 	bind_method(Array, sort, sarray(), varray());
+	bind_method(Array, sort_parallel, sarray(), varray());
 	bind_method(Array, sort_custom, sarray("func"), varray());
 	bind_method(Array, shuffle, sarray(), varray());
 	bind_method(Array, bsearch, sarray("value", "before"), varray(true));
@@ -2402,6 +2456,7 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedByteArray, reverse, sarray(), varray());
 	bind_method(PackedByteArray, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedByteArray, sort, sarray(), varray());
+	bind_functionnc(PackedByteArray, sort_parallel, _VariantCall::func_PackedArray_sort_parallel<PackedByteArray>, sarray(), varray());
 	bind_method(PackedByteArray, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedByteArray, duplicate, sarray(), varray());
 	bind_method(PackedByteArray, find, sarray("value", "from"), varray(0));
@@ -2468,6 +2523,7 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedInt32Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedInt32Array, to_byte_array, sarray(), varray());
 	bind_method(PackedInt32Array, sort, sarray(), varray());
+	bind_functionnc(PackedInt32Array, sort_parallel, _VariantCall::func_PackedArray_sort_parallel<PackedInt32Array>, sarray(), varray());
 	bind_method(PackedInt32Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedInt32Array, duplicate, sarray(), varray());
 	bind_method(PackedInt32Array, find, sarray("value", "from"), varray(0));
@@ -2491,6 +2547,7 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedInt64Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedInt64Array, to_byte_array, sarray(), varray());
 	bind_method(PackedInt64Array, sort, sarray(), varray());
+	bind_functionnc(PackedInt64Array, sort_parallel, _VariantCall::func_PackedArray_sort_parallel<PackedInt64Array>, sarray(), varray());
 	bind_method(PackedInt64Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedInt64Array, duplicate, sarray(), varray());
 	bind_method(PackedInt64Array, find, sarray("value", "from"), varray(0));
@@ -2514,11 +2571,20 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedFloat32Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedFloat32Array, to_byte_array, sarray(), varray());
 	bind_method(PackedFloat32Array, sort, sarray(), varray());
+	bind_functionnc(PackedFloat32Array, sort_parallel, _VariantCall::func_PackedArray_sort_parallel<PackedFloat32Array>, sarray(), varray());
 	bind_method(PackedFloat32Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedFloat32Array, duplicate, sarray(), varray());
 	bind_method(PackedFloat32Array, find, sarray("value", "from"), varray(0));
 	bind_method(PackedFloat32Array, rfind, sarray("value", "from"), varray(-1));
 	bind_method(PackedFloat32Array, count, sarray("value"), varray());
+	bind_functionnc(PackedFloat32Array, add_scalar, _VariantCall::func_PackedFloat32Array_add_scalar, sarray("value"), varray());
+	bind_functionnc(PackedFloat32Array, multiply_scalar, _VariantCall::func_PackedFloat32Array_multiply_scalar, sarray("value"), varray());
+	bind_functionnc(PackedFloat32Array, multiply_add, _VariantCall::func_PackedFloat32Array_multiply_add, sarray("scale", "offset"), varray());
+	bind_functionnc(PackedFloat32Array, clamp, _VariantCall::func_PackedFloat32Array_clamp, sarray("min", "max"), varray());
+	bind_functionnc(PackedFloat32Array, add_array, _VariantCall::func_PackedFloat32Array_add_array, sarray("array"), varray());
+	bind_functionnc(PackedFloat32Array, multiply_array, _VariantCall::func_PackedFloat32Array_multiply_array, sarray("array"), varray());
+	bind_functionnc(PackedFloat32Array, lerp, _VariantCall::func_PackedFloat32Array_lerp, sarray("to", "weight"), varray());
+	bind_function(PackedFloat32Array, dot, _VariantCall::func_PackedFloat32Array_dot, sarray("array"), varray());
 
 	/* Float64 Array */
 
@@ -2537,11 +2603,20 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedFloat64Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedFloat64Array, to_byte_array, sarray(), varray());
 	bind_method(PackedFloat64Array, sort, sarray(), varray());
+	bind_functionnc(PackedFloat64Array, sort_parallel, _VariantCall::func_PackedArray_sort_parallel<PackedFloat64Array>, sarray(), varray());
 	bind_method(PackedFloat64Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedFloat64Array, duplicate, sarray(), varray());
 	bind_method(PackedFloat64Array, find, sarray("value", "from"), varray(0));
 	bind_method(PackedFloat64Array, rfind, sarray("value", "from"), varray(-1));
 	bind_method(PackedFloat64Array, count, sarray("value"), varray());
+	bind_functionnc(PackedFloat64Array, add_scalar, _VariantCall::func_PackedFloat64Array_add_scalar, sarray("value"), varray());
+	bind_functionnc(PackedFloat64Array, multiply_scalar, _VariantCall::func_PackedFloat64Array_multiply_scalar, sarray("value"), varray());
+	bind_functionnc(PackedFloat64Array, multiply_add, _VariantCall::func_PackedFloat64Array_multiply_add, sarray("scale", "offset"), varray());
+	bind_functionnc(PackedFloat64Array, clamp, _VariantCall::func_PackedFloat64Array_clamp, sarray("min", "max"), varray());
+	bind_functionnc(PackedFloat64Array, add_array, _VariantCall::func_PackedFloat64Array_add_array, sarray("array"), varray());
+	bind_functionnc(PackedFloat64Array, multiply_array, _VariantCall::func_PackedFloat64Array_multiply_array, sarray("array"), varray());
+	bind_functionnc(PackedFloat64Array, lerp, _VariantCall::func_PackedFloat64Array_lerp, sarray("to", "weight"), varray());
+	bind_function(PackedFloat64Array, dot, _VariantCall::func_PackedFloat64Array_dot, sarray("array"), varray());
 
 	/* String Array */
 
@@ -2560,6 +2635,7 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedStringArray, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_function(PackedStringArray, to_byte_array, _VariantCall::func_PackedStringArray_to_byte_array, sarray(), varray());
 	bind_method(PackedStringArray, sort, sarray(), varray());
+	bind_functionnc(PackedStringArray, sort_parallel, _VariantCall::func_PackedArray_sort_parallel<PackedStringArray>, sarray(), varray());
 	bind_method(PackedStringArray, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedStringArray, duplicate, sarray(), varray());
 	bind_method(PackedStringArray, find, sarray("value", "from"), varray(0));
@@ -2583,6 +2659,7 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedVector2Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedVector2Array, to_byte_array, sarray(), varray());
 	bind_method(PackedVector2Array, sort, sarray(), varray());
+	bind_functionnc(PackedVector2Array, sort_parallel, _VariantCall::func_PackedArray_sort_parallel<PackedVector2Array>, sarray(), varray());
 	bind_method(PackedVector2Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedVector2Array, duplicate, sarray(), varray());
 	bind_method(PackedVector2Array, find, sarray("value", "from"), varray(0));
@@ -2606,11 +2683,15 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedVector3Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedVector3Array, to_byte_array, sarray(), varray());
 	bind_method(PackedVector3Array, sort, sarray(), varray());
+	bind_functionnc(PackedVector3Array, sort_parallel, _VariantCall::func_PackedArray_sort_parallel<PackedVector3Array>, sarray(), varray());
 	bind_method(PackedVector3Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedVector3Array, duplicate, sarray(), varray());
 	bind_method(PackedVector3Array, find, sarray("value", "from"), varray(0));
 	bind_method(PackedVector3Array, rfind, sarray("value", "from"), varray(-1));
 	bind_method(PackedVector3Array, count, sarray("value"), varray());
+	bind_functionnc(PackedVector3Array, multiply_scalar, _VariantCall::func_PackedVector3Array_multiply_scalar, sarray("value"), varray());
+	bind_functionnc(PackedVector3Array, add_array, _VariantCall::func_PackedVector3Array_add_array, sarray("array"), varray());
+	bind_functionnc(PackedVector3Array, lerp, _VariantCall::func_PackedVector3Array_lerp, sarray("to", "weight"), varray());
 
 	/* Color Array */
 
@@ -2629,6 +2710,7 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedColorArray, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedColorArray, to_byte_array, sarray(), varray());
 	bind_method(PackedColorArray, sort, sarray(), varray());
+	bind_functionnc(PackedColorArray, sort_parallel, _VariantCall::func_PackedArray_sort_parallel<PackedColorArray>, sarray(), varray());
 	bind_method(PackedColorArray, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedColorArray, duplicate, sarray(), varray());
 	bind_method(PackedColorArray, find, sarray("value", "from"), varray(0));
@@ -2652,6 +2734,7 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedVector4Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedVector4Array, to_byte_array, sarray(), varray());
 	bind_method(PackedVector4Array, sort, sarray(), varray());
+	bind_functionnc(PackedVector4Array, sort_parallel, _VariantCall::func_PackedArray_sort_parallel<PackedVector4Array>, sarray(), varray());
 	bind_method(PackedVector4Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedVector4Array, duplicate, sarray(), varray());
 	bind_method(PackedVector4Array, find, sarray("value", "from"), varray(0));
@@ -34,11 +34,19 @@
 
 #include "core/os/thread.h"
 #include "core/string/ustring.h"
+#include "core/templates/vector.h"
 
 #ifdef PTHREAD_BSD_SET_NAME
 #include <pthread_np.h>
 #endif
 
+#ifdef __linux__
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 static Error set_name(const String &p_name) {
 #ifdef PTHREAD_NO_RENAME
 	return ERR_UNAVAILABLE;
@@ -69,8 +77,36 @@ static Error set_name(const String &p_name) {
 #endif // PTHREAD_NO_RENAME
 }
 
+#ifdef __linux__
+static Error set_current_priority(Thread::Priority p_priority) {
+	// On Linux the nice value is per thread, so offset the calling thread from the process.
+	// Raising it above the process usually needs privileges, in which case it's left as is.
+	const pid_t tid = syscall(SYS_gettid);
+	const int base = getpriority(PRIO_PROCESS, 0);
+	const int offset = p_priority == Thread::PRIORITY_LOW ? 5 : (p_priority == Thread::PRIORITY_HIGH ? -5 : 0);
+	return setpriority(PRIO_PROCESS, tid, base + offset) == 0 ? OK : ERR_UNAVAILABLE;
+}
+
+static Error set_affinity(const Vector<int> &p_cpus) {
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int cpu : p_cpus) {
+		ERR_FAIL_INDEX_V(cpu, CPU_SETSIZE, ERR_INVALID_PARAMETER);
+		CPU_SET(cpu, &set);
+	}
+	if (CPU_COUNT(&set) == 0) {
+		return ERR_INVALID_PARAMETER;
+	}
+	return sched_setaffinity(0, sizeof(set), &set) == 0 ? OK : ERR_UNAVAILABLE;
+}
+#endif
+
 void init_thread_posix() {
+#ifdef __linux__
+	Thread::_set_platform_functions({ .set_name = set_name, .set_affinity = set_affinity, .set_current_priority = set_current_priority });
+#else
 	Thread::_set_platform_functions({ .set_name = set_name });
+#endif
 }
 
 #endif // UNIX_ENABLED
@@ -34,6 +34,7 @@
 
 #include "core/os/thread.h"
 #include "core/string/ustring.h"
+#include "core/templates/vector.h"
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -50,10 +51,42 @@ static Error set_name(const String &p_name) {
 	return SUCCEEDED(res) ? OK : ERR_INVALID_PARAMETER;
 }
 
+static Error set_current_priority(Thread::Priority p_priority) {
+	int priority = THREAD_PRIORITY_NORMAL;
+	switch (p_priority) {
+		case Thread::PRIORITY_LOW:
+			priority = THREAD_PRIORITY_BELOW_NORMAL;
+			break;
+		case Thread::PRIORITY_NORMAL:
+			break;
+		case Thread::PRIORITY_HIGH:
+			priority = THREAD_PRIORITY_ABOVE_NORMAL;
+			break;
+	}
+	return SetThreadPriority(GetCurrentThread(), priority) ? OK : ERR_UNAVAILABLE;
+}
+
+static Error set_affinity(const Vector<int> &p_cpus) {
+	// Only the first processor group is addressable with a plain affinity mask.
+	DWORD_PTR mask = 0;
+	for (int cpu : p_cpus) {
+		ERR_FAIL_INDEX_V(cpu, int(sizeof(DWORD_PTR) * 8), ERR_INVALID_PARAMETER);
+		mask |= DWORD_PTR(1) << cpu;
+	}
+	if (mask == 0) {
+		return ERR_INVALID_PARAMETER;
+	}
+	return SetThreadAffinityMask(GetCurrentThread(), mask) != 0 ? OK : ERR_UNAVAILABLE;
+}
+
 void init_thread_win() {
 	w10_SetThreadDescription = (SetThreadDescriptionPtr)(void *)GetProcAddress(LoadLibraryW(L"kernel32.dll"), "SetThreadDescription");
 
-	Thread::_set_platform_functions({ set_name });
+	Thread::PlatformFunctions functions;
+	functions.set_name = set_name;
+	functions.set_affinity = set_affinity;
+	functions.set_current_priority = set_current_priority;
+	Thread::_set_platform_functions(functions);
 }
 
 #endif // WINDOWS_ENABLED
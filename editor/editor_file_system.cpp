@@ -34,6 +34,7 @@
 #include "core/extension/gdextension_manager.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/io/image_compress_scheduler.h"
 #include "core/io/resource_saver.h"
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
@@ -43,6 +44,7 @@
 #include "editor/editor_paths.h"
 #include "editor/editor_resource_preview.h"
 #include "editor/editor_settings.h"
+#include "editor/import/editor_import_cache.h"
 #include "editor/plugins/script_editor_plugin.h"
 #include "editor/project_settings_editor.h"
 #include "scene/resources/packed_scene.h"
@@ -2840,7 +2842,25 @@ Error EditorFileSystem::_reimport_file(const String &p_file, const HashMap<Strin
 	List<String> import_variants;
 	List<String> gen_files;
 	Variant meta;
-	Error err = importer->import(uid, p_file, base_path, params, &import_variants, &gen_files, &meta);
+	Error err = OK;
+
+	// Try the shared import cache first, so unchanged assets don't need to be imported again on every machine.
+	String cache_key;
+	if (!EditorImportCache::get_cache_dir().is_empty()) {
+		cache_key = EditorImportCache::get_key(p_file, importer, opts, params, uid);
+	}
+
+	if (!cache_key.is_empty() && EditorImportCache::restore(cache_key, base_path, &import_variants, &meta)) {
+		print_verbose(vformat("EditorFileSystem: \"%s\" restored from the import cache.", p_file));
+	} else {
+		import_variants.clear();
+		err = importer->import(uid, p_file, base_path, params, &import_variants, &gen_files, &meta);
+
+		// Importers generating files in the project can't be cached, as those are not part of the artifacts.
+		if (err == OK && !cache_key.is_empty() && gen_files.is_empty()) {
+			EditorImportCache::store(cache_key, base_path, import_variants, meta);
+		}
+	}
 
 	// As import is complete, save the .import file.
 
@@ -3188,6 +3208,9 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 	bool use_multiple_threads = false;
 #endif
 
+	// Limits how much memory texture compression jobs running in parallel may hold at once.
+	ImageCompressScheduler::set_memory_budget(uint64_t(int(GLOBAL_GET("editor/import/texture_compression_memory_budget_mb"))) * 1024 * 1024);
+
 	int from = 0;
 	Semaphore imported_sem;
 	for (int i = 0; i < reimport_files.size(); i++) {
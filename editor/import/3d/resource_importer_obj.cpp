@@ -687,5 +687,42 @@ Error ResourceImporterOBJ::import(ResourceUID::ID p_source_id, const String &p_s
 	return OK;
 }
 
+bool ResourceImporterOBJ::get_import_dependencies(const String &p_source_file, const HashMap<StringName, Variant> &p_options, List<String> *r_dependencies) const {
+	// Material libraries are embedded in the result, and the textures they use are referenced when they exist.
+	Ref<FileAccess> f = FileAccess::open(p_source_file, FileAccess::READ);
+	ERR_FAIL_COND_V(f.is_null(), false);
+
+	HashSet<String> libraries;
+	while (!f->eof_reached()) {
+		const String l = f->get_line().strip_edges();
+		if (!l.begins_with("mtllib ")) {
+			continue;
+		}
+		String lib_path = l.replace("mtllib", "").strip_edges();
+		if (lib_path.is_relative_path()) {
+			lib_path = p_source_file.get_base_dir().path_join(lib_path);
+		}
+		if (libraries.has(lib_path)) {
+			continue;
+		}
+		libraries.insert(lib_path);
+		r_dependencies->push_back(lib_path);
+
+		Ref<FileAccess> lib = FileAccess::open(lib_path, FileAccess::READ);
+		if (lib.is_null()) {
+			continue;
+		}
+		while (!lib->eof_reached()) {
+			const String map = lib->get_line().strip_edges();
+			if (!map.begins_with("map_Kd ") && !map.begins_with("map_Ks ") && !map.begins_with("map_Ns ") && !map.begins_with("map_bump ")) {
+				continue;
+			}
+			const String p = map.substr(map.find(" ")).replace("\\", "/").strip_edges();
+			r_dependencies->push_back(p.is_absolute_path() ? p : lib_path.get_base_dir().path_join(p));
+		}
+	}
+	return true;
+}
+
 ResourceImporterOBJ::ResourceImporterOBJ() {
 }
@@ -61,6 +61,7 @@ public:
 	virtual bool get_option_visibility(const String &p_path, const String &p_option, const HashMap<StringName, Variant> &p_options) const override;
 
 	virtual Error import(ResourceUID::ID p_source_id, const String &p_source_file, const String &p_save_path, const HashMap<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files = nullptr, Variant *r_metadata = nullptr) override;
+	virtual bool get_import_dependencies(const String &p_source_file, const HashMap<StringName, Variant> &p_options, List<String> *r_dependencies) const override;
 
 	ResourceImporterOBJ();
 };
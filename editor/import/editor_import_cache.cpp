@@ -0,0 +1,211 @@
+/**************************************************************************/
+/*  editor_import_cache.cpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "editor_import_cache.h"
+
+#include "core/config/project_settings.h"
+#include "core/io/config_file.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/math/random_number_generator.h"
+#include "core/os/os.h"
+#include "core/variant/variant_parser.h"
+#include "core/version.h"
+
+String EditorImportCache::_get_entry_dir(const String &p_cache_dir, const String &p_key) {
+	// Spread entries over subdirectories, so no single directory grows too large.
+	return p_cache_dir.path_join(p_key.substr(0, 2)).path_join(p_key);
+}
+
+String EditorImportCache::get_cache_dir() {
+	String cache_dir = GLOBAL_GET("editor/import/shared_cache_path");
+	if (cache_dir.is_empty()) {
+		return String();
+	}
+
+	if (cache_dir.begins_with("res://") || cache_dir.begins_with("user://")) {
+		return ProjectSettings::get_singleton()->globalize_path(cache_dir);
+	}
+	if (cache_dir.is_relative_path()) {
+		// Relative to the project, so the same setting works for every checkout.
+		return ProjectSettings::get_singleton()->get_resource_path().path_join(cache_dir).simplify_path();
+	}
+	return cache_dir;
+}
+
+String EditorImportCache::get_key(const String &p_source_file, const Ref<ResourceImporter> &p_importer, const List<ResourceImporter::ImportOption> &p_options, const HashMap<StringName, Variant> &p_params, ResourceUID::ID p_uid) {
+	ERR_FAIL_COND_V(p_importer.is_null(), String());
+
+	List<String> dependencies;
+	if (!p_importer->get_import_dependencies(p_source_file, p_params, &dependencies)) {
+		return String(); // The result may depend on files the key can't account for.
+	}
+
+	const String source_hash = FileAccess::get_sha256(p_source_file);
+	if (source_hash.is_empty()) {
+		return String();
+	}
+
+	String key = String(VERSION_FULL_BUILD) + "\n" + VERSION_HASH + "\n";
+	key += p_importer->get_importer_name() + "\n" + itos(p_importer->get_format_version()) + "\n";
+	// Some importers derive the UIDs of what they generate from the source UID.
+	key += ResourceUID::get_singleton()->id_to_text(p_uid) + "\n";
+	key += source_hash + "\n";
+	for (const String &dependency : dependencies) {
+		// Missing files hash as empty, so a dependency appearing changes the key too.
+		key += dependency + "=" + FileAccess::get_sha256(dependency) + "\n";
+	}
+	// Project settings the importer depends on, like the enabled texture compression formats.
+	key += p_importer->get_import_settings_string() + "\n";
+
+	for (const ResourceImporter::ImportOption &E : p_options) {
+		const Variant *value = p_params.getptr(E.option.name);
+		String value_text;
+		if (value) {
+			VariantWriter::write_to_string(*value, value_text);
+		}
+		key += String(E.option.name) + "=" + value_text + "\n";
+	}
+
+	return key.sha256_text();
+}
+
+bool EditorImportCache::restore(const String &p_key, const String &p_base_path, List<String> *r_import_variants, Variant *r_metadata) {
+	const String cache_dir = get_cache_dir();
+	if (cache_dir.is_empty() || p_key.is_empty()) {
+		return false;
+	}
+
+	const String entry_dir = _get_entry_dir(cache_dir, p_key);
+	Ref<ConfigFile> manifest;
+	manifest.instantiate();
+	if (manifest->load(entry_dir.path_join("manifest.cfg")) != OK) {
+		return false;
+	}
+
+	const PackedStringArray artifacts = manifest->get_value("artifacts", "files", PackedStringArray());
+	if (artifacts.is_empty()) {
+		return false;
+	}
+
+	const String base_path = ProjectSettings::get_singleton()->globalize_path(p_base_path);
+	for (const String &suffix : artifacts) {
+		Error err = DirAccess::copy_absolute(entry_dir.path_join("artifact" + suffix), base_path + suffix);
+		if (err != OK) {
+			print_verbose(vformat("EditorImportCache: Failed to restore \"%s\" from entry %s.", p_base_path + suffix, p_key));
+			return false;
+		}
+	}
+
+	const PackedStringArray variants = manifest->get_value("artifacts", "variants", PackedStringArray());
+	for (const String &variant : variants) {
+		r_import_variants->push_back(variant);
+	}
+	*r_metadata = manifest->get_value("artifacts", "metadata", Variant());
+
+	return true;
+}
+
+Error EditorImportCache::store(const String &p_key, const String &p_base_path, const List<String> &p_import_variants, const Variant &p_metadata) {
+	const String cache_dir = get_cache_dir();
+	ERR_FAIL_COND_V(cache_dir.is_empty() || p_key.is_empty(), ERR_UNCONFIGURED);
+
+	const String entry_dir = _get_entry_dir(cache_dir, p_key);
+	if (FileAccess::exists(entry_dir.path_join("manifest.cfg"))) {
+		return OK; // Already stored, e.g. by another machine.
+	}
+
+	// Importers may write more files than their declared destinations (like editor-only variants),
+	// so store everything sharing the base path. The .md5 file is written after importing.
+	const String base_path = ProjectSettings::get_singleton()->globalize_path(p_base_path);
+	const String prefix = base_path.get_file() + ".";
+	PackedStringArray artifacts;
+	{
+		Ref<DirAccess> da = DirAccess::open(base_path.get_base_dir());
+		ERR_FAIL_COND_V(da.is_null(), ERR_CANT_OPEN);
+		da->list_dir_begin();
+		for (String file = da->get_next(); !file.is_empty(); file = da->get_next()) {
+			if (!da->current_is_dir() && file.begins_with(prefix) && file != prefix + "md5") {
+				artifacts.push_back(file.substr(prefix.length() - 1));
+			}
+		}
+		da->list_dir_end();
+	}
+	if (artifacts.is_empty()) {
+		return ERR_FILE_NOT_FOUND;
+	}
+
+	// Write to a temporary directory and move it in place once complete, so concurrent
+	// readers (possibly on other machines) never see a partial entry.
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->randomize();
+	const String temp_dir = vformat("%s.%d-%d.tmp", entry_dir, OS::get_singleton()->get_process_id(), rng->randi());
+	Error err = DirAccess::make_dir_recursive_absolute(temp_dir);
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Cannot create import cache directory \"%s\".", temp_dir));
+
+	for (const String &suffix : artifacts) {
+		err = DirAccess::copy_absolute(base_path + suffix, temp_dir.path_join("artifact" + suffix));
+		if (err != OK) {
+			break;
+		}
+	}
+
+	if (err == OK) {
+		PackedStringArray variants;
+		for (const String &variant : p_import_variants) {
+			variants.push_back(variant);
+		}
+
+		Ref<ConfigFile> manifest;
+		manifest.instantiate();
+		manifest->set_value("artifacts", "files", artifacts);
+		manifest->set_value("artifacts", "variants", variants);
+		if (p_metadata != Variant()) {
+			manifest->set_value("artifacts", "metadata", p_metadata);
+		}
+		err = manifest->save(temp_dir.path_join("manifest.cfg"));
+	}
+
+	if (err == OK) {
+		err = DirAccess::rename_absolute(temp_dir, entry_dir);
+	}
+
+	if (err != OK) {
+		// Either something failed, or another process stored the same entry first.
+		Ref<DirAccess> da = DirAccess::open(temp_dir);
+		if (da.is_valid()) {
+			da->erase_contents_recursive();
+		}
+		DirAccess::remove_absolute(temp_dir);
+	}
+
+	return err;
+}
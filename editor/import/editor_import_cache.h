@@ -0,0 +1,58 @@
+/**************************************************************************/
+/*  editor_import_cache.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/io/resource_importer.h"
+
+// Content-addressed cache of import artifacts.
+//
+// Artifacts are stored in a plain directory (which can be shared between
+// machines, e.g. on a network drive or restored by CI) under a key made of
+// the hash of the source file and the files it depends on, the importer and
+// its options, and the engine version. On a hit, the imported files are
+// copied back into `.godot/imported` instead of running the importer.
+//
+// Only importers which report their dependencies through
+// ResourceImporter::get_import_dependencies() are cached.
+class EditorImportCache {
+	static String _get_entry_dir(const String &p_cache_dir, const String &p_key);
+
+public:
+	// Empty if the cache is disabled.
+	static String get_cache_dir();
+
+	static String get_key(const String &p_source_file, const Ref<ResourceImporter> &p_importer, const List<ResourceImporter::ImportOption> &p_options, const HashMap<StringName, Variant> &p_params, ResourceUID::ID p_uid);
+
+	// Copies the artifacts stored under p_key to p_base_path. Returns false on a miss.
+	static bool restore(const String &p_key, const String &p_base_path, List<String> *r_import_variants, Variant *r_metadata);
+	// Stores the artifacts the importer just wrote to p_base_path under p_key.
+	static Error store(const String &p_key, const String &p_base_path, const List<String> &p_import_variants, const Variant &p_metadata);
+};
@@ -51,6 +51,7 @@ public:
 	virtual Error import(ResourceUID::ID p_source_id, const String &p_source_file, const String &p_save_path, const HashMap<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files = nullptr, Variant *r_metadata = nullptr) override;
 
 	virtual bool can_import_threaded() const override { return true; }
+	virtual bool get_import_dependencies(const String &p_source_file, const HashMap<StringName, Variant> &p_options, List<String> *r_dependencies) const override { return true; }
 
 	ResourceImporterCSVTranslation();
 };
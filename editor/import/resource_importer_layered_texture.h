@@ -117,6 +117,7 @@ public:
 	virtual String get_import_settings_string() const override;
 
 	virtual bool can_import_threaded() const override { return true; }
+	virtual bool get_import_dependencies(const String &p_source_file, const HashMap<StringName, Variant> &p_options, List<String> *r_dependencies) const override { return true; }
 
 	void set_mode(Mode p_mode) { mode = p_mode; }
 
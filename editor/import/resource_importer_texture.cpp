@@ -791,6 +791,15 @@ String ResourceImporterTexture::get_import_settings_string() const {
 	return s;
 }
 
+bool ResourceImporterTexture::get_import_dependencies(const String &p_source_file, const HashMap<StringName, Variant> &p_options, List<String> *r_dependencies) const {
+	// The normal map is read when generating roughness mipmaps.
+	const Variant *normal_map = p_options.getptr("roughness/src_normal");
+	if (normal_map && !String(*normal_map).is_empty()) {
+		r_dependencies->push_back(*normal_map);
+	}
+	return true;
+}
+
 bool ResourceImporterTexture::are_import_settings_valid(const String &p_path, const Dictionary &p_meta) const {
 	if (p_meta.has("has_editor_variant")) {
 		String imported_path = ResourceFormatImporter::get_singleton()->get_internal_resource_path(p_path);
@@ -287,6 +287,8 @@ void register_editor_types() {
 
 	GLOBAL_DEF("editor/import/reimport_missing_imported_files", true);
 	GLOBAL_DEF("editor/import/use_multiple_threads", true);
+	GLOBAL_DEF(PropertyInfo(Variant::STRING, "editor/import/shared_cache_path", PROPERTY_HINT_GLOBAL_DIR), "");
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "editor/import/texture_compression_memory_budget_mb", PROPERTY_HINT_RANGE, "0,65536,1,or_greater,suffix:MiB"), 0);
 
 	GLOBAL_DEF(PropertyInfo(Variant::INT, "editor/import/atlas_max_width", PROPERTY_HINT_RANGE, "128,8192,1,or_greater"), 2048);
 
@@ -48,6 +48,7 @@
 #include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
 #include "core/object/script_language.h"
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 #include "core/os/time.h"
 #include "core/register_core_types.h"
@@ -243,6 +244,7 @@ static bool debug_canvas_item_redraw = false;
 #endif
 static int max_fps = -1;
 static int frame_delay = 0;
+static String cpu_affinity;
 static int audio_output_latency = 0;
 static bool disable_render_loop = false;
 static int fixed_fps = -1;
@@ -603,6 +605,11 @@ void Main::print_help(const char *p_binary) {
 	print_help_option("--generate-spirv-debug-info", "Generate SPIR-V debug information. This allows source-level shader debugging with RenderDoc.\n");
 	print_help_option("--remote-debug <uri>", "Remote debug (<protocol>://<host/IP>[:<port>], e.g. tcp://127.0.0.1:6007).\n");
 	print_help_option("--single-threaded-scene", "Force scene tree to run in single-threaded mode. Sub-thread groups are disabled and run on the main thread.\n");
+#ifdef MODULE_GDSCRIPT_ENABLED
+	print_help_option("--gdscript-sampling-profile <path>", "Sample the GDScript call stacks of all threads and save them to the given file when the engine quits. The path should be absolute.\n");
+	print_help_option("", "The file has collapsed stacks for flame graph tools, or a Chrome trace if the path ends with \".json\".\n");
+	print_help_option("--gdscript-sampling-rate <hz>", "Set the sampling rate of --gdscript-sampling-profile (default: 1000).\n");
+#endif
 #if defined(DEBUG_ENABLED)
 	print_help_option("--debug-collisions", "Show collision shapes when running the scene.\n", CLI_OPTION_AVAILABILITY_TEMPLATE_DEBUG);
 	print_help_option("--debug-paths", "Show path lines when running the scene.\n", CLI_OPTION_AVAILABILITY_TEMPLATE_DEBUG);
@@ -614,6 +621,7 @@ void Main::print_help(const char *p_binary) {
 #endif
 	print_help_option("--max-fps <fps>", "Set a maximum number of frames per second rendered (can be used to limit power usage). A value of 0 results in unlimited framerate.\n");
 	print_help_option("--frame-delay <ms>", "Simulate high CPU load (delay each frame by <ms> milliseconds). Do not use as a FPS limiter; use --max-fps instead.\n");
+	print_help_option("--cpu-affinity <cpus>", "Restrict the main thread and the worker thread pool to the given logical CPUs (e.g. \"0-3,8\"). Overrides the threading/worker_pool/cpu_affinity project setting.\n");
 	print_help_option("--time-scale <scale>", "Force time scale (higher values are faster, 1.0 is normal speed).\n");
 	print_help_option("--disable-vsync", "Forces disabling of vertical synchronization, even if enabled in the project settings. Does not override driver-level V-Sync enforcement.\n");
 	print_help_option("--disable-render-loop", "Disable render loop so rendering only occurs when called explicitly from script.\n");
@@ -1640,6 +1648,16 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 				goto error;
 			}
 
+		} else if (arg == "--cpu-affinity") { // restrict threads to a set of CPUs
+
+			if (N) {
+				cpu_affinity = N->get();
+				N = N->next();
+			} else {
+				OS::get_singleton()->print("Missing CPU list argument, aborting.\n");
+				goto error;
+			}
+
 		} else if (arg == "--time-scale") { // force time scale
 
 			if (N) {
@@ -1873,13 +1891,26 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 	// Initialize WorkerThreadPool.
 	{
 #ifdef THREADS_ENABLED
+		WorkerThreadPool::PoolSettings pool_settings;
 		if (editor || project_manager) {
-			WorkerThreadPool::get_singleton()->init(-1, 0.75);
+			pool_settings.low_priority_task_ratio = 0.75;
 		} else {
-			int worker_threads = GLOBAL_GET("threading/worker_pool/max_threads");
-			float low_priority_ratio = GLOBAL_GET("threading/worker_pool/low_priority_thread_ratio");
-			WorkerThreadPool::get_singleton()->init(worker_threads, low_priority_ratio);
+			pool_settings.thread_count = GLOBAL_GET("threading/worker_pool/max_threads");
+			pool_settings.low_priority_task_ratio = GLOBAL_GET("threading/worker_pool/low_priority_thread_ratio");
+			pool_settings.thread_priority = Thread::Priority(int(GLOBAL_GET("threading/worker_pool/thread_priority")));
+			pool_settings.pin_threads = GLOBAL_GET("threading/worker_pool/pin_threads");
+			pool_settings.measure_task_times = GLOBAL_GET("threading/worker_pool/measure_task_times");
 		}
+		if (!cpu_affinity.is_empty()) {
+			// Only the command line argument restricts the main thread too.
+			pool_settings.cpu_affinity = WorkerThreadPool::parse_cpu_list(cpu_affinity);
+			if (!pool_settings.cpu_affinity.is_empty() && Thread::set_affinity(pool_settings.cpu_affinity) != OK) {
+				WARN_PRINT(vformat("Couldn't restrict the main thread to CPUs \"%s\".", cpu_affinity));
+			}
+		} else if (!editor && !project_manager) {
+			pool_settings.cpu_affinity = WorkerThreadPool::parse_cpu_list(GLOBAL_GET("threading/worker_pool/cpu_affinity"));
+		}
+		WorkerThreadPool::get_singleton()->init(pool_settings);
 #else
 		WorkerThreadPool::get_singleton()->init(0, 0);
 #endif
@@ -4422,6 +4453,8 @@ static uint64_t navigation_process_max = 0;
 bool Main::iteration() {
 	iterating++;
 
+	FrameArena::begin_frame();
+
 	const uint64_t ticks = OS::get_singleton()->get_ticks_usec();
 	Engine::get_singleton()->_frame_ticks = ticks;
 	main_timer_sync.set_cpu_ticks_usec(ticks);
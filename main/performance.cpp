@@ -30,6 +30,7 @@
 
 #include "performance.h"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "core/variant/typed_array.h"
 #include "scene/main/node.h"
@@ -92,6 +93,10 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_FREE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_OBSTACLE_COUNT);
+	BIND_ENUM_CONSTANT(THREADING_WORKER_POOL_QUEUED_TASKS);
+	BIND_ENUM_CONSTANT(THREADING_WORKER_POOL_TASK_WAIT_TIME);
+	BIND_ENUM_CONSTANT(THREADING_WORKER_POOL_TASK_RUN_TIME);
+	BIND_ENUM_CONSTANT(THREADING_WORKER_POOL_STEALS);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -104,6 +109,52 @@ int Performance::_get_node_count() const {
 	return sml->get_node_count();
 }
 
+double Performance::_get_worker_pool_monitor(const WorkerThreadPool *p_pool, WorkerPoolMonitor p_monitor) {
+	if (!p_pool) {
+		return 0;
+	}
+	const WorkerThreadPool::Telemetry telemetry = p_pool->get_telemetry();
+	switch (p_monitor) {
+		case WORKER_POOL_MONITOR_QUEUED_TASKS:
+			return telemetry.queued_tasks;
+		case WORKER_POOL_MONITOR_TASK_WAIT_TIME:
+			return telemetry.average_wait_usec / 1000000.0;
+		case WORKER_POOL_MONITOR_TASK_RUN_TIME:
+			return telemetry.average_run_usec / 1000000.0;
+		case WORKER_POOL_MONITOR_STEALS:
+			return telemetry.steals;
+		default: {
+		}
+	}
+	return 0;
+}
+
+double Performance::_get_named_pool_monitor(const StringName &p_pool_name, int p_monitor) const {
+	return _get_worker_pool_monitor(WorkerThreadPool::get_named_pool(p_pool_name), WorkerPoolMonitor(p_monitor));
+}
+
+void Performance::_add_named_pool_monitors(const StringName &p_pool_name) {
+	static const char *names[WORKER_POOL_MONITOR_MAX] = {
+		"queued_tasks",
+		"task_wait_time",
+		"task_run_time",
+		"steals",
+	};
+	for (int i = 0; i < WORKER_POOL_MONITOR_MAX; i++) {
+		const StringName id = String(p_pool_name) + "/" + names[i];
+		if (!has_custom_monitor(id)) {
+			add_custom_monitor(id, callable_mp(this, &Performance::_get_named_pool_monitor), varray(p_pool_name, i));
+		}
+	}
+}
+
+void Performance::_named_pool_created(const StringName &p_pool_name) {
+	// Pools may be created from any thread, so register their monitors from the main one.
+	if (singleton) {
+		callable_mp(singleton, &Performance::_add_named_pool_monitors).call_deferred(p_pool_name);
+	}
+}
+
 String Performance::get_monitor_name(Monitor p_monitor) const {
 	ERR_FAIL_INDEX_V(p_monitor, MONITOR_MAX, String());
 	static const char *names[MONITOR_MAX] = {
@@ -141,6 +192,10 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		PNAME("navigation/edges_connected"),
 		PNAME("navigation/edges_free"),
 		PNAME("navigation/obstacles"),
+		PNAME("threading/queued_tasks"),
+		PNAME("threading/task_wait_time"),
+		PNAME("threading/task_run_time"),
+		PNAME("threading/steals"),
 
 	};
 	static_assert(std::size(names) == MONITOR_MAX);
@@ -228,6 +283,14 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
 		case NAVIGATION_OBSTACLE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_OBSTACLE_COUNT);
+		case THREADING_WORKER_POOL_QUEUED_TASKS:
+			return _get_worker_pool_monitor(WorkerThreadPool::get_singleton(), WORKER_POOL_MONITOR_QUEUED_TASKS);
+		case THREADING_WORKER_POOL_TASK_WAIT_TIME:
+			return _get_worker_pool_monitor(WorkerThreadPool::get_singleton(), WORKER_POOL_MONITOR_TASK_WAIT_TIME);
+		case THREADING_WORKER_POOL_TASK_RUN_TIME:
+			return _get_worker_pool_monitor(WorkerThreadPool::get_singleton(), WORKER_POOL_MONITOR_TASK_RUN_TIME);
+		case THREADING_WORKER_POOL_STEALS:
+			return _get_worker_pool_monitor(WorkerThreadPool::get_singleton(), WORKER_POOL_MONITOR_STEALS);
 
 		default: {
 		}
@@ -274,6 +337,10 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
@@ -341,6 +408,12 @@ Performance::Performance() {
 	_navigation_process_time = 0;
 	_monitor_modification_time = 0;
 	singleton = this;
+	WorkerThreadPool::named_pool_created_callback = &Performance::_named_pool_created;
+}
+
+Performance::~Performance() {
+	WorkerThreadPool::named_pool_created_callback = nullptr;
+	singleton = nullptr;
 }
 
 Performance::MonitorCall::MonitorCall(Callable p_callable, Vector<Variant> p_arguments) {
@@ -38,6 +38,7 @@
 
 template <typename T>
 class TypedArray;
+class WorkerThreadPool;
 
 class Performance : public Object {
 	GDCLASS(Performance, Object);
@@ -47,6 +48,19 @@ class Performance : public Object {
 
 	int _get_node_count() const;
 
+	enum WorkerPoolMonitor {
+		WORKER_POOL_MONITOR_QUEUED_TASKS,
+		WORKER_POOL_MONITOR_TASK_WAIT_TIME,
+		WORKER_POOL_MONITOR_TASK_RUN_TIME,
+		WORKER_POOL_MONITOR_STEALS,
+		WORKER_POOL_MONITOR_MAX
+	};
+
+	static double _get_worker_pool_monitor(const WorkerThreadPool *p_pool, WorkerPoolMonitor p_monitor);
+	double _get_named_pool_monitor(const StringName &p_pool_name, int p_monitor) const;
+	void _add_named_pool_monitors(const StringName &p_pool_name);
+	static void _named_pool_created(const StringName &p_pool_name);
+
 	double _process_time;
 	double _physics_process_time;
 	double _navigation_process_time;
@@ -100,6 +114,10 @@ public:
 		NAVIGATION_EDGE_CONNECTION_COUNT,
 		NAVIGATION_EDGE_FREE_COUNT,
 		NAVIGATION_OBSTACLE_COUNT,
+		THREADING_WORKER_POOL_QUEUED_TASKS,
+		THREADING_WORKER_POOL_TASK_WAIT_TIME,
+		THREADING_WORKER_POOL_TASK_RUN_TIME,
+		THREADING_WORKER_POOL_STEALS,
 		MONITOR_MAX
 	};
 
@@ -129,6 +147,7 @@ public:
 	static Performance *get_singleton() { return singleton; }
 
 	Performance();
+	~Performance();
 };
 
 VARIANT_ENUM_CAST(Performance::Monitor);
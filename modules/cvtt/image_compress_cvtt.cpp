@@ -30,10 +30,9 @@
 
 #include "image_compress_cvtt.h"
 
-#include "core/object/worker_thread_pool.h"
+#include "core/io/image_compress_scheduler.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
-#include "core/templates/safe_refcount.h"
 
 #include <ConvectionKernels.h>
 
@@ -45,28 +44,13 @@ struct CVTTCompressionJobParams {
 	cvtt::Options options;
 };
 
-struct CVTTCompressionRowTask {
-	Vector<uint8_t> in_mm;
-	uint8_t *out_mm_bytes = nullptr;
-	int y_start = 0;
-	int width = 0;
-	int height = 0;
-};
-
-struct CVTTCompressionJobQueue {
-	CVTTCompressionJobParams job_params;
-	const CVTTCompressionRowTask *job_tasks = nullptr;
-	uint32_t num_tasks = 0;
-	SafeNumeric<uint32_t> current_task;
-};
-
-static void _digest_row_task(const CVTTCompressionJobParams &p_job_params, const CVTTCompressionRowTask &p_row_task) {
-	const uint8_t *in_bytes = p_row_task.in_mm.ptr();
-	uint8_t *out_bytes = p_row_task.out_mm_bytes;
-	int w = p_row_task.width;
-	int h = p_row_task.height;
+static void _digest_row_task(const CVTTCompressionJobParams &p_job_params, const uint8_t *p_in_bytes, uint8_t *p_out_bytes, int p_width, int p_height, int p_y_start) {
+	const uint8_t *in_bytes = p_in_bytes;
+	uint8_t *out_bytes = p_out_bytes;
+	int w = p_width;
+	int h = p_height;
 
-	int y_start = p_row_task.y_start;
+	int y_start = p_y_start;
 	int y_end = y_start + 4;
 
 	int bytes_per_pixel = p_job_params.bytes_per_pixel;
@@ -129,15 +113,12 @@ static void _digest_row_task(const CVTTCompressionJobParams &p_job_params, const
 	}
 }
 
-static void _digest_job_queue(void *p_job_queue, uint32_t p_index) {
-	CVTTCompressionJobQueue *job_queue = static_cast<CVTTCompressionJobQueue *>(p_job_queue);
-	uint32_t num_tasks = job_queue->num_tasks;
-	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
-	uint32_t start = p_index * num_tasks / total_threads;
-	uint32_t end = (p_index + 1 == total_threads) ? num_tasks : ((p_index + 1) * num_tasks / total_threads);
+static void _digest_job(const ImageCompressScheduler::Job &p_job, void *p_userdata) {
+	const CVTTCompressionJobParams &job_params = *static_cast<const CVTTCompressionJobParams *>(p_userdata);
+	const int row_bytes = 16 * (p_job.width / 4);
 
-	for (uint32_t i = start; i < end; i++) {
-		_digest_row_task(job_queue->job_params, job_queue->job_tasks[i]);
+	for (uint32_t y_start = 0; y_start < p_job.height; y_start += 4) {
+		_digest_row_task(job_params, p_job.src, p_job.dst + (y_start / 4) * row_bytes, p_job.width, p_job.height, y_start);
 	}
 }
 
@@ -187,100 +168,17 @@ void image_compress_cvtt(Image *p_image, Image::UsedChannels p_channels) {
 
 	Vector<uint8_t> data;
 	int64_t target_size = Image::get_image_data_size(w, h, target_format, p_image->has_mipmaps());
-	int mm_count = p_image->has_mipmaps() ? Image::get_image_required_mipmaps(w, h, target_format) : 0;
 	data.resize(target_size);
-	int shift = Image::get_format_pixel_rshift(target_format);
-
-	uint8_t *wb = data.ptrw();
-
-	int64_t dst_ofs = 0;
 
-	CVTTCompressionJobQueue job_queue;
-	job_queue.job_params.is_hdr = is_hdr;
-	job_queue.job_params.is_signed = is_signed;
-	job_queue.job_params.options = options;
-	job_queue.job_params.bytes_per_pixel = is_hdr ? 6 : 4;
-	cvtt::Kernels::ConfigureBC7EncodingPlanFromQuality(job_queue.job_params.bc7_plan, 5);
-
-	// Amdahl's law (Wikipedia)
-	// If a program needs 20 hours to complete using a single thread, but a one-hour portion of the program cannot be parallelized,
-	// therefore only the remaining 19 hours (p = 0.95) of execution time can be parallelized, then regardless of how many threads are devoted
-	// to a parallelized execution of this program, the minimum execution time cannot be less than one hour.
-	//
-	// The number of executions with different inputs can be increased while the latency is the same.
-
-	Vector<CVTTCompressionRowTask> tasks;
-
-	for (int i = 0; i <= mm_count; i++) {
-		Vector<uint8_t> in_data;
-		int width, height;
-		Image::get_image_mipmap_offset_and_dimensions(w, h, target_format, i, width, height);
-
-		int bw = width % 4 != 0 ? width + (4 - width % 4) : width;
-		int bh = height % 4 != 0 ? height + (4 - height % 4) : height;
-
-		int64_t src_mip_ofs, src_mip_size;
-		int src_mip_w, src_mip_h;
-		p_image->get_mipmap_offset_size_and_dimensions(i, src_mip_ofs, src_mip_size, src_mip_w, src_mip_h);
-
-		// Pad textures to nearest block by smearing.
-		if (width != src_mip_w || height != src_mip_h) {
-			const uint8_t *src_mip_read = p_image->ptr() + src_mip_ofs;
-
-			// Reserve the buffer for padded image data.
-			int px_size = Image::get_format_pixel_size(p_image->get_format());
-			in_data.resize(width * height * px_size);
-			uint8_t *ptrw = in_data.ptrw();
-
-			int x = 0, y = 0;
-			for (y = 0; y < src_mip_h; y++) {
-				for (x = 0; x < src_mip_w; x++) {
-					memcpy(ptrw + (width * y + x) * px_size, src_mip_read + (src_mip_w * y + x) * px_size, px_size);
-				}
-
-				// First, smear in x.
-				for (; x < width; x++) {
-					memcpy(ptrw + (width * y + x) * px_size, ptrw + (width * y + x - 1) * px_size, px_size);
-				}
-			}
-
-			// Then, smear in y.
-			for (; y < height; y++) {
-				for (x = 0; x < width; x++) {
-					memcpy(ptrw + (width * y + x) * px_size, ptrw + (width * y + x - width) * px_size, px_size);
-				}
-			}
-		} else {
-			// Create a buffer filled with the source mip layer data.
-			in_data.resize(src_mip_size);
-			memcpy(in_data.ptrw(), p_image->ptr() + src_mip_ofs, src_mip_size);
-		}
-
-		//const uint8_t *in_bytes = &rb[src_ofs];
-		uint8_t *out_bytes = &wb[dst_ofs];
-
-		for (int y_start = 0; y_start < height; y_start += 4) {
-			CVTTCompressionRowTask row_task;
-			row_task.width = width;
-			row_task.height = height;
-			row_task.y_start = y_start;
-			row_task.in_mm = in_data;
-			row_task.out_mm_bytes = out_bytes;
-
-			tasks.push_back(row_task);
-
-			out_bytes += 16 * (bw / 4);
-		}
-
-		dst_ofs += (MAX(4, bw) * MAX(4, bh)) >> shift;
-	}
-
-	const CVTTCompressionRowTask *tasks_rb = tasks.ptr();
-
-	job_queue.job_tasks = &tasks_rb[0];
-	job_queue.num_tasks = static_cast<uint32_t>(tasks.size());
-	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&_digest_job_queue, &job_queue, WorkerThreadPool::get_singleton()->get_thread_count(), -1, true, SNAME("CVTT Compress"));
-	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	CVTTCompressionJobParams job_params;
+	job_params.is_hdr = is_hdr;
+	job_params.is_signed = is_signed;
+	job_params.options = options;
+	job_params.bytes_per_pixel = is_hdr ? 6 : 4;
+	cvtt::Kernels::ConfigureBC7EncodingPlanFromQuality(job_params.bc7_plan, 5);
+
+	// Mip levels are padded to whole blocks and compressed in parallel strips.
+	ImageCompressScheduler::compress(p_image, w, h, target_format, data.ptrw(), &_digest_job, &job_params);
 
 	p_image->set_data(w, h, p_image->has_mipmaps(), target_format, data);
 
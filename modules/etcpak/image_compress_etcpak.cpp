@@ -32,6 +32,7 @@
 
 #ifdef TOOLS_ENABLED
 
+#include "core/io/image_compress_scheduler.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 
@@ -90,6 +91,58 @@ void _compress_bc(Image *r_img, Image::UsedChannels p_channels) {
 	_compress_etcpak(_determine_dxt_type(p_channels), r_img);
 }
 
+static void _compress_etcpak_job(const ImageCompressScheduler::Job &p_job, void *p_userdata) {
+	const EtcpakType compress_type = *static_cast<const EtcpakType *>(p_userdata);
+	const uint32_t *src_read = reinterpret_cast<const uint32_t *>(p_job.src);
+	// Blocks are 8 or 16 bytes, so strips are always aligned as etcpak expects.
+	uint64_t *dest_write = reinterpret_cast<uint64_t *>(p_job.dst);
+	const uint32_t blocks = p_job.width * p_job.height / 16;
+
+	switch (compress_type) {
+		case EtcpakType::ETCPAK_TYPE_ETC1:
+			CompressEtc1RgbDither(src_read, dest_write, blocks, p_job.width);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_ETC2:
+			CompressEtc2Rgb(src_read, dest_write, blocks, p_job.width, true);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_ETC2_ALPHA:
+		case EtcpakType::ETCPAK_TYPE_ETC2_RA_AS_RG:
+			CompressEtc2Rgba(src_read, dest_write, blocks, p_job.width, true);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_ETC2_R:
+			CompressEacR(src_read, dest_write, blocks, p_job.width);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_ETC2_RG:
+			CompressEacRg(src_read, dest_write, blocks, p_job.width);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_DXT1:
+			CompressBc1Dither(src_read, dest_write, blocks, p_job.width);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_DXT5:
+		case EtcpakType::ETCPAK_TYPE_DXT5_RA_AS_RG:
+			CompressBc3(src_read, dest_write, blocks, p_job.width);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_RGTC_R:
+			CompressBc4(src_read, dest_write, blocks, p_job.width);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_RGTC_RG:
+			CompressBc5(src_read, dest_write, blocks, p_job.width);
+			break;
+
+		default:
+			ERR_FAIL_MSG("etcpak: Invalid or unsupported compression format.");
+			break;
+	}
+}
+
 void _compress_etcpak(EtcpakType p_compress_type, Image *r_img) {
 	uint64_t start_time = OS::get_singleton()->get_ticks_msec();
 
@@ -197,108 +250,9 @@ void _compress_etcpak(EtcpakType p_compress_type, Image *r_img) {
 	// Create the buffer for compressed image data.
 	Vector<uint8_t> dest_data;
 	dest_data.resize(Image::get_image_data_size(width, height, target_format, has_mipmaps));
-	uint8_t *dest_write = dest_data.ptrw();
-
-	const uint8_t *src_read = r_img->get_data().ptr();
-
-	const int mip_count = has_mipmaps ? Image::get_image_required_mipmaps(width, height, target_format) : 0;
-	Vector<uint32_t> padded_src;
-
-	for (int i = 0; i < mip_count + 1; i++) {
-		// Get write mip metrics for target image.
-		int dest_mip_w, dest_mip_h;
-		int64_t dest_mip_ofs = Image::get_image_mipmap_offset_and_dimensions(width, height, target_format, i, dest_mip_w, dest_mip_h);
-
-		// Ensure that mip offset is a multiple of 8 (etcpak expects uint64_t pointer).
-		ERR_FAIL_COND(dest_mip_ofs % 8 != 0);
-		uint64_t *dest_mip_write = reinterpret_cast<uint64_t *>(dest_write + dest_mip_ofs);
-
-		// Block size.
-		dest_mip_w = (dest_mip_w + 3) & ~3;
-		dest_mip_h = (dest_mip_h + 3) & ~3;
-		const uint32_t blocks = dest_mip_w * dest_mip_h / 16;
-
-		// Get mip data from source image for reading.
-		int64_t src_mip_ofs, src_mip_size;
-		int src_mip_w, src_mip_h;
-
-		r_img->get_mipmap_offset_size_and_dimensions(i, src_mip_ofs, src_mip_size, src_mip_w, src_mip_h);
-
-		const uint32_t *src_mip_read = reinterpret_cast<const uint32_t *>(src_read + src_mip_ofs);
-
-		// Pad textures to nearest block by smearing.
-		if (dest_mip_w != src_mip_w || dest_mip_h != src_mip_h) {
-			// Reserve the buffer for padded image data.
-			padded_src.resize(dest_mip_w * dest_mip_h);
-			uint32_t *ptrw = padded_src.ptrw();
-
-			int x = 0, y = 0;
-			for (y = 0; y < src_mip_h; y++) {
-				for (x = 0; x < src_mip_w; x++) {
-					ptrw[dest_mip_w * y + x] = src_mip_read[src_mip_w * y + x];
-				}
-
-				// First, smear in x.
-				for (; x < dest_mip_w; x++) {
-					ptrw[dest_mip_w * y + x] = ptrw[dest_mip_w * y + x - 1];
-				}
-			}
-
-			// Then, smear in y.
-			for (; y < dest_mip_h; y++) {
-				for (x = 0; x < dest_mip_w; x++) {
-					ptrw[dest_mip_w * y + x] = ptrw[dest_mip_w * y + x - dest_mip_w];
-				}
-			}
-
-			// Override the src_mip_read pointer to our temporary Vector.
-			src_mip_read = padded_src.ptr();
-		}
-
-		switch (p_compress_type) {
-			case EtcpakType::ETCPAK_TYPE_ETC1:
-				CompressEtc1RgbDither(src_mip_read, dest_mip_write, blocks, dest_mip_w);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_ETC2:
-				CompressEtc2Rgb(src_mip_read, dest_mip_write, blocks, dest_mip_w, true);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_ETC2_ALPHA:
-			case EtcpakType::ETCPAK_TYPE_ETC2_RA_AS_RG:
-				CompressEtc2Rgba(src_mip_read, dest_mip_write, blocks, dest_mip_w, true);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_ETC2_R:
-				CompressEacR(src_mip_read, dest_mip_write, blocks, dest_mip_w);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_ETC2_RG:
-				CompressEacRg(src_mip_read, dest_mip_write, blocks, dest_mip_w);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_DXT1:
-				CompressBc1Dither(src_mip_read, dest_mip_write, blocks, dest_mip_w);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_DXT5:
-			case EtcpakType::ETCPAK_TYPE_DXT5_RA_AS_RG:
-				CompressBc3(src_mip_read, dest_mip_write, blocks, dest_mip_w);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_RGTC_R:
-				CompressBc4(src_mip_read, dest_mip_write, blocks, dest_mip_w);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_RGTC_RG:
-				CompressBc5(src_mip_read, dest_mip_write, blocks, dest_mip_w);
-				break;
-
-			default:
-				ERR_FAIL_MSG("etcpak: Invalid or unsupported compression format.");
-				break;
-		}
-	}
+
+	// Mip levels are padded to whole blocks and compressed in parallel strips.
+	ImageCompressScheduler::compress(r_img, width, height, target_format, dest_data.ptrw(), &_compress_etcpak_job, &p_compress_type);
 
 	// Replace original image with compressed one.
 	r_img->set_data(width, height, has_mipmaps, target_format, dest_data);
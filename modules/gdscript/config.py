@@ -3,6 +3,24 @@ def can_build(env, platform):
     return True
 
 
+def get_opts(platform):
+    from SCons.Variables import BoolVariable, PathVariable
+
+    return [
+        BoolVariable(
+            "gdscript_line_traces",
+            "Report the line and stack trace of GDScript errors in release export templates, using a line table looked up only when needed",
+            False,
+        ),
+        PathVariable(
+            "gdscript_native_source",
+            "Path to the C++ source written by exporting a project with 'gdscript/native_source_path' set, to build into the template",
+            "",
+            PathVariable.PathAccept,
+        ),
+    ]
+
+
 def configure(env):
     pass
 
@@ -31,10 +31,12 @@
 #include "gdscript.h"
 
 #include "gdscript_analyzer.h"
+#include "gdscript_bytecode_cache.h"
 #include "gdscript_cache.h"
 #include "gdscript_compiler.h"
 #include "gdscript_parser.h"
 #include "gdscript_rpc_callable.h"
+#include "gdscript_sampling_profiler.h"
 #include "gdscript_tokenizer_buffer.h"
 #include "gdscript_warning.h"
 
@@ -806,13 +808,31 @@ Error GDScript::reload(bool p_keep_state) {
 	}
 #endif
 
+	if (!valid && !has_instances && _owner == nullptr) {
+		Vector<uint8_t> cached = bytecode_cache.is_empty() ? GDScriptBytecodeCache::load(path) : bytecode_cache;
+		bytecode_cache.clear();
+		if (!cached.is_empty() && GDScriptBytecodeCache::deserialize(this, cached) == OK) {
+			Error err = GDScriptCache::finish_compiling(path);
+			if (err == OK && (ScriptServer::is_scripting_enabled() || is_tool())) {
+				err = _static_init();
+			}
+			reloading = false;
+			return err;
+		}
+	}
+
 	valid = false;
-	GDScriptParser parser;
-	Error err;
-	if (!binary_tokens.is_empty()) {
-		err = parser.parse_binary(binary_tokens, path);
-	} else {
-		err = parser.parse(source, path, false);
+	// Scripts found by `GDScriptCache::warm_up()` are already parsed, and usually analyzed too.
+	Ref<GDScriptParserRef> warmed_up = _owner == nullptr ? GDScriptCache::take_warmed_up_parser(path) : Ref<GDScriptParserRef>();
+	GDScriptParser local_parser;
+	GDScriptParser &parser = warmed_up.is_valid() ? *warmed_up->get_parser() : local_parser;
+	Error err = OK;
+	if (warmed_up.is_null()) {
+		if (!binary_tokens.is_empty()) {
+			err = parser.parse_binary(binary_tokens, path);
+		} else {
+			err = parser.parse(source, path, false);
+		}
 	}
 	if (err) {
 		if (EngineDebugger::is_active()) {
@@ -825,7 +845,14 @@ Error GDScript::reload(bool p_keep_state) {
 	}
 
 	GDScriptAnalyzer analyzer(&parser);
-	err = analyzer.analyze();
+	if (warmed_up.is_valid()) {
+		err = warmed_up->raise_status(GDScriptParserRef::FULLY_SOLVED);
+		if (err == OK) {
+			err = warmed_up->get_analyzer()->resolve_dependencies();
+		}
+	} else {
+		err = analyzer.analyze();
+	}
 
 	if (err) {
 		if (EngineDebugger::is_active()) {
@@ -860,6 +887,10 @@ Error GDScript::reload(bool p_keep_state) {
 		}
 	}
 
+	if (_owner == nullptr) {
+		GDScriptBytecodeCache::save(this);
+	}
+
 #ifdef TOOLS_ENABLED
 	// Done after compilation because it needs the GDScript object's inner class GDScript objects,
 	// which are made by calling make_scripts() within compiler.compile() above.
@@ -1533,6 +1564,8 @@ void GDScript::clear(ClearData *p_clear_data) {
 	}
 	clearing = true;
 
+	GDScriptFunction::invalidate_inline_caches();
+
 	ClearData data;
 	ClearData *clear_data = p_clear_data;
 	bool is_root = false;
@@ -1624,6 +1657,8 @@ GDScript::~GDScript() {
 	}
 	destructing = true;
 
+	GDScriptFunction::invalidate_inline_caches();
+
 	if (is_print_verbose_enabled()) {
 		MutexLock lock(func_ptrs_to_update_mutex);
 		if (!func_ptrs_to_update.is_empty()) {
@@ -2274,11 +2309,65 @@ void GDScriptLanguage::init() {
 	}
 #endif
 
+	if (GLOBAL_GET("gdscript/warm_up/enabled")) {
+		_warm_up_scripts();
+	}
+
+	GDScriptSamplingProfiler::handle_cmdline();
+
+#ifdef GDSCRIPT_LINE_TRACES
+	line_traces_error_handler.errfunc = _line_traces_error_handler;
+	line_traces_error_handler.userdata = this;
+	add_error_handler(&line_traces_error_handler);
+#endif
+
 #ifdef TESTS_ENABLED
 	GDScriptTests::GDScriptTestRunner::handle_cmdline();
 #endif
 }
 
+#ifdef GDSCRIPT_LINE_TRACES
+void GDScriptLanguage::_line_traces_error_handler(void *p_self, const char *p_func, const char *p_file, int p_line, const char *p_error, const char *p_errorexp, bool p_editor_notify, ErrorHandlerType p_type) {
+	// Warnings can be raised every frame, a backtrace for each would flood the output.
+	if (_call_stack.stack_pos == 0 || (p_type != ERR_HANDLER_ERROR && p_type != ERR_HANDLER_SCRIPT)) {
+		return;
+	}
+
+	// Follows every error raised while scripts run on this thread, so engine errors can be traced back to the script.
+	String backtrace = "GDScript backtrace (most recent call first):\n";
+	for (int i = _call_stack.stack_pos - 1; i >= 0; i--) {
+		const CallLevel &level = _call_stack.levels[i];
+		String source = level.function->get_source();
+		if (source.is_empty()) {
+			source = "<built-in>";
+		}
+		backtrace += vformat("    [%d] %s (%s:%d)\n", _call_stack.stack_pos - 1 - i, level.function->get_name(), source, _get_call_level_line(level));
+	}
+	OS::get_singleton()->printerr("%s", backtrace.utf8().get_data());
+}
+#endif
+
+void GDScriptLanguage::_warm_up_scripts() {
+	// Global classes and autoloads are the scripts most likely to be needed early on, along with everything they use.
+	Vector<String> paths;
+
+	List<StringName> global_classes;
+	ScriptServer::get_global_class_list(&global_classes);
+	for (const StringName &class_name : global_classes) {
+		if (ScriptServer::get_global_class_language(class_name) == get_name()) {
+			paths.push_back(ScriptServer::get_global_class_path(class_name));
+		}
+	}
+
+	for (const KeyValue<StringName, ProjectSettings::AutoloadInfo> &E : ProjectSettings::get_singleton()->get_autoload_list()) {
+		if (E.value.path.get_extension().to_lower() == get_extension()) {
+			paths.push_back(E.value.path);
+		}
+	}
+
+	GDScriptCache::warm_up(paths);
+}
+
 #ifdef TOOLS_ENABLED
 void GDScriptLanguage::_extension_loaded(const Ref<GDExtension> &p_extension) {
 	List<StringName> class_list;
@@ -2315,6 +2404,12 @@ void GDScriptLanguage::finish() {
 	}
 	finishing = true;
 
+	GDScriptSamplingProfiler::stop();
+
+#ifdef GDSCRIPT_LINE_TRACES
+	remove_error_handler(&line_traces_error_handler);
+#endif
+
 	_call_stack.free();
 
 	// Clear the cache before parsing the script_list
@@ -2351,6 +2446,8 @@ void GDScriptLanguage::finish() {
 	script_list.clear();
 	function_list.clear();
 
+	GDScriptFunctionState::clear_stack_pool();
+
 	finishing = false;
 }
 
@@ -2930,9 +3027,16 @@ GDScriptLanguage::GDScriptLanguage() {
 
 		_debug_max_call_stack = dmcs;
 	} else {
+#ifdef GDSCRIPT_LINE_TRACES
+		_debug_max_call_stack = dmcs;
+#else
 		_debug_max_call_stack = 0;
+#endif
 	}
 
+	GLOBAL_DEF("gdscript/bytecode_cache/enabled", false);
+	GLOBAL_DEF("gdscript/warm_up/enabled", false);
+
 #ifdef DEBUG_ENABLED
 	GLOBAL_DEF("debug/gdscript/warnings/enable", true);
 	GLOBAL_DEF("debug/gdscript/warnings/exclude_addons", true);
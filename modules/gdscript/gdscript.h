@@ -83,6 +83,7 @@ class GDScript : public Script {
 	friend class GDScriptInstance;
 	friend class GDScriptFunction;
 	friend class GDScriptAnalyzer;
+	friend class GDScriptBytecodeCache;
 	friend class GDScriptCompiler;
 	friend class GDScriptDocGen;
 	friend class GDScriptLambdaCallable;
@@ -181,6 +182,7 @@ private:
 	//exported members
 	String source;
 	Vector<uint8_t> binary_tokens;
+	Vector<uint8_t> bytecode_cache; // Entry found by `GDScriptCache` when the script was first requested.
 	String path;
 	bool path_valid = false; // False if using default path.
 	StringName local_name; // Inner class identifier or `class_name`.
@@ -433,6 +435,9 @@ class GDScriptLanguage : public ScriptLanguage {
 		GDScriptInstance *instance = nullptr;
 		int *ip = nullptr;
 		int *line = nullptr;
+#ifdef GDSCRIPT_LINE_TRACES
+		int traced_ip = 0; // Stored by the VM when `ip` is null, see `enter_traced_function()`.
+#endif
 	};
 
 	static thread_local int _debug_parse_err_line;
@@ -456,6 +461,23 @@ class GDScriptLanguage : public ScriptLanguage {
 	static thread_local CallStack _call_stack;
 	int _debug_max_call_stack = 0;
 
+	static int _get_call_level_line(const CallLevel &p_level) {
+#ifdef GDSCRIPT_LINE_TRACES
+		if (p_level.function) {
+			int line = p_level.function->get_line_at(p_level.ip ? *p_level.ip : p_level.traced_ip);
+			if (line >= 0) {
+				return line;
+			}
+		}
+#endif
+		return p_level.line ? *p_level.line : 0;
+	}
+
+#ifdef GDSCRIPT_LINE_TRACES
+	ErrorHandlerList line_traces_error_handler;
+	static void _line_traces_error_handler(void *p_self, const char *p_func, const char *p_file, int p_line, const char *p_error, const char *p_errorexp, bool p_editor_notify, ErrorHandlerType p_type);
+#endif
+
 	void _add_global(const StringName &p_name, const Variant &p_value);
 	void _remove_global(const StringName &p_name);
 
@@ -475,6 +497,8 @@ class GDScriptLanguage : public ScriptLanguage {
 
 	HashMap<String, ObjectID> orphan_subclasses;
 
+	void _warm_up_scripts();
+
 #ifdef TOOLS_ENABLED
 	void _extension_loaded(const Ref<GDExtension> &p_extension);
 	void _extension_unloading(const Ref<GDExtension> &p_extension);
@@ -522,11 +546,40 @@ public:
 		_call_stack.stack_pos--;
 	}
 
+#ifdef GDSCRIPT_LINE_TRACES
+	// Same as `enter_function()`, for release builds which have no debugger. Instead of a pointer to the position, which
+	// would keep it out of a register, returns where the VM stores it before instructions that may raise errors.
+	// Returns null if the function wasn't pushed.
+	_FORCE_INLINE_ int *enter_traced_function(GDScriptInstance *p_instance, GDScriptFunction *p_function, Variant *p_stack, int *p_line) {
+		if (unlikely(_call_stack.levels == nullptr)) {
+			_call_stack.levels = memnew_arr(CallLevel, _debug_max_call_stack + 1);
+		}
+
+		if (unlikely(_call_stack.stack_pos >= _debug_max_call_stack)) {
+			return nullptr; // Deeper calls are left out of the trace.
+		}
+
+		CallLevel &level = _call_stack.levels[_call_stack.stack_pos];
+		level.stack = p_stack;
+		level.instance = p_instance;
+		level.function = p_function;
+		level.ip = nullptr;
+		level.line = p_line;
+		level.traced_ip = 0;
+		_call_stack.stack_pos++;
+		return &level.traced_ip;
+	}
+
+	_FORCE_INLINE_ void exit_traced_function() {
+		_call_stack.stack_pos--;
+	}
+#endif
+
 	virtual Vector<StackInfo> debug_get_current_stack_info() override {
 		Vector<StackInfo> csi;
 		csi.resize(_call_stack.stack_pos);
 		for (int i = 0; i < _call_stack.stack_pos; i++) {
-			csi.write[_call_stack.stack_pos - i - 1].line = _call_stack.levels[i].line ? *_call_stack.levels[i].line : 0;
+			csi.write[_call_stack.stack_pos - i - 1].line = _get_call_level_line(_call_stack.levels[i]);
 			if (_call_stack.levels[i].function) {
 				csi.write[_call_stack.stack_pos - i - 1].func = _call_stack.levels[i].function->get_name();
 				csi.write[_call_stack.stack_pos - i - 1].file = _call_stack.levels[i].function->get_script()->get_script_path();
@@ -0,0 +1,741 @@
+/**************************************************************************/
+/*  gdscript_byte_code_optimizer.cpp                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_byte_code_optimizer.h"
+
+// Bounds the amount of jumps followed when threading a chain of unconditional jumps, so cycles terminate.
+#define MAX_JUMP_THREADING_HOPS 16
+
+int GDScriptByteCodeOptimizer::get_instruction_length(const int *p_code, int p_code_size, int p_ip) {
+	if (p_ip < 0 || p_ip >= p_code_size) {
+		return -1;
+	}
+
+	constexpr int _pointer_size = sizeof(Variant::ValidatedOperatorEvaluator) / sizeof(*p_code);
+	int fixed_args = 0;
+
+	switch (p_code[p_ip]) {
+		case GDScriptFunction::OPCODE_OPERATOR:
+			return 7 + _pointer_size;
+		case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+		case GDScriptFunction::OPCODE_OPERATOR_ADD_INT:
+		case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT:
+		case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT:
+		case GDScriptFunction::OPCODE_OPERATOR_EQUAL_INT:
+		case GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_INT:
+		case GDScriptFunction::OPCODE_OPERATOR_LESS_INT:
+		case GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_INT:
+		case GDScriptFunction::OPCODE_OPERATOR_GREATER_INT:
+		case GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT:
+		case GDScriptFunction::OPCODE_OPERATOR_ADD_FLOAT:
+		case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT:
+		case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT:
+		case GDScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT:
+		case GDScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT:
+		case GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT:
+		case GDScriptFunction::OPCODE_OPERATOR_LESS_FLOAT:
+		case GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT:
+		case GDScriptFunction::OPCODE_OPERATOR_GREATER_FLOAT:
+		case GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT:
+		case GDScriptFunction::OPCODE_OPERATOR_ADD_VECTOR3:
+		case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_VECTOR3:
+		case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT:
+		case GDScriptFunction::OPCODE_SET_KEYED_VALIDATED:
+		case GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED:
+		case GDScriptFunction::OPCODE_GET_KEYED_VALIDATED:
+		case GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED:
+		case GDScriptFunction::OPCODE_RETURN_TYPED_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_FLOAT:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_VECTOR2:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_VECTOR2I:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_VECTOR3:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_VECTOR3I:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_STRING:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_DICTIONARY:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_PACKED_BYTE_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_PACKED_INT32_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_PACKED_INT64_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_PACKED_FLOAT32_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_PACKED_FLOAT64_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_PACKED_STRING_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_PACKED_VECTOR2_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_PACKED_VECTOR3_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_PACKED_COLOR_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_PACKED_VECTOR4_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN_OBJECT:
+		case GDScriptFunction::OPCODE_ITERATE:
+		case GDScriptFunction::OPCODE_ITERATE_INT:
+		case GDScriptFunction::OPCODE_ITERATE_FLOAT:
+		case GDScriptFunction::OPCODE_ITERATE_VECTOR2:
+		case GDScriptFunction::OPCODE_ITERATE_VECTOR2I:
+		case GDScriptFunction::OPCODE_ITERATE_VECTOR3:
+		case GDScriptFunction::OPCODE_ITERATE_VECTOR3I:
+		case GDScriptFunction::OPCODE_ITERATE_STRING:
+		case GDScriptFunction::OPCODE_ITERATE_DICTIONARY:
+		case GDScriptFunction::OPCODE_ITERATE_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_PACKED_BYTE_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_PACKED_INT32_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_PACKED_INT64_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_PACKED_FLOAT32_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_PACKED_FLOAT64_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_PACKED_STRING_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_PACKED_VECTOR2_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_PACKED_VECTOR3_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_PACKED_COLOR_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_PACKED_VECTOR4_ARRAY:
+		case GDScriptFunction::OPCODE_ITERATE_OBJECT:
+		case GDScriptFunction::OPCODE_SET_NAMED:
+		case GDScriptFunction::OPCODE_GET_NAMED:
+			return 5;
+		case GDScriptFunction::OPCODE_TYPE_TEST_ARRAY:
+		case GDScriptFunction::OPCODE_ASSIGN_TYPED_ARRAY:
+			return 6;
+		case GDScriptFunction::OPCODE_TYPE_TEST_BUILTIN:
+		case GDScriptFunction::OPCODE_TYPE_TEST_NATIVE:
+		case GDScriptFunction::OPCODE_TYPE_TEST_SCRIPT:
+		case GDScriptFunction::OPCODE_SET_KEYED:
+		case GDScriptFunction::OPCODE_GET_KEYED:
+		case GDScriptFunction::OPCODE_SET_NAMED_VALIDATED:
+		case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED:
+		case GDScriptFunction::OPCODE_SET_STATIC_VARIABLE:
+		case GDScriptFunction::OPCODE_GET_STATIC_VARIABLE:
+		case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+		case GDScriptFunction::OPCODE_ASSIGN_TYPED_NATIVE:
+		case GDScriptFunction::OPCODE_ASSIGN_TYPED_SCRIPT:
+		case GDScriptFunction::OPCODE_CAST_TO_BUILTIN:
+		case GDScriptFunction::OPCODE_CAST_TO_NATIVE:
+		case GDScriptFunction::OPCODE_CAST_TO_SCRIPT:
+			return 4;
+		case GDScriptFunction::OPCODE_SET_MEMBER:
+		case GDScriptFunction::OPCODE_GET_MEMBER:
+		case GDScriptFunction::OPCODE_ASSIGN:
+		case GDScriptFunction::OPCODE_JUMP_IF:
+		case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+		case GDScriptFunction::OPCODE_JUMP_IF_SHARED:
+		case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN:
+		case GDScriptFunction::OPCODE_RETURN_TYPED_NATIVE:
+		case GDScriptFunction::OPCODE_RETURN_TYPED_SCRIPT:
+		case GDScriptFunction::OPCODE_STORE_GLOBAL:
+		case GDScriptFunction::OPCODE_STORE_NAMED_GLOBAL:
+		case GDScriptFunction::OPCODE_ASSERT:
+			return 3;
+		case GDScriptFunction::OPCODE_ASSIGN_NULL:
+		case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+		case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+		case GDScriptFunction::OPCODE_AWAIT:
+		case GDScriptFunction::OPCODE_AWAIT_RESUME:
+		case GDScriptFunction::OPCODE_JUMP:
+		case GDScriptFunction::OPCODE_RETURN:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_INT:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_FLOAT:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_STRING:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_VECTOR2:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_VECTOR2I:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_RECT2:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_RECT2I:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_VECTOR3:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_VECTOR3I:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_TRANSFORM2D:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_VECTOR4:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_VECTOR4I:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_PLANE:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_QUATERNION:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_AABB:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_BASIS:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_TRANSFORM3D:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_PROJECTION:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_COLOR:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_STRING_NAME:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_NODE_PATH:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_RID:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_OBJECT:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_CALLABLE:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_SIGNAL:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_DICTIONARY:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_ARRAY:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_BYTE_ARRAY:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_INT32_ARRAY:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_INT64_ARRAY:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_FLOAT32_ARRAY:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_FLOAT64_ARRAY:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_STRING_ARRAY:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_VECTOR2_ARRAY:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_VECTOR3_ARRAY:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_COLOR_ARRAY:
+		case GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_VECTOR4_ARRAY:
+		case GDScriptFunction::OPCODE_LINE:
+			return 2;
+		case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT:
+		case GDScriptFunction::OPCODE_BREAKPOINT:
+		case GDScriptFunction::OPCODE_END:
+			return 1;
+
+		// Superinstructions overlay the instructions they fuse, so only the first one is skipped here.
+		case GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF:
+		case GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT:
+			return 5;
+		case GDScriptFunction::OPCODE_GET_MEMBER_OPERATOR_VALIDATED:
+			return 3;
+
+		// Instructions with variable arguments store the amount right after the opcode.
+		case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY:
+		case GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY:
+			fixed_args = 2;
+			break;
+		case GDScriptFunction::OPCODE_CONSTRUCT:
+		case GDScriptFunction::OPCODE_CONSTRUCT_VALIDATED:
+		case GDScriptFunction::OPCODE_CALL_UTILITY:
+		case GDScriptFunction::OPCODE_CALL_UTILITY_VALIDATED:
+		case GDScriptFunction::OPCODE_CALL_GDSCRIPT_UTILITY:
+		case GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED:
+		case GDScriptFunction::OPCODE_CALL_SELF_BASE:
+		case GDScriptFunction::OPCODE_CALL_METHOD_BIND:
+		case GDScriptFunction::OPCODE_CALL_METHOD_BIND_RET:
+		case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC:
+		case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC_VALIDATED_RETURN:
+		case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC_VALIDATED_NO_RETURN:
+		case GDScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN:
+		case GDScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN:
+		case GDScriptFunction::OPCODE_CREATE_LAMBDA:
+		case GDScriptFunction::OPCODE_CREATE_SELF_LAMBDA:
+			fixed_args = 3;
+			break;
+		case GDScriptFunction::OPCODE_CONSTRUCT_TYPED_ARRAY:
+		case GDScriptFunction::OPCODE_CALL_BUILTIN_STATIC:
+		case GDScriptFunction::OPCODE_CALL:
+		case GDScriptFunction::OPCODE_CALL_RETURN:
+		case GDScriptFunction::OPCODE_CALL_ASYNC:
+			fixed_args = 4;
+			break;
+		default:
+			return -1;
+	}
+
+	if (p_ip + 1 >= p_code_size || p_code[p_ip + 1] < 0) {
+		return -1;
+	}
+	return 1 + p_code[p_ip + 1] + fixed_args;
+}
+
+int GDScriptByteCodeOptimizer::_get_base_opcode(int p_instruction) const {
+	int opcode = _get_opcode(p_instruction);
+	if (opcode > GDScriptFunction::OPCODE_OPERATOR_VALIDATED && opcode <= GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT) {
+		return GDScriptFunction::OPCODE_OPERATOR_VALIDATED; // Typed operators share its layout.
+	}
+	return opcode;
+}
+
+int GDScriptByteCodeOptimizer::_get_length(int p_instruction) const {
+	int next = p_instruction + 1 < (int)instructions.size() ? instructions[p_instruction + 1] : code.size();
+	return next - instructions[p_instruction];
+}
+
+bool GDScriptByteCodeOptimizer::_is_temporary(int p_address) const {
+	if (((p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) != GDScriptFunction::ADDR_TYPE_STACK) {
+		return false;
+	}
+	int index = p_address & GDScriptFunction::ADDR_MASK;
+	return index >= first_temporary && index < first_temporary + temporary_count;
+}
+
+bool GDScriptByteCodeOptimizer::_is_constant(int p_address) const {
+	return ((p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) == GDScriptFunction::ADDR_TYPE_CONSTANT;
+}
+
+bool GDScriptByteCodeOptimizer::_has_fallthrough(int p_instruction) const {
+	switch (_get_opcode(p_instruction)) {
+		case GDScriptFunction::OPCODE_JUMP:
+		case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT:
+		case GDScriptFunction::OPCODE_RETURN:
+		case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN:
+		case GDScriptFunction::OPCODE_RETURN_TYPED_ARRAY:
+		case GDScriptFunction::OPCODE_RETURN_TYPED_NATIVE:
+		case GDScriptFunction::OPCODE_RETURN_TYPED_SCRIPT:
+		case GDScriptFunction::OPCODE_END:
+			return false;
+		default:
+			return true;
+	}
+}
+
+int GDScriptByteCodeOptimizer::_get_jump_operand(int p_instruction) const {
+	int opcode = _get_opcode(p_instruction);
+	switch (opcode) {
+		case GDScriptFunction::OPCODE_JUMP:
+			return 1;
+		case GDScriptFunction::OPCODE_JUMP_IF:
+		case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+		case GDScriptFunction::OPCODE_JUMP_IF_SHARED:
+			return 2;
+		default:
+			break;
+	}
+	if (opcode >= GDScriptFunction::OPCODE_ITERATE_BEGIN && opcode <= GDScriptFunction::OPCODE_ITERATE_OBJECT) {
+		return 4;
+	}
+	return -1;
+}
+
+void GDScriptByteCodeOptimizer::_get_successors(int p_instruction, LocalVector<int> &r_successors) const {
+	r_successors.clear();
+	if (_has_fallthrough(p_instruction) && p_instruction + 1 < (int)instructions.size()) {
+		r_successors.push_back(p_instruction + 1);
+	}
+	int jump_operand = _get_jump_operand(p_instruction);
+	if (jump_operand >= 0) {
+		int target = instruction_at[_get_operand(p_instruction, jump_operand)];
+		if (target < (int)instructions.size()) {
+			r_successors.push_back(target);
+		}
+	} else if (_get_opcode(p_instruction) == GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT) {
+		for (int i = 0; i < default_arguments.size(); i++) {
+			int target = instruction_at[default_arguments[i]];
+			if (target < (int)instructions.size()) {
+				r_successors.push_back(target);
+			}
+		}
+	}
+}
+
+bool GDScriptByteCodeOptimizer::_reads_address(int p_instruction, int p_address) const {
+	switch (_get_base_opcode(p_instruction)) {
+		case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+			return _get_operand(p_instruction, 1) == p_address || _get_operand(p_instruction, 2) == p_address;
+		case GDScriptFunction::OPCODE_ASSIGN:
+			return _get_operand(p_instruction, 2) == p_address;
+		case GDScriptFunction::OPCODE_ASSIGN_NULL:
+		case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+		case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+		case GDScriptFunction::OPCODE_JUMP:
+			return false;
+		default:
+			break;
+	}
+
+	// Without a precise operand layout, any operand matching the address counts as a read.
+	int length = _get_length(p_instruction);
+	for (int i = 1; i < length; i++) {
+		if (_get_operand(p_instruction, i) == p_address) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool GDScriptByteCodeOptimizer::_writes_address(int p_instruction, int p_address) const {
+	switch (_get_base_opcode(p_instruction)) {
+		case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+			return _get_operand(p_instruction, 3) == p_address;
+		case GDScriptFunction::OPCODE_ASSIGN:
+		case GDScriptFunction::OPCODE_ASSIGN_NULL:
+		case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+		case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+			return _get_operand(p_instruction, 1) == p_address;
+		default:
+			return false;
+	}
+}
+
+bool GDScriptByteCodeOptimizer::_is_live_after(int p_instruction, int p_address) const {
+	LocalVector<bool> visited;
+	visited.resize(instructions.size());
+	for (uint32_t i = 0; i < visited.size(); i++) {
+		visited[i] = false;
+	}
+
+	LocalVector<int> pending;
+	LocalVector<int> successors;
+	_get_successors(p_instruction, pending);
+
+	while (!pending.is_empty()) {
+		int current = pending[pending.size() - 1];
+		pending.remove_at(pending.size() - 1);
+		if (visited[current]) {
+			continue;
+		}
+		visited[current] = true;
+
+		if (_reads_address(current, p_address)) {
+			return true;
+		}
+		if (_writes_address(current, p_address)) {
+			continue; // The value is overwritten before being read on this path.
+		}
+
+		_get_successors(current, successors);
+		for (int successor : successors) {
+			if (!visited[successor]) {
+				pending.push_back(successor);
+			}
+		}
+	}
+
+	return false;
+}
+
+bool GDScriptByteCodeOptimizer::_decode() {
+	instructions.clear();
+	instruction_at.resize(code.size() + 1);
+	for (uint32_t i = 0; i < instruction_at.size(); i++) {
+		instruction_at[i] = -1;
+	}
+
+	int ip = 0;
+	while (ip < code.size()) {
+		int opcode = code[ip];
+		if (opcode == GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF || opcode == GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT || opcode == GDScriptFunction::OPCODE_GET_MEMBER_OPERATOR_VALIDATED) {
+			return false; // Already optimized.
+		}
+		int length = get_instruction_length(code.ptr(), code.size(), ip);
+		if (length <= 0 || ip + length > code.size()) {
+			return false;
+		}
+		instruction_at[ip] = instructions.size();
+		instructions.push_back(ip);
+		ip += length;
+	}
+	// Jumping to the end of the code is valid.
+	instruction_at[code.size()] = instructions.size();
+
+	// Every position control can be transferred to must be the start of an instruction.
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		int jump_operand = _get_jump_operand(i);
+		if (jump_operand < 0) {
+			continue;
+		}
+		int target = _get_operand(i, jump_operand);
+		if (target < 0 || target > code.size() || instruction_at[target] < 0) {
+			return false;
+		}
+	}
+	for (int i = 0; i < default_arguments.size(); i++) {
+		int target = default_arguments[i];
+		if (target < 0 || target > code.size() || instruction_at[target] < 0) {
+			return false;
+		}
+	}
+
+	removed.resize(instructions.size());
+	for (uint32_t i = 0; i < removed.size(); i++) {
+		removed[i] = false;
+	}
+	return true;
+}
+
+void GDScriptByteCodeOptimizer::_find_jump_targets() {
+	jump_targets.resize(instructions.size() + 1);
+	for (uint32_t i = 0; i < jump_targets.size(); i++) {
+		jump_targets[i] = false;
+	}
+
+	jump_targets[0] = true;
+	for (int i = 0; i < default_arguments.size(); i++) {
+		jump_targets[instruction_at[default_arguments[i]]] = true;
+	}
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		int jump_operand = _get_jump_operand(i);
+		if (jump_operand >= 0) {
+			jump_targets[instruction_at[_get_operand(i, jump_operand)]] = true;
+		}
+		if (_get_opcode(i) == GDScriptFunction::OPCODE_AWAIT) {
+			jump_targets[i + 1] = true; // Execution resumes there.
+		}
+	}
+}
+
+void GDScriptByteCodeOptimizer::_thread_jumps() {
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		int jump_operand = _get_jump_operand(i);
+		if (jump_operand < 0) {
+			continue;
+		}
+
+		// Follow chains of unconditional jumps, which nested loops and branches produce often.
+		int target = _get_operand(i, jump_operand);
+		for (int hops = 0; hops < MAX_JUMP_THREADING_HOPS; hops++) {
+			int target_instruction = instruction_at[target];
+			if (target_instruction >= (int)instructions.size() || _get_opcode(target_instruction) != GDScriptFunction::OPCODE_JUMP) {
+				break;
+			}
+			int next_target = _get_operand(target_instruction, 1);
+			if (next_target == target) {
+				break;
+			}
+			target = next_target;
+		}
+		code.write[instructions[i] + jump_operand] = target;
+
+		// A jump to the next instruction does nothing.
+		if (_get_opcode(i) == GDScriptFunction::OPCODE_JUMP && instruction_at[target] == (int)i + 1) {
+			removed[i] = true;
+		}
+	}
+}
+
+void GDScriptByteCodeOptimizer::_propagate_constants() {
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		if (removed[i] || _get_opcode(i) != GDScriptFunction::OPCODE_ASSIGN) {
+			continue;
+		}
+		int temporary = _get_operand(i, 1);
+		int constant = _get_operand(i, 2);
+		if (!_is_temporary(temporary) || !_is_constant(constant)) {
+			continue;
+		}
+
+		// Forward the constant to the reads in the same basic block whose operand layout is known.
+		for (uint32_t j = i + 1; j < instructions.size(); j++) {
+			if (jump_targets[j]) {
+				break;
+			}
+			if (removed[j]) {
+				continue;
+			}
+
+			int base = instructions[j];
+			switch (_get_base_opcode(j)) {
+				case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+					for (int k = 1; k <= 2; k++) {
+						if (code[base + k] == temporary) {
+							code.write[base + k] = constant;
+						}
+					}
+					break;
+				case GDScriptFunction::OPCODE_ASSIGN:
+					if (code[base + 2] == temporary) {
+						code.write[base + 2] = constant;
+					}
+					break;
+				case GDScriptFunction::OPCODE_JUMP_IF:
+				case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+				case GDScriptFunction::OPCODE_RETURN:
+					if (code[base + 1] == temporary) {
+						code.write[base + 1] = constant;
+					}
+					break;
+				default:
+					break;
+			}
+
+			if (_reads_address(j, temporary) || _writes_address(j, temporary) || !_has_fallthrough(j) || _get_jump_operand(j) >= 0) {
+				break;
+			}
+		}
+
+		if (!_is_live_after(i, temporary)) {
+			removed[i] = true;
+		}
+	}
+}
+
+static bool _is_trivially_copyable(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::BOOL:
+		case Variant::INT:
+		case Variant::FLOAT:
+		case Variant::VECTOR2:
+		case Variant::VECTOR2I:
+		case Variant::RECT2:
+		case Variant::RECT2I:
+		case Variant::VECTOR3:
+		case Variant::VECTOR3I:
+		case Variant::VECTOR4:
+		case Variant::VECTOR4I:
+		case Variant::PLANE:
+		case Variant::QUATERNION:
+		case Variant::COLOR:
+			return true;
+		default:
+			return false;
+	}
+}
+
+void GDScriptByteCodeOptimizer::_eliminate_copies() {
+	for (uint32_t i = 0; i + 1 < instructions.size(); i++) {
+		uint32_t copy = i + 1;
+		if (removed[i] || removed[copy] || jump_targets[copy]) {
+			continue;
+		}
+		if (_get_base_opcode(i) != GDScriptFunction::OPCODE_OPERATOR_VALIDATED || _get_opcode(copy) != GDScriptFunction::OPCODE_ASSIGN) {
+			continue;
+		}
+
+		// Only values without heap storage are written in place, so a local that is also an operand is safe to alias.
+		const Variant::Type *type = local_copies.getptr(instructions[copy]);
+		if (!type || !_is_trivially_copyable(*type)) {
+			continue;
+		}
+
+		int temporary = _get_operand(i, 3);
+		if (!_is_temporary(temporary) || _get_operand(copy, 2) != temporary || _is_live_after(copy, temporary)) {
+			continue;
+		}
+
+		code.write[instructions[i] + 3] = _get_operand(copy, 1);
+		removed[copy] = true;
+	}
+}
+
+void GDScriptByteCodeOptimizer::_compact() {
+	// Removed instructions have no length, so jumps to them land on the next kept instruction.
+	LocalVector<int> new_position;
+	new_position.resize(instructions.size() + 1);
+	int size = 0;
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		new_position[i] = size;
+		if (!removed[i]) {
+			size += _get_length(i);
+		}
+	}
+	new_position[instructions.size()] = size;
+
+	Vector<int> new_code;
+	new_code.resize(size);
+	int *dst = new_code.ptrw();
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		if (removed[i]) {
+			continue;
+		}
+		int length = _get_length(i);
+		memcpy(dst, &code[instructions[i]], length * sizeof(int));
+		int jump_operand = _get_jump_operand(i);
+		if (jump_operand >= 0) {
+			dst[jump_operand] = new_position[instruction_at[dst[jump_operand]]];
+		}
+		dst += length;
+	}
+
+	for (int i = 0; i < default_arguments.size(); i++) {
+		default_arguments.write[i] = new_position[instruction_at[default_arguments[i]]];
+	}
+
+#ifdef GDSCRIPT_LINE_TABLES
+	if (line_table) {
+		// A line with no code of its own is superseded by the next one starting at the same position.
+		line_table->clear();
+		for (const GDScriptFunction::LinePosition &stripped : stripped_lines) {
+			GDScriptFunction::LinePosition entry;
+			entry.position = new_position[stripped.position];
+			entry.line = stripped.line;
+			if (!line_table->is_empty() && line_table->get(line_table->size() - 1).position == entry.position) {
+				line_table->write[line_table->size() - 1] = entry;
+			} else {
+				line_table->push_back(entry);
+			}
+		}
+		stripped_lines.clear();
+	}
+#endif
+
+	code = new_code;
+}
+
+#ifdef GDSCRIPT_LINE_TABLES
+void GDScriptByteCodeOptimizer::_strip_lines() {
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		if (removed[i] || _get_opcode(i) != GDScriptFunction::OPCODE_LINE) {
+			continue;
+		}
+		GDScriptFunction::LinePosition stripped;
+		stripped.position = i;
+		stripped.line = _get_operand(i, 1);
+		stripped_lines.push_back(stripped);
+		removed[i] = true;
+	}
+}
+#endif
+
+void GDScriptByteCodeOptimizer::_fuse_superinstructions() {
+	// Superinstructions only replace the opcode of the first instruction, leaving the operands of both in place.
+	// The second instruction stays valid on its own, so it can still be a jump target.
+	for (uint32_t i = 0; i + 1 < instructions.size(); i++) {
+		if (_get_base_opcode(i) != GDScriptFunction::OPCODE_OPERATOR_VALIDATED) {
+			continue;
+		}
+		int next = _get_opcode(i + 1);
+		if ((next != GDScriptFunction::OPCODE_JUMP_IF && next != GDScriptFunction::OPCODE_JUMP_IF_NOT) || _get_operand(i + 1, 1) != _get_operand(i, 3)) {
+			continue;
+		}
+		code.write[instructions[i]] = next == GDScriptFunction::OPCODE_JUMP_IF ? GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF : GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT;
+	}
+
+	for (uint32_t i = 0; i + 1 < instructions.size(); i++) {
+		if (_get_opcode(i) != GDScriptFunction::OPCODE_GET_MEMBER || _get_base_opcode(i + 1) != GDScriptFunction::OPCODE_OPERATOR_VALIDATED) {
+			continue;
+		}
+		int member = _get_operand(i, 1);
+		if (_get_operand(i + 1, 1) != member && _get_operand(i + 1, 2) != member) {
+			continue;
+		}
+		code.write[instructions[i]] = GDScriptFunction::OPCODE_GET_MEMBER_OPERATOR_VALIDATED;
+	}
+}
+
+void GDScriptByteCodeOptimizer::optimize() {
+	if (!_decode()) {
+		return;
+	}
+
+	_find_jump_targets();
+	_thread_jumps();
+	_find_jump_targets();
+	_propagate_constants();
+	_eliminate_copies();
+#ifdef GDSCRIPT_LINE_TABLES
+	if (line_table) {
+		_strip_lines();
+	}
+#endif
+
+	bool any_removed = false;
+	for (uint32_t i = 0; i < removed.size(); i++) {
+		any_removed = any_removed || removed[i];
+	}
+	if (any_removed) {
+		_compact();
+		if (!_decode()) {
+			return;
+		}
+	}
+
+	_fuse_superinstructions();
+}
+
+GDScriptByteCodeOptimizer::GDScriptByteCodeOptimizer(Vector<int> &r_code, Vector<int> &r_default_arguments, int p_first_temporary, int p_temporary_count, const HashMap<int, Variant::Type> &p_local_copies) :
+		code(r_code),
+		default_arguments(r_default_arguments),
+		first_temporary(p_first_temporary),
+		temporary_count(p_temporary_count),
+		local_copies(p_local_copies) {
+}
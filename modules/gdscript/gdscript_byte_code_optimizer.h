@@ -0,0 +1,94 @@
+/**************************************************************************/
+/*  gdscript_byte_code_optimizer.h                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "gdscript_function.h"
+
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Peephole optimizer run over the final bytecode of a function, after temporaries have been
+// resolved to stack slots. Every rewrite only touches instructions whose operand layout is
+// known; if the function contains anything it cannot decode, the code is left untouched.
+class GDScriptByteCodeOptimizer {
+	Vector<int> &code;
+	Vector<int> &default_arguments;
+	int first_temporary = 0;
+	int temporary_count = 0;
+	const HashMap<int, Variant::Type> &local_copies;
+
+	LocalVector<int> instructions; // Start position of each instruction, in order.
+	LocalVector<int> instruction_at; // Instruction index for each code position, or -1.
+	LocalVector<bool> jump_targets; // Indexed by instruction.
+	LocalVector<bool> removed; // Indexed by instruction.
+
+#ifdef GDSCRIPT_LINE_TABLES
+	Vector<GDScriptFunction::LinePosition> *line_table = nullptr;
+	LocalVector<GDScriptFunction::LinePosition> stripped_lines; // Position is the instruction index until compacted.
+#endif
+
+	int _get_opcode(int p_instruction) const { return code[instructions[p_instruction]]; }
+	int _get_operand(int p_instruction, int p_operand) const { return code[instructions[p_instruction] + p_operand]; }
+	int _get_base_opcode(int p_instruction) const;
+	int _get_length(int p_instruction) const;
+	bool _is_temporary(int p_address) const;
+	bool _is_constant(int p_address) const;
+	bool _has_fallthrough(int p_instruction) const;
+	int _get_jump_operand(int p_instruction) const;
+	void _get_successors(int p_instruction, LocalVector<int> &r_successors) const;
+	bool _reads_address(int p_instruction, int p_address) const;
+	bool _writes_address(int p_instruction, int p_address) const;
+	bool _is_live_after(int p_instruction, int p_address) const;
+
+	bool _decode();
+	void _find_jump_targets();
+	void _thread_jumps();
+	void _propagate_constants();
+	void _eliminate_copies();
+	void _compact();
+	void _fuse_superinstructions();
+#ifdef GDSCRIPT_LINE_TABLES
+	void _strip_lines();
+#endif
+
+public:
+	static int get_instruction_length(const int *p_code, int p_code_size, int p_ip);
+
+#ifdef GDSCRIPT_LINE_TABLES
+	// Moves the `OPCODE_LINE` instructions out of the code into `r_line_table`.
+	void set_line_table(Vector<GDScriptFunction::LinePosition> *r_line_table) { line_table = r_line_table; }
+#endif
+	void optimize();
+
+	// `p_local_copies` maps the position of each `OPCODE_ASSIGN` that copies a temporary into an already
+	// initialized local of the same built-in type to that type.
+	GDScriptByteCodeOptimizer(Vector<int> &r_code, Vector<int> &r_default_arguments, int p_first_temporary, int p_temporary_count, const HashMap<int, Variant::Type> &p_local_copies);
+};
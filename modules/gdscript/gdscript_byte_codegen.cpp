@@ -31,6 +31,8 @@
 #include "gdscript_byte_codegen.h"
 
 #include "gdscript.h"
+#include "gdscript_byte_code_optimizer.h"
+#include "gdscript_native.h"
 
 #include "core/debugger/engine_debugger.h"
 
@@ -47,6 +49,7 @@ uint32_t GDScriptByteCodeGenerator::add_parameter(const StringName &p_name, bool
 uint32_t GDScriptByteCodeGenerator::add_local(const StringName &p_name, const GDScriptDataType &p_type) {
 	int stack_pos = locals.size() + GDScriptFunction::FIXED_ADDRESSES_MAX;
 	locals.push_back(StackSlot(p_type.builtin_type, p_type.can_contain_object()));
+	initialized_locals.erase(stack_pos);
 	add_stack_identifier(p_name, stack_pos);
 	return stack_pos;
 }
@@ -196,6 +199,12 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 		}
 	}
 
+	GDScriptByteCodeOptimizer optimizer(opcodes, function->default_arguments, max_locals + GDScriptFunction::FIXED_ADDRESSES_MAX, temporaries.size(), local_copies);
+#ifdef GDSCRIPT_LINE_TRACES
+	optimizer.set_line_table(&function->line_table);
+#endif
+	optimizer.optimize();
+
 	if (constant_map.size()) {
 		function->_constant_count = constant_map.size();
 		function->constants.resize(constant_map.size());
@@ -395,6 +404,15 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 		function->_lambdas_count = 0;
 	}
 
+	if (inline_cache_count) {
+		function->inline_caches.resize(inline_cache_count);
+		function->_inline_caches_ptr = function->inline_caches.ptrw();
+		function->_inline_caches_count = inline_cache_count;
+	} else {
+		function->_inline_caches_ptr = nullptr;
+		function->_inline_caches_count = 0;
+	}
+
 	if (debug_stack) {
 		function->stack_debug = stack_debug;
 	}
@@ -409,6 +427,8 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 	function->constructors_names = constructors_names;
 	function->utilities_names = utilities_names;
 	function->gds_utilities_names = gds_utilities_names;
+#else
+	function->native_body = GDScriptNative::get_body(function);
 #endif
 
 	ended = true;
@@ -584,6 +604,71 @@ void GDScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Va
 	}
 }
 
+// Operators on int, float and Vector3 operands that have a dedicated instruction, computed without going through the evaluator.
+static GDScriptFunction::Opcode _get_typed_operator_opcode(Variant::Operator p_operator, Variant::Type p_left_type, Variant::Type p_right_type) {
+	if (p_left_type == Variant::INT && p_right_type == Variant::INT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return GDScriptFunction::OPCODE_OPERATOR_ADD_INT;
+			case Variant::OP_SUBTRACT:
+				return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT;
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT;
+			case Variant::OP_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_EQUAL_INT;
+			case Variant::OP_NOT_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_INT;
+			case Variant::OP_LESS:
+				return GDScriptFunction::OPCODE_OPERATOR_LESS_INT;
+			case Variant::OP_LESS_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_INT;
+			case Variant::OP_GREATER:
+				return GDScriptFunction::OPCODE_OPERATOR_GREATER_INT;
+			case Variant::OP_GREATER_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT;
+			default:
+				break;
+		}
+	} else if (p_left_type == Variant::FLOAT && p_right_type == Variant::FLOAT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return GDScriptFunction::OPCODE_OPERATOR_ADD_FLOAT;
+			case Variant::OP_SUBTRACT:
+				return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT;
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT;
+			case Variant::OP_DIVIDE:
+				return GDScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT;
+			case Variant::OP_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT;
+			case Variant::OP_NOT_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT;
+			case Variant::OP_LESS:
+				return GDScriptFunction::OPCODE_OPERATOR_LESS_FLOAT;
+			case Variant::OP_LESS_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT;
+			case Variant::OP_GREATER:
+				return GDScriptFunction::OPCODE_OPERATOR_GREATER_FLOAT;
+			case Variant::OP_GREATER_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT;
+			default:
+				break;
+		}
+	} else if (p_left_type == Variant::VECTOR3 && p_right_type == Variant::VECTOR3) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return GDScriptFunction::OPCODE_OPERATOR_ADD_VECTOR3;
+			case Variant::OP_SUBTRACT:
+				return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_VECTOR3;
+			default:
+				break;
+		}
+	} else if (p_left_type == Variant::VECTOR3 && p_right_type == Variant::FLOAT && p_operator == Variant::OP_MULTIPLY) {
+		return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT;
+	}
+	return GDScriptFunction::OPCODE_OPERATOR_VALIDATED;
+}
+
 void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand) {
 	bool valid = HAS_BUILTIN_TYPE(p_left_operand) && HAS_BUILTIN_TYPE(p_right_operand);
 
@@ -615,7 +700,14 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 
-		append_opcode(GDScriptFunction::OPCODE_OPERATOR_VALIDATED);
+		if (p_target.mode == Address::TEMPORARY) {
+			last_operator_pos = opcodes.size();
+			last_operator_temporary = p_target.address;
+			last_operator_type = Variant::get_operator_return_type(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
+		}
+
+		// The evaluator is kept even for typed instructions, so all of them share the same layout.
+		append_opcode(_get_typed_operator_opcode(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type));
 		append(p_left_operand);
 		append(p_right_operand);
 		append(p_target);
@@ -849,6 +941,7 @@ void GDScriptByteCodeGenerator::write_set_named(const Address &p_target, const S
 	append(p_target);
 	append(p_source);
 	append(p_name);
+	append(get_inline_cache_pos(p_target, false));
 }
 
 void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
@@ -867,6 +960,7 @@ void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const S
 	append(p_source);
 	append(p_target);
 	append(p_name);
+	append(get_inline_cache_pos(p_source, false));
 }
 
 void GDScriptByteCodeGenerator::write_set_member(const Address &p_value, const StringName &p_name) {
@@ -959,10 +1053,20 @@ void GDScriptByteCodeGenerator::write_assign(const Address &p_target, const Addr
 		append(p_source);
 		append(p_target.type.builtin_type);
 	} else {
+		// Copy of an operator result into a local already holding the same type, the optimizer can drop it.
+		if (p_target.mode == Address::LOCAL_VARIABLE && p_source.mode == Address::TEMPORARY && p_source.address == last_operator_temporary && last_operator_pos + 5 == int(opcodes.size())) {
+			if (p_target.type.kind == GDScriptDataType::BUILTIN && p_target.type.builtin_type == last_operator_type && initialized_locals.has(p_target.address)) {
+				local_copies.insert(opcodes.size(), last_operator_type);
+			}
+		}
 		append_opcode(GDScriptFunction::OPCODE_ASSIGN);
 		append(p_target);
 		append(p_source);
 	}
+
+	if (p_target.mode == Address::LOCAL_VARIABLE) {
+		initialized_locals.insert(p_target.address);
+	}
 }
 
 void GDScriptByteCodeGenerator::write_assign_null(const Address &p_target) {
@@ -1057,6 +1161,7 @@ void GDScriptByteCodeGenerator::write_call(const Address &p_target, const Addres
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(get_inline_cache_pos(p_base, true));
 	ct.cleanup();
 }
 
@@ -1082,6 +1187,7 @@ void GDScriptByteCodeGenerator::write_call_async(const Address &p_target, const
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(get_inline_cache_pos(p_base, true));
 	ct.cleanup();
 }
 
@@ -1316,6 +1422,7 @@ void GDScriptByteCodeGenerator::write_call_self(const Address &p_target, const S
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(get_inline_cache_pos(Address(Address::SELF), true));
 	ct.cleanup();
 }
 
@@ -1329,6 +1436,7 @@ void GDScriptByteCodeGenerator::write_call_self_async(const Address &p_target, c
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(get_inline_cache_pos(Address(Address::SELF), true));
 	ct.cleanup();
 }
 
@@ -1342,6 +1450,7 @@ void GDScriptByteCodeGenerator::write_call_script_function(const Address &p_targ
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(get_inline_cache_pos(p_base, true));
 	ct.cleanup();
 }
 
@@ -1841,6 +1950,7 @@ void GDScriptByteCodeGenerator::clear_address(const Address &p_address) {
 
 	if (p_address.mode == Address::LOCAL_VARIABLE) {
 		dirty_locals.erase(p_address.address);
+		initialized_locals.insert(p_address.address);
 	}
 }
 
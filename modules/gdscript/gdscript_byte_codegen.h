@@ -84,6 +84,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 
 	Vector<StackSlot> locals;
 	HashSet<int> dirty_locals;
+	HashSet<int> initialized_locals; // Locals written since they were added, so their typed value is in place.
 
 	Vector<StackSlot> temporaries;
 	List<int> used_temporaries;
@@ -97,6 +98,13 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	int max_locals = 0;
 	int current_line = 0;
 	int instr_args_max = 0;
+	int inline_cache_count = 0;
+
+	// Last validated operator written into a temporary, so the optimizer can write its result straight into a local.
+	int last_operator_pos = -1;
+	uint32_t last_operator_temporary = UINT32_MAX;
+	Variant::Type last_operator_type = Variant::NIL;
+	HashMap<int, Variant::Type> local_copies;
 
 #ifdef DEBUG_ENABLED
 	List<int> temp_stack;
@@ -195,6 +203,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 #endif
 		for (int i = current_locals; i < locals.size(); i++) {
 			dirty_locals.insert(i + GDScriptFunction::FIXED_ADDRESSES_MAX);
+			initialized_locals.erase(i + GDScriptFunction::FIXED_ADDRESSES_MAX);
 		}
 		locals.resize(current_locals);
 		if (debug_stack) {
@@ -348,6 +357,20 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 		return pos;
 	}
 
+	// Returns the inline cache slot for a named access or call on p_base, or -1 when the VM would never use one:
+	// the caches only hold object lookups, and debug builds don't read them for calls.
+	int get_inline_cache_pos(const Address &p_base, bool p_is_call) {
+#ifdef DEBUG_ENABLED
+		if (p_is_call) {
+			return -1;
+		}
+#endif
+		if (p_base.type.has_type && p_base.type.kind == GDScriptDataType::BUILTIN && p_base.type.builtin_type != Variant::OBJECT) {
+			return -1;
+		}
+		return inline_cache_count++;
+	}
+
 	CallTarget get_call_target(const Address &p_target, Variant::Type p_type = Variant::NIL);
 
 	int address_of(const Address &p_address) {
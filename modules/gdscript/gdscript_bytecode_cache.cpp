@@ -0,0 +1,2171 @@
+/**************************************************************************/
+/*  gdscript_bytecode_cache.cpp                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_bytecode_cache.h"
+
+#include "gdscript_byte_code_optimizer.h"
+#include "gdscript_cache.h"
+#include "gdscript_native.h"
+
+#include "core/config/engine.h"
+#include "core/config/project_settings.h"
+#include "core/debugger/engine_debugger.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/marshalls.h"
+#include "core/io/resource_loader.h"
+#include "core/os/os.h"
+#include "core/version.h"
+
+static constexpr uint32_t BYTECODE_CACHE_MAGIC = 0x43424447; // "GDBC".
+static constexpr uint32_t BYTECODE_CACHE_FORMAT_VERSION = 2;
+
+template <typename K, typename V>
+static const V *_find_key(const RBMap<K, V> &p_map, const K &p_key) {
+	const typename RBMap<K, V>::Element *E = p_map.find(p_key);
+	return E ? &E->get() : nullptr;
+}
+
+struct GDScriptBytecodeCache::Writer {
+	LocalVector<uint8_t> data;
+
+	void put_u8(uint8_t p_value) {
+		data.push_back(p_value);
+	}
+
+	void put_u32(uint32_t p_value) {
+		uint32_t position = data.size();
+		data.resize(position + 4);
+		encode_uint32(p_value, &data[position]);
+	}
+
+	void put_32(int32_t p_value) {
+		put_u32((uint32_t)p_value);
+	}
+
+	void put_string(const String &p_string) {
+		const CharString utf8 = p_string.utf8();
+		put_u32(utf8.length());
+		uint32_t position = data.size();
+		data.resize(position + utf8.length());
+		memcpy(data.ptr() + position, utf8.get_data(), utf8.length());
+	}
+
+	bool put_variant(const Variant &p_variant) {
+		int length = 0;
+		if (encode_variant(p_variant, nullptr, length) != OK) {
+			return false;
+		}
+		put_u32(length);
+		uint32_t position = data.size();
+		data.resize(position + length);
+		return encode_variant(p_variant, data.ptr() + position, length) == OK;
+	}
+};
+
+struct GDScriptBytecodeCache::Reader {
+	const uint8_t *data = nullptr;
+	uint32_t size = 0;
+	uint32_t position = 0;
+	bool failed = false;
+
+	bool has(uint32_t p_bytes) {
+		if (failed || size - position < p_bytes) {
+			failed = true;
+			return false;
+		}
+		return true;
+	}
+
+	uint8_t get_u8() {
+		if (!has(1)) {
+			return 0;
+		}
+		return data[position++];
+	}
+
+	uint32_t get_u32() {
+		if (!has(4)) {
+			return 0;
+		}
+		uint32_t value = decode_uint32(data + position);
+		position += 4;
+		return value;
+	}
+
+	int32_t get_32() {
+		return (int32_t)get_u32();
+	}
+
+	// Counts are checked against what's left to read, given the smallest size an element is written with,
+	// so a corrupted count fails before anything gets allocated for it.
+	uint32_t get_count(uint32_t p_element_size = 1) {
+		uint32_t count = get_u32();
+		if (failed || count > (size - position) / p_element_size) {
+			failed = true;
+			return 0;
+		}
+		return count;
+	}
+
+	String get_string() {
+		uint32_t length = get_count();
+		if (failed) {
+			return String();
+		}
+		String string = String::utf8((const char *)data + position, length);
+		position += length;
+		return string;
+	}
+
+	Variant get_variant() {
+		uint32_t length = get_count();
+		if (failed) {
+			return Variant();
+		}
+		Variant variant;
+		int used = 0;
+		if (decode_variant(variant, data + position, length, &used) != OK || used != (int)length) {
+			failed = true;
+			return Variant();
+		}
+		position += length;
+		return variant;
+	}
+
+	Reader(const Vector<uint8_t> &p_buffer) {
+		data = p_buffer.ptr();
+		size = p_buffer.size();
+	}
+};
+
+Mutex GDScriptBytecodeCache::mutex;
+HashMap<String, String> GDScriptBytecodeCache::source_md5s;
+uint32_t GDScriptBytecodeCache::extension_api_hash = 0;
+bool GDScriptBytecodeCache::extension_api_hash_valid = false;
+
+bool GDScriptBytecodeCache::function_keys_valid = false;
+RBMap<Variant::ValidatedOperatorEvaluator, uint32_t> GDScriptBytecodeCache::operator_keys;
+RBMap<Variant::ValidatedSetter, GDScriptBytecodeCache::MemberKey> GDScriptBytecodeCache::setter_keys;
+RBMap<Variant::ValidatedGetter, GDScriptBytecodeCache::MemberKey> GDScriptBytecodeCache::getter_keys;
+RBMap<Variant::ValidatedKeyedSetter, Variant::Type> GDScriptBytecodeCache::keyed_setter_keys;
+RBMap<Variant::ValidatedKeyedGetter, Variant::Type> GDScriptBytecodeCache::keyed_getter_keys;
+RBMap<Variant::ValidatedIndexedSetter, Variant::Type> GDScriptBytecodeCache::indexed_setter_keys;
+RBMap<Variant::ValidatedIndexedGetter, Variant::Type> GDScriptBytecodeCache::indexed_getter_keys;
+RBMap<Variant::ValidatedBuiltInMethod, GDScriptBytecodeCache::MemberKey> GDScriptBytecodeCache::builtin_method_keys;
+RBMap<Variant::ValidatedConstructor, GDScriptBytecodeCache::MemberKey> GDScriptBytecodeCache::constructor_keys;
+RBMap<Variant::ValidatedUtilityFunction, StringName> GDScriptBytecodeCache::utility_keys;
+RBMap<GDScriptUtilityFunctions::FunctionPtr, StringName> GDScriptBytecodeCache::gds_utility_keys;
+
+uint32_t GDScriptBytecodeCache::_get_build_flags() {
+	uint32_t flags = 0;
+#ifdef DEBUG_ENABLED
+	flags |= BUILD_DEBUG;
+#endif
+#ifdef TOOLS_ENABLED
+	flags |= BUILD_TOOLS;
+#endif
+#ifdef REAL_T_IS_DOUBLE
+	flags |= BUILD_REAL_T_IS_DOUBLE;
+#endif
+#ifdef GDSCRIPT_LINE_TRACES
+	flags |= BUILD_LINE_TRACES;
+#endif
+	if (EngineDebugger::is_active()) {
+		// Functions keep their stack debug info only when compiled with a debugger attached.
+		flags |= BUILD_DEBUGGER;
+	}
+	if (sizeof(void *) == 8) {
+		flags |= BUILD_64_BITS;
+	}
+	return flags;
+}
+
+uint32_t GDScriptBytecodeCache::_get_extension_api_hash() {
+	MutexLock lock(mutex);
+	if (extension_api_hash_valid) {
+		return extension_api_hash;
+	}
+
+	// `ClassDB::get_api_hash()` is only available in debug builds, and core classes are covered by the engine version anyway.
+	uint32_t hash = hash_murmur3_one_32(BYTECODE_CACHE_FORMAT_VERSION);
+	List<StringName> classes;
+	ClassDB::get_class_list(&classes);
+	for (const StringName &class_name : classes) {
+		ClassDB::APIType api = ClassDB::get_api_type(class_name);
+		if (api != ClassDB::API_EXTENSION && api != ClassDB::API_EDITOR_EXTENSION) {
+			continue;
+		}
+		hash = hash_murmur3_one_32(class_name.hash(), hash);
+		hash = hash_murmur3_one_32(ClassDB::get_parent_class(class_name).hash(), hash);
+
+		List<MethodInfo> methods;
+		ClassDB::get_method_list(class_name, &methods, true);
+		LocalVector<StringName> method_names;
+		for (const MethodInfo &method : methods) {
+			method_names.push_back(method.name);
+		}
+		method_names.sort_custom<StringName::AlphCompare>();
+		for (const StringName &method_name : method_names) {
+			MethodBind *method = ClassDB::get_method(class_name, method_name);
+			if (method != nullptr) {
+				hash = hash_murmur3_one_32(method_name.hash(), hash);
+				hash = hash_murmur3_one_32(method->get_hash(), hash);
+			}
+		}
+
+		List<String> constants;
+		ClassDB::get_integer_constant_list(class_name, &constants, true);
+		constants.sort();
+		for (const String &constant : constants) {
+			hash = hash_murmur3_one_32(constant.hash(), hash);
+			hash = hash_murmur3_one_64(ClassDB::get_integer_constant(class_name, constant), hash);
+		}
+	}
+
+	extension_api_hash = hash_fmix32(hash);
+	extension_api_hash_valid = true;
+	return extension_api_hash;
+}
+
+void GDScriptBytecodeCache::_build_function_keys() {
+	MutexLock lock(mutex);
+	if (function_keys_valid) {
+		return;
+	}
+
+	for (int op = 0; op < Variant::OP_MAX; op++) {
+		for (int a = 0; a < Variant::VARIANT_MAX; a++) {
+			for (int b = 0; b < Variant::VARIANT_MAX; b++) {
+				Variant::ValidatedOperatorEvaluator evaluator = Variant::get_validated_operator_evaluator((Variant::Operator)op, (Variant::Type)a, (Variant::Type)b);
+				if (evaluator != nullptr && !operator_keys.has(evaluator)) {
+					operator_keys.insert(evaluator, (op << 16) | (a << 8) | b);
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < Variant::VARIANT_MAX; i++) {
+		Variant::Type type = (Variant::Type)i;
+
+		List<StringName> members;
+		Variant::get_member_list(type, &members);
+		for (const StringName &member : members) {
+			Variant::ValidatedSetter setter = Variant::get_member_validated_setter(type, member);
+			if (setter != nullptr && !setter_keys.has(setter)) {
+				setter_keys.insert(setter, { type, member, 0 });
+			}
+			Variant::ValidatedGetter getter = Variant::get_member_validated_getter(type, member);
+			if (getter != nullptr && !getter_keys.has(getter)) {
+				getter_keys.insert(getter, { type, member, 0 });
+			}
+		}
+
+		Variant::ValidatedKeyedSetter keyed_setter = Variant::get_member_validated_keyed_setter(type);
+		if (keyed_setter != nullptr && !keyed_setter_keys.has(keyed_setter)) {
+			keyed_setter_keys.insert(keyed_setter, type);
+		}
+		Variant::ValidatedKeyedGetter keyed_getter = Variant::get_member_validated_keyed_getter(type);
+		if (keyed_getter != nullptr && !keyed_getter_keys.has(keyed_getter)) {
+			keyed_getter_keys.insert(keyed_getter, type);
+		}
+		Variant::ValidatedIndexedSetter indexed_setter = Variant::get_member_validated_indexed_setter(type);
+		if (indexed_setter != nullptr && !indexed_setter_keys.has(indexed_setter)) {
+			indexed_setter_keys.insert(indexed_setter, type);
+		}
+		Variant::ValidatedIndexedGetter indexed_getter = Variant::get_member_validated_indexed_getter(type);
+		if (indexed_getter != nullptr && !indexed_getter_keys.has(indexed_getter)) {
+			indexed_getter_keys.insert(indexed_getter, type);
+		}
+
+		List<StringName> methods;
+		Variant::get_builtin_method_list(type, &methods);
+		for (const StringName &method : methods) {
+			Variant::ValidatedBuiltInMethod builtin_method = Variant::get_validated_builtin_method(type, method);
+			if (builtin_method != nullptr && !builtin_method_keys.has(builtin_method)) {
+				builtin_method_keys.insert(builtin_method, { type, method, 0 });
+			}
+		}
+
+		for (int j = 0; j < Variant::get_constructor_count(type); j++) {
+			Variant::ValidatedConstructor constructor = Variant::get_validated_constructor(type, j);
+			if (constructor != nullptr && !constructor_keys.has(constructor)) {
+				constructor_keys.insert(constructor, { type, StringName(), j });
+			}
+		}
+	}
+
+	List<StringName> utilities;
+	Variant::get_utility_function_list(&utilities);
+	for (const StringName &utility : utilities) {
+		Variant::ValidatedUtilityFunction function = Variant::get_validated_utility_function(utility);
+		if (function != nullptr && !utility_keys.has(function)) {
+			utility_keys.insert(function, utility);
+		}
+	}
+
+	List<StringName> gds_utilities;
+	GDScriptUtilityFunctions::get_function_list(&gds_utilities);
+	for (const StringName &utility : gds_utilities) {
+		GDScriptUtilityFunctions::FunctionPtr function = GDScriptUtilityFunctions::get_function(utility);
+		if (function != nullptr && !gds_utility_keys.has(function)) {
+			gds_utility_keys.insert(function, utility);
+		}
+	}
+
+	function_keys_valid = true;
+}
+
+String GDScriptBytecodeCache::_get_cache_file(const String &p_path) {
+#ifdef TOOLS_ENABLED
+	// Projects run from the editor share the cache with each other, exported ones can only write to `user://`.
+	const String directory = ProjectSettings::get_singleton()->get_project_data_path().path_join("gdscript_bytecode");
+#else
+	const String directory = "user://gdscript_bytecode";
+#endif
+	return directory.path_join(p_path.md5_text() + ".gdbc");
+}
+
+String GDScriptBytecodeCache::_get_source_md5(const String &p_path, bool p_refresh) {
+	MutexLock lock(mutex);
+	if (!p_refresh) {
+		if (const String *md5 = source_md5s.getptr(p_path)) {
+			return *md5;
+		}
+	}
+	const String md5 = FileAccess::get_md5(ResourceLoader::path_remap(p_path));
+	source_md5s[p_path] = md5;
+	return md5;
+}
+
+void GDScriptBytecodeCache::_collect_dependencies(const String &p_path, HashSet<String> &r_dependencies) {
+	MutexLock lock(GDScriptCache::mutex);
+
+	// `parser_inverse_dependencies` maps every script to the scripts whose analysis needed it.
+	LocalVector<String> pending;
+	pending.push_back(p_path);
+	for (const String &dependency : r_dependencies) {
+		pending.push_back(dependency);
+	}
+	r_dependencies.insert(p_path);
+
+	while (!pending.is_empty()) {
+		const String current = pending[pending.size() - 1];
+		pending.remove_at(pending.size() - 1);
+		for (const KeyValue<String, HashSet<String>> &E : GDScriptCache::singleton->parser_inverse_dependencies) {
+			if (E.value.has(current) && !r_dependencies.has(E.key)) {
+				r_dependencies.insert(E.key);
+				pending.push_back(E.key);
+			}
+		}
+	}
+}
+
+bool GDScriptBytecodeCache::_read_header(Reader &r_reader, String &r_path) {
+	if (r_reader.get_u32() != BYTECODE_CACHE_MAGIC || r_reader.get_u32() != BYTECODE_CACHE_FORMAT_VERSION) {
+		return false;
+	}
+	if (r_reader.get_u32() != (uint32_t)(VERSION_HEX) || r_reader.get_string() != String(VERSION_HASH)) {
+		return false;
+	}
+	if (r_reader.get_u32() != _get_build_flags() || r_reader.get_u32() != _get_extension_api_hash()) {
+		return false;
+	}
+
+	r_path = r_reader.get_string();
+	uint32_t dependency_count = r_reader.get_count();
+	for (uint32_t i = 0; i < dependency_count; i++) {
+		const String dependency = r_reader.get_string();
+		const String md5 = r_reader.get_string();
+		if (r_reader.failed || _get_source_md5(dependency) != md5) {
+			return false;
+		}
+	}
+
+	// Everything after the header must be exactly what was written, a damaged file is compiled from source instead.
+	const uint32_t body_size = r_reader.get_u32();
+	const uint32_t body_checksum = r_reader.get_u32();
+	if (r_reader.failed || body_size != r_reader.size - r_reader.position) {
+		return false;
+	}
+	return hash_murmur3_buffer(r_reader.data + r_reader.position, body_size) == body_checksum;
+}
+
+bool GDScriptBytecodeCache::_is_compiled(const GDScript *p_script) {
+	if (!p_script->member_functions.is_empty() || p_script->implicit_initializer != nullptr) {
+		return true;
+	}
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		if (_is_compiled(E.value.ptr())) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Writing */
+
+bool GDScriptBytecodeCache::_write_script_reference(SaveState &r_state, Writer &r_writer, const Script *p_script) {
+	if (p_script == nullptr) {
+		r_writer.put_u8(SCRIPT_REFERENCE_NONE);
+		return true;
+	}
+
+	const GDScript *gdscript = Object::cast_to<GDScript>(p_script);
+	if (gdscript != nullptr) {
+		const GDScript *root = gdscript;
+		while (root->_owner != nullptr) {
+			root = root->_owner;
+		}
+		const String relative_name = gdscript->fully_qualified_name.trim_prefix(root->fully_qualified_name);
+
+		if (root == r_state.root) {
+			r_writer.put_u8(SCRIPT_REFERENCE_LOCAL);
+			r_writer.put_string(relative_name);
+			return true;
+		}
+
+		const String path = root->get_script_path();
+		if (!path.is_resource_file()) {
+			r_state.error = vformat(R"(Script "%s" isn't saved to a file.)", gdscript->fully_qualified_name);
+			return false;
+		}
+		r_writer.put_u8(SCRIPT_REFERENCE_GDSCRIPT);
+		r_writer.put_string(path);
+		r_writer.put_string(relative_name);
+		r_state.dependencies.insert(path);
+		return true;
+	}
+
+	const String path = p_script->get_path();
+	if (!path.is_resource_file()) {
+		r_state.error = vformat(R"(Script of type "%s" isn't saved to a file.)", p_script->get_class());
+		return false;
+	}
+	r_writer.put_u8(SCRIPT_REFERENCE_RESOURCE);
+	r_writer.put_string(path);
+	return true;
+}
+
+bool GDScriptBytecodeCache::_write_constant(SaveState &r_state, Writer &r_writer, const Variant &p_constant) {
+	switch (p_constant.get_type()) {
+		case Variant::OBJECT: {
+			Object *object = p_constant.get_validated_object();
+			if (object == nullptr) {
+				r_writer.put_u8(CONSTANT_NULL_OBJECT);
+				return true;
+			}
+
+			if (const GDScriptNativeClass *native_class = Object::cast_to<GDScriptNativeClass>(object)) {
+				r_writer.put_u8(CONSTANT_NATIVE_CLASS);
+				r_writer.put_string(native_class->get_name());
+				return true;
+			}
+
+			if (const Script *script = Object::cast_to<Script>(object)) {
+				r_writer.put_u8(CONSTANT_SCRIPT);
+				return _write_script_reference(r_state, r_writer, script);
+			}
+
+			const Resource *resource = Object::cast_to<Resource>(object);
+			if (resource != nullptr && resource->get_path().is_resource_file()) {
+				r_writer.put_u8(CONSTANT_RESOURCE);
+				r_writer.put_string(resource->get_path());
+				return true;
+			}
+
+			r_state.error = vformat(R"(Constant of type "%s" can't be loaded by path.)", object->get_class());
+			return false;
+		}
+		case Variant::ARRAY: {
+			const Array array = p_constant;
+			const Ref<Script> typed_script = array.get_typed_script();
+			if (typed_script.is_valid()) {
+				r_state.error = "Arrays typed with a script can't be stored.";
+				return false;
+			}
+
+			r_writer.put_u8(CONSTANT_ARRAY);
+			r_writer.put_u8(array.is_read_only());
+			r_writer.put_u8(array.is_typed());
+			r_writer.put_u32(array.get_typed_builtin());
+			r_writer.put_string(array.get_typed_class_name());
+			r_writer.put_u32(array.size());
+			for (int i = 0; i < array.size(); i++) {
+				if (!_write_constant(r_state, r_writer, array[i])) {
+					return false;
+				}
+			}
+			return true;
+		}
+		case Variant::DICTIONARY: {
+			const Dictionary dictionary = p_constant;
+			r_writer.put_u8(CONSTANT_DICTIONARY);
+			r_writer.put_u8(dictionary.is_read_only());
+			r_writer.put_u32(dictionary.size());
+			List<Variant> keys;
+			dictionary.get_key_list(&keys);
+			for (const Variant &key : keys) {
+				if (!_write_constant(r_state, r_writer, key) || !_write_constant(r_state, r_writer, dictionary[key])) {
+					return false;
+				}
+			}
+			return true;
+		}
+		case Variant::RID:
+		case Variant::CALLABLE:
+		case Variant::SIGNAL: {
+			r_state.error = vformat(R"(Constant of type "%s" can't be stored.)", Variant::get_type_name(p_constant.get_type()));
+			return false;
+		}
+		default: {
+			r_writer.put_u8(CONSTANT_VARIANT);
+			if (!r_writer.put_variant(p_constant)) {
+				r_state.error = vformat(R"(Constant of type "%s" can't be encoded.)", Variant::get_type_name(p_constant.get_type()));
+				return false;
+			}
+			return true;
+		}
+	}
+}
+
+bool GDScriptBytecodeCache::_write_data_type(SaveState &r_state, Writer &r_writer, const GDScriptDataType &p_data_type) {
+	r_writer.put_u8(p_data_type.kind);
+	r_writer.put_u8(p_data_type.has_type);
+	r_writer.put_u32(p_data_type.builtin_type);
+	r_writer.put_string(p_data_type.native_type);
+	if (!_write_script_reference(r_state, r_writer, p_data_type.script_type)) {
+		return false;
+	}
+	r_writer.put_u8(p_data_type.script_type_ref.is_valid());
+	r_writer.put_u32(p_data_type.container_element_types.size());
+	for (const GDScriptDataType &element_type : p_data_type.container_element_types) {
+		if (!_write_data_type(r_state, r_writer, element_type)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void GDScriptBytecodeCache::_write_property_info(Writer &r_writer, const PropertyInfo &p_info) {
+	r_writer.put_u32(p_info.type);
+	r_writer.put_string(p_info.name);
+	r_writer.put_string(p_info.class_name);
+	r_writer.put_u32(p_info.hint);
+	r_writer.put_string(p_info.hint_string);
+	r_writer.put_u32(p_info.usage);
+}
+
+bool GDScriptBytecodeCache::_write_method_info(SaveState &r_state, Writer &r_writer, const MethodInfo &p_info) {
+	r_writer.put_string(p_info.name);
+	_write_property_info(r_writer, p_info.return_val);
+	r_writer.put_u32(p_info.flags);
+	r_writer.put_32(p_info.id);
+	r_writer.put_u32(p_info.arguments.size());
+	for (const PropertyInfo &argument : p_info.arguments) {
+		_write_property_info(r_writer, argument);
+	}
+	r_writer.put_u32(p_info.default_arguments.size());
+	for (const Variant &default_argument : p_info.default_arguments) {
+		if (!_write_constant(r_state, r_writer, default_argument)) {
+			return false;
+		}
+	}
+	r_writer.put_32(p_info.return_val_metadata);
+	r_writer.put_u32(p_info.arguments_metadata.size());
+	for (int metadata : p_info.arguments_metadata) {
+		r_writer.put_32(metadata);
+	}
+	return true;
+}
+
+bool GDScriptBytecodeCache::_write_member_info(SaveState &r_state, Writer &r_writer, const GDScript::MemberInfo &p_info) {
+	r_writer.put_32(p_info.index);
+	r_writer.put_string(p_info.setter);
+	r_writer.put_string(p_info.getter);
+	_write_property_info(r_writer, p_info.property_info);
+	return _write_data_type(r_state, r_writer, p_info.data_type);
+}
+
+bool GDScriptBytecodeCache::_write_function(SaveState &r_state, Writer &r_writer, const GDScriptFunction *p_function, const HashMap<GDScriptFunction *, int> &p_pool) {
+	r_writer.put_string(p_function->name);
+	r_writer.put_u8(p_function->_static);
+	r_writer.put_32(p_function->_initial_line);
+	r_writer.put_32(p_function->_argument_count);
+	r_writer.put_32(p_function->_stack_size);
+	r_writer.put_32(p_function->_instruction_args_size);
+
+	if (!_write_data_type(r_state, r_writer, p_function->return_type)) {
+		return false;
+	}
+	r_writer.put_u32(p_function->argument_types.size());
+	for (const GDScriptDataType &argument_type : p_function->argument_types) {
+		if (!_write_data_type(r_state, r_writer, argument_type)) {
+			return false;
+		}
+	}
+	if (!_write_method_info(r_state, r_writer, p_function->method_info) || !_write_constant(r_state, r_writer, p_function->rpc_config)) {
+		return false;
+	}
+
+	r_writer.put_u32(p_function->temporary_slots.size());
+	for (const KeyValue<int, Variant::Type> &E : p_function->temporary_slots) {
+		r_writer.put_32(E.key);
+		r_writer.put_u32(E.value);
+	}
+	r_writer.put_u32(p_function->stack_debug.size());
+	for (const GDScriptFunction::StackDebug &stack_debug : p_function->stack_debug) {
+		r_writer.put_32(stack_debug.line);
+		r_writer.put_32(stack_debug.pos);
+		r_writer.put_u8(stack_debug.added);
+		r_writer.put_string(stack_debug.identifier);
+	}
+#ifdef GDSCRIPT_LINE_TRACES
+	r_writer.put_u32(p_function->line_table.size());
+	for (const GDScriptFunction::LinePosition &line_position : p_function->line_table) {
+		r_writer.put_32(line_position.position);
+		r_writer.put_32(line_position.line);
+	}
+#endif
+	r_writer.put_u32(p_function->default_arguments.size());
+	for (int default_argument : p_function->default_arguments) {
+		r_writer.put_32(default_argument);
+	}
+
+	// Operator instructions cache their evaluator in the code when first run, and global indices depend on
+	// the order in which singletons and classes got registered, so neither can be stored as is.
+	Vector<int> code = p_function->code;
+	LocalVector<StringName> globals;
+	HashMap<int, int> global_indices;
+	int *code_ptr = code.ptrw();
+	for (int ip = 0; ip < code.size();) {
+		const int length = GDScriptByteCodeOptimizer::get_instruction_length(code_ptr, code.size(), ip);
+		if (length <= 0 || ip + length > code.size()) {
+			r_state.error = vformat(R"(Unknown instruction in function "%s".)", p_function->name);
+			return false;
+		}
+		switch (code_ptr[ip]) {
+			case GDScriptFunction::OPCODE_OPERATOR: {
+				for (int i = ip + 5; i < ip + length; i++) {
+					code_ptr[i] = 0;
+				}
+			} break;
+			case GDScriptFunction::OPCODE_STORE_GLOBAL: {
+				const StringName *name = r_state.global_names.getptr(code_ptr[ip + 2]);
+				if (name == nullptr) {
+					r_state.error = vformat(R"(Unknown global in function "%s".)", p_function->name);
+					return false;
+				}
+				if (!global_indices.has(code_ptr[ip + 2])) {
+					global_indices.insert(code_ptr[ip + 2], globals.size());
+					globals.push_back(*name);
+				}
+				code_ptr[ip + 2] = global_indices[code_ptr[ip + 2]];
+			} break;
+			default:
+				break;
+		}
+		ip += length;
+	}
+	r_writer.put_u32(code.size());
+	for (int i = 0; i < code.size(); i++) {
+		r_writer.put_32(code_ptr[i]);
+	}
+	r_writer.put_u32(globals.size());
+	for (const StringName &global : globals) {
+		r_writer.put_string(global);
+	}
+
+	r_writer.put_u32(p_function->constants.size());
+	for (const Variant &constant : p_function->constants) {
+		if (!_write_constant(r_state, r_writer, constant)) {
+			return false;
+		}
+	}
+	r_writer.put_u32(p_function->global_names.size());
+	for (const StringName &global_name : p_function->global_names) {
+		r_writer.put_string(global_name);
+	}
+
+	r_writer.put_u32(p_function->operator_funcs.size());
+	for (Variant::ValidatedOperatorEvaluator evaluator : p_function->operator_funcs) {
+		const uint32_t *key = _find_key(operator_keys, evaluator);
+		ERR_FAIL_NULL_V(key, false);
+		r_writer.put_u32(*key);
+	}
+	r_writer.put_u32(p_function->setters.size());
+	for (Variant::ValidatedSetter setter : p_function->setters) {
+		const MemberKey *key = _find_key(setter_keys, setter);
+		ERR_FAIL_NULL_V(key, false);
+		r_writer.put_u32(key->type);
+		r_writer.put_string(key->name);
+	}
+	r_writer.put_u32(p_function->getters.size());
+	for (Variant::ValidatedGetter getter : p_function->getters) {
+		const MemberKey *key = _find_key(getter_keys, getter);
+		ERR_FAIL_NULL_V(key, false);
+		r_writer.put_u32(key->type);
+		r_writer.put_string(key->name);
+	}
+	r_writer.put_u32(p_function->keyed_setters.size());
+	for (Variant::ValidatedKeyedSetter setter : p_function->keyed_setters) {
+		const Variant::Type *key = _find_key(keyed_setter_keys, setter);
+		ERR_FAIL_NULL_V(key, false);
+		r_writer.put_u32(*key);
+	}
+	r_writer.put_u32(p_function->keyed_getters.size());
+	for (Variant::ValidatedKeyedGetter getter : p_function->keyed_getters) {
+		const Variant::Type *key = _find_key(keyed_getter_keys, getter);
+		ERR_FAIL_NULL_V(key, false);
+		r_writer.put_u32(*key);
+	}
+	r_writer.put_u32(p_function->indexed_setters.size());
+	for (Variant::ValidatedIndexedSetter setter : p_function->indexed_setters) {
+		const Variant::Type *key = _find_key(indexed_setter_keys, setter);
+		ERR_FAIL_NULL_V(key, false);
+		r_writer.put_u32(*key);
+	}
+	r_writer.put_u32(p_function->indexed_getters.size());
+	for (Variant::ValidatedIndexedGetter getter : p_function->indexed_getters) {
+		const Variant::Type *key = _find_key(indexed_getter_keys, getter);
+		ERR_FAIL_NULL_V(key, false);
+		r_writer.put_u32(*key);
+	}
+	r_writer.put_u32(p_function->builtin_methods.size());
+	for (Variant::ValidatedBuiltInMethod method : p_function->builtin_methods) {
+		const MemberKey *key = _find_key(builtin_method_keys, method);
+		ERR_FAIL_NULL_V(key, false);
+		r_writer.put_u32(key->type);
+		r_writer.put_string(key->name);
+	}
+	r_writer.put_u32(p_function->constructors.size());
+	for (Variant::ValidatedConstructor constructor : p_function->constructors) {
+		const MemberKey *key = _find_key(constructor_keys, constructor);
+		ERR_FAIL_NULL_V(key, false);
+		r_writer.put_u32(key->type);
+		r_writer.put_32(key->index);
+	}
+	r_writer.put_u32(p_function->utilities.size());
+	for (Variant::ValidatedUtilityFunction utility : p_function->utilities) {
+		const StringName *key = _find_key(utility_keys, utility);
+		ERR_FAIL_NULL_V(key, false);
+		r_writer.put_string(*key);
+	}
+	r_writer.put_u32(p_function->gds_utilities.size());
+	for (GDScriptUtilityFunctions::FunctionPtr utility : p_function->gds_utilities) {
+		const StringName *key = _find_key(gds_utility_keys, utility);
+		ERR_FAIL_NULL_V(key, false);
+		r_writer.put_string(*key);
+	}
+	r_writer.put_u32(p_function->methods.size());
+	for (const MethodBind *method : p_function->methods) {
+		r_writer.put_string(method->get_instance_class());
+		r_writer.put_string(method->get_name());
+		r_writer.put_u32(method->get_hash());
+	}
+
+	r_writer.put_u32(p_function->lambdas.size());
+	for (GDScriptFunction *lambda : p_function->lambdas) {
+		const int *index = p_pool.getptr(lambda);
+		ERR_FAIL_NULL_V(index, false);
+		r_writer.put_32(*index);
+	}
+	r_writer.put_u32(p_function->inline_caches.size());
+
+#ifdef DEBUG_ENABLED
+	const Vector<String> *names[] = {
+		&p_function->operator_names,
+		&p_function->setter_names,
+		&p_function->getter_names,
+		&p_function->builtin_methods_names,
+		&p_function->constructors_names,
+		&p_function->utilities_names,
+		&p_function->gds_utilities_names,
+	};
+	for (const Vector<String> *name_list : names) {
+		r_writer.put_u32(name_list->size());
+		for (const String &name : *name_list) {
+			r_writer.put_string(name);
+		}
+	}
+	r_writer.put_string(p_function->profile.signature);
+#endif
+
+	return true;
+}
+
+void GDScriptBytecodeCache::_write_class_tree(Writer &r_writer, const GDScript *p_script) {
+	r_writer.put_string(p_script->local_name);
+	r_writer.put_string(p_script->global_name);
+	r_writer.put_string(p_script->simplified_icon_path);
+	r_writer.put_u32(p_script->subclasses.size());
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		r_writer.put_string(E.key);
+		r_writer.put_string(E.value->fully_qualified_name);
+		_write_class_tree(r_writer, E.value.ptr());
+	}
+}
+
+bool GDScriptBytecodeCache::_write_class(SaveState &r_state, Writer &r_writer, GDScript *p_script) {
+	r_writer.put_u8(p_script->tool);
+	r_writer.put_string(p_script->native.is_valid() ? String(p_script->native->get_name()) : String());
+	if (!_write_script_reference(r_state, r_writer, p_script->base.ptr())) {
+		return false;
+	}
+
+	r_writer.put_u32(p_script->members.size());
+	for (const StringName &member : p_script->members) {
+		r_writer.put_string(member);
+	}
+	r_writer.put_u32(p_script->member_indices.size());
+	for (const KeyValue<StringName, GDScript::MemberInfo> &E : p_script->member_indices) {
+		r_writer.put_string(E.key);
+		if (!_write_member_info(r_state, r_writer, E.value)) {
+			return false;
+		}
+	}
+	r_writer.put_u32(p_script->static_variables_indices.size());
+	for (const KeyValue<StringName, GDScript::MemberInfo> &E : p_script->static_variables_indices) {
+		r_writer.put_string(E.key);
+		if (!_write_member_info(r_state, r_writer, E.value)) {
+			return false;
+		}
+	}
+	r_writer.put_u32(p_script->constants.size());
+	for (const KeyValue<StringName, Variant> &E : p_script->constants) {
+		r_writer.put_string(E.key);
+		if (!_write_constant(r_state, r_writer, E.value)) {
+			return false;
+		}
+	}
+	r_writer.put_u32(p_script->_signals.size());
+	for (const KeyValue<StringName, MethodInfo> &E : p_script->_signals) {
+		r_writer.put_string(E.key);
+		if (!_write_method_info(r_state, r_writer, E.value)) {
+			return false;
+		}
+	}
+	if (!_write_constant(r_state, r_writer, p_script->rpc_config)) {
+		return false;
+	}
+
+	// All functions of the class, lambdas included, are stored in one list so they can refer to each other by index.
+	LocalVector<GDScriptFunction *> functions;
+	HashMap<GDScriptFunction *, int> pool;
+	LocalVector<GDScriptFunction *> pending;
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->member_functions) {
+		pending.push_back(E.value);
+	}
+	pending.push_back(p_script->implicit_initializer);
+	pending.push_back(p_script->implicit_ready);
+	pending.push_back(p_script->static_initializer);
+	for (const KeyValue<GDScriptFunction *, GDScript::LambdaInfo> &E : p_script->lambda_info) {
+		pending.push_back(E.key);
+	}
+	for (uint32_t i = 0; i < pending.size(); i++) {
+		GDScriptFunction *function = pending[i];
+		if (function == nullptr || pool.has(function)) {
+			continue;
+		}
+		pool.insert(function, functions.size());
+		functions.push_back(function);
+		for (GDScriptFunction *lambda : function->lambdas) {
+			pending.push_back(lambda);
+		}
+	}
+
+	r_writer.put_u32(functions.size());
+	for (const GDScriptFunction *function : functions) {
+		if (!_write_function(r_state, r_writer, function, pool)) {
+			return false;
+		}
+	}
+
+	r_writer.put_u32(p_script->member_functions.size());
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->member_functions) {
+		r_writer.put_string(E.key);
+		r_writer.put_32(pool[E.value]);
+	}
+	GDScriptFunction *special_functions[] = {
+		p_script->initializer,
+		p_script->implicit_initializer,
+		p_script->implicit_ready,
+		p_script->static_initializer,
+	};
+	for (GDScriptFunction *function : special_functions) {
+		const int *index = function != nullptr ? pool.getptr(function) : nullptr;
+		r_writer.put_32(index != nullptr ? *index : -1);
+	}
+	r_writer.put_u32(p_script->lambda_info.size());
+	for (const KeyValue<GDScriptFunction *, GDScript::LambdaInfo> &E : p_script->lambda_info) {
+		r_writer.put_32(pool[E.key]);
+		r_writer.put_32(E.value.capture_count);
+		r_writer.put_u8(E.value.use_self);
+	}
+
+#ifdef TOOLS_ENABLED
+	r_writer.put_u32(p_script->member_default_values.size());
+	for (const KeyValue<StringName, Variant> &E : p_script->member_default_values) {
+		r_writer.put_string(E.key);
+		if (!_write_constant(r_state, r_writer, E.value)) {
+			return false;
+		}
+	}
+#endif
+
+	r_writer.put_u32(p_script->subclasses.size());
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		r_writer.put_string(E.key);
+		if (!_write_class(r_state, r_writer, E.value.ptr())) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Reading */
+
+bool GDScriptBytecodeCache::_read_script_reference(LoadState &r_state, Reader &r_reader, Ref<Script> &r_script) {
+	r_script = Ref<Script>();
+	switch (r_reader.get_u8()) {
+		case SCRIPT_REFERENCE_NONE: {
+			return !r_reader.failed;
+		}
+		case SCRIPT_REFERENCE_LOCAL: {
+			const String relative_name = r_reader.get_string();
+			r_script = Ref<Script>(relative_name.is_empty() ? r_state.root : r_state.root->find_class(relative_name));
+		} break;
+		case SCRIPT_REFERENCE_GDSCRIPT: {
+			const String path = r_reader.get_string();
+			const String relative_name = r_reader.get_string();
+			if (r_reader.failed) {
+				return false;
+			}
+			Error err = OK;
+			Ref<GDScript> root = GDScriptCache::get_shallow_script(path, err, r_state.path);
+			if (err != OK || root.is_null()) {
+				return false;
+			}
+			r_script = Ref<Script>(relative_name.is_empty() ? root.ptr() : root->find_class(relative_name));
+		} break;
+		case SCRIPT_REFERENCE_RESOURCE: {
+			const String path = r_reader.get_string();
+			if (r_reader.failed) {
+				return false;
+			}
+			r_script = ResourceLoader::load(path);
+		} break;
+		default: {
+			return false;
+		}
+	}
+	return !r_reader.failed && r_script.is_valid();
+}
+
+bool GDScriptBytecodeCache::_read_constant(LoadState &r_state, Reader &r_reader, Variant &r_constant) {
+	switch (r_reader.get_u8()) {
+		case CONSTANT_VARIANT: {
+			r_constant = r_reader.get_variant();
+		} break;
+		case CONSTANT_NULL_OBJECT: {
+			r_constant = (Object *)nullptr;
+		} break;
+		case CONSTANT_SCRIPT: {
+			Ref<Script> script;
+			if (!_read_script_reference(r_state, r_reader, script)) {
+				return false;
+			}
+			r_constant = script;
+		} break;
+		case CONSTANT_NATIVE_CLASS: {
+			const int *index = GDScriptLanguage::get_singleton()->get_global_map().getptr(r_reader.get_string());
+			if (index == nullptr) {
+				return false;
+			}
+			const Ref<GDScriptNativeClass> native_class = GDScriptLanguage::get_singleton()->get_global_array()[*index];
+			if (native_class.is_null()) {
+				return false;
+			}
+			r_constant = native_class;
+		} break;
+		case CONSTANT_RESOURCE: {
+			const String path = r_reader.get_string();
+			if (r_reader.failed) {
+				return false;
+			}
+			const Ref<Resource> resource = ResourceLoader::load(path);
+			if (resource.is_null()) {
+				return false;
+			}
+			r_constant = resource;
+		} break;
+		case CONSTANT_ARRAY: {
+			const bool read_only = r_reader.get_u8();
+			const bool typed = r_reader.get_u8();
+			const uint32_t builtin_type = r_reader.get_u32();
+			const StringName class_name = r_reader.get_string();
+			const uint32_t size = r_reader.get_count();
+			if (r_reader.failed || builtin_type >= Variant::VARIANT_MAX) {
+				return false;
+			}
+			Array array;
+			if (typed) {
+				array.set_typed(builtin_type, class_name, Variant());
+			}
+			for (uint32_t i = 0; i < size; i++) {
+				Variant element;
+				if (!_read_constant(r_state, r_reader, element)) {
+					return false;
+				}
+				array.push_back(element);
+			}
+			if (read_only) {
+				array.make_read_only();
+			}
+			r_constant = array;
+		} break;
+		case CONSTANT_DICTIONARY: {
+			const bool read_only = r_reader.get_u8();
+			const uint32_t size = r_reader.get_count();
+			Dictionary dictionary;
+			for (uint32_t i = 0; i < size; i++) {
+				Variant key;
+				Variant value;
+				if (!_read_constant(r_state, r_reader, key) || !_read_constant(r_state, r_reader, value)) {
+					return false;
+				}
+				dictionary[key] = value;
+			}
+			if (read_only) {
+				dictionary.make_read_only();
+			}
+			r_constant = dictionary;
+		} break;
+		default: {
+			return false;
+		}
+	}
+	return !r_reader.failed;
+}
+
+bool GDScriptBytecodeCache::_read_data_type(LoadState &r_state, Reader &r_reader, GDScriptDataType &r_data_type) {
+	const uint32_t kind = r_reader.get_u8();
+	r_data_type.has_type = r_reader.get_u8();
+	const uint32_t builtin_type = r_reader.get_u32();
+	r_data_type.native_type = r_reader.get_string();
+	if (r_reader.failed || kind > GDScriptDataType::GDSCRIPT || builtin_type >= Variant::VARIANT_MAX) {
+		return false;
+	}
+	r_data_type.kind = (GDScriptDataType::Kind)kind;
+	r_data_type.builtin_type = (Variant::Type)builtin_type;
+
+	Ref<Script> script;
+	if (!_read_script_reference(r_state, r_reader, script)) {
+		return false;
+	}
+	r_data_type.script_type = script.ptr();
+	// Classes of the same file only hold raw pointers to each other, like the compiler makes them.
+	if (r_reader.get_u8()) {
+		r_data_type.script_type_ref = script;
+	}
+
+	const uint32_t element_count = r_reader.get_count();
+	r_data_type.container_element_types.resize(element_count);
+	for (uint32_t i = 0; i < element_count; i++) {
+		if (!_read_data_type(r_state, r_reader, r_data_type.container_element_types.write[i])) {
+			return false;
+		}
+	}
+	return !r_reader.failed;
+}
+
+void GDScriptBytecodeCache::_read_property_info(Reader &r_reader, PropertyInfo &r_info) {
+	r_info.type = (Variant::Type)r_reader.get_u32();
+	r_info.name = r_reader.get_string();
+	r_info.class_name = r_reader.get_string();
+	r_info.hint = (PropertyHint)r_reader.get_u32();
+	r_info.hint_string = r_reader.get_string();
+	r_info.usage = r_reader.get_u32();
+	if (r_info.type >= Variant::VARIANT_MAX) {
+		r_reader.failed = true;
+	}
+}
+
+bool GDScriptBytecodeCache::_read_method_info(LoadState &r_state, Reader &r_reader, MethodInfo &r_info) {
+	r_info.name = r_reader.get_string();
+	_read_property_info(r_reader, r_info.return_val);
+	r_info.flags = r_reader.get_u32();
+	r_info.id = r_reader.get_32();
+	const uint32_t argument_count = r_reader.get_count();
+	r_info.arguments.resize(argument_count);
+	for (uint32_t i = 0; i < argument_count; i++) {
+		_read_property_info(r_reader, r_info.arguments.write[i]);
+	}
+	const uint32_t default_argument_count = r_reader.get_count();
+	r_info.default_arguments.resize(default_argument_count);
+	for (uint32_t i = 0; i < default_argument_count; i++) {
+		if (!_read_constant(r_state, r_reader, r_info.default_arguments.write[i])) {
+			return false;
+		}
+	}
+	r_info.return_val_metadata = r_reader.get_32();
+	const uint32_t metadata_count = r_reader.get_count();
+	r_info.arguments_metadata.resize(metadata_count);
+	for (uint32_t i = 0; i < metadata_count; i++) {
+		r_info.arguments_metadata.write[i] = r_reader.get_32();
+	}
+	return !r_reader.failed;
+}
+
+bool GDScriptBytecodeCache::_read_member_info(LoadState &r_state, Reader &r_reader, GDScript::MemberInfo &r_info) {
+	r_info.index = r_reader.get_32();
+	r_info.setter = r_reader.get_string();
+	r_info.getter = r_reader.get_string();
+	_read_property_info(r_reader, r_info.property_info);
+	return _read_data_type(r_state, r_reader, r_info.data_type) && !r_reader.failed;
+}
+
+bool GDScriptBytecodeCache::_validate_code(const GDScriptFunction *p_function, int p_member_count) {
+	// Release builds run the bytecode without any bounds checks, so everything it indexes with is checked here once.
+	const int *code = p_function->code.ptr();
+	const int code_size = p_function->code.size();
+
+	LocalVector<bool> starts;
+	starts.resize(code_size + 1);
+	for (uint32_t i = 0; i < starts.size(); i++) {
+		starts[i] = false;
+	}
+	for (int ip = 0; ip < code_size;) {
+		const int length = GDScriptByteCodeOptimizer::get_instruction_length(code, code_size, ip);
+		if (length <= 0 || ip + length > code_size) {
+			return false;
+		}
+		starts[ip] = true;
+		ip += length;
+	}
+	starts[code_size] = true; // Jumping to the end returns.
+
+	for (int default_argument : p_function->default_arguments) {
+		if (default_argument < 0 || default_argument > code_size || !starts[default_argument]) {
+			return false;
+		}
+	}
+
+	auto is_address = [&](int p_address) {
+		const int index = p_address & GDScriptFunction::ADDR_MASK;
+		switch ((p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) {
+			case GDScriptFunction::ADDR_TYPE_STACK:
+				return index < p_function->_stack_size;
+			case GDScriptFunction::ADDR_TYPE_CONSTANT:
+				return index < p_function->constants.size();
+			case GDScriptFunction::ADDR_TYPE_MEMBER:
+				return index < p_member_count;
+			default:
+				return false;
+		}
+	};
+	auto is_index = [](int p_index, int p_count) {
+		return p_index >= 0 && p_index < p_count;
+	};
+	auto is_type = [](int p_type) {
+		return p_type >= 0 && p_type < Variant::VARIANT_MAX;
+	};
+	auto is_jump = [&](int p_target) {
+		return p_target >= 0 && p_target <= code_size && starts[p_target];
+	};
+	auto is_inline_cache = [&](int p_cache) {
+		return p_cache >= -1 && p_cache < p_function->inline_caches.size();
+	};
+
+	const int global_name_count = p_function->global_names.size();
+	for (int ip = 0; ip < code_size;) {
+		const int *instruction = &code[ip];
+		const int opcode = instruction[0];
+		const int length = GDScriptByteCodeOptimizer::get_instruction_length(code, code_size, ip);
+
+		bool valid = true;
+		int address_count = 0; // The first operands of fixed-size instructions are addresses.
+		switch (opcode) {
+			case GDScriptFunction::OPCODE_OPERATOR: {
+				address_count = 3;
+				valid = is_index(instruction[4], Variant::OP_MAX);
+				// The VM caches the evaluator it resolved here, so it's written zeroed.
+				for (int i = 5; i < length; i++) {
+					valid = valid && instruction[i] == 0;
+				}
+			} break;
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+				address_count = 3;
+				valid = is_index(instruction[4], p_function->operator_funcs.size());
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF:
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT:
+				// The fused jump is validated as the next instruction, but the VM only reads it through this one.
+				address_count = 3;
+				valid = is_index(instruction[4], p_function->operator_funcs.size()) && ip + 8 <= code_size &&
+						instruction[5] == (opcode == GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF ? GDScriptFunction::OPCODE_JUMP_IF : GDScriptFunction::OPCODE_JUMP_IF_NOT);
+				break;
+			case GDScriptFunction::OPCODE_GET_MEMBER_OPERATOR_VALIDATED:
+				address_count = 1;
+				valid = !p_function->_static && is_index(instruction[2], global_name_count) && ip + 8 <= code_size &&
+						instruction[3] >= GDScriptFunction::OPCODE_OPERATOR_VALIDATED && instruction[3] <= GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT &&
+						is_index(instruction[7], p_function->operator_funcs.size());
+				break;
+			case GDScriptFunction::OPCODE_TYPE_TEST_BUILTIN:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+			case GDScriptFunction::OPCODE_CAST_TO_BUILTIN:
+				address_count = 2;
+				valid = is_type(instruction[3]);
+				break;
+			case GDScriptFunction::OPCODE_TYPE_TEST_ARRAY:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_ARRAY:
+				address_count = 3;
+				valid = is_type(instruction[4]) && is_index(instruction[5], global_name_count);
+				break;
+			case GDScriptFunction::OPCODE_TYPE_TEST_NATIVE:
+				address_count = 2;
+				valid = is_index(instruction[3], global_name_count);
+				break;
+			case GDScriptFunction::OPCODE_TYPE_TEST_SCRIPT:
+			case GDScriptFunction::OPCODE_SET_KEYED:
+			case GDScriptFunction::OPCODE_GET_KEYED:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_NATIVE:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_SCRIPT:
+			case GDScriptFunction::OPCODE_CAST_TO_NATIVE:
+			case GDScriptFunction::OPCODE_CAST_TO_SCRIPT:
+				address_count = 3;
+				break;
+			case GDScriptFunction::OPCODE_SET_KEYED_VALIDATED:
+				address_count = 3;
+				valid = is_index(instruction[4], p_function->keyed_setters.size());
+				break;
+			case GDScriptFunction::OPCODE_GET_KEYED_VALIDATED:
+				address_count = 3;
+				valid = is_index(instruction[4], p_function->keyed_getters.size());
+				break;
+			case GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED:
+				address_count = 3;
+				valid = is_index(instruction[4], p_function->indexed_setters.size());
+				break;
+			case GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED:
+				address_count = 3;
+				valid = is_index(instruction[4], p_function->indexed_getters.size());
+				break;
+			case GDScriptFunction::OPCODE_SET_NAMED:
+			case GDScriptFunction::OPCODE_GET_NAMED:
+				address_count = 2;
+				valid = is_index(instruction[3], global_name_count) && is_inline_cache(instruction[4]);
+				break;
+			case GDScriptFunction::OPCODE_SET_NAMED_VALIDATED:
+				address_count = 2;
+				valid = is_index(instruction[3], p_function->setters.size());
+				break;
+			case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED:
+				address_count = 2;
+				valid = is_index(instruction[3], p_function->getters.size());
+				break;
+			case GDScriptFunction::OPCODE_SET_MEMBER:
+			case GDScriptFunction::OPCODE_GET_MEMBER:
+				// Native properties are read from the instance.
+				address_count = 1;
+				valid = !p_function->_static && is_index(instruction[2], global_name_count);
+				break;
+			case GDScriptFunction::OPCODE_STORE_NAMED_GLOBAL:
+				address_count = 1;
+				valid = is_index(instruction[2], global_name_count);
+				break;
+			case GDScriptFunction::OPCODE_SET_STATIC_VARIABLE:
+			case GDScriptFunction::OPCODE_GET_STATIC_VARIABLE:
+			case GDScriptFunction::OPCODE_ASSIGN:
+			case GDScriptFunction::OPCODE_ASSERT:
+			case GDScriptFunction::OPCODE_RETURN_TYPED_NATIVE:
+			case GDScriptFunction::OPCODE_RETURN_TYPED_SCRIPT:
+				address_count = 2;
+				break;
+			case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN:
+				address_count = 1;
+				valid = is_type(instruction[2]);
+				break;
+			case GDScriptFunction::OPCODE_RETURN_TYPED_ARRAY:
+				address_count = 2;
+				valid = is_type(instruction[3]) && is_index(instruction[4], global_name_count);
+				break;
+			case GDScriptFunction::OPCODE_STORE_GLOBAL:
+				address_count = 1;
+				valid = is_index(instruction[2], GDScriptLanguage::get_singleton()->get_global_array_size());
+				break;
+			case GDScriptFunction::OPCODE_JUMP:
+				valid = is_jump(instruction[1]);
+				break;
+			case GDScriptFunction::OPCODE_JUMP_IF:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+			case GDScriptFunction::OPCODE_JUMP_IF_SHARED:
+				address_count = 1;
+				valid = is_jump(instruction[2]);
+				break;
+			case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT:
+			case GDScriptFunction::OPCODE_BREAKPOINT:
+			case GDScriptFunction::OPCODE_LINE:
+			case GDScriptFunction::OPCODE_END:
+				break;
+			case GDScriptFunction::OPCODE_CONSTRUCT:
+			case GDScriptFunction::OPCODE_CONSTRUCT_VALIDATED:
+			case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY:
+			case GDScriptFunction::OPCODE_CONSTRUCT_TYPED_ARRAY:
+			case GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY:
+			case GDScriptFunction::OPCODE_CALL:
+			case GDScriptFunction::OPCODE_CALL_RETURN:
+			case GDScriptFunction::OPCODE_CALL_ASYNC:
+			case GDScriptFunction::OPCODE_CALL_METHOD_BIND:
+			case GDScriptFunction::OPCODE_CALL_METHOD_BIND_RET:
+			case GDScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN:
+			case GDScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN:
+			case GDScriptFunction::OPCODE_CALL_BUILTIN_STATIC:
+			case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC:
+			case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC_VALIDATED_RETURN:
+			case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC_VALIDATED_NO_RETURN:
+			case GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED:
+			case GDScriptFunction::OPCODE_CALL_UTILITY:
+			case GDScriptFunction::OPCODE_CALL_UTILITY_VALIDATED:
+			case GDScriptFunction::OPCODE_CALL_GDSCRIPT_UTILITY:
+			case GDScriptFunction::OPCODE_CALL_SELF_BASE:
+			case GDScriptFunction::OPCODE_CREATE_LAMBDA:
+			case GDScriptFunction::OPCODE_CREATE_SELF_LAMBDA: {
+				// Addresses are loaded into the instruction arguments first, the fixed operands follow them.
+				const int instruction_arg_count = instruction[1];
+				if (instruction_arg_count > p_function->_instruction_args_size) {
+					return false;
+				}
+				for (int i = 0; i < instruction_arg_count; i++) {
+					if (!is_address(instruction[2 + i])) {
+						return false;
+					}
+				}
+
+				// Same offsets as the VM uses once it skipped the arguments, with the highest argument it reads.
+				const int *fixed = &instruction[1 + instruction_arg_count];
+				int last_argument = -1;
+				switch (opcode) {
+					case GDScriptFunction::OPCODE_CONSTRUCT:
+						valid = is_type(fixed[2]);
+						last_argument = fixed[1];
+						break;
+					case GDScriptFunction::OPCODE_CONSTRUCT_VALIDATED:
+						valid = is_index(fixed[2], p_function->constructors.size());
+						last_argument = fixed[1];
+						break;
+					case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY:
+						last_argument = fixed[1];
+						break;
+					case GDScriptFunction::OPCODE_CONSTRUCT_TYPED_ARRAY:
+						valid = is_type(fixed[2]) && is_index(fixed[3], global_name_count);
+						last_argument = fixed[1] + 1;
+						break;
+					case GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY:
+						valid = fixed[1] >= 0 && fixed[1] <= instruction_arg_count;
+						last_argument = fixed[1] * 2;
+						break;
+					case GDScriptFunction::OPCODE_CALL:
+					case GDScriptFunction::OPCODE_CALL_RETURN:
+					case GDScriptFunction::OPCODE_CALL_ASYNC:
+						valid = is_index(fixed[2], global_name_count) && is_inline_cache(fixed[3]);
+						last_argument = fixed[1] + 1;
+						break;
+					case GDScriptFunction::OPCODE_CALL_METHOD_BIND:
+					case GDScriptFunction::OPCODE_CALL_METHOD_BIND_RET:
+					case GDScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN:
+					case GDScriptFunction::OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN:
+						valid = is_index(fixed[2], p_function->methods.size());
+						last_argument = fixed[1] + 1;
+						break;
+					case GDScriptFunction::OPCODE_CALL_BUILTIN_STATIC:
+						valid = is_type(fixed[1]) && is_index(fixed[2], global_name_count);
+						last_argument = fixed[3];
+						break;
+					case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC:
+						valid = is_index(fixed[1], p_function->methods.size());
+						last_argument = fixed[2];
+						break;
+					case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC_VALIDATED_RETURN:
+					case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC_VALIDATED_NO_RETURN:
+						valid = is_index(fixed[2], p_function->methods.size());
+						last_argument = fixed[1];
+						break;
+					case GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED:
+						valid = is_index(fixed[2], p_function->builtin_methods.size());
+						last_argument = fixed[1] + 1;
+						break;
+					case GDScriptFunction::OPCODE_CALL_UTILITY:
+					case GDScriptFunction::OPCODE_CALL_SELF_BASE:
+						valid = is_index(fixed[2], global_name_count);
+						last_argument = fixed[1];
+						break;
+					case GDScriptFunction::OPCODE_CALL_UTILITY_VALIDATED:
+						valid = is_index(fixed[2], p_function->utilities.size());
+						last_argument = fixed[1];
+						break;
+					case GDScriptFunction::OPCODE_CALL_GDSCRIPT_UTILITY:
+						valid = is_index(fixed[2], p_function->gds_utilities.size());
+						last_argument = fixed[1];
+						break;
+					case GDScriptFunction::OPCODE_CREATE_LAMBDA:
+					case GDScriptFunction::OPCODE_CREATE_SELF_LAMBDA:
+						valid = is_index(fixed[2], p_function->lambdas.size());
+						last_argument = fixed[1];
+						break;
+					default:
+						break;
+				}
+				valid = valid && fixed[1] >= 0 && is_index(last_argument, instruction_arg_count);
+			} break;
+			default:
+				if (opcode > GDScriptFunction::OPCODE_OPERATOR_VALIDATED && opcode <= GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT) {
+					address_count = 3; // Typed operators don't look up an evaluator.
+				} else if (opcode >= GDScriptFunction::OPCODE_ITERATE_BEGIN && opcode <= GDScriptFunction::OPCODE_ITERATE_OBJECT) {
+					address_count = 3;
+					valid = is_jump(instruction[4]);
+				} else if (opcode == GDScriptFunction::OPCODE_ASSIGN_NULL || opcode == GDScriptFunction::OPCODE_ASSIGN_TRUE || opcode == GDScriptFunction::OPCODE_ASSIGN_FALSE ||
+						opcode == GDScriptFunction::OPCODE_AWAIT || opcode == GDScriptFunction::OPCODE_AWAIT_RESUME || opcode == GDScriptFunction::OPCODE_RETURN ||
+						(opcode >= GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL && opcode <= GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_VECTOR4_ARRAY)) {
+					address_count = 1;
+				} else {
+					return false;
+				}
+				break;
+		}
+
+		if (!valid || address_count >= length) {
+			return false;
+		}
+		for (int i = 1; i <= address_count; i++) {
+			if (!is_address(instruction[i])) {
+				return false;
+			}
+		}
+		ip += length;
+	}
+	return true;
+}
+
+bool GDScriptBytecodeCache::_read_function(LoadState &r_state, Reader &r_reader, GDScriptFunction *p_function, uint32_t p_pool_start, uint32_t p_pool_size, int p_member_count) {
+	p_function->name = r_reader.get_string();
+	p_function->source = r_state.path;
+	p_function->_static = r_reader.get_u8();
+	p_function->_initial_line = r_reader.get_32();
+	p_function->_argument_count = r_reader.get_32();
+	p_function->_stack_size = r_reader.get_32();
+	p_function->_instruction_args_size = r_reader.get_32();
+	if (p_function->_argument_count < 0 || p_function->_stack_size < GDScriptFunction::FIXED_ADDRESSES_MAX + p_function->_argument_count || p_function->_stack_size > GDScriptFunction::ADDR_MASK || p_function->_instruction_args_size < 0) {
+		return false;
+	}
+
+	if (!_read_data_type(r_state, r_reader, p_function->return_type)) {
+		return false;
+	}
+	const uint32_t argument_count = r_reader.get_count();
+	p_function->argument_types.resize(argument_count);
+	for (uint32_t i = 0; i < argument_count; i++) {
+		if (!_read_data_type(r_state, r_reader, p_function->argument_types.write[i])) {
+			return false;
+		}
+	}
+	if (!_read_method_info(r_state, r_reader, p_function->method_info) || !_read_constant(r_state, r_reader, p_function->rpc_config)) {
+		return false;
+	}
+
+	const uint32_t temporary_count = r_reader.get_count(8);
+	for (uint32_t i = 0; i < temporary_count; i++) {
+		const int slot = r_reader.get_32();
+		const uint32_t type = r_reader.get_u32();
+		if (slot < 0 || slot >= p_function->_stack_size || type >= Variant::VARIANT_MAX) {
+			return false;
+		}
+		p_function->temporary_slots[slot] = (Variant::Type)type;
+	}
+	const uint32_t stack_debug_count = r_reader.get_count(13);
+	for (uint32_t i = 0; i < stack_debug_count; i++) {
+		GDScriptFunction::StackDebug stack_debug;
+		stack_debug.line = r_reader.get_32();
+		stack_debug.pos = r_reader.get_32();
+		stack_debug.added = r_reader.get_u8();
+		stack_debug.identifier = r_reader.get_string();
+		p_function->stack_debug.push_back(stack_debug);
+	}
+#ifdef GDSCRIPT_LINE_TRACES
+	const uint32_t line_position_count = r_reader.get_count(8);
+	p_function->line_table.resize(line_position_count);
+	for (uint32_t i = 0; i < line_position_count; i++) {
+		p_function->line_table.write[i].position = r_reader.get_32();
+		p_function->line_table.write[i].line = r_reader.get_32();
+	}
+#endif
+	const uint32_t default_argument_count = r_reader.get_count(4);
+	p_function->default_arguments.resize(default_argument_count);
+	for (uint32_t i = 0; i < default_argument_count; i++) {
+		p_function->default_arguments.write[i] = r_reader.get_32();
+	}
+
+	const uint32_t code_size = r_reader.get_count(4);
+	p_function->code.resize(code_size);
+	int *code_ptr = p_function->code.ptrw();
+	for (uint32_t i = 0; i < code_size; i++) {
+		code_ptr[i] = r_reader.get_32();
+	}
+	const uint32_t global_count = r_reader.get_count(4);
+	LocalVector<int> global_indices;
+	for (uint32_t i = 0; i < global_count; i++) {
+		const int *index = GDScriptLanguage::get_singleton()->get_global_map().getptr(r_reader.get_string());
+		if (index == nullptr) {
+			return false;
+		}
+		global_indices.push_back(*index);
+	}
+	if (r_reader.failed) {
+		return false;
+	}
+	for (int ip = 0; ip < (int)code_size;) {
+		const int length = GDScriptByteCodeOptimizer::get_instruction_length(code_ptr, code_size, ip);
+		if (length <= 0 || ip + length > (int)code_size) {
+			return false;
+		}
+		if (code_ptr[ip] == GDScriptFunction::OPCODE_STORE_GLOBAL) {
+			const int global = code_ptr[ip + 2];
+			if (global < 0 || global >= (int)global_indices.size()) {
+				return false;
+			}
+			code_ptr[ip + 2] = global_indices[global];
+		}
+		ip += length;
+	}
+
+	const uint32_t constant_count = r_reader.get_count();
+	p_function->constants.resize(constant_count);
+	for (uint32_t i = 0; i < constant_count; i++) {
+		if (!_read_constant(r_state, r_reader, p_function->constants.write[i])) {
+			return false;
+		}
+	}
+	const uint32_t global_name_count = r_reader.get_count(4);
+	p_function->global_names.resize(global_name_count);
+	for (uint32_t i = 0; i < global_name_count; i++) {
+		p_function->global_names.write[i] = r_reader.get_string();
+	}
+
+	const uint32_t operator_count = r_reader.get_count(4);
+	for (uint32_t i = 0; i < operator_count; i++) {
+		const uint32_t key = r_reader.get_u32();
+		const uint32_t op = key >> 16;
+		const uint32_t type_a = (key >> 8) & 0xFF;
+		const uint32_t type_b = key & 0xFF;
+		if (op >= Variant::OP_MAX || type_a >= Variant::VARIANT_MAX || type_b >= Variant::VARIANT_MAX) {
+			return false;
+		}
+		Variant::ValidatedOperatorEvaluator evaluator = Variant::get_validated_operator_evaluator((Variant::Operator)op, (Variant::Type)type_a, (Variant::Type)type_b);
+		if (evaluator == nullptr) {
+			return false;
+		}
+		p_function->operator_funcs.push_back(evaluator);
+	}
+
+	const uint32_t setter_count = r_reader.get_count(8);
+	for (uint32_t i = 0; i < setter_count; i++) {
+		const uint32_t type = r_reader.get_u32();
+		const StringName member = r_reader.get_string();
+		if (type >= Variant::VARIANT_MAX || !Variant::has_member((Variant::Type)type, member)) {
+			return false;
+		}
+		Variant::ValidatedSetter setter = Variant::get_member_validated_setter((Variant::Type)type, member);
+		if (setter == nullptr) {
+			return false;
+		}
+		p_function->setters.push_back(setter);
+	}
+	const uint32_t getter_count = r_reader.get_count(8);
+	for (uint32_t i = 0; i < getter_count; i++) {
+		const uint32_t type = r_reader.get_u32();
+		const StringName member = r_reader.get_string();
+		if (type >= Variant::VARIANT_MAX || !Variant::has_member((Variant::Type)type, member)) {
+			return false;
+		}
+		Variant::ValidatedGetter getter = Variant::get_member_validated_getter((Variant::Type)type, member);
+		if (getter == nullptr) {
+			return false;
+		}
+		p_function->getters.push_back(getter);
+	}
+
+	const uint32_t keyed_setter_count = r_reader.get_count(4);
+	for (uint32_t i = 0; i < keyed_setter_count; i++) {
+		const uint32_t type = r_reader.get_u32();
+		Variant::ValidatedKeyedSetter setter = type < Variant::VARIANT_MAX ? Variant::get_member_validated_keyed_setter((Variant::Type)type) : nullptr;
+		if (setter == nullptr) {
+			return false;
+		}
+		p_function->keyed_setters.push_back(setter);
+	}
+	const uint32_t keyed_getter_count = r_reader.get_count(4);
+	for (uint32_t i = 0; i < keyed_getter_count; i++) {
+		const uint32_t type = r_reader.get_u32();
+		Variant::ValidatedKeyedGetter getter = type < Variant::VARIANT_MAX ? Variant::get_member_validated_keyed_getter((Variant::Type)type) : nullptr;
+		if (getter == nullptr) {
+			return false;
+		}
+		p_function->keyed_getters.push_back(getter);
+	}
+	const uint32_t indexed_setter_count = r_reader.get_count(4);
+	for (uint32_t i = 0; i < indexed_setter_count; i++) {
+		const uint32_t type = r_reader.get_u32();
+		Variant::ValidatedIndexedSetter setter = type < Variant::VARIANT_MAX ? Variant::get_member_validated_indexed_setter((Variant::Type)type) : nullptr;
+		if (setter == nullptr) {
+			return false;
+		}
+		p_function->indexed_setters.push_back(setter);
+	}
+	const uint32_t indexed_getter_count = r_reader.get_count(4);
+	for (uint32_t i = 0; i < indexed_getter_count; i++) {
+		const uint32_t type = r_reader.get_u32();
+		Variant::ValidatedIndexedGetter getter = type < Variant::VARIANT_MAX ? Variant::get_member_validated_indexed_getter((Variant::Type)type) : nullptr;
+		if (getter == nullptr) {
+			return false;
+		}
+		p_function->indexed_getters.push_back(getter);
+	}
+
+	const uint32_t builtin_method_count = r_reader.get_count(8);
+	for (uint32_t i = 0; i < builtin_method_count; i++) {
+		const uint32_t type = r_reader.get_u32();
+		const StringName method = r_reader.get_string();
+		if (type >= Variant::VARIANT_MAX || !Variant::has_builtin_method((Variant::Type)type, method)) {
+			return false;
+		}
+		p_function->builtin_methods.push_back(Variant::get_validated_builtin_method((Variant::Type)type, method));
+	}
+	const uint32_t constructor_count = r_reader.get_count(8);
+	for (uint32_t i = 0; i < constructor_count; i++) {
+		const uint32_t type = r_reader.get_u32();
+		const int index = r_reader.get_32();
+		if (type >= Variant::VARIANT_MAX || index < 0 || index >= Variant::get_constructor_count((Variant::Type)type)) {
+			return false;
+		}
+		p_function->constructors.push_back(Variant::get_validated_constructor((Variant::Type)type, index));
+	}
+	const uint32_t utility_count = r_reader.get_count(4);
+	for (uint32_t i = 0; i < utility_count; i++) {
+		Variant::ValidatedUtilityFunction utility = Variant::get_validated_utility_function(r_reader.get_string());
+		if (utility == nullptr) {
+			return false;
+		}
+		p_function->utilities.push_back(utility);
+	}
+	const uint32_t gds_utility_count = r_reader.get_count(4);
+	for (uint32_t i = 0; i < gds_utility_count; i++) {
+		const StringName utility = r_reader.get_string();
+		if (!GDScriptUtilityFunctions::function_exists(utility)) {
+			return false;
+		}
+		p_function->gds_utilities.push_back(GDScriptUtilityFunctions::get_function(utility));
+	}
+	const uint32_t method_count = r_reader.get_count(12);
+	for (uint32_t i = 0; i < method_count; i++) {
+		const StringName class_name = r_reader.get_string();
+		const StringName method_name = r_reader.get_string();
+		const uint32_t hash = r_reader.get_u32();
+		MethodBind *method = r_reader.failed ? nullptr : ClassDB::get_method(class_name, method_name);
+		if (method == nullptr || method->get_hash() != hash) {
+			return false;
+		}
+		p_function->methods.push_back(method);
+	}
+
+	const uint32_t lambda_count = r_reader.get_count(4);
+	for (uint32_t i = 0; i < lambda_count; i++) {
+		const uint32_t index = r_reader.get_u32();
+		if (index >= p_pool_size) {
+			return false;
+		}
+		p_function->lambdas.push_back(r_state.functions[p_pool_start + index]);
+	}
+	// Inline caches aren't stored, but each one belongs to a single instruction.
+	const uint32_t inline_cache_count = r_reader.get_u32();
+	if (inline_cache_count > code_size) {
+		return false;
+	}
+	p_function->inline_caches.resize(inline_cache_count);
+
+#ifdef DEBUG_ENABLED
+	Vector<String> *names[] = {
+		&p_function->operator_names,
+		&p_function->setter_names,
+		&p_function->getter_names,
+		&p_function->builtin_methods_names,
+		&p_function->constructors_names,
+		&p_function->utilities_names,
+		&p_function->gds_utilities_names,
+	};
+	for (Vector<String> *name_list : names) {
+		const uint32_t name_count = r_reader.get_count(4);
+		name_list->resize(name_count);
+		for (uint32_t i = 0; i < name_count; i++) {
+			name_list->write[i] = r_reader.get_string();
+		}
+	}
+	p_function->profile.signature = r_reader.get_string();
+	p_function->func_cname = (String(p_function->source) + " - " + String(p_function->name)).utf8();
+	p_function->_func_cname = p_function->func_cname.get_data();
+#endif
+
+	if (r_reader.failed) {
+		return false;
+	}
+
+	p_function->_code_size = p_function->code.size();
+	p_function->_code_ptr = p_function->code.is_empty() ? nullptr : p_function->code.ptrw();
+	p_function->_default_arg_count = p_function->default_arguments.is_empty() ? 0 : p_function->default_arguments.size() - 1;
+	p_function->_default_arg_ptr = p_function->default_arguments.is_empty() ? nullptr : p_function->default_arguments.ptr();
+	p_function->_constant_count = p_function->constants.size();
+	p_function->_constants_ptr = p_function->constants.is_empty() ? nullptr : p_function->constants.ptrw();
+	p_function->_global_names_count = p_function->global_names.size();
+	p_function->_global_names_ptr = p_function->global_names.is_empty() ? nullptr : p_function->global_names.ptr();
+	p_function->_operator_funcs_count = p_function->operator_funcs.size();
+	p_function->_operator_funcs_ptr = p_function->operator_funcs.is_empty() ? nullptr : p_function->operator_funcs.ptr();
+	p_function->_setters_count = p_function->setters.size();
+	p_function->_setters_ptr = p_function->setters.is_empty() ? nullptr : p_function->setters.ptr();
+	p_function->_getters_count = p_function->getters.size();
+	p_function->_getters_ptr = p_function->getters.is_empty() ? nullptr : p_function->getters.ptr();
+	p_function->_keyed_setters_count = p_function->keyed_setters.size();
+	p_function->_keyed_setters_ptr = p_function->keyed_setters.is_empty() ? nullptr : p_function->keyed_setters.ptr();
+	p_function->_keyed_getters_count = p_function->keyed_getters.size();
+	p_function->_keyed_getters_ptr = p_function->keyed_getters.is_empty() ? nullptr : p_function->keyed_getters.ptr();
+	p_function->_indexed_setters_count = p_function->indexed_setters.size();
+	p_function->_indexed_setters_ptr = p_function->indexed_setters.is_empty() ? nullptr : p_function->indexed_setters.ptr();
+	p_function->_indexed_getters_count = p_function->indexed_getters.size();
+	p_function->_indexed_getters_ptr = p_function->indexed_getters.is_empty() ? nullptr : p_function->indexed_getters.ptr();
+	p_function->_builtin_methods_count = p_function->builtin_methods.size();
+	p_function->_builtin_methods_ptr = p_function->builtin_methods.is_empty() ? nullptr : p_function->builtin_methods.ptr();
+	p_function->_constructors_count = p_function->constructors.size();
+	p_function->_constructors_ptr = p_function->constructors.is_empty() ? nullptr : p_function->constructors.ptr();
+	p_function->_utilities_count = p_function->utilities.size();
+	p_function->_utilities_ptr = p_function->utilities.is_empty() ? nullptr : p_function->utilities.ptr();
+	p_function->_gds_utilities_count = p_function->gds_utilities.size();
+	p_function->_gds_utilities_ptr = p_function->gds_utilities.is_empty() ? nullptr : p_function->gds_utilities.ptr();
+	p_function->_methods_count = p_function->methods.size();
+	p_function->_methods_ptr = p_function->methods.is_empty() ? nullptr : p_function->methods.ptrw();
+	p_function->_lambdas_count = p_function->lambdas.size();
+	p_function->_lambdas_ptr = p_function->lambdas.is_empty() ? nullptr : p_function->lambdas.ptrw();
+	p_function->_inline_caches_count = p_function->inline_caches.size();
+	p_function->_inline_caches_ptr = p_function->inline_caches.is_empty() ? nullptr : p_function->inline_caches.ptrw();
+
+	// Static functions run without an instance, so they have no members to address.
+	if (!_validate_code(p_function, p_function->_static ? 0 : p_member_count)) {
+		return false;
+	}
+
+#ifndef DEBUG_ENABLED
+	p_function->native_body = GDScriptNative::get_body(p_function);
+#endif
+
+	return true;
+}
+
+bool GDScriptBytecodeCache::_read_class_tree(Reader &r_reader, GDScript *p_script) {
+	p_script->local_name = r_reader.get_string();
+	p_script->global_name = r_reader.get_string();
+	p_script->simplified_icon_path = r_reader.get_string();
+
+	// Inner classes are reused when possible, so references held by existing instances stay valid.
+	HashMap<StringName, Ref<GDScript>> old_subclasses = p_script->subclasses;
+	p_script->subclasses.clear();
+
+	const uint32_t subclass_count = r_reader.get_count();
+	for (uint32_t i = 0; i < subclass_count; i++) {
+		const StringName name = r_reader.get_string();
+		const String fully_qualified_name = r_reader.get_string();
+		if (r_reader.failed) {
+			return false;
+		}
+
+		Ref<GDScript> subclass;
+		if (old_subclasses.has(name)) {
+			subclass = old_subclasses[name];
+		} else {
+			subclass = GDScriptLanguage::get_singleton()->get_orphan_subclass(fully_qualified_name);
+		}
+		if (subclass.is_null()) {
+			subclass.instantiate();
+		}
+		subclass->_owner = p_script;
+		subclass->path = p_script->path;
+		subclass->fully_qualified_name = fully_qualified_name;
+		p_script->subclasses.insert(name, subclass);
+
+		if (!_read_class_tree(r_reader, subclass.ptr())) {
+			return false;
+		}
+	}
+	return !r_reader.failed;
+}
+
+bool GDScriptBytecodeCache::_read_class(LoadState &r_state, Reader &r_reader, GDScript *p_script) {
+	const uint32_t class_index = r_state.classes.size();
+	r_state.classes.push_back(ClassData());
+	ClassData &data = r_state.classes[class_index];
+
+	data.script = p_script;
+	data.tool = r_reader.get_u8();
+	const int *native_index = GDScriptLanguage::get_singleton()->get_global_map().getptr(r_reader.get_string());
+	if (native_index == nullptr) {
+		return false;
+	}
+	data.native = GDScriptLanguage::get_singleton()->get_global_array()[*native_index];
+	if (data.native.is_null()) {
+		return false;
+	}
+	Ref<Script> base;
+	if (!_read_script_reference(r_state, r_reader, base)) {
+		return false;
+	}
+	data.base = base;
+	if (base.is_valid() && data.base.is_null()) {
+		return false;
+	}
+
+	const uint32_t member_count = r_reader.get_count();
+	for (uint32_t i = 0; i < member_count; i++) {
+		data.members.push_back(r_reader.get_string());
+	}
+	const uint32_t member_index_count = r_reader.get_count();
+	for (uint32_t i = 0; i < member_index_count; i++) {
+		const StringName name = r_reader.get_string();
+		if (!_read_member_info(r_state, r_reader, data.member_indices[name])) {
+			return false;
+		}
+	}
+	const uint32_t static_variable_count = r_reader.get_count();
+	for (uint32_t i = 0; i < static_variable_count; i++) {
+		const StringName name = r_reader.get_string();
+		if (!_read_member_info(r_state, r_reader, data.static_variables_indices[name])) {
+			return false;
+		}
+	}
+	const uint32_t constant_count = r_reader.get_count();
+	for (uint32_t i = 0; i < constant_count; i++) {
+		const StringName name = r_reader.get_string();
+		if (!_read_constant(r_state, r_reader, data.constants[name])) {
+			return false;
+		}
+	}
+	const uint32_t signal_count = r_reader.get_count();
+	for (uint32_t i = 0; i < signal_count; i++) {
+		const StringName name = r_reader.get_string();
+		if (!_read_method_info(r_state, r_reader, data.signals[name])) {
+			return false;
+		}
+	}
+	Variant rpc_config;
+	if (!_read_constant(r_state, r_reader, rpc_config) || rpc_config.get_type() != Variant::DICTIONARY) {
+		return false;
+	}
+	data.rpc_config = rpc_config;
+
+	// Functions are allocated before any of them is read, since they refer to their lambdas by index.
+	const uint32_t pool_start = r_state.functions.size();
+	const uint32_t pool_size = r_reader.get_count();
+	for (uint32_t i = 0; i < pool_size; i++) {
+		GDScriptFunction *function = memnew(GDScriptFunction);
+		function->_script = p_script;
+		r_state.functions.push_back(function);
+	}
+	for (uint32_t i = 0; i < pool_size; i++) {
+		if (!_read_function(r_state, r_reader, r_state.functions[pool_start + i], pool_start, pool_size, data.member_indices.size())) {
+			return false;
+		}
+	}
+
+	bool valid = true;
+	auto get_function = [&](int32_t p_index) -> GDScriptFunction * {
+		if (p_index < -1 || p_index >= (int32_t)pool_size) {
+			valid = false;
+			return nullptr;
+		}
+		return p_index == -1 ? nullptr : r_state.functions[pool_start + p_index];
+	};
+
+	const uint32_t member_function_count = r_reader.get_count();
+	for (uint32_t i = 0; i < member_function_count; i++) {
+		const StringName name = r_reader.get_string();
+		GDScriptFunction *function = get_function(r_reader.get_32());
+		if (function == nullptr) {
+			return false;
+		}
+		data.member_functions.insert(name, function);
+	}
+	data.initializer = get_function(r_reader.get_32());
+	data.implicit_initializer = get_function(r_reader.get_32());
+	data.implicit_ready = get_function(r_reader.get_32());
+	data.static_initializer = get_function(r_reader.get_32());
+	const uint32_t lambda_count = r_reader.get_count();
+	for (uint32_t i = 0; i < lambda_count; i++) {
+		GDScriptFunction *function = get_function(r_reader.get_32());
+		GDScript::LambdaInfo info;
+		info.capture_count = r_reader.get_32();
+		info.use_self = r_reader.get_u8();
+		if (function == nullptr) {
+			return false;
+		}
+		data.lambda_info.insert(function, info);
+	}
+	if (!valid) {
+		return false;
+	}
+
+#ifdef TOOLS_ENABLED
+	const uint32_t default_value_count = r_reader.get_count();
+	for (uint32_t i = 0; i < default_value_count; i++) {
+		const StringName name = r_reader.get_string();
+		if (!_read_constant(r_state, r_reader, data.member_default_values[name])) {
+			return false;
+		}
+	}
+#endif
+
+	const uint32_t subclass_count = r_reader.get_count();
+	for (uint32_t i = 0; i < subclass_count; i++) {
+		const StringName name = r_reader.get_string();
+		const Ref<GDScript> *subclass = p_script->subclasses.getptr(name);
+		if (subclass == nullptr || !_read_class(r_state, r_reader, subclass->ptr())) {
+			return false;
+		}
+	}
+	return !r_reader.failed;
+}
+
+/* Public API */
+
+bool GDScriptBytecodeCache::is_enabled() {
+#ifdef TOOLS_ENABLED
+	if (Engine::get_singleton()->is_editor_hint()) {
+		// The editor needs parse trees anyway, for documentation, code completion and warnings.
+		return false;
+	}
+#endif
+	return GLOBAL_GET("gdscript/bytecode_cache/enabled");
+}
+
+Error GDScriptBytecodeCache::serialize(GDScript *p_script, Vector<uint8_t> &r_buffer) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!p_script->is_root_script() || !p_script->is_valid(), ERR_INVALID_PARAMETER);
+
+	_build_function_keys();
+
+	SaveState state;
+	state.root = p_script;
+	for (const KeyValue<StringName, int> &E : GDScriptLanguage::get_singleton()->get_global_map()) {
+		state.global_names.insert(E.value, E.key);
+	}
+
+	Writer body;
+	body.put_string(p_script->fully_qualified_name);
+	_write_class_tree(body, p_script);
+	{
+		MutexLock lock(GDScriptCache::mutex);
+		const Ref<GDScript> *static_script = GDScriptCache::singleton->static_gdscript_cache.getptr(p_script->fully_qualified_name);
+		body.put_u8(static_script != nullptr && static_script->ptr() == p_script);
+	}
+
+	const String path = p_script->get_script_path();
+	if (!_write_class(state, body, p_script)) {
+		print_verbose(vformat(R"(GDScript bytecode cache: Can't store "%s": %s)", path, state.error));
+		return ERR_UNAVAILABLE;
+	}
+
+	// The compiled code depends on the interface of every script the analyzer looked at, not only on those it references.
+	_collect_dependencies(path, state.dependencies);
+
+	Writer header;
+	header.put_u32(BYTECODE_CACHE_MAGIC);
+	header.put_u32(BYTECODE_CACHE_FORMAT_VERSION);
+	header.put_u32((uint32_t)(VERSION_HEX));
+	header.put_string(String(VERSION_HASH));
+	header.put_u32(_get_build_flags());
+	header.put_u32(_get_extension_api_hash());
+	header.put_string(path);
+	header.put_u32(state.dependencies.size());
+	for (const String &dependency : state.dependencies) {
+		// Scripts can be reloaded while running from the editor, so their sources are hashed again when saving.
+		const String md5 = dependency.is_resource_file() ? _get_source_md5(dependency, true) : String();
+		if (md5.is_empty()) {
+			print_verbose(vformat(R"(GDScript bytecode cache: Can't store "%s": Dependency "%s" isn't a file.)", path, dependency));
+			return ERR_UNAVAILABLE;
+		}
+		header.put_string(dependency);
+		header.put_string(md5);
+	}
+	header.put_u32(body.data.size());
+	header.put_u32(hash_murmur3_buffer(body.data.ptr(), body.data.size()));
+
+	r_buffer.resize(header.data.size() + body.data.size());
+	memcpy(r_buffer.ptrw(), header.data.ptr(), header.data.size());
+	memcpy(r_buffer.ptrw() + header.data.size(), body.data.ptr(), body.data.size());
+	return OK;
+}
+
+Error GDScriptBytecodeCache::make_scripts(GDScript *p_script, const Vector<uint8_t> &p_buffer) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+
+	Reader reader(p_buffer);
+	String path;
+	if (!_read_header(reader, path)) {
+		return ERR_FILE_UNRECOGNIZED;
+	}
+	p_script->fully_qualified_name = reader.get_string();
+	if (!_read_class_tree(reader, p_script)) {
+		return ERR_FILE_CORRUPT;
+	}
+	p_script->bytecode_cache = p_buffer;
+	return OK;
+}
+
+Error GDScriptBytecodeCache::deserialize(GDScript *p_script, const Vector<uint8_t> &p_buffer) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!p_script->is_root_script(), ERR_INVALID_PARAMETER);
+
+	Reader reader(p_buffer);
+	LoadState state;
+	state.root = p_script;
+	if (!_read_header(reader, state.path)) {
+		return ERR_FILE_UNRECOGNIZED;
+	}
+	if (state.path != p_script->get_script_path()) {
+		return ERR_INVALID_DATA;
+	}
+	p_script->fully_qualified_name = reader.get_string();
+	if (!_read_class_tree(reader, p_script)) {
+		return ERR_FILE_CORRUPT;
+	}
+	// Replacing the functions of a compiled script would need the same care as a hot reload, so only fresh scripts are loaded.
+	ERR_FAIL_COND_V(_is_compiled(p_script), ERR_ALREADY_IN_USE);
+	const bool is_static_script = reader.get_u8();
+
+	if (!_read_class(state, reader, p_script) || reader.position != reader.size) {
+		for (GDScriptFunction *function : state.functions) {
+			// Lambdas are part of the list as well.
+			function->lambdas.clear();
+			function->name = StringName();
+			memdelete(function);
+		}
+		return ERR_FILE_CORRUPT;
+	}
+
+	GDScriptFunction::invalidate_inline_caches();
+
+	p_script->_owner = nullptr;
+	for (ClassData &data : state.classes) {
+		GDScript *script = data.script;
+		script->tool = data.tool;
+		script->native = data.native;
+		script->base = data.base;
+		script->_base = data.base.ptr();
+		script->members.clear();
+		for (const StringName &member : data.members) {
+			script->members.insert(member);
+		}
+		script->member_indices = data.member_indices;
+		script->static_variables_indices = data.static_variables_indices;
+		script->static_variables.resize(data.static_variables_indices.size());
+		script->constants = data.constants;
+		script->_signals = data.signals;
+		script->rpc_config = data.rpc_config;
+		script->member_functions = data.member_functions;
+		script->initializer = data.initializer;
+		script->implicit_initializer = data.implicit_initializer;
+		script->implicit_ready = data.implicit_ready;
+		script->static_initializer = data.static_initializer;
+		script->lambda_info = data.lambda_info;
+#ifdef TOOLS_ENABLED
+		script->member_default_values = data.member_default_values;
+#endif
+		script->_static_default_init();
+		script->valid = true;
+	}
+
+	if (is_static_script) {
+		GDScriptCache::add_static_script(p_script);
+	}
+	return OK;
+}
+
+Vector<uint8_t> GDScriptBytecodeCache::load(const String &p_path) {
+	if (!p_path.is_resource_file() || !is_enabled()) {
+		return Vector<uint8_t>();
+	}
+
+	const String cache_file = _get_cache_file(p_path);
+	if (!FileAccess::exists(cache_file)) {
+		return Vector<uint8_t>();
+	}
+	Vector<uint8_t> buffer = FileAccess::get_file_as_bytes(cache_file);
+
+	Reader reader(buffer);
+	String path;
+	if (!_read_header(reader, path) || path != p_path) {
+		return Vector<uint8_t>();
+	}
+	return buffer;
+}
+
+Error GDScriptBytecodeCache::save(GDScript *p_script) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+	const String path = p_script->get_script_path();
+	if (!path.is_resource_file() || !is_enabled()) {
+		return ERR_UNAVAILABLE;
+	}
+
+	Vector<uint8_t> buffer;
+	Error err = serialize(p_script, buffer);
+	if (err != OK) {
+		return err;
+	}
+
+	const String cache_file = _get_cache_file(path);
+	err = DirAccess::make_dir_recursive_absolute(cache_file.get_base_dir());
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat(R"(Can't create the GDScript bytecode cache directory "%s".)", cache_file.get_base_dir()));
+
+	// Several instances of the project may be running, so each writes its own file and then moves it in place.
+	const String temporary_file = cache_file + "." + itos(OS::get_singleton()->get_process_id()) + ".tmp";
+	{
+		Ref<FileAccess> file = FileAccess::open(temporary_file, FileAccess::WRITE, &err);
+		ERR_FAIL_COND_V_MSG(err != OK, err, vformat(R"(Can't write the GDScript bytecode cache file "%s".)", temporary_file));
+		file->store_buffer(buffer.ptr(), buffer.size());
+	}
+	if (FileAccess::exists(cache_file)) {
+		DirAccess::remove_absolute(cache_file);
+	}
+	return DirAccess::rename_absolute(temporary_file, cache_file);
+}
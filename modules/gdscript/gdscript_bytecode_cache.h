@@ -0,0 +1,184 @@
+/**************************************************************************/
+/*  gdscript_bytecode_cache.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "gdscript.h"
+
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/rb_map.h"
+
+// Compiled form of a GDScript file, used to skip parsing, analysis and compilation on later loads.
+//
+// A cache entry holds every class of the file with its members, constants, signals and the bytecode of
+// all its functions. Anything that only exists at runtime is stored by name and resolved again at load:
+// validated Variant calls by operator, member or method name, method binds by class and method name,
+// globals by name, and other scripts and resources by path. An entry is only used if it was written by
+// the same engine build, with the same extension classes, and if none of the scripts it was compiled
+// against changed since. In any other case the script is compiled from its source as usual.
+class GDScriptBytecodeCache {
+	enum {
+		BUILD_DEBUG = 1 << 0,
+		BUILD_TOOLS = 1 << 1,
+		BUILD_DEBUGGER = 1 << 2,
+		BUILD_REAL_T_IS_DOUBLE = 1 << 3,
+		BUILD_64_BITS = 1 << 4,
+		BUILD_LINE_TRACES = 1 << 5,
+	};
+
+	enum ScriptReference {
+		SCRIPT_REFERENCE_NONE,
+		SCRIPT_REFERENCE_LOCAL, // A class of the file being cached, by qualified name relative to its root.
+		SCRIPT_REFERENCE_GDSCRIPT, // A class of another GDScript file, by path and relative qualified name.
+		SCRIPT_REFERENCE_RESOURCE, // A script of another language, by path.
+	};
+
+	enum ConstantType {
+		CONSTANT_VARIANT,
+		CONSTANT_NULL_OBJECT,
+		CONSTANT_SCRIPT,
+		CONSTANT_NATIVE_CLASS,
+		CONSTANT_RESOURCE,
+		CONSTANT_ARRAY,
+		CONSTANT_DICTIONARY,
+	};
+
+	struct Writer;
+	struct Reader;
+
+	struct MemberKey {
+		Variant::Type type = Variant::NIL;
+		StringName name;
+		int index = 0;
+	};
+
+	struct SaveState {
+		GDScript *root = nullptr;
+		HashSet<String> dependencies;
+		HashMap<int, StringName> global_names;
+		String error;
+	};
+
+	// Everything read for one class, applied only once the whole file was read successfully.
+	struct ClassData {
+		GDScript *script = nullptr;
+		bool tool = false;
+		Ref<GDScriptNativeClass> native;
+		Ref<GDScript> base;
+		LocalVector<StringName> members;
+		HashMap<StringName, GDScript::MemberInfo> member_indices;
+		HashMap<StringName, GDScript::MemberInfo> static_variables_indices;
+		HashMap<StringName, Variant> constants;
+		HashMap<StringName, MethodInfo> signals;
+		Dictionary rpc_config;
+		HashMap<StringName, GDScriptFunction *> member_functions;
+		GDScriptFunction *initializer = nullptr;
+		GDScriptFunction *implicit_initializer = nullptr;
+		GDScriptFunction *implicit_ready = nullptr;
+		GDScriptFunction *static_initializer = nullptr;
+		HashMap<GDScriptFunction *, GDScript::LambdaInfo> lambda_info;
+#ifdef TOOLS_ENABLED
+		HashMap<StringName, Variant> member_default_values;
+#endif
+	};
+
+	struct LoadState {
+		GDScript *root = nullptr;
+		String path;
+		LocalVector<GDScriptFunction *> functions;
+		LocalVector<ClassData> classes;
+	};
+
+	static Mutex mutex;
+	static HashMap<String, String> source_md5s;
+	static uint32_t extension_api_hash;
+	static bool extension_api_hash_valid;
+
+	static bool function_keys_valid;
+	static RBMap<Variant::ValidatedOperatorEvaluator, uint32_t> operator_keys;
+	static RBMap<Variant::ValidatedSetter, MemberKey> setter_keys;
+	static RBMap<Variant::ValidatedGetter, MemberKey> getter_keys;
+	static RBMap<Variant::ValidatedKeyedSetter, Variant::Type> keyed_setter_keys;
+	static RBMap<Variant::ValidatedKeyedGetter, Variant::Type> keyed_getter_keys;
+	static RBMap<Variant::ValidatedIndexedSetter, Variant::Type> indexed_setter_keys;
+	static RBMap<Variant::ValidatedIndexedGetter, Variant::Type> indexed_getter_keys;
+	static RBMap<Variant::ValidatedBuiltInMethod, MemberKey> builtin_method_keys;
+	static RBMap<Variant::ValidatedConstructor, MemberKey> constructor_keys;
+	static RBMap<Variant::ValidatedUtilityFunction, StringName> utility_keys;
+	static RBMap<GDScriptUtilityFunctions::FunctionPtr, StringName> gds_utility_keys;
+
+	static uint32_t _get_build_flags();
+	static uint32_t _get_extension_api_hash();
+	static void _build_function_keys();
+	static String _get_cache_file(const String &p_path);
+	static String _get_source_md5(const String &p_path, bool p_refresh = false);
+	static void _collect_dependencies(const String &p_path, HashSet<String> &r_dependencies);
+	static bool _read_header(Reader &r_reader, String &r_path);
+	static bool _is_compiled(const GDScript *p_script);
+
+	static bool _write_script_reference(SaveState &r_state, Writer &r_writer, const Script *p_script);
+	static bool _write_constant(SaveState &r_state, Writer &r_writer, const Variant &p_constant);
+	static bool _write_data_type(SaveState &r_state, Writer &r_writer, const GDScriptDataType &p_data_type);
+	static void _write_property_info(Writer &r_writer, const PropertyInfo &p_info);
+	static bool _write_method_info(SaveState &r_state, Writer &r_writer, const MethodInfo &p_info);
+	static bool _write_member_info(SaveState &r_state, Writer &r_writer, const GDScript::MemberInfo &p_info);
+	static bool _write_function(SaveState &r_state, Writer &r_writer, const GDScriptFunction *p_function, const HashMap<GDScriptFunction *, int> &p_pool);
+	static void _write_class_tree(Writer &r_writer, const GDScript *p_script);
+	static bool _write_class(SaveState &r_state, Writer &r_writer, GDScript *p_script);
+
+	static bool _read_script_reference(LoadState &r_state, Reader &r_reader, Ref<Script> &r_script);
+	static bool _read_constant(LoadState &r_state, Reader &r_reader, Variant &r_constant);
+	static bool _read_data_type(LoadState &r_state, Reader &r_reader, GDScriptDataType &r_data_type);
+	static void _read_property_info(Reader &r_reader, PropertyInfo &r_info);
+	static bool _read_method_info(LoadState &r_state, Reader &r_reader, MethodInfo &r_info);
+	static bool _read_member_info(LoadState &r_state, Reader &r_reader, GDScript::MemberInfo &r_info);
+	static bool _read_function(LoadState &r_state, Reader &r_reader, GDScriptFunction *p_function, uint32_t p_pool_start, uint32_t p_pool_size, int p_member_count);
+	static bool _validate_code(const GDScriptFunction *p_function, int p_member_count);
+	static bool _read_class_tree(Reader &r_reader, GDScript *p_script);
+	static bool _read_class(LoadState &r_state, Reader &r_reader, GDScript *p_script);
+
+public:
+	static bool is_enabled();
+
+	// Writes the compiled state of `p_script` and its inner classes. Fails if it references anything that
+	// can't be found again by name or path, such as built-in resources.
+	static Error serialize(GDScript *p_script, Vector<uint8_t> &r_buffer);
+	// Creates the inner classes of `p_script`, like `GDScriptCompiler::make_scripts()` does from a parse tree,
+	// and keeps the entry so `GDScript::reload()` can use it without reading it again.
+	static Error make_scripts(GDScript *p_script, const Vector<uint8_t> &p_buffer);
+	// Rebuilds what `GDScriptCompiler::compile()` produces. Leaves `p_script` untouched on failure.
+	static Error deserialize(GDScript *p_script, const Vector<uint8_t> &p_buffer);
+
+	// Returns the cache entry of the script at `p_path` if it's still valid, or an empty buffer.
+	static Vector<uint8_t> load(const String &p_path);
+	static Error save(GDScript *p_script);
+};
@@ -32,10 +32,12 @@
 
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_bytecode_cache.h"
 #include "gdscript_compiler.h"
 #include "gdscript_parser.h"
 
 #include "core/io/file_access.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/vector.h"
 
 GDScriptParserRef::Status GDScriptParserRef::get_status() const {
@@ -68,13 +70,32 @@ Error GDScriptParserRef::raise_status(Status p_new_status) {
 	ERR_FAIL_COND_V(clearing, ERR_BUG);
 	ERR_FAIL_COND_V(parser == nullptr && status != EMPTY, ERR_BUG);
 
+	// Parsers may be raised from worker threads (see `GDScriptCache::warm_up()`), so only one thread raises a given parser at a time.
+	// The steps themselves run without the cache lock, unless the caller was already holding it.
+	MutexLock lock(GDScriptCache::mutex);
+	const Thread::ID caller_id = Thread::get_caller_id();
+	bool claimed = false;
+
 	while (result == OK && p_new_status > status) {
+		if (raising_thread == Thread::UNASSIGNED_ID) {
+			raising_thread = caller_id;
+			claimed = true;
+		} else if (raising_thread != caller_id && !GDScriptCache::singleton->_is_raise_waiting_on(raising_thread, caller_id)) {
+			GDScriptCache::singleton->raise_waits[caller_id] = this;
+			GDScriptCache::raise_condition.wait(lock);
+			GDScriptCache::singleton->raise_waits.erase(caller_id);
+			continue;
+		}
+		// If the raising thread is waiting for a parser this thread is raising (cyclic dependency), carry on
+		// like the recursive call would on a single thread. The other thread is blocked until this one is done.
+
 		switch (status) {
 			case EMPTY: {
 				// Calling parse will clear the parser, which can destruct another GDScriptParserRef which can clear the last reference to the script with this path, calling remove_script, which clears this GDScriptParserRef.
 				// It's ok if its the first thing done here.
 				get_parser()->clear();
 				status = PARSED;
+				lock.temp_unlock();
 				String remapped_path = ResourceLoader::path_remap(path);
 				if (remapped_path.get_extension().to_lower() == "gdc") {
 					Vector<uint8_t> tokens = GDScriptCache::get_binary_tokens(remapped_path);
@@ -85,25 +106,36 @@ Error GDScriptParserRef::raise_status(Status p_new_status) {
 					source_hash = source.hash();
 					result = get_parser()->parse(source, path, false);
 				}
+				lock.temp_relock();
 			} break;
 			case PARSED: {
 				status = INHERITANCE_SOLVED;
+				lock.temp_unlock();
 				result = get_analyzer()->resolve_inheritance();
+				lock.temp_relock();
 			} break;
 			case INHERITANCE_SOLVED: {
 				status = INTERFACE_SOLVED;
+				lock.temp_unlock();
 				result = get_analyzer()->resolve_interface();
+				lock.temp_relock();
 			} break;
 			case INTERFACE_SOLVED: {
 				status = FULLY_SOLVED;
+				lock.temp_unlock();
 				result = get_analyzer()->resolve_body();
+				lock.temp_relock();
 			} break;
 			case FULLY_SOLVED: {
-				return result;
-			}
+			} break;
 		}
 	}
 
+	if (claimed) {
+		raising_thread = Thread::UNASSIGNED_ID;
+		GDScriptCache::raise_condition.notify_all();
+	}
+
 	return result;
 }
 
@@ -151,6 +183,23 @@ SafeBinaryMutex<GDScriptCache::BINARY_MUTEX_TAG> &_get_gdscript_cache_mutex() {
 template <>
 thread_local SafeBinaryMutex<GDScriptCache::BINARY_MUTEX_TAG>::TLSData SafeBinaryMutex<GDScriptCache::BINARY_MUTEX_TAG>::tls_data(_get_gdscript_cache_mutex());
 SafeBinaryMutex<GDScriptCache::BINARY_MUTEX_TAG> GDScriptCache::mutex;
+ConditionVariable GDScriptCache::raise_condition;
+
+bool GDScriptCache::_is_raise_waiting_on(Thread::ID p_thread, Thread::ID p_raiser) const {
+	// Follows the chain of threads waiting for each other's parsers, which ends at a thread doing actual work.
+	Thread::ID thread = p_thread;
+	for (uint32_t i = 0; i < raise_waits.size(); i++) {
+		HashMap<Thread::ID, GDScriptParserRef *>::ConstIterator E = raise_waits.find(thread);
+		if (!E) {
+			return false;
+		}
+		thread = E->value->raising_thread;
+		if (thread == p_raiser) {
+			return true;
+		}
+	}
+	return false;
+}
 
 void GDScriptCache::move_script(const String &p_from, const String &p_to) {
 	if (singleton == nullptr || p_from == p_to) {
@@ -253,6 +302,7 @@ void GDScriptCache::remove_parser(const String &p_path) {
 
 	// Can't clear the parser because some other parser might be currently using it in the chain of calls.
 	singleton->parser_map.erase(p_path);
+	singleton->warmed_up_parsers.erase(p_path);
 
 	// Have to copy while iterating, because parser_inverse_dependencies is modified.
 	HashSet<String> ideps = singleton->parser_inverse_dependencies[p_path];
@@ -327,9 +377,13 @@ Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, Error &r_e
 		return Ref<GDScript>(); // Returns null and does not cache when the script fails to load.
 	}
 
-	Ref<GDScriptParserRef> parser_ref = get_parser(p_path, GDScriptParserRef::PARSED, r_error);
-	if (r_error == OK) {
-		GDScriptCompiler::make_scripts(script.ptr(), parser_ref->get_parser()->get_tree(), true);
+	Vector<uint8_t> bytecode_cache = GDScriptBytecodeCache::load(p_path);
+	// When found in the cache, the script is loaded from it in `GDScript::reload()` and doesn't need to be parsed.
+	if (bytecode_cache.is_empty() || GDScriptBytecodeCache::make_scripts(script.ptr(), bytecode_cache) != OK) {
+		Ref<GDScriptParserRef> parser_ref = get_parser(p_path, GDScriptParserRef::PARSED, r_error);
+		if (r_error == OK) {
+			GDScriptCompiler::make_scripts(script.ptr(), parser_ref->get_parser()->get_tree(), true);
+		}
 	}
 
 	singleton->shallow_gdscript_cache[p_path] = script;
@@ -444,6 +498,159 @@ void GDScriptCache::remove_static_script(const String &p_fqcn) {
 	singleton->static_gdscript_cache.erase(p_fqcn);
 }
 
+void GDScriptCache::_warm_up_raise(uint32_t p_index, WarmUpBatch *p_batch) {
+	p_batch->refs[p_index]->raise_status(p_batch->status);
+}
+
+void GDScriptCache::_run_warm_up_batch(WarmUpBatch &p_batch, const String &p_description) {
+	if (p_batch.refs.is_empty()) {
+		return;
+	}
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(singleton, &GDScriptCache::_warm_up_raise, &p_batch, p_batch.refs.size(), -1, true, p_description);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
+void GDScriptCache::warm_up(const Vector<String> &p_paths) {
+	ERR_FAIL_NULL(singleton);
+
+	// The parser fills some static tables on first use, which must not happen on several threads at once.
+	{
+		GDScriptParser parser;
+		GDScriptParser::get_builtin_type(StringName());
+	}
+
+	struct WarmUpScript {
+		Ref<GDScriptParserRef> ref;
+		HashSet<String> dependencies;
+		bool only_scripts = false;
+		bool blocked = false;
+		bool analyzed = false;
+	};
+	HashMap<String, WarmUpScript> scripts;
+
+	// Parse the given scripts and every script they may depend on, one wave of newly found scripts at a time.
+	Vector<String> to_parse = p_paths;
+	while (!to_parse.is_empty()) {
+		WarmUpBatch batch;
+		batch.status = GDScriptParserRef::PARSED;
+		LocalVector<String> batch_paths;
+		for (const String &path : to_parse) {
+			if (scripts.has(path)) {
+				continue;
+			}
+			WarmUpScript &script = scripts[path];
+			Error err = OK;
+			script.ref = get_parser(path, GDScriptParserRef::EMPTY, err);
+			if (script.ref.is_null()) {
+				script.analyzed = true;
+				continue;
+			}
+			batch.refs.push_back(script.ref.ptr());
+			batch_paths.push_back(path);
+		}
+		_run_warm_up_batch(batch, "GDScriptWarmUpParse");
+
+		to_parse.clear();
+		for (const String &path : batch_paths) {
+			WarmUpScript &script = scripts[path];
+			if (script.ref->result != OK) {
+				// Reported when the script is actually loaded.
+				script.analyzed = true;
+				continue;
+			}
+			script.only_scripts = script.ref->get_parser()->get_possible_script_dependencies(script.dependencies);
+			for (const String &dependency : script.dependencies) {
+				if (!scripts.has(dependency)) {
+					to_parse.push_back(dependency);
+				}
+			}
+		}
+	}
+
+	// The analyzer may load other resources (scenes, non-GDScript classes, etc.), which is left to the normal loading path.
+	// This excludes the scripts that need such resources, and the ones depending on them.
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (KeyValue<String, WarmUpScript> &E : scripts) {
+			WarmUpScript &script = E.value;
+			if (script.analyzed || script.blocked) {
+				continue;
+			}
+			script.blocked = !script.only_scripts;
+			for (const String &dependency : script.dependencies) {
+				if (script.blocked) {
+					break;
+				}
+				const WarmUpScript *dependency_script = scripts.getptr(dependency);
+				script.blocked = dependency_script != nullptr && dependency_script->blocked;
+			}
+			changed = changed || script.blocked;
+		}
+	}
+
+	// Analyze a script once every script it may depend on is done, so that analyzers only read finished trees of other scripts.
+	while (true) {
+		WarmUpBatch batch;
+		batch.status = GDScriptParserRef::FULLY_SOLVED;
+		LocalVector<WarmUpScript *> batch_scripts;
+		for (KeyValue<String, WarmUpScript> &E : scripts) {
+			WarmUpScript &script = E.value;
+			if (script.analyzed || script.blocked) {
+				continue;
+			}
+			bool ready = true;
+			for (const String &dependency : script.dependencies) {
+				const WarmUpScript *dependency_script = scripts.getptr(dependency);
+				if (dependency_script != nullptr && !dependency_script->analyzed) {
+					ready = false;
+					break;
+				}
+			}
+			if (ready) {
+				batch.refs.push_back(script.ref.ptr());
+				batch_scripts.push_back(&script);
+			}
+		}
+		if (batch.refs.is_empty()) {
+			break;
+		}
+		_run_warm_up_batch(batch, "GDScriptWarmUpAnalyze");
+		for (WarmUpScript *script : batch_scripts) {
+			script->analyzed = true;
+		}
+	}
+
+	// What's left depends on a cycle of scripts, analyze it the usual way.
+	for (KeyValue<String, WarmUpScript> &E : scripts) {
+		if (!E.value.analyzed && !E.value.blocked) {
+			E.value.ref->raise_status(GDScriptParserRef::FULLY_SOLVED);
+		}
+	}
+
+	MutexLock lock(singleton->mutex);
+	for (KeyValue<String, WarmUpScript> &E : scripts) {
+		if (E.value.ref.is_valid() && E.value.ref->result == OK && !E.value.ref->abandoned) {
+			singleton->warmed_up_parsers[E.key] = E.value.ref;
+		}
+	}
+}
+
+Ref<GDScriptParserRef> GDScriptCache::take_warmed_up_parser(const String &p_path) {
+	if (singleton == nullptr) {
+		return Ref<GDScriptParserRef>();
+	}
+
+	MutexLock lock(singleton->mutex);
+
+	Ref<GDScriptParserRef> ref;
+	if (HashMap<String, Ref<GDScriptParserRef>>::Iterator E = singleton->warmed_up_parsers.find(p_path)) {
+		ref = E->value;
+		singleton->warmed_up_parsers.remove(E);
+	}
+	return ref;
+}
+
 void GDScriptCache::clear() {
 	if (singleton == nullptr) {
 		return;
@@ -457,6 +664,7 @@ void GDScriptCache::clear() {
 	singleton->cleared = true;
 
 	singleton->parser_inverse_dependencies.clear();
+	singleton->warmed_up_parsers.clear();
 
 	for (const KeyValue<String, Vector<ObjectID>> &KV : singleton->abandoned_parser_map) {
 		for (ObjectID parser_ref_id : KV.value) {
@@ -33,9 +33,12 @@
 #include "gdscript.h"
 
 #include "core/object/ref_counted.h"
+#include "core/os/condition_variable.h"
 #include "core/os/safe_binary_mutex.h"
+#include "core/os/thread.h"
 #include "core/templates/hash_map.h"
 #include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
 
 class GDScriptAnalyzer;
 class GDScriptParser;
@@ -59,6 +62,8 @@ private:
 	uint32_t source_hash = 0;
 	bool clearing = false;
 	bool abandoned = false;
+	// The thread currently raising the status; the others wait for it instead of analyzing the same tree.
+	Thread::ID raising_thread = Thread::UNASSIGNED_ID;
 
 	friend class GDScriptCache;
 	friend class GDScript;
@@ -85,8 +90,11 @@ class GDScriptCache {
 	HashMap<String, Ref<GDScript>> static_gdscript_cache;
 	HashMap<String, HashSet<String>> dependencies;
 	HashMap<String, HashSet<String>> parser_inverse_dependencies;
+	HashMap<String, Ref<GDScriptParserRef>> warmed_up_parsers;
+	HashMap<Thread::ID, GDScriptParserRef *> raise_waits;
 
 	friend class GDScript;
+	friend class GDScriptBytecodeCache;
 	friend class GDScriptParserRef;
 	friend class GDScriptInstance;
 
@@ -99,8 +107,18 @@ public:
 
 private:
 	static SafeBinaryMutex<BINARY_MUTEX_TAG> mutex;
+	static ConditionVariable raise_condition;
 	friend SafeBinaryMutex<BINARY_MUTEX_TAG> &_get_gdscript_cache_mutex();
 
+	struct WarmUpBatch {
+		LocalVector<GDScriptParserRef *> refs;
+		GDScriptParserRef::Status status = GDScriptParserRef::EMPTY;
+	};
+
+	bool _is_raise_waiting_on(Thread::ID p_thread, Thread::ID p_raiser) const;
+	void _warm_up_raise(uint32_t p_index, WarmUpBatch *p_batch);
+	static void _run_warm_up_batch(WarmUpBatch &p_batch, const String &p_description);
+
 public:
 	static void move_script(const String &p_from, const String &p_to);
 	static void remove_script(const String &p_path);
@@ -115,6 +133,8 @@ public:
 	static Error finish_compiling(const String &p_owner);
 	static void add_static_script(Ref<GDScript> p_script);
 	static void remove_static_script(const String &p_fqcn);
+	static void warm_up(const Vector<String> &p_paths);
+	static Ref<GDScriptParserRef> take_warmed_up_parser(const String &p_path);
 
 	static void clear();
 
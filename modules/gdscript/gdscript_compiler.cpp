@@ -37,6 +37,7 @@
 
 #include "core/config/engine.h"
 #include "core/config/project_settings.h"
+#include "core/debugger/engine_debugger.h"
 
 #include "scene/scene_string_names.h"
 
@@ -1887,6 +1888,248 @@ void GDScriptCompiler::_clear_block_locals(CodeGen &codegen, const List<GDScript
 	}
 }
 
+// Returns `array` if `p_expression` is `array[p_index]`, where `array` is a local packed float array.
+static const GDScriptParser::IdentifierNode *_get_packed_array_element(const GDScriptParser::ExpressionNode *p_expression, const StringName &p_index) {
+	if (p_expression->type != GDScriptParser::Node::SUBSCRIPT) {
+		return nullptr;
+	}
+	const GDScriptParser::SubscriptNode *subscript = static_cast<const GDScriptParser::SubscriptNode *>(p_expression);
+	if (subscript->is_attribute || subscript->base->type != GDScriptParser::Node::IDENTIFIER || subscript->index->type != GDScriptParser::Node::IDENTIFIER) {
+		return nullptr;
+	}
+
+	const GDScriptParser::IdentifierNode *index = static_cast<const GDScriptParser::IdentifierNode *>(subscript->index);
+	if (index->source != GDScriptParser::IdentifierNode::LOCAL_ITERATOR || index->name != p_index) {
+		return nullptr;
+	}
+
+	const GDScriptParser::IdentifierNode *array = static_cast<const GDScriptParser::IdentifierNode *>(subscript->base);
+	if (array->source != GDScriptParser::IdentifierNode::LOCAL_VARIABLE && array->source != GDScriptParser::IdentifierNode::FUNCTION_PARAMETER) {
+		return nullptr;
+	}
+	const GDScriptParser::DataType &type = array->get_datatype();
+	if (!type.is_hard_type() || type.kind != GDScriptParser::DataType::BUILTIN || (type.builtin_type != Variant::PACKED_FLOAT32_ARRAY && type.builtin_type != Variant::PACKED_FLOAT64_ARRAY)) {
+		return nullptr;
+	}
+	return array;
+}
+
+static bool _is_same_packed_array_element(const GDScriptParser::ExpressionNode *p_expression, const GDScriptParser::IdentifierNode *p_array, const StringName &p_index) {
+	const GDScriptParser::IdentifierNode *array = _get_packed_array_element(p_expression, p_index);
+	return array != nullptr && array->name == p_array->name;
+}
+
+// Whether `p_expression` is a number that the loop body can't change, so it can be evaluated once before the loop.
+static bool _is_loop_invariant_number(const GDScriptParser::ExpressionNode *p_expression, const StringName &p_index) {
+	if (p_expression->is_constant) {
+		return p_expression->reduced_value.get_type() == Variant::INT || p_expression->reduced_value.get_type() == Variant::FLOAT;
+	}
+	if (p_expression->type != GDScriptParser::Node::IDENTIFIER) {
+		return false;
+	}
+
+	const GDScriptParser::IdentifierNode *identifier = static_cast<const GDScriptParser::IdentifierNode *>(p_expression);
+	switch (identifier->source) {
+		case GDScriptParser::IdentifierNode::FUNCTION_PARAMETER:
+		case GDScriptParser::IdentifierNode::LOCAL_VARIABLE:
+		case GDScriptParser::IdentifierNode::LOCAL_ITERATOR:
+			break;
+		default:
+			return false;
+	}
+	const GDScriptParser::DataType &type = identifier->get_datatype();
+	return identifier->name != p_index && type.is_hard_type() && type.kind == GDScriptParser::DataType::BUILTIN && (type.builtin_type == Variant::INT || type.builtin_type == Variant::FLOAT);
+}
+
+// Recognizes `for i in array.size()` and `for i in range(array.size())` loops whose body is one of:
+// `array[i] += x`, `array[i] -= x`, `array[i] *= x`, `array[i] = array[i] * x + y`, `array[i] = clamp(array[i], x, y)`,
+// `array[i] += other[i]`, `array[i] *= other[i]` or `array[i] = lerp(array[i], other[i], x)`.
+// The bulk methods do the same math in the same order, so the results are identical.
+bool GDScriptCompiler::_get_packed_array_loop(const GDScriptParser::ForNode *p_for, PackedArrayLoop &r_loop) {
+	if (p_for->loop->statements.size() != 1 || p_for->loop->statements[0]->type != GDScriptParser::Node::ASSIGNMENT) {
+		return false;
+	}
+
+	const GDScriptParser::ExpressionNode *list = p_for->list;
+	if (list->type == GDScriptParser::Node::CALL) {
+		const GDScriptParser::CallNode *range = static_cast<const GDScriptParser::CallNode *>(list);
+		if (!range->is_super && range->callee != nullptr && range->callee->type == GDScriptParser::Node::IDENTIFIER && range->function_name == SNAME("range") && range->arguments.size() == 1) {
+			list = range->arguments[0];
+		}
+	}
+	if (list->type != GDScriptParser::Node::CALL) {
+		return false;
+	}
+	const GDScriptParser::CallNode *size = static_cast<const GDScriptParser::CallNode *>(list);
+	if (size->is_super || size->function_name != SNAME("size") || !size->arguments.is_empty() || size->callee == nullptr || size->callee->type != GDScriptParser::Node::SUBSCRIPT) {
+		return false;
+	}
+	const GDScriptParser::SubscriptNode *size_callee = static_cast<const GDScriptParser::SubscriptNode *>(size->callee);
+	if (!size_callee->is_attribute || size_callee->base->type != GDScriptParser::Node::IDENTIFIER) {
+		return false;
+	}
+	const StringName array_name = static_cast<const GDScriptParser::IdentifierNode *>(size_callee->base)->name;
+
+	const StringName &index = p_for->variable->name;
+	const GDScriptParser::AssignmentNode *assignment = static_cast<const GDScriptParser::AssignmentNode *>(p_for->loop->statements[0]);
+	r_loop.array = _get_packed_array_element(assignment->assignee, index);
+	if (r_loop.array == nullptr || r_loop.array->name != array_name) {
+		return false;
+	}
+	const Variant::Type array_type = r_loop.array->get_datatype().builtin_type;
+	const GDScriptParser::ExpressionNode *value = assignment->assigned_value;
+
+	switch (assignment->operation) {
+		case GDScriptParser::AssignmentNode::OP_ADDITION:
+		case GDScriptParser::AssignmentNode::OP_MULTIPLICATION: {
+			const bool is_addition = assignment->operation == GDScriptParser::AssignmentNode::OP_ADDITION;
+			if (_is_loop_invariant_number(value, index)) {
+				r_loop.method = is_addition ? SNAME("add_scalar") : SNAME("multiply_scalar");
+				r_loop.arguments.push_back(value);
+				return true;
+			}
+			const GDScriptParser::IdentifierNode *operand_array = _get_packed_array_element(value, index);
+			if (operand_array != nullptr && operand_array->get_datatype().builtin_type == array_type) {
+				r_loop.method = is_addition ? SNAME("add_array") : SNAME("multiply_array");
+				r_loop.arguments.push_back(operand_array);
+				r_loop.operand_array = operand_array;
+				return true;
+			}
+		} break;
+		case GDScriptParser::AssignmentNode::OP_SUBTRACTION: {
+			// Negating an int could overflow, so only float variables or constants.
+			if (_is_loop_invariant_number(value, index) && (value->is_constant || value->get_datatype().builtin_type == Variant::FLOAT)) {
+				r_loop.method = SNAME("add_scalar");
+				r_loop.arguments.push_back(value);
+				r_loop.negate_argument = true;
+				return true;
+			}
+		} break;
+		case GDScriptParser::AssignmentNode::OP_NONE: {
+			if (value->type == GDScriptParser::Node::BINARY_OPERATOR) {
+				// `array[i] * x + y`, or `x * array[i] + y`.
+				const GDScriptParser::BinaryOpNode *addition = static_cast<const GDScriptParser::BinaryOpNode *>(value);
+				if (addition->operation != GDScriptParser::BinaryOpNode::OP_ADDITION || addition->left_operand->type != GDScriptParser::Node::BINARY_OPERATOR || !_is_loop_invariant_number(addition->right_operand, index)) {
+					return false;
+				}
+				const GDScriptParser::BinaryOpNode *multiplication = static_cast<const GDScriptParser::BinaryOpNode *>(addition->left_operand);
+				if (multiplication->operation != GDScriptParser::BinaryOpNode::OP_MULTIPLICATION) {
+					return false;
+				}
+				const GDScriptParser::ExpressionNode *scale = nullptr;
+				if (_is_same_packed_array_element(multiplication->left_operand, r_loop.array, index)) {
+					scale = multiplication->right_operand;
+				} else if (_is_same_packed_array_element(multiplication->right_operand, r_loop.array, index)) {
+					scale = multiplication->left_operand;
+				}
+				if (scale == nullptr || !_is_loop_invariant_number(scale, index)) {
+					return false;
+				}
+				r_loop.method = SNAME("multiply_add");
+				r_loop.arguments.push_back(scale);
+				r_loop.arguments.push_back(addition->right_operand);
+				return true;
+			}
+
+			if (value->type != GDScriptParser::Node::CALL) {
+				return false;
+			}
+			// The compiler resolves these names to utility functions before script methods.
+			const GDScriptParser::CallNode *call = static_cast<const GDScriptParser::CallNode *>(value);
+			if (call->is_super || call->callee == nullptr || call->callee->type != GDScriptParser::Node::IDENTIFIER || call->arguments.size() != 3 || !_is_same_packed_array_element(call->arguments[0], r_loop.array, index)) {
+				return false;
+			}
+			if (call->function_name == SNAME("clamp") && _is_loop_invariant_number(call->arguments[1], index) && _is_loop_invariant_number(call->arguments[2], index)) {
+				r_loop.method = SNAME("clamp");
+				r_loop.arguments.push_back(call->arguments[1]);
+				r_loop.arguments.push_back(call->arguments[2]);
+				return true;
+			}
+			if (call->function_name == SNAME("lerp") || call->function_name == SNAME("lerpf")) {
+				const GDScriptParser::IdentifierNode *operand_array = _get_packed_array_element(call->arguments[1], index);
+				if (operand_array != nullptr && operand_array->get_datatype().builtin_type == array_type && _is_loop_invariant_number(call->arguments[2], index)) {
+					r_loop.method = SNAME("lerp");
+					r_loop.arguments.push_back(operand_array);
+					r_loop.arguments.push_back(call->arguments[2]);
+					r_loop.operand_array = operand_array;
+					return true;
+				}
+			}
+		} break;
+		default:
+			break;
+	}
+	return false;
+}
+
+Error GDScriptCompiler::_parse_packed_array_loop(CodeGen &codegen, const PackedArrayLoop &p_loop) {
+	GDScriptCodeGenerator *gen = codegen.generator;
+	Error err = OK;
+	const Variant::Type array_type = p_loop.array->get_datatype().builtin_type;
+
+	GDScriptCodeGenerator::Address array = _parse_expression(codegen, err, p_loop.array);
+	if (err) {
+		return err;
+	}
+
+	if (p_loop.operand_array != nullptr) {
+		// Arrays of different sizes must fail the same way as the loop does, so run the loop for them: `if array.size() == other.size():`.
+		GDScriptCodeGenerator::Address operand_array = _parse_expression(codegen, err, p_loop.operand_array);
+		if (err) {
+			return err;
+		}
+		GDScriptDataType int_type;
+		int_type.has_type = true;
+		int_type.kind = GDScriptDataType::BUILTIN;
+		int_type.builtin_type = Variant::INT;
+		GDScriptDataType bool_type = int_type;
+		bool_type.builtin_type = Variant::BOOL;
+
+		GDScriptCodeGenerator::Address array_size = codegen.add_temporary(int_type);
+		GDScriptCodeGenerator::Address operand_size = codegen.add_temporary(int_type);
+		GDScriptCodeGenerator::Address same_size = codegen.add_temporary(bool_type);
+		gen->write_call_builtin_type(array_size, array, array_type, SNAME("size"), Vector<GDScriptCodeGenerator::Address>());
+		gen->write_call_builtin_type(operand_size, operand_array, array_type, SNAME("size"), Vector<GDScriptCodeGenerator::Address>());
+		gen->write_binary_operator(same_size, Variant::OP_EQUAL, array_size, operand_size);
+		gen->write_if(same_size);
+		gen->pop_temporary();
+		gen->pop_temporary();
+		gen->pop_temporary();
+	}
+
+	Vector<GDScriptCodeGenerator::Address> arguments;
+	for (const GDScriptParser::ExpressionNode *argument : p_loop.arguments) {
+		arguments.push_back(_parse_expression(codegen, err, argument));
+		if (err) {
+			return err;
+		}
+	}
+
+	bool has_negated_argument = false;
+	if (p_loop.negate_argument) {
+		const GDScriptParser::ExpressionNode *argument = p_loop.arguments[0];
+		if (argument->is_constant) {
+			arguments.write[0] = codegen.add_constant(-(double)argument->reduced_value);
+		} else {
+			GDScriptCodeGenerator::Address negated = codegen.add_temporary(arguments[0].type);
+			gen->write_unary_operator(negated, Variant::OP_NEGATE, arguments[0]);
+			arguments.write[0] = negated;
+			has_negated_argument = true;
+		}
+	}
+
+	gen->write_call_builtin_type(GDScriptCodeGenerator::Address(), array, array_type, p_loop.method, arguments);
+
+	if (has_negated_argument) {
+		gen->pop_temporary();
+	}
+
+	if (p_loop.operand_array != nullptr) {
+		gen->write_else();
+	}
+	return OK;
+}
+
 Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::SuiteNode *p_block, bool p_add_locals, bool p_clear_locals) {
 	Error err = OK;
 	GDScriptCodeGenerator *gen = codegen.generator;
@@ -2043,6 +2286,20 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 			case GDScriptParser::Node::FOR: {
 				const GDScriptParser::ForNode *for_n = static_cast<const GDScriptParser::ForNode *>(s);
 
+				// Keep the loop when debugging, so breakpoints and stepping work in its body.
+				PackedArrayLoop packed_loop;
+				const bool is_packed_loop = !EngineDebugger::is_active() && _get_packed_array_loop(for_n, packed_loop);
+				if (is_packed_loop) {
+					err = _parse_packed_array_loop(codegen, packed_loop);
+					if (err) {
+						return err;
+					}
+					if (packed_loop.operand_array == nullptr) {
+						break;
+					}
+					// Otherwise the loop goes in the `else` branch, for arrays of different sizes.
+				}
+
 				// Add an extra block, since the iterator and @special locals belong to the loop scope.
 				// Also we use custom logic to clear block locals.
 				codegen.start_block();
@@ -2079,6 +2336,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 				_clear_block_locals(codegen, loop_locals); // Outside loop, after block - for `break` and normal exit.
 
 				codegen.end_block(); // Get out of extra block for loop iterator, @special locals, and custom locals clearing.
+
+				if (is_packed_loop) {
+					gen->write_endif();
+				}
 			} break;
 			case GDScriptParser::Node::WHILE: {
 				const GDScriptParser::WhileNode *while_n = static_cast<const GDScriptParser::WhileNode *>(s);
@@ -3253,6 +3514,9 @@ Error GDScriptCompiler::compile(const GDScriptParser *p_parser, GDScript *p_scri
 
 	ScriptLambdaInfo old_lambda_info = _get_script_lambda_replacement_info(p_script);
 
+	// Members and functions are about to be rebuilt.
+	GDScriptFunction::invalidate_inline_caches();
+
 	// Create scripts for subclasses beforehand so they can be referenced
 	make_scripts(p_script, root, p_keep_state);
 
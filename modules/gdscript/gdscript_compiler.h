@@ -155,6 +155,19 @@ class GDScriptCompiler {
 	List<GDScriptCodeGenerator::Address> _add_block_locals(CodeGen &codegen, const GDScriptParser::SuiteNode *p_block);
 	void _clear_block_locals(CodeGen &codegen, const List<GDScriptCodeGenerator::Address> &p_locals);
 	Error _parse_block(CodeGen &codegen, const GDScriptParser::SuiteNode *p_block, bool p_add_locals = true, bool p_clear_locals = true);
+
+	// A `for` loop over a packed float array that only updates each element, replaced with a bulk method of the array.
+	struct PackedArrayLoop {
+		const GDScriptParser::IdentifierNode *array = nullptr;
+		StringName method;
+		Vector<const GDScriptParser::ExpressionNode *> arguments;
+		// Set when the first argument is another array of the same type. Its size must be checked at runtime.
+		const GDScriptParser::IdentifierNode *operand_array = nullptr;
+		// `-=` is done with `add_scalar()`.
+		bool negate_argument = false;
+	};
+	bool _get_packed_array_loop(const GDScriptParser::ForNode *p_for, PackedArrayLoop &r_loop);
+	Error _parse_packed_array_loop(CodeGen &codegen, const PackedArrayLoop &p_loop);
 	GDScriptFunction *_parse_function(Error &r_error, GDScript *p_script, const GDScriptParser::ClassNode *p_class, const GDScriptParser::FunctionNode *p_func, bool p_for_ready = false, bool p_for_lambda = false);
 	GDScriptFunction *_make_static_initializer(Error &r_error, GDScript *p_script, const GDScriptParser::ClassNode *p_class);
 	Error _parse_setter_getter(GDScript *p_script, const GDScriptParser::ClassNode *p_class, const GDScriptParser::VariableNode *p_variable, bool p_is_setter);
@@ -141,6 +141,40 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+			case OPCODE_OPERATOR_ADD_INT:
+			case OPCODE_OPERATOR_SUBTRACT_INT:
+			case OPCODE_OPERATOR_MULTIPLY_INT:
+			case OPCODE_OPERATOR_EQUAL_INT:
+			case OPCODE_OPERATOR_NOT_EQUAL_INT:
+			case OPCODE_OPERATOR_LESS_INT:
+			case OPCODE_OPERATOR_LESS_EQUAL_INT:
+			case OPCODE_OPERATOR_GREATER_INT:
+			case OPCODE_OPERATOR_GREATER_EQUAL_INT:
+			case OPCODE_OPERATOR_ADD_FLOAT:
+			case OPCODE_OPERATOR_SUBTRACT_FLOAT:
+			case OPCODE_OPERATOR_MULTIPLY_FLOAT:
+			case OPCODE_OPERATOR_DIVIDE_FLOAT:
+			case OPCODE_OPERATOR_EQUAL_FLOAT:
+			case OPCODE_OPERATOR_NOT_EQUAL_FLOAT:
+			case OPCODE_OPERATOR_LESS_FLOAT:
+			case OPCODE_OPERATOR_LESS_EQUAL_FLOAT:
+			case OPCODE_OPERATOR_GREATER_FLOAT:
+			case OPCODE_OPERATOR_GREATER_EQUAL_FLOAT:
+			case OPCODE_OPERATOR_ADD_VECTOR3:
+			case OPCODE_OPERATOR_SUBTRACT_VECTOR3:
+			case OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT: {
+				text += "typed operator ";
+
+				text += DADDR(3);
+				text += " = ";
+				text += DADDR(1);
+				text += " ";
+				text += operator_names[_code_ptr[ip + 4]];
+				text += " ";
+				text += DADDR(2);
+
+				incr += 5;
+			} break;
 			case OPCODE_TYPE_TEST_BUILTIN: {
 				text += "type test ";
 				text += DADDR(1);
@@ -267,7 +301,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += "\"] = ";
 				text += DADDR(2);
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_SET_NAMED_VALIDATED: {
 				text += "set_named validated ";
@@ -288,7 +322,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += _global_names_ptr[_code_ptr[ip + 3]];
 				text += "\"]";
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_GET_NAMED_VALIDATED: {
 				text += "get_named validated ";
@@ -607,7 +641,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				}
 				text += ")";
 
-				incr = 5 + argc;
+				incr = 6 + argc;
 			} break;
 			case OPCODE_CALL_METHOD_BIND:
 			case OPCODE_CALL_METHOD_BIND_RET: {
@@ -970,6 +1004,31 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr = 3;
 			} break;
+			// Superinstructions overlay the next instruction, which is listed on its own.
+			case OPCODE_OPERATOR_VALIDATED_JUMP_IF:
+			case OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT: {
+				text += opcode == OPCODE_OPERATOR_VALIDATED_JUMP_IF ? "validated operator (fused jump-if) " : "validated operator (fused jump-if-not) ";
+
+				text += DADDR(3);
+				text += " = ";
+				text += DADDR(1);
+				text += " ";
+				text += operator_names[_code_ptr[ip + 4]];
+				text += " ";
+				text += DADDR(2);
+
+				incr = 5;
+			} break;
+			case OPCODE_GET_MEMBER_OPERATOR_VALIDATED: {
+				text += "get_member (fused validated operator) ";
+				text += DADDR(1);
+				text += " = ";
+				text += "[\"";
+				text += _global_names_ptr[_code_ptr[ip + 2]];
+				text += "\"]";
+
+				incr = 3;
+			} break;
 			case OPCODE_RETURN: {
 				text += "return ";
 				text += DADDR(1);
@@ -299,7 +299,7 @@ int GDScriptLanguage::debug_get_stack_level_line(int p_level) const {
 
 	int l = _call_stack.stack_pos - p_level - 1;
 
-	return *(_call_stack.levels[l].line);
+	return _get_call_level_line(_call_stack.levels[l]);
 }
 
 String GDScriptLanguage::debug_get_stack_level_function(int p_level) const {
@@ -334,7 +334,7 @@ void GDScriptLanguage::debug_get_stack_level_locals(int p_level, List<String> *p
 
 	List<Pair<StringName, int>> locals;
 
-	f->debug_get_stack_member_state(*_call_stack.levels[l].line, &locals);
+	f->debug_get_stack_member_state(_get_call_level_line(_call_stack.levels[l]), &locals);
 	for (const Pair<StringName, int> &E : locals) {
 		p_locals->push_back(E.first);
 		p_values->push_back(_call_stack.levels[l].stack[E.second]);
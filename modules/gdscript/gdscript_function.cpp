@@ -31,6 +31,9 @@
 #include "gdscript_function.h"
 
 #include "gdscript.h"
+#include "gdscript_sampling_profiler.h"
+
+SafeNumeric<uint32_t> GDScriptFunction::inline_cache_epoch;
 
 Variant GDScriptFunction::get_constant(int p_idx) const {
 	ERR_FAIL_INDEX_V(p_idx, constants.size(), "<errconst>");
@@ -104,6 +107,27 @@ void GDScriptFunction::debug_get_stack_member_state(int p_line, List<Pair<String
 	}
 }
 
+#ifdef GDSCRIPT_LINE_TABLES
+int GDScriptFunction::find_line(const Vector<LinePosition> &p_line_table, int p_ip) {
+	if (p_line_table.is_empty()) {
+		return -1;
+	}
+
+	const LinePosition *table = p_line_table.ptr();
+	int low = 0;
+	int high = p_line_table.size() - 1;
+	while (low < high) {
+		int middle = (low + high + 1) / 2;
+		if (table[middle].position <= p_ip) {
+			low = middle;
+		} else {
+			high = middle - 1;
+		}
+	}
+	return table[low].line;
+}
+#endif
+
 GDScriptFunction::GDScriptFunction() {
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
@@ -115,6 +139,7 @@ GDScriptFunction::GDScriptFunction() {
 }
 
 GDScriptFunction::~GDScriptFunction() {
+	GDScriptSamplingProfiler::function_freed(this);
 	get_script()->member_functions.erase(name);
 
 	for (int i = 0; i < lambdas.size(); i++) {
@@ -134,6 +159,90 @@ GDScriptFunction::~GDScriptFunction() {
 
 /////////////////////
 
+SpinLock GDScriptFunctionState::stack_pool_lock;
+void *GDScriptFunctionState::stack_pool[STACK_POOL_CLASSES] = {};
+uint32_t GDScriptFunctionState::stack_pool_bytes = 0;
+
+uint8_t *GDScriptFunctionState::_alloc_stack(uint32_t p_size) {
+	const uint32_t shift = MAX((uint32_t)get_shift_from_power_of_2(next_power_of_2(p_size)), STACK_POOL_MIN_SHIFT);
+	const uint32_t size_class = shift - STACK_POOL_MIN_SHIFT;
+	if (size_class >= STACK_POOL_CLASSES) {
+		return (uint8_t *)Memory::alloc_static(p_size);
+	}
+
+	stack_pool_lock.lock();
+	if (stack_pool[size_class] != nullptr) {
+		// Free blocks start with the pointer to the next one.
+		void *block = stack_pool[size_class];
+		stack_pool[size_class] = *(void **)block;
+		stack_pool_bytes -= 1u << shift;
+		stack_pool_lock.unlock();
+		return (uint8_t *)block;
+	}
+	stack_pool_lock.unlock();
+	return (uint8_t *)Memory::alloc_static(1u << shift);
+}
+
+void GDScriptFunctionState::_free_stack(uint8_t *p_stack, uint32_t p_size) {
+	const uint32_t shift = MAX((uint32_t)get_shift_from_power_of_2(next_power_of_2(p_size)), STACK_POOL_MIN_SHIFT);
+	const uint32_t size_class = shift - STACK_POOL_MIN_SHIFT;
+	if (size_class >= STACK_POOL_CLASSES) {
+		Memory::free_static(p_stack);
+		return;
+	}
+
+	const uint32_t block_size = 1u << shift;
+	void *evicted = nullptr;
+	bool pooled = false;
+	stack_pool_lock.lock();
+	for (uint32_t i = STACK_POOL_CLASSES - 1; i > size_class && stack_pool_bytes + block_size > STACK_POOL_MAX_BYTES; i--) {
+		while (stack_pool[i] != nullptr && stack_pool_bytes + block_size > STACK_POOL_MAX_BYTES) {
+			void *block = stack_pool[i];
+			stack_pool[i] = *(void **)block;
+			stack_pool_bytes -= 1u << (i + STACK_POOL_MIN_SHIFT);
+			*(void **)block = evicted;
+			evicted = block;
+		}
+	}
+	if (stack_pool_bytes + block_size <= STACK_POOL_MAX_BYTES) {
+		*(void **)p_stack = stack_pool[size_class];
+		stack_pool[size_class] = p_stack;
+		stack_pool_bytes += block_size;
+		pooled = true;
+	}
+	stack_pool_lock.unlock();
+
+	// Freed outside of the lock, which coroutines on other threads may be waiting for.
+	while (evicted != nullptr) {
+		void *next = *(void **)evicted;
+		Memory::free_static(evicted);
+		evicted = next;
+	}
+	if (!pooled) {
+		Memory::free_static(p_stack);
+	}
+}
+
+void GDScriptFunctionState::clear_stack_pool() {
+	stack_pool_lock.lock();
+	for (uint32_t i = 0; i < STACK_POOL_CLASSES; i++) {
+		while (stack_pool[i] != nullptr) {
+			void *block = stack_pool[i];
+			stack_pool[i] = *(void **)block;
+			Memory::free_static(block);
+		}
+	}
+	stack_pool_bytes = 0;
+	stack_pool_lock.unlock();
+}
+
+void GDScriptFunctionState::_release_stack() {
+	if (state.stack != nullptr) {
+		_free_stack(state.stack, state.alloca_size);
+		state.stack = nullptr;
+	}
+}
+
 Variant GDScriptFunctionState::_signal_callback(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
 	Variant arg;
 	r_error.error = Callable::CallError::CALL_OK;
@@ -219,18 +328,22 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 
 	// If the return value is a GDScriptFunctionState reference,
 	// then the function did await again after resuming.
+	// That's normally this same state, which keeps the stack for the next resume.
 	if (ret.is_ref_counted()) {
 		GDScriptFunctionState *gdfs = Object::cast_to<GDScriptFunctionState>(ret);
-		if (gdfs && gdfs->function == function) {
+		if (gdfs == this) {
+			completed = false;
+		} else if (gdfs && gdfs->function == function) {
 			completed = false;
 			gdfs->first_state = first_state.is_valid() ? first_state : Ref<GDScriptFunctionState>(this);
 		}
 	}
 
-	function = nullptr; //cleaned up;
 	state.result = Variant();
 
 	if (completed) {
+		function = nullptr; //cleaned up;
+
 		if (first_state.is_valid()) {
 			first_state->emit_signal(SNAME("completed"), ret);
 		} else {
@@ -243,7 +356,11 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 		}
 
 		_clear_stack();
+#else
+		// Already freed when the function returned.
+		state.stack_size = 0;
 #endif
+		_release_stack();
 	}
 
 	return ret;
@@ -251,7 +368,7 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 
 void GDScriptFunctionState::_clear_stack() {
 	if (state.stack_size) {
-		Variant *stack = (Variant *)state.stack.ptr();
+		Variant *stack = (Variant *)state.stack;
 		// The first 3 are special addresses and not copied to the state, so we skip them here.
 		for (int i = 3; i < state.stack_size; i++) {
 			stack[i].~Variant();
@@ -280,6 +397,7 @@ void GDScriptFunctionState::_bind_methods() {
 GDScriptFunctionState::GDScriptFunctionState() :
 		scripts_list(this),
 		instances_list(this) {
+	state.function_state = this;
 }
 
 GDScriptFunctionState::~GDScriptFunctionState() {
@@ -288,4 +406,7 @@ GDScriptFunctionState::~GDScriptFunctionState() {
 		scripts_list.remove_from_list();
 		instances_list.remove_from_list();
 	}
+
+	_clear_stack();
+	_release_stack();
 }
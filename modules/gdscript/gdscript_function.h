@@ -34,14 +34,21 @@
 
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
+#include "core/os/spin_lock.h"
 #include "core/os/thread.h"
 #include "core/string/string_name.h"
 #include "core/templates/pair.h"
 #include "core/templates/self_list.h"
 #include "core/variant/variant.h"
 
+// Line tables are built by release builds with line traces, and by tests that check them against `OPCODE_LINE`.
+#if defined(GDSCRIPT_LINE_TRACES) || defined(TESTS_ENABLED)
+#define GDSCRIPT_LINE_TABLES
+#endif
+
 class GDScriptInstance;
 class GDScript;
+class GDScriptFunctionState;
 
 class GDScriptDataType {
 public:
@@ -212,11 +219,36 @@ public:
 	~GDScriptDataType() {}
 };
 
+// Ahead-of-time compiled body of a function, see `GDScriptNative`. Receives the same address tables as the interpreter.
+typedef void (*GDScriptNativeBody)(Variant **p_addresses, const Variant::ValidatedOperatorEvaluator *p_operator_funcs, Variant *r_return);
+
 class GDScriptFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
 		OPCODE_OPERATOR_VALIDATED,
+		OPCODE_OPERATOR_ADD_INT, // Validated operators on typed operands, computed inline.
+		OPCODE_OPERATOR_SUBTRACT_INT,
+		OPCODE_OPERATOR_MULTIPLY_INT,
+		OPCODE_OPERATOR_EQUAL_INT,
+		OPCODE_OPERATOR_NOT_EQUAL_INT,
+		OPCODE_OPERATOR_LESS_INT,
+		OPCODE_OPERATOR_LESS_EQUAL_INT,
+		OPCODE_OPERATOR_GREATER_INT,
+		OPCODE_OPERATOR_GREATER_EQUAL_INT,
+		OPCODE_OPERATOR_ADD_FLOAT,
+		OPCODE_OPERATOR_SUBTRACT_FLOAT,
+		OPCODE_OPERATOR_MULTIPLY_FLOAT,
+		OPCODE_OPERATOR_DIVIDE_FLOAT,
+		OPCODE_OPERATOR_EQUAL_FLOAT,
+		OPCODE_OPERATOR_NOT_EQUAL_FLOAT,
+		OPCODE_OPERATOR_LESS_FLOAT,
+		OPCODE_OPERATOR_LESS_EQUAL_FLOAT,
+		OPCODE_OPERATOR_GREATER_FLOAT,
+		OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,
+		OPCODE_OPERATOR_ADD_VECTOR3,
+		OPCODE_OPERATOR_SUBTRACT_VECTOR3,
+		OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT,
 		OPCODE_TYPE_TEST_BUILTIN,
 		OPCODE_TYPE_TEST_ARRAY,
 		OPCODE_TYPE_TEST_NATIVE,
@@ -276,6 +308,9 @@ public:
 		OPCODE_JUMP_IF_NOT,
 		OPCODE_JUMP_TO_DEF_ARGUMENT,
 		OPCODE_JUMP_IF_SHARED,
+		OPCODE_OPERATOR_VALIDATED_JUMP_IF, // Superinstructions, written by the bytecode optimizer.
+		OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT,
+		OPCODE_GET_MEMBER_OPERATOR_VALIDATED,
 		OPCODE_RETURN,
 		OPCODE_RETURN_TYPED_BUILTIN,
 		OPCODE_RETURN_TYPED_ARRAY,
@@ -396,11 +431,22 @@ public:
 		StringName identifier;
 	};
 
+#ifdef GDSCRIPT_LINE_TABLES
+	// Release builds with line traces don't run `OPCODE_LINE`. Instead, the code position where each line starts is kept
+	// in a table, which is only searched when an error or a stack trace needs the line.
+	struct LinePosition {
+		int position = 0;
+		int line = 0;
+	};
+#endif
+
 private:
 	friend class GDScript;
+	friend class GDScriptBytecodeCache;
 	friend class GDScriptCompiler;
 	friend class GDScriptByteCodeGenerator;
 	friend class GDScriptLanguage;
+	friend class GDScriptNative;
 
 	StringName name;
 	StringName source;
@@ -420,6 +466,9 @@ private:
 	mutable Variant nil;
 	HashMap<int, Variant::Type> temporary_slots;
 	List<StackDebug> stack_debug;
+#ifdef GDSCRIPT_LINE_TABLES
+	Vector<LinePosition> line_table; // Sorted by position.
+#endif
 
 	Vector<int> code;
 	Vector<int> default_arguments;
@@ -439,6 +488,28 @@ private:
 	Vector<MethodBind *> methods;
 	Vector<GDScriptFunction *> lambdas;
 
+	// Per call site cache for `OPCODE_GET_NAMED`, `OPCODE_SET_NAMED` and `OPCODE_CALL*` on untyped bases.
+	// Entries are keyed by the `GDScript` of the base instance, or by the class name of a native object
+	// without a script, and are dropped whenever any script is recompiled or freed. Sites which can't use
+	// a cache (bases of a non-object builtin type, and calls in debug builds) get the index -1.
+	struct InlineCache {
+		static constexpr int SIZE = 4;
+
+		struct Entry {
+			const void *key = nullptr;
+			int member_index = -1;
+			const GDScriptDataType *member_type = nullptr;
+			GDScriptFunction *function = nullptr;
+			MethodBind *method = nullptr;
+		};
+
+		uint32_t epoch = 0;
+		uint32_t next = 0;
+		Entry entries[SIZE];
+	};
+	Vector<InlineCache> inline_caches;
+	static SafeNumeric<uint32_t> inline_cache_epoch;
+
 	int _code_size = 0;
 	int _default_arg_count = 0;
 	int _constant_count = 0;
@@ -456,6 +527,7 @@ private:
 	int _gds_utilities_count = 0;
 	int _methods_count = 0;
 	int _lambdas_count = 0;
+	int _inline_caches_count = 0;
 
 	int *_code_ptr = nullptr;
 	const int *_default_arg_ptr = nullptr;
@@ -474,6 +546,11 @@ private:
 	const GDScriptUtilityFunctions::FunctionPtr *_gds_utilities_ptr = nullptr;
 	MethodBind **_methods_ptr = nullptr;
 	GDScriptFunction **_lambdas_ptr = nullptr;
+	InlineCache *_inline_caches_ptr = nullptr;
+
+#ifndef DEBUG_ENABLED
+	GDScriptNativeBody native_body = nullptr;
+#endif
 
 #ifdef DEBUG_ENABLED
 	CharString func_cname;
@@ -511,17 +588,29 @@ private:
 	_FORCE_INLINE_ String _get_call_error(const String &p_where, const Variant **p_argptrs, const Variant &p_ret, const Callable::CallError &p_err) const;
 	Variant _get_default_variant_for_data_type(const GDScriptDataType &p_data_type);
 
+	InlineCache::Entry *_get_inline_cache_entry(int p_cache, const void *p_key);
+	InlineCache::Entry *_add_inline_cache_entry(int p_cache, const void *p_key);
+	bool _get_named_cached(int p_cache, const Variant *p_base, const StringName &p_name, Variant *r_dst);
+	bool _set_named_cached(int p_cache, const Variant *p_base, const StringName &p_name, const Variant *p_value, bool &r_valid);
+#ifndef DEBUG_ENABLED
+	bool _call_cached(int p_cache, const Variant *p_base, const StringName &p_name, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_err);
+#endif
+
 public:
 	static constexpr int MAX_CALL_DEPTH = 2048; // Limit to try to avoid crash because of a stack overflow.
 
+	// Must be called whenever the members or functions of a script change, or a script is freed.
+	static void invalidate_inline_caches() { inline_cache_epoch.increment(); }
+
 	struct CallState {
+		GDScriptFunctionState *function_state = nullptr;
 		GDScript *script = nullptr;
 		GDScriptInstance *instance = nullptr;
 #ifdef DEBUG_ENABLED
 		StringName function_name;
 		String script_path;
 #endif
-		Vector<uint8_t> stack;
+		uint8_t *stack = nullptr; // From `GDScriptFunctionState::_alloc_stack()`, `alloca_size` bytes.
 		int stack_size = 0;
 		uint32_t alloca_size = 0;
 		int ip = 0;
@@ -538,12 +627,20 @@ public:
 	_FORCE_INLINE_ int get_argument_count() const { return _argument_count; }
 	_FORCE_INLINE_ Variant get_rpc_config() const { return rpc_config; }
 	_FORCE_INLINE_ int get_max_stack_size() const { return _stack_size; }
+	_FORCE_INLINE_ const int *get_code() const { return _code_ptr; }
+	_FORCE_INLINE_ int get_code_size() const { return _code_size; }
 
 	Variant get_constant(int p_idx) const;
 	StringName get_global_name(int p_idx) const;
 
 	Variant call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err, CallState *p_state = nullptr);
 	void debug_get_stack_member_state(int p_line, List<Pair<StringName, int>> *r_stackvars) const;
+#ifdef GDSCRIPT_LINE_TABLES
+	// Returns the last line starting at or before `p_ip`, or -1 if the table is empty.
+	static int find_line(const Vector<LinePosition> &p_line_table, int p_ip);
+	// Returns -1 if the code still has `OPCODE_LINE` instructions, in which case the line is tracked while running.
+	int get_line_at(int p_ip) const { return find_line(line_table, p_ip); }
+#endif
 
 #ifdef DEBUG_ENABLED
 	void _profile_native_call(uint64_t p_t_taken, const String &p_function_name, const String &p_instance_class_name = String());
@@ -565,6 +662,20 @@ class GDScriptFunctionState : public RefCounted {
 	SelfList<GDScriptFunctionState> scripts_list;
 	SelfList<GDScriptFunctionState> instances_list;
 
+	// Stacks of awaiting functions are kept in free lists by power of two size, since they come and go
+	// at a high rate when many coroutines are running. Larger stacks are allocated directly.
+	// The memory kept in the lists is capped, which the largest stacks give up first.
+	static constexpr uint32_t STACK_POOL_MIN_SHIFT = 6;
+	static constexpr uint32_t STACK_POOL_CLASSES = 12;
+	static constexpr uint32_t STACK_POOL_MAX_BYTES = 4 * 1024 * 1024;
+	static SpinLock stack_pool_lock;
+	static void *stack_pool[STACK_POOL_CLASSES];
+	static uint32_t stack_pool_bytes;
+
+	static uint8_t *_alloc_stack(uint32_t p_size);
+	static void _free_stack(uint8_t *p_stack, uint32_t p_size);
+	void _release_stack();
+
 protected:
 	static void _bind_methods();
 
@@ -575,6 +686,9 @@ public:
 	void _clear_stack();
 	void _clear_connections();
 
+	// Frees the pooled stacks. Called when the language is finished.
+	static void clear_stack_pool();
+
 	GDScriptFunctionState();
 	~GDScriptFunctionState();
 };
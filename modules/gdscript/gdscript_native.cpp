@@ -0,0 +1,444 @@
+/**************************************************************************/
+/*  gdscript_native.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_native.h"
+
+#include "gdscript_byte_code_optimizer.h"
+
+#include "core/templates/hashfuncs.h"
+
+HashMap<uint64_t, GDScriptNativeBody> GDScriptNative::bodies;
+
+bool GDScriptNative::_is_supported_constant(const Variant &p_constant) {
+	// Constants are part of the hash, so they must hash the same in the editor and in the exported project.
+	return p_constant.get_type() < Variant::RID;
+}
+
+bool GDScriptNative::_get_canonical_code(const GDScriptFunction *p_function, LocalVector<int> &r_code) {
+	// The canonical form is the bytecode without the instructions that only exist in debug builds and
+	// with superinstructions split back, so the editor and export templates agree on it.
+	const int *code = p_function->_code_ptr;
+	const int code_size = p_function->_code_size;
+	if (code == nullptr || p_function->_default_arg_count > 0) {
+		return false;
+	}
+
+	for (int i = 0; i < p_function->_constant_count; i++) {
+		if (!_is_supported_constant(p_function->_constants_ptr[i])) {
+			return false;
+		}
+	}
+
+	LocalVector<int> positions;
+	positions.resize(code_size + 1);
+	for (int i = 0; i <= code_size; i++) {
+		positions[i] = -1;
+	}
+
+	int canonical_size = 0;
+	for (int ip = 0; ip < code_size;) {
+		int length = GDScriptByteCodeOptimizer::get_instruction_length(code, code_size, ip);
+		if (length <= 0 || ip + length > code_size) {
+			return false;
+		}
+		positions[ip] = canonical_size;
+
+		int opcode = code[ip];
+		if (opcode == GDScriptFunction::OPCODE_LINE) {
+			ip += length;
+			continue;
+		}
+
+		if (opcode < GDScriptFunction::OPCODE_OPERATOR_VALIDATED || opcode > GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT) {
+			switch (opcode) {
+				case GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF:
+				case GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT:
+				case GDScriptFunction::OPCODE_ASSIGN:
+				case GDScriptFunction::OPCODE_ASSIGN_NULL:
+				case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+				case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+				case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+				case GDScriptFunction::OPCODE_JUMP:
+				case GDScriptFunction::OPCODE_JUMP_IF:
+				case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+				case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT:
+				case GDScriptFunction::OPCODE_ITERATE_INT:
+				case GDScriptFunction::OPCODE_RETURN:
+				case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN:
+				case GDScriptFunction::OPCODE_END:
+					break;
+				default:
+					return false;
+			}
+		}
+
+		canonical_size += length;
+		ip += length;
+	}
+	positions[code_size] = canonical_size;
+
+	r_code.clear();
+	r_code.reserve(canonical_size);
+	for (int ip = 0; ip < code_size;) {
+		int length = GDScriptByteCodeOptimizer::get_instruction_length(code, code_size, ip);
+		int opcode = code[ip];
+		if (opcode == GDScriptFunction::OPCODE_LINE) {
+			ip += length;
+			continue;
+		}
+
+		int jump_operand = 0;
+		switch (opcode) {
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF:
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT:
+				// The jump that was fused follows as a regular instruction.
+				opcode = GDScriptFunction::OPCODE_OPERATOR_VALIDATED;
+				break;
+			case GDScriptFunction::OPCODE_JUMP:
+				jump_operand = 1;
+				break;
+			case GDScriptFunction::OPCODE_JUMP_IF:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+				jump_operand = 2;
+				break;
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT:
+			case GDScriptFunction::OPCODE_ITERATE_INT:
+				jump_operand = 4;
+				break;
+			default:
+				break;
+		}
+
+		r_code.push_back(opcode);
+		for (int i = 1; i < length; i++) {
+			int word = code[ip + i];
+			if (i == jump_operand) {
+				if (word < 0 || word > code_size || positions[word] < 0) {
+					return false;
+				}
+				word = positions[word];
+			}
+			r_code.push_back(word);
+		}
+		ip += length;
+	}
+
+	return true;
+}
+
+uint64_t GDScriptNative::hash_function(const GDScriptFunction *p_function) {
+	LocalVector<int> code;
+	if (!_get_canonical_code(p_function, code)) {
+		return 0;
+	}
+
+	// Two independent 32-bit hashes, a collision would run the wrong body.
+	uint32_t low = hash_murmur3_one_32(p_function->_stack_size);
+	uint32_t high = hash_murmur3_one_32(p_function->_argument_count, 0x9E3779B9);
+	for (const int &word : code) {
+		low = hash_murmur3_one_32(word, low);
+		high = hash_murmur3_one_32(word, high);
+	}
+	for (int i = 0; i < p_function->_constant_count; i++) {
+		const Variant &constant = p_function->_constants_ptr[i];
+		low = hash_murmur3_one_32(constant.get_type(), hash_murmur3_one_32(constant.hash(), low));
+		high = hash_murmur3_one_32(constant.get_type(), hash_murmur3_one_32(constant.hash(), high));
+	}
+
+	uint64_t hash = (uint64_t(hash_fmix32(high)) << 32) | hash_fmix32(low);
+	return hash == 0 ? 1 : hash; // Zero means the function can't be compiled.
+}
+
+void GDScriptNative::register_body(uint64_t p_hash, GDScriptNativeBody p_body) {
+	ERR_FAIL_COND(p_hash == 0);
+	ERR_FAIL_NULL(p_body);
+	bodies[p_hash] = p_body;
+}
+
+GDScriptNativeBody GDScriptNative::get_body(const GDScriptFunction *p_function) {
+	if (bodies.is_empty()) {
+		return nullptr;
+	}
+
+	uint64_t hash = hash_function(p_function);
+	if (hash == 0) {
+		return nullptr;
+	}
+
+	const GDScriptNativeBody *body = bodies.getptr(hash);
+	return body ? *body : nullptr;
+}
+
+#ifdef TESTS_ENABLED
+
+Variant GDScriptNative::execute(const GDScriptFunction *p_function, const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+	r_error.error = Callable::CallError::CALL_OK;
+
+	LocalVector<int> code;
+	ERR_FAIL_COND_V_MSG(!_get_canonical_code(p_function, code), Variant(), "Function can't be compiled ahead of time.");
+
+	if (p_argcount != p_function->_argument_count) {
+		r_error.error = p_argcount > p_function->_argument_count ? Callable::CallError::CALL_ERROR_TOO_MANY_ARGUMENTS : Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
+		r_error.expected = p_function->_argument_count;
+		return Variant();
+	}
+
+	// Same stack layout as the VM sets up before running either the bytecode or a native body.
+	LocalVector<Variant> stack;
+	stack.resize(p_function->_stack_size);
+	for (int i = 0; i < p_argcount; i++) {
+		const GDScriptDataType &type = p_function->argument_types[i];
+		if (!type.has_type || type.is_type(*p_args[i], false)) {
+			stack[i + GDScriptFunction::FIXED_ADDRESSES_MAX] = *p_args[i];
+		} else if (type.kind == GDScriptDataType::BUILTIN && type.is_type(*p_args[i], true)) {
+			Variant::construct(type.builtin_type, stack[i + GDScriptFunction::FIXED_ADDRESSES_MAX], &p_args[i], 1, r_error);
+		} else {
+			r_error.error = Callable::CallError::CALL_ERROR_INVALID_ARGUMENT;
+		}
+		if (r_error.error != Callable::CallError::CALL_OK) {
+			r_error.error = Callable::CallError::CALL_ERROR_INVALID_ARGUMENT;
+			r_error.argument = i;
+			r_error.expected = type.builtin_type;
+			return Variant();
+		}
+	}
+	for (const KeyValue<int, Variant::Type> &E : p_function->temporary_slots) {
+		VariantInternal::initialize(&stack[E.key], E.value);
+	}
+	stack[GDScriptFunction::ADDR_STACK_CLASS] = p_function->_script;
+
+	Variant *addresses[GDScriptFunction::ADDR_TYPE_MAX] = { stack.ptr(), p_function->_constants_ptr, nullptr };
+	const Variant::ValidatedOperatorEvaluator *operator_funcs = p_function->_operator_funcs_ptr;
+	auto address = [&](int p_address) {
+		return &addresses[(p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS][p_address & GDScriptFunction::ADDR_MASK];
+	};
+
+	// Mirrors `generate_body()` one instruction at a time, with jumps moving `ip` instead of going to a label.
+	Variant ret;
+	const int code_size = code.size();
+	for (int ip = 0; ip < code_size;) {
+		const int *instruction = &code[ip];
+		int next = ip + GDScriptByteCodeOptimizer::get_instruction_length(code.ptr(), code_size, ip);
+		switch (instruction[0]) {
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+				operator_funcs[instruction[4]](address(instruction[1]), address(instruction[2]), address(instruction[3]));
+				break;
+			case GDScriptFunction::OPCODE_ASSIGN:
+				*address(instruction[1]) = *address(instruction[2]);
+				break;
+			case GDScriptFunction::OPCODE_ASSIGN_NULL:
+				*address(instruction[1]) = Variant();
+				break;
+			case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+				*address(instruction[1]) = true;
+				break;
+			case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+				*address(instruction[1]) = false;
+				break;
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+				assign_typed_builtin(address(instruction[1]), address(instruction[2]), (Variant::Type)instruction[3]);
+				break;
+			case GDScriptFunction::OPCODE_JUMP:
+				next = instruction[1];
+				break;
+			case GDScriptFunction::OPCODE_JUMP_IF:
+				if (address(instruction[1])->booleanize()) {
+					next = instruction[2];
+				}
+				break;
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+				if (!address(instruction[1])->booleanize()) {
+					next = instruction[2];
+				}
+				break;
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT:
+				if (!iterate_begin_int(address(instruction[1]), address(instruction[2]), address(instruction[3]))) {
+					next = instruction[4];
+				}
+				break;
+			case GDScriptFunction::OPCODE_ITERATE_INT:
+				if (!iterate_int(address(instruction[1]), address(instruction[2]), address(instruction[3]))) {
+					next = instruction[4];
+				}
+				break;
+			case GDScriptFunction::OPCODE_RETURN:
+				ret = *address(instruction[1]);
+				return ret;
+			case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN:
+				return_typed_builtin(address(instruction[1]), (Variant::Type)instruction[2], &ret);
+				return ret;
+			case GDScriptFunction::OPCODE_END:
+				return ret;
+			default:
+				typed_operator(instruction[0], address(instruction[1]), address(instruction[2]), address(instruction[3]));
+				break;
+		}
+		ip = next;
+	}
+
+	return ret;
+}
+
+#endif // TESTS_ENABLED
+
+#ifdef TOOLS_ENABLED
+
+String GDScriptNative::_get_address(int p_address) {
+	int type = (p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS;
+	int index = p_address & GDScriptFunction::ADDR_MASK;
+	return vformat("A[%d][%d]", type, index);
+}
+
+String GDScriptNative::_get_symbol(uint64_t p_hash) {
+	return "_gdscript_native_" + String::num_uint64(p_hash, 16);
+}
+
+String GDScriptNative::generate_body(const GDScriptFunction *p_function) {
+	uint64_t hash = hash_function(p_function);
+	if (hash == 0) {
+		return String();
+	}
+
+	LocalVector<int> code;
+	_get_canonical_code(p_function, code);
+
+	LocalVector<bool> jump_targets;
+	jump_targets.resize(code.size() + 1);
+	for (uint32_t i = 0; i < jump_targets.size(); i++) {
+		jump_targets[i] = false;
+	}
+
+	const int code_size = code.size();
+	for (int ip = 0; ip < code_size;) {
+		switch (code[ip]) {
+			case GDScriptFunction::OPCODE_JUMP:
+				jump_targets[code[ip + 1]] = true;
+				break;
+			case GDScriptFunction::OPCODE_JUMP_IF:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+				jump_targets[code[ip + 2]] = true;
+				break;
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT:
+			case GDScriptFunction::OPCODE_ITERATE_INT:
+				jump_targets[code[ip + 4]] = true;
+				break;
+			default:
+				break;
+		}
+		ip += GDScriptByteCodeOptimizer::get_instruction_length(code.ptr(), code_size, ip);
+	}
+
+	// Every instruction gets its own scope, so jumps never cross an initialization.
+	String body = vformat("static void %s(Variant **A, const Variant::ValidatedOperatorEvaluator *O, Variant *R) {\n", _get_symbol(hash));
+	for (int ip = 0; ip < code_size;) {
+		if (jump_targets[ip]) {
+			body += vformat("L%d:\n", ip);
+		}
+
+		const int *instruction = &code[ip];
+		String line;
+		switch (instruction[0]) {
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+				line = vformat("O[%d](&%s, &%s, &%s);", instruction[4], _get_address(instruction[1]), _get_address(instruction[2]), _get_address(instruction[3]));
+				break;
+			case GDScriptFunction::OPCODE_ASSIGN:
+				line = vformat("%s = %s;", _get_address(instruction[1]), _get_address(instruction[2]));
+				break;
+			case GDScriptFunction::OPCODE_ASSIGN_NULL:
+				line = vformat("%s = Variant();", _get_address(instruction[1]));
+				break;
+			case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+				line = vformat("%s = true;", _get_address(instruction[1]));
+				break;
+			case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+				line = vformat("%s = false;", _get_address(instruction[1]));
+				break;
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+				line = vformat("GDScriptNative::assign_typed_builtin(&%s, &%s, (Variant::Type)%d);", _get_address(instruction[1]), _get_address(instruction[2]), instruction[3]);
+				break;
+			case GDScriptFunction::OPCODE_JUMP:
+				line = vformat("goto L%d;", instruction[1]);
+				break;
+			case GDScriptFunction::OPCODE_JUMP_IF:
+				line = vformat("if (%s.booleanize()) { goto L%d; }", _get_address(instruction[1]), instruction[2]);
+				break;
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+				line = vformat("if (!%s.booleanize()) { goto L%d; }", _get_address(instruction[1]), instruction[2]);
+				break;
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT:
+				line = vformat("if (!GDScriptNative::iterate_begin_int(&%s, &%s, &%s)) { goto L%d; }", _get_address(instruction[1]), _get_address(instruction[2]), _get_address(instruction[3]), instruction[4]);
+				break;
+			case GDScriptFunction::OPCODE_ITERATE_INT:
+				line = vformat("if (!GDScriptNative::iterate_int(&%s, &%s, &%s)) { goto L%d; }", _get_address(instruction[1]), _get_address(instruction[2]), _get_address(instruction[3]), instruction[4]);
+				break;
+			case GDScriptFunction::OPCODE_RETURN:
+				line = vformat("*R = %s; return;", _get_address(instruction[1]));
+				break;
+			case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN:
+				line = vformat("GDScriptNative::return_typed_builtin(&%s, (Variant::Type)%d, R); return;", _get_address(instruction[1]), instruction[2]);
+				break;
+			case GDScriptFunction::OPCODE_END:
+				line = "return;";
+				break;
+			default:
+				// Typed operators, same layout as a validated operator.
+				line = vformat("GDScriptNative::typed_operator(%d, &%s, &%s, &%s);", instruction[0], _get_address(instruction[1]), _get_address(instruction[2]), _get_address(instruction[3]));
+				break;
+		}
+
+		body += "\t{ " + line + " }\n";
+		ip += GDScriptByteCodeOptimizer::get_instruction_length(code.ptr(), code_size, ip);
+	}
+	if (jump_targets[code_size]) {
+		body += vformat("L%d:\n\treturn;\n", code_size);
+	}
+	body += "}\n";
+
+	return body;
+}
+
+String GDScriptNative::generate_source(const HashMap<uint64_t, String> &p_definitions) {
+	String source = "// Generated by exporting a project with GDScript native compilation, do not edit.\n\n";
+	source += "#include \"modules/gdscript/gdscript_native.h\"\n\n";
+
+	for (const KeyValue<uint64_t, String> &E : p_definitions) {
+		source += E.value + "\n";
+	}
+
+	source += "void register_gdscript_native_bodies() {\n";
+	for (const KeyValue<uint64_t, String> &E : p_definitions) {
+		source += vformat("\tGDScriptNative::register_body(0x%sULL, &%s);\n", String::num_uint64(E.key, 16), _get_symbol(E.key));
+	}
+	source += "}\n";
+
+	return source;
+}
+
+#endif // TOOLS_ENABLED
@@ -0,0 +1,200 @@
+/**************************************************************************/
+/*  gdscript_native.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "gdscript_function.h"
+
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/variant_internal.h"
+
+// Ahead-of-time compiled bodies for GDScript functions.
+//
+// When exporting, functions made only of instructions with a direct C++ equivalent (typed arithmetic,
+// comparisons, assignments, jumps and integer ranges) can be emitted as C++ source. That source is then
+// built into the export template, which registers each body under the hash of the bytecode it replaces.
+// At load, release builds look up every compiled function and, when its bytecode matches, run the native
+// body instead of the interpreter loop. A body is only ever matched against bytecode it was generated
+// from, so any mismatch between the exported project and the template falls back to the interpreter.
+class GDScriptNative {
+	static HashMap<uint64_t, GDScriptNativeBody> bodies;
+
+	static bool _is_supported_constant(const Variant &p_constant);
+	static bool _get_canonical_code(const GDScriptFunction *p_function, LocalVector<int> &r_code);
+
+#ifdef TOOLS_ENABLED
+	static String _get_address(int p_address);
+	static String _get_symbol(uint64_t p_hash);
+#endif
+
+public:
+	// The generated bodies call these for every instruction that isn't a plain assignment or jump, so they
+	// behave the same when built into a template and when run through `execute()`.
+	static _FORCE_INLINE_ void typed_operator(int p_opcode, const Variant *p_a, const Variant *p_b, Variant *r_dst) {
+		switch (p_opcode) {
+			case GDScriptFunction::OPCODE_OPERATOR_ADD_INT:
+				*VariantInternal::get_int(r_dst) = *VariantInternal::get_int(p_a) + *VariantInternal::get_int(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT:
+				*VariantInternal::get_int(r_dst) = *VariantInternal::get_int(p_a) - *VariantInternal::get_int(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT:
+				*VariantInternal::get_int(r_dst) = *VariantInternal::get_int(p_a) * *VariantInternal::get_int(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_EQUAL_INT:
+				*VariantInternal::get_bool(r_dst) = *VariantInternal::get_int(p_a) == *VariantInternal::get_int(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_INT:
+				*VariantInternal::get_bool(r_dst) = *VariantInternal::get_int(p_a) != *VariantInternal::get_int(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_LESS_INT:
+				*VariantInternal::get_bool(r_dst) = *VariantInternal::get_int(p_a) < *VariantInternal::get_int(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_INT:
+				*VariantInternal::get_bool(r_dst) = *VariantInternal::get_int(p_a) <= *VariantInternal::get_int(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_GREATER_INT:
+				*VariantInternal::get_bool(r_dst) = *VariantInternal::get_int(p_a) > *VariantInternal::get_int(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT:
+				*VariantInternal::get_bool(r_dst) = *VariantInternal::get_int(p_a) >= *VariantInternal::get_int(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_ADD_FLOAT:
+				*VariantInternal::get_float(r_dst) = *VariantInternal::get_float(p_a) + *VariantInternal::get_float(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT:
+				*VariantInternal::get_float(r_dst) = *VariantInternal::get_float(p_a) - *VariantInternal::get_float(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT:
+				*VariantInternal::get_float(r_dst) = *VariantInternal::get_float(p_a) * *VariantInternal::get_float(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT:
+				*VariantInternal::get_float(r_dst) = *VariantInternal::get_float(p_a) / *VariantInternal::get_float(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT:
+				*VariantInternal::get_bool(r_dst) = *VariantInternal::get_float(p_a) == *VariantInternal::get_float(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT:
+				*VariantInternal::get_bool(r_dst) = *VariantInternal::get_float(p_a) != *VariantInternal::get_float(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_LESS_FLOAT:
+				*VariantInternal::get_bool(r_dst) = *VariantInternal::get_float(p_a) < *VariantInternal::get_float(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT:
+				*VariantInternal::get_bool(r_dst) = *VariantInternal::get_float(p_a) <= *VariantInternal::get_float(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_GREATER_FLOAT:
+				*VariantInternal::get_bool(r_dst) = *VariantInternal::get_float(p_a) > *VariantInternal::get_float(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT:
+				*VariantInternal::get_bool(r_dst) = *VariantInternal::get_float(p_a) >= *VariantInternal::get_float(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_ADD_VECTOR3:
+				*VariantInternal::get_vector3(r_dst) = *VariantInternal::get_vector3(p_a) + *VariantInternal::get_vector3(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_VECTOR3:
+				*VariantInternal::get_vector3(r_dst) = *VariantInternal::get_vector3(p_a) - *VariantInternal::get_vector3(p_b);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT:
+				*VariantInternal::get_vector3(r_dst) = *VariantInternal::get_vector3(p_a) * *VariantInternal::get_float(p_b);
+				break;
+			default:
+				break;
+		}
+	}
+
+	static _FORCE_INLINE_ void assign_typed_builtin(Variant *r_dst, Variant *p_src, Variant::Type p_type) {
+		if (p_src->get_type() != p_type) {
+			Callable::CallError ce;
+			Variant::construct(p_type, *r_dst, const_cast<const Variant **>(&p_src), 1, ce);
+		} else {
+			*r_dst = *p_src;
+		}
+	}
+
+	// Both return `false` when the loop is over and the body must jump past it.
+	static _FORCE_INLINE_ bool iterate_begin_int(Variant *r_counter, const Variant *p_container, Variant *r_iterator) {
+		int64_t size = *VariantInternal::get_int(p_container);
+		VariantInternal::initialize(r_counter, Variant::INT);
+		*VariantInternal::get_int(r_counter) = 0;
+		if (size <= 0) {
+			return false;
+		}
+		VariantInternal::initialize(r_iterator, Variant::INT);
+		*VariantInternal::get_int(r_iterator) = 0;
+		return true;
+	}
+
+	static _FORCE_INLINE_ bool iterate_int(Variant *r_counter, const Variant *p_container, Variant *r_iterator) {
+		int64_t size = *VariantInternal::get_int(p_container);
+		int64_t *count = VariantInternal::get_int(r_counter);
+		(*count)++;
+		if (*count >= size) {
+			return false;
+		}
+		*VariantInternal::get_int(r_iterator) = *count;
+		return true;
+	}
+
+	static _FORCE_INLINE_ void return_typed_builtin(Variant *p_value, Variant::Type p_type, Variant *r_return) {
+		Callable::CallError ce;
+		if (p_value->get_type() == p_type) {
+			*r_return = *p_value;
+		} else if (Variant::can_convert_strict(p_value->get_type(), p_type)) {
+			Variant::construct(p_type, *r_return, const_cast<const Variant **>(&p_value), 1, ce);
+		} else {
+			Variant::construct(p_type, *r_return, nullptr, 0, ce);
+		}
+	}
+
+	static uint64_t hash_function(const GDScriptFunction *p_function);
+
+	static void register_body(uint64_t p_hash, GDScriptNativeBody p_body);
+	static bool has_bodies() { return !bodies.is_empty(); }
+	static GDScriptNativeBody get_body(const GDScriptFunction *p_function);
+
+#ifdef TESTS_ENABLED
+	// Runs `p_function` from its canonical code the way its generated body would, without an instance.
+	// This is what tests compare against the bytecode VM, as generated bodies can't be built at runtime.
+	static Variant execute(const GDScriptFunction *p_function, const Variant **p_args, int p_argcount, Callable::CallError &r_error);
+#endif
+
+#ifdef TOOLS_ENABLED
+	// Returns the C++ definition of a function equivalent to `p_function`, or an empty string
+	// if the function uses anything that can't be compiled ahead of time.
+	static String generate_body(const GDScriptFunction *p_function);
+	// Returns a complete source file from the definitions above, keyed by the hash of their function.
+	static String generate_source(const HashMap<uint64_t, String> &p_definitions);
+#endif
+};
+
+// Defined by the generated source when it is built in, see the `gdscript_native_source` build option.
+void register_gdscript_native_bodies();
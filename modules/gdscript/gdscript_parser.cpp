@@ -35,6 +35,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/io/resource_loader.h"
+#include "core/io/resource_uid.h"
 #include "core/math/math_defs.h"
 #include "scene/main/multiplayer_api.h"
 
@@ -790,6 +791,53 @@ const HashMap<String, Ref<GDScriptParserRef>> &GDScriptParser::get_depended_pars
 	return depended_parsers;
 }
 
+bool GDScriptParser::get_possible_script_dependencies(HashSet<String> &r_paths) const {
+	// Over-approximates the scripts the analyzer may reach from this one, without resolving anything.
+	// Returns false if the analysis may also need resources that aren't GDScript files.
+	bool only_scripts = true;
+	for (const Node *node = list; node != nullptr; node = node->next) {
+		String path;
+		switch (node->type) {
+			case Node::CLASS: {
+				path = static_cast<const ClassNode *>(node)->extends_path;
+			} break;
+			case Node::PRELOAD: {
+				const ExpressionNode *path_node = static_cast<const PreloadNode *>(node)->path;
+				if (path_node == nullptr || path_node->type != Node::LITERAL || static_cast<const LiteralNode *>(path_node)->value.get_type() != Variant::STRING) {
+					only_scripts = false;
+					continue;
+				}
+				path = static_cast<const LiteralNode *>(path_node)->value;
+			} break;
+			case Node::IDENTIFIER: {
+				const StringName &name = static_cast<const IdentifierNode *>(node)->name;
+				if (ScriptServer::is_global_class(name)) {
+					path = ScriptServer::get_global_class_path(name);
+				} else if (ProjectSettings::get_singleton()->has_autoload(name)) {
+					path = ProjectSettings::get_singleton()->get_autoload(name).path;
+				}
+			} break;
+			default:
+				break;
+		}
+		if (path.is_empty()) {
+			continue;
+		}
+
+		path = ResourceUID::ensure_path(path);
+		if (path.is_relative_path()) {
+			path = script_path.get_base_dir().path_join(path);
+		}
+		path = path.simplify_path();
+		if (path.get_extension().to_lower() != GDScriptLanguage::get_singleton()->get_extension()) {
+			only_scripts = false;
+		} else if (path != script_path) {
+			r_paths.insert(path);
+		}
+	}
+	return only_scripts;
+}
+
 GDScriptParser::ClassNode *GDScriptParser::find_class(const String &p_qualified_name) const {
 	String first = p_qualified_name.get_slice("::", 0);
 
@@ -0,0 +1,298 @@
+/**************************************************************************/
+/*  gdscript_sampling_profiler.cpp                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_sampling_profiler.h"
+
+#include "gdscript_function.h"
+
+#include "core/io/file_access.h"
+#include "core/io/json.h"
+#include "core/object/method_bind.h"
+#include "core/os/os.h"
+
+SafeFlag GDScriptSamplingProfiler::active;
+thread_local GDScriptSamplingProfiler::ThreadStackOwner GDScriptSamplingProfiler::thread_stack;
+Mutex GDScriptSamplingProfiler::mutex;
+
+LocalVector<GDScriptSamplingProfiler::ThreadStack *> GDScriptSamplingProfiler::threads;
+LocalVector<String> GDScriptSamplingProfiler::names;
+HashMap<String, uint32_t> GDScriptSamplingProfiler::name_ids;
+HashMap<const GDScriptFunction *, uint32_t> GDScriptSamplingProfiler::function_names;
+HashMap<const MethodBind *, uint32_t> GDScriptSamplingProfiler::native_names;
+LocalVector<GDScriptSamplingProfiler::StackNode> GDScriptSamplingProfiler::nodes;
+HashMap<uint64_t, uint32_t> GDScriptSamplingProfiler::node_ids;
+LocalVector<GDScriptSamplingProfiler::Sample> GDScriptSamplingProfiler::samples;
+
+Thread GDScriptSamplingProfiler::sampler_thread;
+SafeFlag GDScriptSamplingProfiler::sampling;
+String GDScriptSamplingProfiler::output_path;
+uint64_t GDScriptSamplingProfiler::interval_usec = 1000;
+uint64_t GDScriptSamplingProfiler::start_time = 0;
+
+GDScriptSamplingProfiler::ThreadStackOwner::~ThreadStackOwner() {
+	if (stack == nullptr) {
+		return;
+	}
+	MutexLock lock(mutex);
+	threads.erase(stack);
+	memdelete(stack);
+}
+
+GDScriptSamplingProfiler::Frame *GDScriptSamplingProfiler::_enter_function(const GDScriptFunction *p_function) {
+	ThreadStack *stack = thread_stack.stack;
+	if (unlikely(stack == nullptr)) {
+		stack = memnew(ThreadStack);
+		stack->thread_id = Thread::get_caller_id();
+		MutexLock lock(mutex);
+		stack->name = _get_name_id(stack->thread_id == Thread::get_main_id() ? String("Main Thread") : vformat("Thread %d", stack->thread_id));
+		threads.push_back(stack);
+		thread_stack.stack = stack;
+	}
+
+	const uint32_t depth = stack->depth.load(std::memory_order_relaxed);
+	Frame *frame = &stack->frames[MIN(depth, MAX_DEPTH)];
+	frame->function.store(p_function, std::memory_order_relaxed);
+	frame->native_method.store(nullptr, std::memory_order_relaxed);
+	// Publishes the frame to the sampler.
+	stack->depth.store(depth + 1, std::memory_order_release);
+	return frame;
+}
+
+void GDScriptSamplingProfiler::_exit_function() {
+	ThreadStack *stack = thread_stack.stack;
+	stack->depth.store(stack->depth.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+}
+
+void GDScriptSamplingProfiler::function_freed(const GDScriptFunction *p_function) {
+	if (likely(!active.is_set())) {
+		return;
+	}
+	// Also waits for the sampler to be done reading stacks, which may include this function.
+	MutexLock lock(mutex);
+	function_names.erase(p_function);
+}
+
+uint32_t GDScriptSamplingProfiler::_get_name_id(const String &p_name) {
+	if (const uint32_t *id = name_ids.getptr(p_name)) {
+		return *id;
+	}
+	const uint32_t id = names.size();
+	names.push_back(p_name);
+	name_ids.insert(p_name, id);
+	return id;
+}
+
+uint32_t GDScriptSamplingProfiler::_get_function_name(const GDScriptFunction *p_function) {
+	if (const uint32_t *id = function_names.getptr(p_function)) {
+		return *id;
+	}
+	const uint32_t id = _get_name_id(String(p_function->get_source()) + ":" + String(p_function->get_name()));
+	function_names.insert(p_function, id);
+	return id;
+}
+
+uint32_t GDScriptSamplingProfiler::_get_native_name(const MethodBind *p_method) {
+	if (const uint32_t *id = native_names.getptr(p_method)) {
+		return *id;
+	}
+	const uint32_t id = _get_name_id(String(p_method->get_instance_class()) + "::" + String(p_method->get_name()));
+	native_names.insert(p_method, id);
+	return id;
+}
+
+uint32_t GDScriptSamplingProfiler::_get_node(uint32_t p_parent, uint32_t p_name) {
+	const uint64_t key = (uint64_t(p_parent) << 32) | p_name;
+	if (const uint32_t *id = node_ids.getptr(key)) {
+		return *id;
+	}
+	const uint32_t id = nodes.size();
+	StackNode node;
+	node.parent = p_parent;
+	node.name = p_name;
+	nodes.push_back(node);
+	node_ids.insert(key, id);
+	return id;
+}
+
+void GDScriptSamplingProfiler::_sample_threads() {
+	MutexLock lock(mutex);
+	const uint64_t time = OS::get_singleton()->get_ticks_usec() - start_time;
+
+	for (ThreadStack *stack : threads) {
+		const uint32_t depth = MIN(stack->depth.load(std::memory_order_acquire), MAX_DEPTH);
+		if (depth == 0) {
+			continue;
+		}
+
+		// The stack may change while it's being read, so a sample can mix two neighboring states.
+		// Every function read is still alive, since freeing one waits for the lock held here.
+		uint32_t node = _get_node(NO_PARENT, stack->name);
+		for (uint32_t i = 0; i < depth; i++) {
+			const GDScriptFunction *function = stack->frames[i].function.load(std::memory_order_relaxed);
+			if (function == nullptr) {
+				break;
+			}
+			node = _get_node(node, _get_function_name(function));
+		}
+		const MethodBind *native_method = stack->frames[depth - 1].native_method.load(std::memory_order_relaxed);
+		if (native_method != nullptr) {
+			node = _get_node(node, _get_native_name(native_method));
+		}
+
+		nodes[node].samples++;
+		if (output_path.get_extension().to_lower() == "json") {
+			Sample sample;
+			sample.time = time;
+			sample.thread_id = stack->thread_id;
+			sample.node = node;
+			samples.push_back(sample);
+		}
+	}
+}
+
+void GDScriptSamplingProfiler::_sampler_loop(void *p_userdata) {
+	while (sampling.is_set()) {
+		OS::get_singleton()->delay_usec(interval_usec);
+		_sample_threads();
+	}
+}
+
+String GDScriptSamplingProfiler::_get_collapsed_stacks() {
+	String result;
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		if (nodes[i].samples == 0) {
+			continue;
+		}
+		String line = itos(nodes[i].samples);
+		for (uint32_t node = i; node != NO_PARENT; node = nodes[node].parent) {
+			line = names[nodes[node].name].replace(";", ",") + (node == i ? " " : ";") + line;
+		}
+		result += line + "\n";
+	}
+	return result;
+}
+
+String GDScriptSamplingProfiler::_get_chrome_trace() {
+	Array events;
+	for (const ThreadStack *stack : threads) {
+		Dictionary event;
+		event["ph"] = "M";
+		event["name"] = "thread_name";
+		event["pid"] = 1;
+		event["tid"] = stack->thread_id;
+		Dictionary args;
+		args["name"] = names[stack->name];
+		event["args"] = args;
+		events.push_back(event);
+	}
+
+	Dictionary stack_frames;
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		Dictionary frame;
+		frame["name"] = names[nodes[i].name];
+		if (nodes[i].parent != NO_PARENT) {
+			frame["parent"] = itos(nodes[i].parent);
+		}
+		stack_frames[itos(i)] = frame;
+	}
+
+	Array trace_samples;
+	for (const Sample &sample : samples) {
+		Dictionary entry;
+		entry["name"] = "sample";
+		entry["cpu"] = 0;
+		entry["tid"] = sample.thread_id;
+		entry["ts"] = sample.time;
+		entry["sf"] = itos(sample.node);
+		entry["weight"] = 1;
+		trace_samples.push_back(entry);
+	}
+
+	Dictionary trace;
+	trace["traceEvents"] = events;
+	trace["stackFrames"] = stack_frames;
+	trace["samples"] = trace_samples;
+	return JSON::stringify(trace, "", false);
+}
+
+void GDScriptSamplingProfiler::start(const String &p_output_path, int p_rate_hz) {
+	ERR_FAIL_COND_MSG(sampling.is_set(), "The GDScript sampling profiler is already running.");
+	ERR_FAIL_COND_MSG(p_rate_hz <= 0, "The GDScript sampling profiler rate must be positive.");
+
+	output_path = p_output_path;
+	interval_usec = MAX(1000000 / p_rate_hz, 1);
+	start_time = OS::get_singleton()->get_ticks_usec();
+
+	active.set();
+	sampling.set();
+	sampler_thread.start(&GDScriptSamplingProfiler::_sampler_loop, nullptr);
+}
+
+Error GDScriptSamplingProfiler::stop() {
+	if (!sampling.is_set()) {
+		return OK;
+	}
+	sampling.clear();
+	sampler_thread.wait_to_finish();
+	// Threads already inside a function keep their frames balanced, since they only pop the frames they pushed.
+	active.clear();
+
+	MutexLock lock(mutex);
+	const String contents = output_path.get_extension().to_lower() == "json" ? _get_chrome_trace() : _get_collapsed_stacks();
+
+	function_names.clear();
+	native_names.clear();
+	nodes.clear();
+	node_ids.clear();
+	samples.clear();
+
+	Error err = OK;
+	Ref<FileAccess> file = FileAccess::open(output_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat(R"(Couldn't save the GDScript sampling profile to "%s".)", output_path));
+	file->store_string(contents);
+	print_line(vformat(R"(GDScript sampling profile saved to "%s".)", output_path));
+	return OK;
+}
+
+void GDScriptSamplingProfiler::handle_cmdline() {
+	const List<String> args = OS::get_singleton()->get_cmdline_args();
+	String path;
+	int rate = 1000;
+	for (const List<String>::Element *E = args.front(); E && E->next(); E = E->next()) {
+		if (E->get() == "--gdscript-sampling-profile") {
+			path = E->next()->get();
+		} else if (E->get() == "--gdscript-sampling-rate") {
+			rate = E->next()->get().to_int();
+		}
+	}
+	if (!path.is_empty()) {
+		start(path, rate);
+	}
+}
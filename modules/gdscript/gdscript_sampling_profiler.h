@@ -0,0 +1,135 @@
+/**************************************************************************/
+/*  gdscript_sampling_profiler.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+#include <atomic>
+
+class GDScriptFunction;
+class MethodBind;
+
+// Statistical profiler for scripts, meant to be used on release builds under real load.
+//
+// While running, every thread executing GDScript keeps a shadow stack of its functions, plus the method bind
+// being called from the innermost one, if any. A separate thread reads these stacks at a fixed rate and counts
+// each distinct stack, so the threads being profiled never take a lock or measure time themselves.
+// The result is written as collapsed stacks (one `frame;frame;frame count` line per stack, as read by flame
+// graph tools), or as a Chrome trace with one sample per stack read if the output path ends with `.json`.
+class GDScriptSamplingProfiler {
+public:
+	struct Frame {
+		std::atomic<const GDScriptFunction *> function = nullptr;
+		std::atomic<const MethodBind *> native_method = nullptr;
+	};
+
+private:
+	static constexpr uint32_t MAX_DEPTH = 256;
+	static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+	struct ThreadStack {
+		Frame frames[MAX_DEPTH + 1]; // The last one stands for all frames deeper than `MAX_DEPTH`.
+		std::atomic<uint32_t> depth = 0;
+		uint32_t name = 0;
+		Thread::ID thread_id = Thread::UNASSIGNED_ID;
+	};
+
+	struct ThreadStackOwner {
+		ThreadStack *stack = nullptr;
+		~ThreadStackOwner();
+	};
+
+	struct StackNode {
+		uint32_t parent = NO_PARENT;
+		uint32_t name = 0;
+		uint64_t samples = 0;
+	};
+
+	struct Sample {
+		uint64_t time = 0;
+		Thread::ID thread_id = Thread::UNASSIGNED_ID;
+		uint32_t node = 0;
+	};
+
+	static SafeFlag active;
+	static thread_local ThreadStackOwner thread_stack;
+	static Mutex mutex;
+
+	static LocalVector<ThreadStack *> threads;
+	static LocalVector<String> names;
+	static HashMap<String, uint32_t> name_ids;
+	static HashMap<const GDScriptFunction *, uint32_t> function_names;
+	static HashMap<const MethodBind *, uint32_t> native_names;
+	static LocalVector<StackNode> nodes;
+	static HashMap<uint64_t, uint32_t> node_ids;
+	static LocalVector<Sample> samples;
+
+	static Thread sampler_thread;
+	static SafeFlag sampling;
+	static String output_path;
+	static uint64_t interval_usec;
+	static uint64_t start_time;
+
+	static Frame *_enter_function(const GDScriptFunction *p_function);
+	static void _exit_function();
+
+	static uint32_t _get_name_id(const String &p_name);
+	static uint32_t _get_function_name(const GDScriptFunction *p_function);
+	static uint32_t _get_native_name(const MethodBind *p_method);
+	static uint32_t _get_node(uint32_t p_parent, uint32_t p_name);
+	static void _sample_threads();
+	static void _sampler_loop(void *p_userdata);
+
+	static String _get_collapsed_stacks();
+	static String _get_chrome_trace();
+
+public:
+	// Returns the frame of the function, if profiling. `exit_function()` must be called on return only in that case.
+	_FORCE_INLINE_ static Frame *enter_function(const GDScriptFunction *p_function) {
+		if (likely(!active.is_set())) {
+			return nullptr;
+		}
+		return _enter_function(p_function);
+	}
+	_FORCE_INLINE_ static void exit_function() {
+		_exit_function();
+	}
+	static void function_freed(const GDScriptFunction *p_function);
+
+	static bool is_active() { return active.is_set(); }
+	static void start(const String &p_output_path, int p_rate_hz);
+	static Error stop();
+	static void handle_cmdline();
+};
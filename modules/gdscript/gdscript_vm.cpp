@@ -31,8 +31,10 @@
 #include "gdscript.h"
 #include "gdscript_function.h"
 #include "gdscript_lambda_callable.h"
+#include "gdscript_sampling_profiler.h"
 
 #include "core/os/os.h"
+#include "scene/scene_string_names.h"
 
 #ifdef DEBUG_ENABLED
 
@@ -166,6 +168,236 @@ String GDScriptFunction::_get_call_error(const String &p_where, const Variant **
 	return "Bug: Invalid call error code " + itos(p_err.error) + ".";
 }
 
+static GDScriptInstance *_get_gdscript_instance(ScriptInstance *p_instance) {
+	if (p_instance == nullptr || p_instance->get_language() != GDScriptLanguage::get_singleton() || p_instance->is_placeholder()) {
+		return nullptr;
+	}
+	return static_cast<GDScriptInstance *>(p_instance);
+}
+
+static bool _is_inline_cacheable_class(const StringName &p_class) {
+	// Classes from extensions can be unloaded, which would leave dangling method binds behind.
+	ClassDB::APIType api = ClassDB::get_api_type(p_class);
+	return api == ClassDB::API_CORE || api == ClassDB::API_EDITOR;
+}
+
+GDScriptFunction::InlineCache::Entry *GDScriptFunction::_get_inline_cache_entry(int p_cache, const void *p_key) {
+	InlineCache &cache = _inline_caches_ptr[p_cache];
+	uint32_t epoch = inline_cache_epoch.get();
+	if (unlikely(cache.epoch != epoch)) {
+		cache = InlineCache();
+		cache.epoch = epoch;
+		return nullptr;
+	}
+
+	for (int i = 0; i < InlineCache::SIZE; i++) {
+		if (cache.entries[i].key == p_key) {
+			return &cache.entries[i];
+		}
+	}
+	return nullptr;
+}
+
+GDScriptFunction::InlineCache::Entry *GDScriptFunction::_add_inline_cache_entry(int p_cache, const void *p_key) {
+	// Once every entry is taken, the oldest one is replaced, so megamorphic sites keep cycling.
+	InlineCache &cache = _inline_caches_ptr[p_cache];
+	InlineCache::Entry &entry = cache.entries[cache.next];
+	cache.next = (cache.next + 1) % InlineCache::SIZE;
+
+	entry = InlineCache::Entry();
+	entry.key = p_key;
+	return &entry;
+}
+
+bool GDScriptFunction::_get_named_cached(int p_cache, const Variant *p_base, const StringName &p_name, Variant *r_dst) {
+	// Caches are only touched by the main thread, so entries never need to be synchronized.
+	if (p_base->get_type() != Variant::OBJECT || !Thread::is_main_thread()) {
+		return false;
+	}
+	Object *obj = p_base->get_validated_object();
+	if (obj == nullptr) {
+		return false;
+	}
+
+	ScriptInstance *script_instance = obj->get_script_instance();
+	GDScriptInstance *instance = _get_gdscript_instance(script_instance);
+	if (instance) {
+		GDScript *script = instance->script.ptr();
+		InlineCache::Entry *entry = _get_inline_cache_entry(p_cache, script);
+		if (entry == nullptr) {
+			const GDScript::MemberInfo *member = script->member_indices.getptr(p_name);
+			if (member == nullptr || !script->valid || member->getter != StringName()) {
+				return false;
+			}
+			entry = _add_inline_cache_entry(p_cache, script);
+			entry->member_index = member->index;
+		}
+
+		if (unlikely(r_dst == p_base)) {
+			// Assigning over the base could free the instance holding the value.
+			Variant value = instance->members[entry->member_index];
+			*r_dst = value;
+		} else {
+			*r_dst = instance->members[entry->member_index];
+		}
+		return true;
+	}
+
+	if (script_instance) {
+		return false;
+	}
+
+	const StringName &class_name = obj->get_class_name();
+	InlineCache::Entry *entry = _get_inline_cache_entry(p_cache, class_name.data_unique_pointer());
+	if (entry == nullptr) {
+		// Only plain properties, anything that `ClassDB::get_property()` would resolve differently stays uncached.
+		bool valid = false;
+		int index = ClassDB::get_property_index(class_name, p_name, &valid);
+		if (!valid || index >= 0 || !_is_inline_cacheable_class(class_name) || ClassDB::has_method(class_name, p_name) || ClassDB::has_signal(class_name, p_name) || ClassDB::has_integer_constant(class_name, p_name)) {
+			return false;
+		}
+		StringName getter = ClassDB::get_property_getter(class_name, p_name);
+		MethodBind *method = getter == StringName() ? nullptr : ClassDB::get_method(class_name, getter);
+		if (method == nullptr) {
+			return false;
+		}
+		entry = _add_inline_cache_entry(p_cache, class_name.data_unique_pointer());
+		entry->method = method;
+	}
+
+	Callable::CallError ce;
+	*r_dst = entry->method->call(obj, nullptr, 0, ce);
+	return true;
+}
+
+bool GDScriptFunction::_set_named_cached(int p_cache, const Variant *p_base, const StringName &p_name, const Variant *p_value, bool &r_valid) {
+	if (p_base->get_type() != Variant::OBJECT || !Thread::is_main_thread()) {
+		return false;
+	}
+	Object *obj = p_base->get_validated_object();
+	if (obj == nullptr) {
+		return false;
+	}
+
+	ScriptInstance *script_instance = obj->get_script_instance();
+	GDScriptInstance *instance = _get_gdscript_instance(script_instance);
+	if (instance) {
+		GDScript *script = instance->script.ptr();
+		InlineCache::Entry *entry = _get_inline_cache_entry(p_cache, script);
+		if (entry == nullptr) {
+			const GDScript::MemberInfo *member = script->member_indices.getptr(p_name);
+			if (member == nullptr || !script->valid || member->setter != StringName()) {
+				return false;
+			}
+			entry = _add_inline_cache_entry(p_cache, script);
+			entry->member_index = member->index;
+			entry->member_type = &member->data_type;
+		}
+
+		// Values needing a conversion take the regular path, which knows how to report failures.
+		if (entry->member_type->has_type && !entry->member_type->is_type(*p_value)) {
+			return false;
+		}
+#ifdef TOOLS_ENABLED
+		obj->set_edited(true);
+#endif
+		instance->members.write[entry->member_index] = *p_value;
+		r_valid = true;
+		return true;
+	}
+
+	if (script_instance) {
+		return false;
+	}
+
+	const StringName &class_name = obj->get_class_name();
+	InlineCache::Entry *entry = _get_inline_cache_entry(p_cache, class_name.data_unique_pointer());
+	if (entry == nullptr) {
+		bool valid = false;
+		int index = ClassDB::get_property_index(class_name, p_name, &valid);
+		if (!valid || index >= 0 || !_is_inline_cacheable_class(class_name)) {
+			return false;
+		}
+		StringName setter = ClassDB::get_property_setter(class_name, p_name);
+		MethodBind *method = setter == StringName() ? nullptr : ClassDB::get_method(class_name, setter);
+		if (method == nullptr) {
+			return false;
+		}
+		entry = _add_inline_cache_entry(p_cache, class_name.data_unique_pointer());
+		entry->method = method;
+	}
+
+#ifdef TOOLS_ENABLED
+	obj->set_edited(true);
+#endif
+	const Variant *args[1] = { p_value };
+	Callable::CallError ce;
+	entry->method->call(obj, args, 1, ce);
+	r_valid = ce.error == Callable::CallError::CALL_OK;
+	return true;
+}
+
+#ifndef DEBUG_ENABLED
+bool GDScriptFunction::_call_cached(int p_cache, const Variant *p_base, const StringName &p_name, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_err) {
+	if (p_base->get_type() != Variant::OBJECT || !Thread::is_main_thread()) {
+		return false;
+	}
+	Object *obj = p_base->get_validated_object();
+	if (obj == nullptr) {
+		return false;
+	}
+
+	ScriptInstance *script_instance = obj->get_script_instance();
+	GDScriptInstance *instance = _get_gdscript_instance(script_instance);
+	if (instance) {
+		GDScript *script = instance->script.ptr();
+		InlineCache::Entry *entry = _get_inline_cache_entry(p_cache, script);
+		if (entry == nullptr) {
+			// `_ready()` also runs the implicit initializers, and `free()` always goes to the object.
+			if (p_name == SceneStringName(_ready) || p_name == CoreStringName(free_)) {
+				return false;
+			}
+			GDScriptFunction *function = nullptr;
+			for (GDScript *sptr = script; sptr && function == nullptr; sptr = sptr->_base) {
+				if (likely(sptr->valid)) {
+					GDScriptFunction *const *E = sptr->member_functions.getptr(p_name);
+					function = E ? *E : nullptr;
+				}
+			}
+			if (function == nullptr) {
+				return false;
+			}
+			entry = _add_inline_cache_entry(p_cache, script);
+			entry->function = function;
+		}
+
+		r_ret = entry->function->call(instance, p_args, p_argcount, r_err);
+		return true;
+	}
+
+	if (script_instance) {
+		return false;
+	}
+
+	const StringName &class_name = obj->get_class_name();
+	InlineCache::Entry *entry = _get_inline_cache_entry(p_cache, class_name.data_unique_pointer());
+	if (entry == nullptr) {
+		if (p_name == CoreStringName(free_) || !_is_inline_cacheable_class(class_name)) {
+			return false;
+		}
+		MethodBind *method = ClassDB::get_method(class_name, p_name);
+		if (method == nullptr) {
+			return false;
+		}
+		entry = _add_inline_cache_entry(p_cache, class_name.data_unique_pointer());
+		entry->method = method;
+	}
+
+	r_ret = entry->method->call(obj, p_args, p_argcount, r_err);
+	return true;
+}
+#endif // !DEBUG_ENABLED
+
 void (*type_init_function_table[])(Variant *) = {
 	nullptr, // NIL (shouldn't be called).
 	&VariantInitializer<bool>::init, // BOOL.
@@ -213,6 +445,28 @@ void (*type_init_function_table[])(Variant *) = {
 	static const void *switch_table_ops[] = {            \
 		&&OPCODE_OPERATOR,                               \
 		&&OPCODE_OPERATOR_VALIDATED,                     \
+		&&OPCODE_OPERATOR_ADD_INT,                       \
+		&&OPCODE_OPERATOR_SUBTRACT_INT,                  \
+		&&OPCODE_OPERATOR_MULTIPLY_INT,                  \
+		&&OPCODE_OPERATOR_EQUAL_INT,                     \
+		&&OPCODE_OPERATOR_NOT_EQUAL_INT,                 \
+		&&OPCODE_OPERATOR_LESS_INT,                      \
+		&&OPCODE_OPERATOR_LESS_EQUAL_INT,                \
+		&&OPCODE_OPERATOR_GREATER_INT,                   \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_INT,             \
+		&&OPCODE_OPERATOR_ADD_FLOAT,                     \
+		&&OPCODE_OPERATOR_SUBTRACT_FLOAT,                \
+		&&OPCODE_OPERATOR_MULTIPLY_FLOAT,                \
+		&&OPCODE_OPERATOR_DIVIDE_FLOAT,                  \
+		&&OPCODE_OPERATOR_EQUAL_FLOAT,                   \
+		&&OPCODE_OPERATOR_NOT_EQUAL_FLOAT,               \
+		&&OPCODE_OPERATOR_LESS_FLOAT,                    \
+		&&OPCODE_OPERATOR_LESS_EQUAL_FLOAT,              \
+		&&OPCODE_OPERATOR_GREATER_FLOAT,                 \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,           \
+		&&OPCODE_OPERATOR_ADD_VECTOR3,                   \
+		&&OPCODE_OPERATOR_SUBTRACT_VECTOR3,              \
+		&&OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT,        \
 		&&OPCODE_TYPE_TEST_BUILTIN,                      \
 		&&OPCODE_TYPE_TEST_ARRAY,                        \
 		&&OPCODE_TYPE_TEST_NATIVE,                       \
@@ -272,6 +526,9 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_JUMP_IF_NOT,                            \
 		&&OPCODE_JUMP_TO_DEF_ARGUMENT,                   \
 		&&OPCODE_JUMP_IF_SHARED,                         \
+		&&OPCODE_OPERATOR_VALIDATED_JUMP_IF,             \
+		&&OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT,         \
+		&&OPCODE_GET_MEMBER_OPERATOR_VALIDATED,          \
 		&&OPCODE_RETURN,                                 \
 		&&OPCODE_RETURN_TYPED_BUILTIN,                   \
 		&&OPCODE_RETURN_TYPED_ARRAY,                     \
@@ -495,11 +752,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	if (p_state) {
 		//use existing (supplied) state (awaited)
-		stack = (Variant *)p_state->stack.ptr();
-		instruction_args = (Variant **)&p_state->stack.ptr()[sizeof(Variant) * p_state->stack_size]; //ptr() to avoid bounds check
+		stack = (Variant *)p_state->stack;
+		instruction_args = (Variant **)&p_state->stack[sizeof(Variant) * p_state->stack_size];
 		line = p_state->line;
 		ip = p_state->ip;
-		alloca_size = p_state->stack.size();
+		alloca_size = p_state->alloca_size;
 		script = p_state->script;
 		p_instance = p_state->instance;
 		defarg = p_state->defarg;
@@ -592,6 +849,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	memnew_placement(&stack[ADDR_STACK_NIL], Variant);
 
 	String err_text;
+	bool stack_moved = false; // The stack is owned by a `GDScriptFunctionState` after awaiting.
+
+	GDScriptSamplingProfiler::Frame *sample_frame = GDScriptSamplingProfiler::enter_function(this);
+
+#ifdef GDSCRIPT_LINE_TRACES
+	// Without a debugger to keep the call stack, it's kept here so errors can report where they happened.
+	int *traced_ip = GDScriptLanguage::get_singleton()->enter_traced_function(p_instance, this, stack, &line);
+#endif
 
 #ifdef DEBUG_ENABLED
 
@@ -659,6 +924,26 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #define GET_INSTRUCTION_ARG(m_v, m_idx) \
 	Variant *m_v = instruction_args[m_idx]
 
+#define SAMPLE_NATIVE_CALL_BEGIN(m_method)                                      \
+	if (unlikely(sample_frame)) {                                               \
+		sample_frame->native_method.store(m_method, std::memory_order_relaxed); \
+	}
+#define SAMPLE_NATIVE_CALL_END                                                 \
+	if (unlikely(sample_frame)) {                                              \
+		sample_frame->native_method.store(nullptr, std::memory_order_relaxed); \
+	}
+
+#ifdef GDSCRIPT_LINE_TRACES
+// Traced functions only store their position before instructions that run other code or may raise engine errors,
+// so that a backtrace shows the line of each call.
+#define TRACE_IP()           \
+	if (traced_ip) {         \
+		*traced_ip = ip;     \
+	}
+#else
+#define TRACE_IP()
+#endif
+
 #ifdef DEBUG_ENABLED
 	uint64_t function_start_time = 0;
 	uint64_t function_call_time = 0;
@@ -680,11 +965,16 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	OPCODE_WHILE(ip < _code_size) {
 		int last_opcode = _code_ptr[ip];
 #else
-	OPCODE_WHILE(true) {
+	// Functions compiled ahead of time never await nor take default arguments, so they always start at the top.
+	if (native_body) {
+		native_body(variant_addresses, _operator_funcs_ptr, &retvalue);
+	} else {
+		OPCODE_WHILE(true) {
 #endif
 
 		OPCODE_SWITCH(_code_ptr[ip]) {
 			OPCODE(OPCODE_OPERATOR) {
+				TRACE_IP();
 				constexpr int _pointer_size = sizeof(Variant::ValidatedOperatorEvaluator) / sizeof(*_code_ptr);
 				CHECK_SPACE(7 + _pointer_size);
 
@@ -788,6 +1078,41 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			// Same layout as a validated operator, but computed directly on the values held by the typed slots.
+#define OPCODE_OPERATOR_TYPED(m_name, m_left_get, m_right_get, m_result_get, m_op)                                   \
+	OPCODE(OPCODE_OPERATOR_##m_name) {                                                                               \
+		CHECK_SPACE(5);                                                                                              \
+		GET_VARIANT_PTR(a, 0);                                                                                       \
+		GET_VARIANT_PTR(b, 1);                                                                                       \
+		GET_VARIANT_PTR(dst, 2);                                                                                     \
+		*VariantInternal::m_result_get(dst) = *VariantInternal::m_left_get(a) m_op *VariantInternal::m_right_get(b); \
+		ip += 5;                                                                                                     \
+	}                                                                                                                \
+	DISPATCH_OPCODE
+
+			OPCODE_OPERATOR_TYPED(ADD_INT, get_int, get_int, get_int, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_INT, get_int, get_int, get_int, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_INT, get_int, get_int, get_int, *);
+			OPCODE_OPERATOR_TYPED(EQUAL_INT, get_int, get_int, get_bool, ==);
+			OPCODE_OPERATOR_TYPED(NOT_EQUAL_INT, get_int, get_int, get_bool, !=);
+			OPCODE_OPERATOR_TYPED(LESS_INT, get_int, get_int, get_bool, <);
+			OPCODE_OPERATOR_TYPED(LESS_EQUAL_INT, get_int, get_int, get_bool, <=);
+			OPCODE_OPERATOR_TYPED(GREATER_INT, get_int, get_int, get_bool, >);
+			OPCODE_OPERATOR_TYPED(GREATER_EQUAL_INT, get_int, get_int, get_bool, >=);
+			OPCODE_OPERATOR_TYPED(ADD_FLOAT, get_float, get_float, get_float, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_FLOAT, get_float, get_float, get_float, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_FLOAT, get_float, get_float, get_float, *);
+			OPCODE_OPERATOR_TYPED(DIVIDE_FLOAT, get_float, get_float, get_float, /);
+			OPCODE_OPERATOR_TYPED(EQUAL_FLOAT, get_float, get_float, get_bool, ==);
+			OPCODE_OPERATOR_TYPED(NOT_EQUAL_FLOAT, get_float, get_float, get_bool, !=);
+			OPCODE_OPERATOR_TYPED(LESS_FLOAT, get_float, get_float, get_bool, <);
+			OPCODE_OPERATOR_TYPED(LESS_EQUAL_FLOAT, get_float, get_float, get_bool, <=);
+			OPCODE_OPERATOR_TYPED(GREATER_FLOAT, get_float, get_float, get_bool, >);
+			OPCODE_OPERATOR_TYPED(GREATER_EQUAL_FLOAT, get_float, get_float, get_bool, >=);
+			OPCODE_OPERATOR_TYPED(ADD_VECTOR3, get_vector3, get_vector3, get_vector3, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_VECTOR3, get_vector3, get_vector3, get_vector3, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_VECTOR3_FLOAT, get_vector3, get_float, get_vector3, *);
+
 			OPCODE(OPCODE_TYPE_TEST_BUILTIN) {
 				CHECK_SPACE(4);
 
@@ -882,6 +1207,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_KEYED) {
+				TRACE_IP();
 				CHECK_SPACE(3);
 
 				GET_VARIANT_PTR(dst, 0);
@@ -998,6 +1324,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_KEYED) {
+				TRACE_IP();
 				CHECK_SPACE(3);
 
 				GET_VARIANT_PTR(src, 0);
@@ -1102,7 +1429,8 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_NAMED) {
-				CHECK_SPACE(3);
+				TRACE_IP();
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(dst, 0);
 				GET_VARIANT_PTR(value, 1);
@@ -1112,8 +1440,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int inline_cache = _code_ptr[ip + 4];
+				GD_ERR_BREAK(inline_cache < -1 || inline_cache >= _inline_caches_count);
+
 				bool valid;
-				dst->set_named(*index, *value, valid);
+				if (inline_cache < 0 || !_set_named_cached(inline_cache, dst, *index, value, valid)) {
+					dst->set_named(*index, *value, valid);
+				}
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -1134,7 +1467,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1154,7 +1487,8 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+				TRACE_IP();
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(src, 0);
 				GET_VARIANT_PTR(dst, 1);
@@ -1164,22 +1498,27 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
+				int inline_cache = _code_ptr[ip + 4];
+				GD_ERR_BREAK(inline_cache < -1 || inline_cache >= _inline_caches_count);
+
+				if (inline_cache < 0 || !_get_named_cached(inline_cache, src, *index, dst)) {
+					bool valid;
 #ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, valid);
+					//allow better error message in cases where src and dst are the same stack position
+					Variant ret = src->get_named(*index, valid);
 
 #else
-				*dst = src->get_named(*index, valid);
+					*dst = src->get_named(*index, valid);
 #endif
 #ifdef DEBUG_ENABLED
-				if (!valid) {
-					err_text = "Invalid access to property or key '" + index->operator String() + "' on a base object of type '" + _get_var_type(src) + "'.";
-					OPCODE_BREAK;
-				}
-				*dst = ret;
+					if (!valid) {
+						err_text = "Invalid access to property or key '" + index->operator String() + "' on a base object of type '" + _get_var_type(src) + "'.";
+						OPCODE_BREAK;
+					}
+					*dst = ret;
 #endif
-				ip += 4;
+				}
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1586,6 +1925,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CONSTRUCT) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(2 + instr_arg_count);
 
@@ -1614,6 +1954,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CONSTRUCT_VALIDATED) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(2 + instr_arg_count);
 				ip += instr_arg_count;
@@ -1635,6 +1976,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CONSTRUCT_ARRAY) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(1 + instr_arg_count);
 				ip += instr_arg_count;
@@ -1657,6 +1999,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CONSTRUCT_TYPED_ARRAY) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
 				ip += instr_arg_count;
@@ -1685,6 +2028,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CONSTRUCT_DICTIONARY) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(2 + instr_arg_count);
 
@@ -1710,12 +2054,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_CALL_ASYNC)
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
+				TRACE_IP();
 				bool call_ret = (_code_ptr[ip]) != OPCODE_CALL;
 #ifdef DEBUG_ENABLED
 				bool call_async = (_code_ptr[ip]) == OPCODE_CALL_ASYNC;
 #endif
 				LOAD_INSTRUCTION_ARGS
-				CHECK_SPACE(3 + instr_arg_count);
+				CHECK_SPACE(4 + instr_arg_count);
 
 				ip += instr_arg_count;
 
@@ -1726,6 +2071,12 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(methodname_idx < 0 || methodname_idx >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[methodname_idx];
 
+#ifndef DEBUG_ENABLED
+				// Debug builds always take the regular path, which keeps the object locked and reports call errors.
+				int inline_cache = _code_ptr[ip + 3];
+				GD_ERR_BREAK(inline_cache < -1 || inline_cache >= _inline_caches_count);
+#endif
+
 				GET_INSTRUCTION_ARG(base, argc);
 				Variant **argptrs = instruction_args;
 
@@ -1742,9 +2093,15 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				Variant temp_ret;
 				Callable::CallError err;
+#ifdef DEBUG_ENABLED
+				base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
+#else
+				if (inline_cache < 0 || !_call_cached(inline_cache, base, *methodname, (const Variant **)argptrs, argc, temp_ret, err)) {
+					base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
+				}
+#endif
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
-					base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
 					*ret = temp_ret;
 #ifdef DEBUG_ENABLED
 					if (ret->get_type() == Variant::NIL) {
@@ -1773,8 +2130,6 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 						}
 					}
 #endif
-				} else {
-					base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
 				}
 #ifdef DEBUG_ENABLED
 
@@ -1824,12 +2179,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 #endif // DEBUG_ENABLED
 
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_METHOD_BIND)
 			OPCODE(OPCODE_CALL_METHOD_BIND_RET) {
+				TRACE_IP();
 				bool call_ret = (_code_ptr[ip]) == OPCODE_CALL_METHOD_BIND_RET;
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
@@ -1869,10 +2225,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Callable::CallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
+					SAMPLE_NATIVE_CALL_BEGIN(method);
 					temp_ret = method->call(base_obj, (const Variant **)argptrs, argc, err);
+					SAMPLE_NATIVE_CALL_END;
 					*ret = temp_ret;
 				} else {
+					SAMPLE_NATIVE_CALL_BEGIN(method);
 					temp_ret = method->call(base_obj, (const Variant **)argptrs, argc, err);
+					SAMPLE_NATIVE_CALL_END;
 				}
 
 #ifdef DEBUG_ENABLED
@@ -1914,6 +2274,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_BUILTIN_STATIC) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(4 + instr_arg_count);
 
@@ -1948,6 +2309,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_NATIVE_STATIC) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
 
@@ -1971,7 +2333,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 				Callable::CallError err;
+				SAMPLE_NATIVE_CALL_BEGIN(method);
 				*ret = method->call(nullptr, argptrs, argc, err);
+				SAMPLE_NATIVE_CALL_END;
 
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
@@ -1991,6 +2355,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_NATIVE_STATIC_VALIDATED_RETURN) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
 
@@ -2012,7 +2377,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 				GET_INSTRUCTION_ARG(ret, argc);
+				SAMPLE_NATIVE_CALL_BEGIN(method);
 				method->validated_call(nullptr, (const Variant **)argptrs, ret);
+				SAMPLE_NATIVE_CALL_END;
 
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2027,6 +2394,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_NATIVE_STATIC_VALIDATED_NO_RETURN) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
 
@@ -2048,7 +2416,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				GET_INSTRUCTION_ARG(ret, argc);
 				VariantInternal::initialize(ret, Variant::NIL);
+				SAMPLE_NATIVE_CALL_BEGIN(method);
 				method->validated_call(nullptr, (const Variant **)argptrs, nullptr);
+				SAMPLE_NATIVE_CALL_END;
 
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2063,6 +2433,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
 
@@ -2100,7 +2471,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 				GET_INSTRUCTION_ARG(ret, argc + 1);
+				SAMPLE_NATIVE_CALL_BEGIN(method);
 				method->validated_call(base_obj, (const Variant **)argptrs, ret);
+				SAMPLE_NATIVE_CALL_END;
 
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2115,6 +2488,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
 
@@ -2150,7 +2524,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				GET_INSTRUCTION_ARG(ret, argc + 1);
 				VariantInternal::initialize(ret, Variant::NIL);
+				SAMPLE_NATIVE_CALL_BEGIN(method);
 				method->validated_call(base_obj, (const Variant **)argptrs, nullptr);
+				SAMPLE_NATIVE_CALL_END;
 
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2165,6 +2541,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_BUILTIN_TYPE_VALIDATED) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 
 				CHECK_SPACE(3 + instr_arg_count);
@@ -2188,6 +2565,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_UTILITY) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
 
@@ -2223,6 +2601,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_UTILITY_VALIDATED) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
 
@@ -2245,6 +2624,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_GDSCRIPT_UTILITY) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
 
@@ -2280,6 +2660,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CALL_SELF_BASE) {
+				TRACE_IP();
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
 
@@ -2347,6 +2728,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_AWAIT) {
+				TRACE_IP();
 				CHECK_SPACE(2);
 
 				// Do the one-shot connect.
@@ -2387,15 +2769,21 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 
 				if (is_signal) {
-					Ref<GDScriptFunctionState> gdfs = memnew(GDScriptFunctionState);
-					gdfs->function = this;
-
-					gdfs->state.stack.resize(alloca_size);
+					Ref<GDScriptFunctionState> gdfs;
+					if (p_state) {
+						// Resumed after an earlier await, so the stack already lives in that state: await again with it.
+						gdfs = Ref<GDScriptFunctionState>(p_state->function_state);
+					} else {
+						gdfs = memnew(GDScriptFunctionState);
+						gdfs->state.stack = GDScriptFunctionState::_alloc_stack(alloca_size);
 
-					// First 3 stack addresses are special, so we just skip them here.
-					for (int i = 3; i < _stack_size; i++) {
-						memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
+						// First 3 stack addresses are special, so we just skip them here.
+						// The others are moved to the state, and not freed when returning below.
+						memcpy((void *)&gdfs->state.stack[sizeof(Variant) * 3], (const void *)&stack[3], sizeof(Variant) * (_stack_size - 3));
 					}
+					stack_moved = true;
+					gdfs->function = this;
+
 					gdfs->state.stack_size = _stack_size;
 					gdfs->state.alloca_size = alloca_size;
 					gdfs->state.ip = ip + 2;
@@ -2578,6 +2966,85 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_OPERATOR_VALIDATED_JUMP_IF) {
+				// Overlays a validated operator and a jump-if testing its result.
+				CHECK_SPACE(8);
+
+				int operator_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(operator_idx < 0 || operator_idx >= _operator_funcs_count);
+				Variant::ValidatedOperatorEvaluator operator_func = _operator_funcs_ptr[operator_idx];
+
+				GET_VARIANT_PTR(a, 0);
+				GET_VARIANT_PTR(b, 1);
+				GET_VARIANT_PTR(dst, 2);
+
+				operator_func(a, b, dst);
+
+				if (dst->booleanize()) {
+					int to = _code_ptr[ip + 7];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 8;
+				}
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT) {
+				// Overlays a validated operator and a jump-if-not testing its result.
+				CHECK_SPACE(8);
+
+				int operator_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(operator_idx < 0 || operator_idx >= _operator_funcs_count);
+				Variant::ValidatedOperatorEvaluator operator_func = _operator_funcs_ptr[operator_idx];
+
+				GET_VARIANT_PTR(a, 0);
+				GET_VARIANT_PTR(b, 1);
+				GET_VARIANT_PTR(dst, 2);
+
+				operator_func(a, b, dst);
+
+				if (!dst->booleanize()) {
+					int to = _code_ptr[ip + 7];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 8;
+				}
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_GET_MEMBER_OPERATOR_VALIDATED) {
+				// Overlays a member read and a validated operator using it.
+				CHECK_SPACE(8);
+				GET_VARIANT_PTR(member, 0);
+				int indexname = _code_ptr[ip + 2];
+				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
+				const StringName *index = &_global_names_ptr[indexname];
+#ifndef DEBUG_ENABLED
+				ClassDB::get_property(p_instance->owner, *index, *member);
+#else
+				bool ok = ClassDB::get_property(p_instance->owner, *index, *member);
+				if (!ok) {
+					err_text = "Internal error getting property: " + String(*index);
+					OPCODE_BREAK;
+				}
+#endif
+
+				int operator_idx = _code_ptr[ip + 7];
+				GD_ERR_BREAK(operator_idx < 0 || operator_idx >= _operator_funcs_count);
+				Variant::ValidatedOperatorEvaluator operator_func = _operator_funcs_ptr[operator_idx];
+
+				GET_VARIANT_PTR(a, 3);
+				GET_VARIANT_PTR(b, 4);
+				GET_VARIANT_PTR(dst, 5);
+
+				operator_func(a, b, dst);
+
+				ip += 8;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_RETURN) {
 				CHECK_SPACE(2);
 				GET_VARIANT_PTR(r, 0);
@@ -2761,6 +3228,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 
 			OPCODE(OPCODE_ITERATE_BEGIN) {
+				TRACE_IP();
 				CHECK_SPACE(8); // Space for this and a regular iterate.
 
 				GET_VARIANT_PTR(counter, 0);
@@ -3078,6 +3546,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE_ITERATE_BEGIN_PACKED_ARRAY(VECTOR4, Vector4, get_vector4_array, VECTOR4, Vector4, get_vector4);
 
 			OPCODE(OPCODE_ITERATE_BEGIN_OBJECT) {
+				TRACE_IP();
 				CHECK_SPACE(4);
 
 				GET_VARIANT_PTR(counter, 0);
@@ -3138,6 +3607,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_ITERATE) {
+				TRACE_IP();
 				CHECK_SPACE(4);
 
 				GET_VARIANT_PTR(counter, 0);
@@ -3414,6 +3884,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE_ITERATE_PACKED_ARRAY(VECTOR4, Vector4, get_vector4_array, get_vector4);
 
 			OPCODE(OPCODE_ITERATE_OBJECT) {
+				TRACE_IP();
 				CHECK_SPACE(4);
 
 				GET_VARIANT_PTR(counter, 0);
@@ -3665,12 +4136,38 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 		// Get a default return type in case of failure
 		retvalue = _get_default_variant_for_data_type(return_type);
+#elif defined(GDSCRIPT_LINE_TRACES)
+		// Release builds only detect a few errors, but those should still say where they happened.
+		if (!err_text.is_empty()) {
+			String err_file = script ? script->path : String();
+			if (err_file.is_empty()) {
+				err_file = "<built-in>";
+			}
+			int err_line = get_line_at(ip);
+			if (err_line < 0) {
+				err_line = line;
+			}
+			TRACE_IP();
+			_err_print_error(String(name).utf8().get_data(), err_file.utf8().get_data(), err_line, err_text.utf8().get_data(), false, ERR_HANDLER_SCRIPT);
+		}
 #endif
 
 		OPCODE_OUT;
 	}
+#ifndef DEBUG_ENABLED
+	} // if (native_body)
+#endif
 
 	OPCODES_OUT
+	if (sample_frame) {
+		GDScriptSamplingProfiler::exit_function();
+	}
+#ifdef GDSCRIPT_LINE_TRACES
+	if (traced_ip) {
+		GDScriptLanguage::get_singleton()->exit_traced_function();
+	}
+#endif
+
 #ifdef DEBUG_ENABLED
 	if (GDScriptLanguage::get_singleton()->profiling) {
 		uint64_t time_taken = OS::get_singleton()->get_ticks_usec() - function_start_time;
@@ -3693,8 +4190,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 		// Free stack, except reserved addresses.
-		for (int i = FIXED_ADDRESSES_MAX; i < _stack_size; i++) {
-			stack[i].~Variant();
+		if (!stack_moved) {
+			for (int i = FIXED_ADDRESSES_MAX; i < _stack_size; i++) {
+				stack[i].~Variant();
+			}
 		}
 #ifdef DEBUG_ENABLED
 	}
@@ -32,6 +32,7 @@
 
 #include "gdscript.h"
 #include "gdscript_cache.h"
+#include "gdscript_native.h"
 #include "gdscript_parser.h"
 #include "gdscript_tokenizer_buffer.h"
 #include "gdscript_utility_functions.h"
@@ -81,18 +82,56 @@ class EditorExportGDScript : public EditorExportPlugin {
 	static constexpr int DEFAULT_SCRIPT_MODE = EditorExportPreset::MODE_SCRIPT_BINARY_TOKENS_COMPRESSED;
 	int script_mode = DEFAULT_SCRIPT_MODE;
 
+	String native_source_path;
+	HashMap<uint64_t, String> native_definitions;
+
+	void _generate_native_bodies(const Ref<GDScript> &p_script) {
+		for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->get_member_functions()) {
+			uint64_t hash = GDScriptNative::hash_function(E.value);
+			if (hash == 0 || native_definitions.has(hash)) {
+				continue;
+			}
+			String definition = GDScriptNative::generate_body(E.value);
+			if (!definition.is_empty()) {
+				native_definitions[hash] = definition;
+			}
+		}
+		for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->get_subclasses()) {
+			_generate_native_bodies(E.value);
+		}
+	}
+
 protected:
+	virtual void _get_export_options(const Ref<EditorExportPlatform> &p_export_platform, List<EditorExportPlatform::ExportOption> *r_options) const override {
+		// Writes C++ for the functions that can be compiled ahead of time, to build into a custom export template.
+		r_options->push_back(EditorExportPlatform::ExportOption(PropertyInfo(Variant::STRING, "gdscript/native_source_path", PROPERTY_HINT_GLOBAL_SAVE_FILE, "*.cpp"), ""));
+	}
+
 	virtual void _export_begin(const HashSet<String> &p_features, bool p_debug, const String &p_path, int p_flags) override {
 		script_mode = DEFAULT_SCRIPT_MODE;
+		native_source_path = String();
+		native_definitions.clear();
 
 		const Ref<EditorExportPreset> &preset = get_export_preset();
 		if (preset.is_valid()) {
 			script_mode = preset->get_script_export_mode();
+			native_source_path = get_option("gdscript/native_source_path");
 		}
 	}
 
 	virtual void _export_file(const String &p_path, const String &p_type, const HashSet<String> &p_features) override {
-		if (p_path.get_extension() != "gd" || script_mode == EditorExportPreset::MODE_SCRIPT_TEXT) {
+		if (p_path.get_extension() != "gd") {
+			return;
+		}
+
+		if (!native_source_path.is_empty()) {
+			Ref<GDScript> script = ResourceLoader::load(p_path);
+			if (script.is_valid() && script->is_valid()) {
+				_generate_native_bodies(script);
+			}
+		}
+
+		if (script_mode == EditorExportPreset::MODE_SCRIPT_TEXT) {
 			return;
 		}
 
@@ -112,6 +151,17 @@ protected:
 		add_file(p_path.get_basename() + ".gdc", file, true);
 	}
 
+	virtual void _export_end() override {
+		if (native_source_path.is_empty()) {
+			return;
+		}
+
+		Ref<FileAccess> f = FileAccess::open(native_source_path, FileAccess::WRITE);
+		ERR_FAIL_COND_MSG(f.is_null(), vformat("Cannot write GDScript native source to \"%s\".", native_source_path));
+		f->store_string(GDScriptNative::generate_source(native_definitions));
+		native_definitions.clear();
+	}
+
 public:
 	virtual String get_name() const override { return "GDScript"; }
 };
@@ -153,6 +203,10 @@ void initialize_gdscript_module(ModuleInitializationLevel p_level) {
 		gdscript_cache = memnew(GDScriptCache);
 
 		GDScriptUtilityFunctions::register_functions();
+
+#ifdef GDSCRIPT_NATIVE_BODIES_ENABLED
+		register_gdscript_native_bodies();
+#endif
 	}
 
 #ifdef TOOLS_ENABLED
@@ -218,9 +272,19 @@ void test_bytecode() {
 	GDScriptTests::test(GDScriptTests::TestType::TEST_BYTECODE);
 }
 
+void test_bytecode_cache() {
+	GDScriptTests::test(GDScriptTests::TestType::TEST_BYTECODE_CACHE);
+}
+
+void test_await() {
+	GDScriptTests::test(GDScriptTests::TestType::TEST_AWAIT);
+}
+
 REGISTER_TEST_COMMAND("gdscript-tokenizer", &test_tokenizer);
 REGISTER_TEST_COMMAND("gdscript-tokenizer-buffer", &test_tokenizer_buffer);
 REGISTER_TEST_COMMAND("gdscript-parser", &test_parser);
 REGISTER_TEST_COMMAND("gdscript-compiler", &test_compiler);
 REGISTER_TEST_COMMAND("gdscript-bytecode", &test_bytecode);
+REGISTER_TEST_COMMAND("gdscript-bytecode-cache", &test_bytecode_cache);
+REGISTER_TEST_COMMAND("gdscript-await", &test_await);
 #endif
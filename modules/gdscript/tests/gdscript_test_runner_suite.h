@@ -32,6 +32,17 @@
 
 #include "gdscript_test_runner.h"
 
+#include "../gdscript_analyzer.h"
+#include "../gdscript_byte_code_optimizer.h"
+#include "../gdscript_bytecode_cache.h"
+#include "../gdscript_compiler.h"
+#include "../gdscript_native.h"
+#include "../gdscript_parser.h"
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/marshalls.h"
+
 #include "tests/test_macros.h"
 
 namespace GDScriptTests {
@@ -69,8 +80,372 @@ func _init():
 	ref_counted->set_script(gdscript);
 	CHECK_MESSAGE(int(ref_counted->get_meta("result")) == 42, "The script should assign object metadata successfully.");
 }
+
+TEST_CASE("[Modules][GDScript] Native bodies match the bytecode VM") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+static func sum_range(n: int) -> int:
+	var total: int = 0
+	for i in n:
+		total = total + i * i
+	return total
+
+static func clamp_float(x: float, low: float, high: float) -> float:
+	if x < low:
+		return low
+	elif x > high:
+		return high
+	return x
+
+static func is_between(x: int, low: int, high: int) -> bool:
+	return x >= low and x <= high
+
+static func collatz_steps(n: int) -> int:
+	var steps: int = 0
+	while n > 1:
+		if n % 2 == 0:
+			n = n / 2
+		else:
+			n = 3 * n + 1
+		steps = steps + 1
+	return steps
+
+static func lerp_vector(from: Vector3, to: Vector3, weight: float) -> Vector3:
+	return from + (to - from) * weight
+
+static func untyped(a, b):
+	var c = a
+	if b:
+		c = b
+	return c
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	HashMap<StringName, Vector<Vector<Variant>>> inputs;
+	inputs["sum_range"] = { Vector<Variant>{ 0 }, Vector<Variant>{ 1 }, Vector<Variant>{ 10 }, Vector<Variant>{ -5 }, Vector<Variant>{ 1000 } };
+	inputs["clamp_float"] = { Vector<Variant>{ -1.5, 0.0, 1.0 }, Vector<Variant>{ 0.25, 0.0, 1.0 }, Vector<Variant>{ 3, 0, 1 }, Vector<Variant>{ 0.5, 1.0, 0.0 } };
+	inputs["is_between"] = { Vector<Variant>{ 5, 0, 10 }, Vector<Variant>{ 0, 0, 0 }, Vector<Variant>{ -1, 0, 10 }, Vector<Variant>{ 11, 0, 10 } };
+	inputs["collatz_steps"] = { Vector<Variant>{ 1 }, Vector<Variant>{ 6 }, Vector<Variant>{ 27 }, Vector<Variant>{ -3 } };
+	inputs["lerp_vector"] = { Vector<Variant>{ Vector3(), Vector3(1, 2, 3), 0.5 }, Vector<Variant>{ Vector3(-1, 0, 1), Vector3(1, 0, -1), 2 } };
+	inputs["untyped"] = { Vector<Variant>{ 1, 2 }, Vector<Variant>{ "a", Variant() }, Vector<Variant>{ Vector3(1, 1, 1), false } };
+
+	int eligible_count = 0;
+	for (const KeyValue<StringName, GDScriptFunction *> &E : gdscript->get_member_functions()) {
+		GDScriptFunction *function = E.value;
+		if (GDScriptNative::hash_function(function) == 0) {
+			continue;
+		}
+		eligible_count++;
+		CHECK_MESSAGE(!GDScriptNative::generate_body(function).is_empty(), vformat("A body should be generated for `%s()`.", E.key));
+
+		Vector<Vector<Variant>> calls;
+		if (inputs.has(E.key)) {
+			calls = inputs[E.key];
+		}
+		// Wrong argument counts must be rejected the same way.
+		Vector<Variant> too_many;
+		too_many.resize(function->get_argument_count() + 1);
+		calls.push_back(too_many);
+		if (function->get_argument_count() > 0) {
+			calls.push_back(Vector<Variant>());
+		}
+
+		for (int call = 0; call < calls.size(); call++) {
+			const Vector<Variant> &args = calls[call];
+			Vector<const Variant *> arg_ptrs;
+			for (const Variant &arg : args) {
+				arg_ptrs.push_back(&arg);
+			}
+
+			Callable::CallError vm_error;
+			const Variant vm_result = function->call(nullptr, arg_ptrs.ptrw(), arg_ptrs.size(), vm_error);
+			Callable::CallError native_error;
+			const Variant native_result = GDScriptNative::execute(function, arg_ptrs.ptrw(), arg_ptrs.size(), native_error);
+
+			CHECK_MESSAGE(native_error.error == vm_error.error, vformat("Call %d of `%s()` should fail the same way in both.", call, E.key));
+			if (vm_error.error == Callable::CallError::CALL_OK) {
+				CHECK_MESSAGE(native_result.get_type() == vm_result.get_type(), vformat("Call %d of `%s()` should return the same type in both.", call, E.key));
+				CHECK_MESSAGE(native_result == vm_result, vformat("Call %d of `%s()` should return %s, got %s.", call, E.key, vm_result, native_result));
+			}
+		}
+	}
+	CHECK_MESSAGE(eligible_count > 0, "Some of the typed functions should be compiled ahead of time.");
+}
+
+// The cache stores the dependencies of a script with the hashes of their sources, so the script must be a file of the test project.
+static const String bytecode_cache_script = "res://bytecode_cache.notest.gd";
+
+static Ref<GDScript> compile_for_bytecode_cache() {
+	const String source = FileAccess::get_file_as_string(bytecode_cache_script);
+	GDScriptParser parser;
+	Error err = parser.parse(source, bytecode_cache_script, false);
+	if (err == OK) {
+		GDScriptAnalyzer analyzer(&parser);
+		err = analyzer.analyze();
+	}
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_path(bytecode_cache_script, true);
+	if (err == OK) {
+		GDScriptCompiler compiler;
+		err = compiler.compile(&parser, script.ptr(), false);
+	}
+	return err == OK ? script : Ref<GDScript>();
+}
+
+static Array make_array(const Vector<Variant> &p_values) {
+	Array array;
+	for (const Variant &value : p_values) {
+		array.push_back(value);
+	}
+	return array;
+}
+
+static Error load_from_bytecode_cache(const Vector<uint8_t> &p_buffer, Ref<GDScript> &r_script) {
+	r_script.instantiate();
+	r_script->set_path(bytecode_cache_script, true);
+	Error err = GDScriptBytecodeCache::make_scripts(r_script.ptr(), p_buffer);
+	if (err == OK) {
+		err = GDScriptBytecodeCache::deserialize(r_script.ptr(), p_buffer);
+	}
+	return err;
+}
+
+TEST_CASE("[Modules][GDScript] Bytecode cache round trip") {
+	Ref<DirAccess> dir = DirAccess::open("modules/gdscript/tests/scripts");
+	REQUIRE_MESSAGE(dir.is_valid(), "The GDScript test project should be found.");
+	init_language(dir->get_current_dir());
+
+	ERR_PRINT_OFF;
+	Ref<GDScript> compiled = compile_for_bytecode_cache();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(compiled.is_valid(), "The script should compile.");
+	Vector<uint8_t> buffer;
+	REQUIRE_MESSAGE(GDScriptBytecodeCache::serialize(compiled.ptr(), buffer) == OK, "The script should be stored in the cache.");
+
+	Ref<GDScript> cached;
+	REQUIRE_MESSAGE(load_from_bytecode_cache(buffer, cached) == OK, "The script should load from the cache.");
+	Vector<uint8_t> round_trip;
+	CHECK_MESSAGE(GDScriptBytecodeCache::serialize(cached.ptr(), round_trip) == OK, "The loaded script should be stored in the cache again.");
+	CHECK_MESSAGE(round_trip == buffer, "Storing the loaded script should give the same cache entry.");
+
+	Vector<Pair<StringName, Vector<Variant>>> calls;
+	calls.push_back({ "collatz", Vector<Variant>{ 27 } });
+	calls.push_back({ "classify", Vector<Variant>{ 4 } });
+	calls.push_back({ "classify", Vector<Variant>{ "text" } });
+	calls.push_back({ "classify", Vector<Variant>{ Array() } });
+	calls.push_back({ "classify", Vector<Variant>{ Vector3() } });
+	calls.push_back({ "filter_primes", Vector<Variant>{ make_array({ 1, 2, 3, 4, 5, 6, 7 }) } });
+	calls.push_back({ "count_with_inner", Vector<Variant>{ 10 } });
+	calls.push_back({ "map_with_lambda", Vector<Variant>{ make_array({ 1, 2, 3 }) } });
+	for (const Pair<StringName, Vector<Variant>> &call : calls) {
+		Vector<const Variant *> arg_ptrs;
+		for (const Variant &arg : call.second) {
+			arg_ptrs.push_back(&arg);
+		}
+		Callable::CallError compiled_error;
+		const Variant compiled_result = static_cast<Object *>(compiled.ptr())->callp(call.first, arg_ptrs.ptrw(), arg_ptrs.size(), compiled_error);
+		Callable::CallError cached_error;
+		const Variant cached_result = static_cast<Object *>(cached.ptr())->callp(call.first, arg_ptrs.ptrw(), arg_ptrs.size(), cached_error);
+
+		REQUIRE_MESSAGE(compiled_error.error == Callable::CallError::CALL_OK, vformat("`%s()` should run in the compiled script.", call.first));
+		CHECK_MESSAGE(cached_error.error == Callable::CallError::CALL_OK, vformat("`%s()` should run in the cached script.", call.first));
+		CHECK_MESSAGE(cached_result == compiled_result, vformat("`%s()` should return %s, got %s.", call.first, compiled_result, cached_result));
+	}
+
+	// Member variables and their initializers go through the instance.
+	const PackedInt32Array values = { 1, 2, 3 };
+	Ref<RefCounted> compiled_instance = memnew(RefCounted);
+	compiled_instance->set_script(compiled);
+	Ref<RefCounted> cached_instance = memnew(RefCounted);
+	cached_instance->set_script(cached);
+	CHECK(int(cached_instance->call("accumulate", values)) == int(compiled_instance->call("accumulate", values)));
+	CHECK(int(cached_instance->call("accumulate", values)) == 22);
+
+	compiled_instance.unref();
+	cached_instance.unref();
+	compiled.unref();
+	cached.unref();
+	finish_language();
+}
+
+TEST_CASE("[Modules][GDScript] Bytecode cache rejects damaged entries") {
+	Ref<DirAccess> dir = DirAccess::open("modules/gdscript/tests/scripts");
+	REQUIRE_MESSAGE(dir.is_valid(), "The GDScript test project should be found.");
+	init_language(dir->get_current_dir());
+
+	ERR_PRINT_OFF;
+	Vector<uint8_t> buffer;
+	{
+		Ref<GDScript> compiled = compile_for_bytecode_cache();
+		REQUIRE_MESSAGE(compiled.is_valid(), "The script should compile.");
+		REQUIRE_MESSAGE(GDScriptBytecodeCache::serialize(compiled.ptr(), buffer) == OK, "The script should be stored in the cache.");
+	}
+
+	SUBCASE("Truncated entries") {
+		const int step = MAX(1, buffer.size() / 200);
+		for (int size = 0; size < buffer.size(); size += step) {
+			Ref<GDScript> script;
+			CHECK_MESSAGE(load_from_bytecode_cache(buffer.slice(0, size), script) != OK, vformat("An entry cut at %d bytes should be rejected.", size));
+		}
+		Ref<GDScript> script;
+		CHECK_MESSAGE(load_from_bytecode_cache(buffer.slice(0, buffer.size() - 1), script) != OK, "An entry missing its last byte should be rejected.");
+		Vector<uint8_t> extended = buffer;
+		extended.push_back(0);
+		CHECK_MESSAGE(load_from_bytecode_cache(extended, script) != OK, "An entry with trailing data should be rejected.");
+	}
+
+	// The header ends with the size of the body and its checksum.
+	int body_start = 0;
+	for (int i = 0; i + 8 <= buffer.size(); i++) {
+		const uint32_t body_size = buffer.size() - i - 8;
+		if (decode_uint32(buffer.ptr() + i) == body_size && decode_uint32(buffer.ptr() + i + 4) == hash_murmur3_buffer(buffer.ptr() + i + 8, body_size)) {
+			body_start = i + 8;
+			break;
+		}
+	}
+	REQUIRE_MESSAGE(body_start > 0, "The body of the entry should be found.");
+
+	SUBCASE("Corrupted bodies are caught by the checksum") {
+		for (int i = body_start; i < buffer.size(); i += 7) {
+			Vector<uint8_t> corrupted = buffer;
+			corrupted.write[i] ^= 0x5a;
+			Ref<GDScript> script;
+			CHECK_MESSAGE(load_from_bytecode_cache(corrupted, script) != OK, vformat("An entry with byte %d changed should be rejected.", i));
+		}
+	}
+
+	SUBCASE("Corrupted bodies with a valid checksum") {
+		// Entries that pass the checksum are still checked while reading, so the loader must not crash on any of them.
+		// Some changes are harmless (e.g. a different character in a name), so not all of them are rejected.
+		int rejected = 0;
+		const uint8_t patterns[] = { 0x01, 0x80, 0xff };
+		for (int i = body_start; i < buffer.size(); i++) {
+			for (uint8_t pattern : patterns) {
+				Vector<uint8_t> corrupted = buffer;
+				corrupted.write[i] ^= pattern;
+				const uint32_t body_size = corrupted.size() - body_start;
+				encode_uint32(hash_murmur3_buffer(corrupted.ptr() + body_start, body_size), corrupted.ptrw() + body_start - 4);
+				Ref<GDScript> script;
+				if (load_from_bytecode_cache(corrupted, script) != OK) {
+					rejected++;
+				}
+			}
+		}
+		CHECK_MESSAGE(rejected > 0, "Corrupted entries should be rejected.");
+	}
+	ERR_PRINT_ON;
+
+	finish_language();
+}
 #endif // TOOLS_ENABLED
 
+#ifndef GDSCRIPT_LINE_TRACES // Functions are already stripped of their lines there.
+TEST_CASE("[Modules][GDScript] Line tables map code positions to lines") {
+	const String source = R"(
+extends RefCounted
+
+func branches(value):
+	var result = 0
+	if value > 10:
+		result = "big"
+	elif value < 0:
+		result = "negative"
+	else:
+		result = "small"
+	return result
+
+func loops(count):
+	var total = 0
+	for i in range(count):
+		if i % 2 == 0:
+			continue
+		total += i
+	while total > 100:
+		total -= 7
+	return total
+
+func matching(value):
+	match value:
+		1:
+			return "one"
+		"two":
+			return 2
+	return null
+)";
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(source);
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	const Vector<String> source_lines = source.split("\n");
+	for (const KeyValue<StringName, GDScriptFunction *> &E : gdscript->get_member_functions()) {
+		const GDScriptFunction *function = E.value;
+		const int *original = function->get_code();
+		const int original_size = function->get_code_size();
+
+		// The line of each instruction is the one of the last `OPCODE_LINE` before it.
+		LocalVector<int> expected_lines;
+		int line = -1;
+		for (int ip = 0; ip < original_size;) {
+			if (original[ip] == GDScriptFunction::OPCODE_LINE) {
+				line = original[ip + 1];
+			} else {
+				expected_lines.push_back(line);
+			}
+			const int length = GDScriptByteCodeOptimizer::get_instruction_length(original, original_size, ip);
+			REQUIRE(length > 0);
+			ip += length;
+		}
+
+		// Strips the lines the way release builds with line traces do. There are no temporaries left to optimize.
+		Vector<int> code;
+		code.resize(original_size);
+		memcpy(code.ptrw(), original, original_size * sizeof(int));
+		Vector<int> default_arguments;
+		HashMap<int, Variant::Type> local_copies;
+		Vector<GDScriptFunction::LinePosition> line_table;
+		GDScriptByteCodeOptimizer optimizer(code, default_arguments, function->get_max_stack_size(), 0, local_copies);
+		optimizer.set_line_table(&line_table);
+		optimizer.optimize();
+		REQUIRE_MESSAGE(!line_table.is_empty(), vformat("`%s()` should have a line table.", E.key));
+
+		uint32_t instruction = 0;
+		for (int ip = 0; ip < code.size(); instruction++) {
+			REQUIRE_MESSAGE(code[ip] != GDScriptFunction::OPCODE_LINE, vformat("`%s()` should have no lines left in its code.", E.key));
+			REQUIRE_MESSAGE(instruction < expected_lines.size(), vformat("`%s()` should only lose its lines.", E.key));
+			if (expected_lines[instruction] >= 0) {
+				CHECK_MESSAGE(GDScriptFunction::find_line(line_table, ip) == expected_lines[instruction], vformat("Position %d of `%s()` should be on line %d.", ip, E.key, expected_lines[instruction]));
+			}
+			ip += GDScriptByteCodeOptimizer::get_instruction_length(code.ptr(), code.size(), ip);
+		}
+		CHECK_MESSAGE(instruction == expected_lines.size(), vformat("`%s()` should only lose its lines.", E.key));
+
+		for (const GDScriptFunction::LinePosition &entry : line_table) {
+			CHECK_MESSAGE((entry.line > 0 && entry.line <= source_lines.size()), vformat("`%s()` should only have lines of the script.", E.key));
+		}
+
+		if (E.key == StringName("branches")) {
+			// Each branch starts a line of its own.
+			for (const char *assignment : { "result = \"big\"", "result = \"negative\"", "result = \"small\"" }) {
+				bool found = false;
+				for (const GDScriptFunction::LinePosition &entry : line_table) {
+					found = found || (entry.line > 0 && entry.line <= source_lines.size() && source_lines[entry.line - 1].strip_edges() == assignment);
+				}
+				CHECK_MESSAGE(found, vformat("`%s` should have a line of its own.", assignment));
+			}
+		}
+	}
+}
+#endif // GDSCRIPT_LINE_TRACES
+
 TEST_CASE("[Modules][GDScript] Validate built-in API") {
 	GDScriptLanguage *lang = GDScriptLanguage::get_singleton();
 
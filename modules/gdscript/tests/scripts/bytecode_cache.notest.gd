@@ -0,0 +1,61 @@
+# Loaded through the bytecode cache by `gdscript_test_runner_suite.h`, the results are compared with the compiled script.
+extends RefCounted
+
+const PRIMES = [2, 3, 5, 7, 11]
+
+class Counter:
+	var count := 0
+
+	func add(amount: int) -> int:
+		count += amount
+		return count
+
+var total := 10
+
+
+static func collatz(n: int) -> int:
+	var steps := 0
+	while n != 1:
+		if n % 2 == 0:
+			n = n / 2
+		else:
+			n = 3 * n + 1
+		steps += 1
+	return steps
+
+
+static func classify(value: Variant) -> String:
+	match typeof(value):
+		TYPE_INT:
+			return "int %d" % value
+		TYPE_STRING:
+			return "string " + value
+		TYPE_ARRAY:
+			return "array of %d" % value.size()
+	return "other"
+
+
+static func filter_primes(values: Array) -> Array[int]:
+	var result: Array[int] = []
+	for value in values:
+		if value in PRIMES:
+			result.append(value)
+	return result
+
+
+static func count_with_inner(times: int) -> int:
+	var counter := Counter.new()
+	for i in range(times):
+		counter.add(i)
+	return counter.count
+
+
+static func map_with_lambda(values: Array) -> Array:
+	var offset := 3
+	return values.map(func(value): return value * 2 + offset)
+
+
+func accumulate(values: PackedInt32Array) -> int:
+	for value in values:
+		total += value
+	return total
@@ -0,0 +1,57 @@
+extends Node
+
+# Patterns rewritten by the bytecode optimizer: operator results copied into locals,
+# comparisons feeding branches, chains of jumps and native members used in operators.
+
+func count_odd(limit: int) -> int:
+	var total := 0
+	var i := 0
+	while i < limit:
+		i += 1
+		if i % 2 == 0:
+			continue
+		total += i
+	return total
+
+func find_product(product: int) -> int:
+	var found := -1
+	for a in 5:
+		for b in 5:
+			if a * b == product:
+				found = a * 10 + b
+				break
+		if found >= 0:
+			break
+	return found
+
+func pick(flag: bool) -> int:
+	return 1 if flag else 2
+
+func test():
+	print(count_odd(10))
+	print(count_odd(0))
+
+	print(find_product(6))
+	print(find_product(7))
+
+	var v := Vector3(1, 2, 3)
+	v = v * 2.0 + v
+	print(v == Vector3(3, 6, 9))
+
+	var f := 0.0
+	for _k in 4:
+		f += 0.5
+	print(f)
+
+	var total := count_odd(10)
+	var magnitude := "big" if total > 10 else "small"
+	print(magnitude)
+
+	print(pick(true))
+	print(pick(false))
+
+	process_priority = 3
+	var doubled := process_priority + process_priority
+	print(doubled)
+	var shifted := process_priority * 10 + 1
+	print(shifted)
@@ -0,0 +1,86 @@
+# Untyped property accesses and method calls are cached per call site.
+# The same site must keep working as the type of its base changes.
+
+class A:
+	var value = 1
+	var typed: int = 10
+	func describe():
+		return "A %d" % value
+
+class B:
+	var padding = 0
+	var value = 2
+	var typed: int = 20
+	func describe():
+		return "B %d" % value
+
+class C extends A:
+	var extra = 3
+	func describe():
+		return "C %d" % (value + extra)
+
+class D:
+	var value = 4
+	var typed: int = 40
+	func describe():
+		return "D %d" % value
+
+class E:
+	var value = 5
+	var typed: int = 50
+	func describe():
+		return "E %d" % value
+
+class WithAccessors:
+	var value = 0:
+		set(v):
+			value = v * 2
+		get:
+			return value + 1
+	var typed: int = 0
+	func describe():
+		return "WithAccessors"
+
+func read_value(obj):
+	return obj.value
+
+func write_value(obj, v):
+	obj.value = v
+
+func write_typed(obj, v):
+	obj.typed = v
+
+func describe(obj):
+	return obj.describe()
+
+func test():
+	var objects = [A.new(), B.new(), C.new(), D.new(), E.new(), A.new()]
+	for _pass in 2:
+		var line = []
+		for obj in objects:
+			line.push_back("%s/%s" % [read_value(obj), describe(obj)])
+		print(" ".join(line))
+
+	for i in objects.size():
+		write_value(objects[i], i * 10)
+	print(objects.map(read_value))
+
+	write_typed(objects[0], 7.9)
+	write_typed(objects[1], 8)
+	print(objects[0].typed, " ", objects[1].typed)
+
+	var accessors = WithAccessors.new()
+	write_value(accessors, 3)
+	print(read_value(accessors), " ", describe(accessors))
+
+	var resource = Resource.new()
+	write_property(resource, "First")
+	print(resource.resource_name)
+	write_property(resource, "Second")
+	print(read_property(resource))
+
+func write_property(obj, v):
+	obj.resource_name = v
+
+func read_property(obj):
+	return obj.resource_name
@@ -0,0 +1,75 @@
+# Loops that only update each element of a packed float array are compiled to bulk methods.
+# Results must match the same operations done one element at a time.
+
+func make_array(size: int) -> PackedFloat32Array:
+	var array := PackedFloat32Array()
+	array.resize(size)
+	for i in size:
+		array.set(i, sin(i * 0.37) * 3.0)
+	return array
+
+func make_array_64(size: int) -> PackedFloat64Array:
+	var array := PackedFloat64Array()
+	array.resize(size)
+	for i in size:
+		array.set(i, cos(i * 0.29) * 2.0)
+	return array
+
+func test():
+	var scale := 0.1
+	var offset := 0.3
+	var count := 3
+
+	var a := make_array(23)
+	var expected := make_array(23)
+	for i in a.size():
+		a[i] += offset
+	for i in expected.size():
+		expected.set(i, expected.get(i) + offset)
+	print(a == expected)
+
+	for i in range(a.size()):
+		a[i] -= scale
+	for i in expected.size():
+		expected.set(i, expected.get(i) - scale)
+	print(a == expected)
+
+	for i in a.size():
+		a[i] *= count
+	for i in expected.size():
+		expected.set(i, expected.get(i) * count)
+	print(a == expected)
+
+	for i in a.size():
+		a[i] = a[i] * scale + offset
+	for i in expected.size():
+		expected.set(i, expected.get(i) * scale + offset)
+	print(a == expected)
+
+	for i in a.size():
+		a[i] = clamp(a[i], 0.25, 0.5)
+	for i in expected.size():
+		expected.set(i, clampf(expected.get(i), 0.25, 0.5))
+	print(a == expected)
+
+	var b := make_array_64(23)
+	var c := make_array_64(23)
+	var expected_64 := make_array_64(23)
+	for i in b.size():
+		b[i] += c[i]
+	for i in expected_64.size():
+		expected_64.set(i, expected_64.get(i) + c.get(i))
+	print(b == expected_64)
+
+	for i in b.size():
+		b[i] = lerp(b[i], c[i], scale)
+	for i in expected_64.size():
+		expected_64.set(i, lerpf(expected_64.get(i), c.get(i), scale))
+	print(b == expected_64)
+
+	# Arrays of different sizes keep the behavior of the loop.
+	var short := PackedFloat64Array([1.0, 2.0])
+	var long := PackedFloat64Array([1.0, 2.0, 3.0])
+	for i in short.size():
+		short[i] *= long[i]
+	print(short)
@@ -0,0 +1,38 @@
+# Operators on typed int, float and Vector3 operands use dedicated instructions.
+
+func test():
+	var a := 7
+	var b := -3
+	print(a + b)
+	print(a - b)
+	print(a * b)
+	print(a == b, a != b)
+	print(a < b, a <= b, a > b, a >= b)
+	print(a <= 7, a >= 7)
+
+	var x := 1.5
+	var y := 0.25
+	print(x + y)
+	print(x - y)
+	print(x * y)
+	print(x / y)
+	print(x == y, x != y)
+	print(x < y, x <= y, x > y, x >= y)
+
+	var v := Vector3(1, 2, 3)
+	var w := Vector3(0.5, 0.5, 0.5)
+	print(v + w == Vector3(1.5, 2.5, 3.5))
+	print(v - w == Vector3(0.5, 1.5, 2.5))
+	print(v * 2.0 == Vector3(2, 4, 6))
+
+	var i := 0
+	var sum := 0
+	while i < 100:
+		i += 1
+		sum += i
+	print(sum)
+
+	var t := 0.0
+	while t < 1.0:
+		t += 0.25
+	print(t)
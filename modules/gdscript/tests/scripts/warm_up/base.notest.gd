@@ -0,0 +1,8 @@
+# Used by `test_gdscript_cache.h`.
+extends RefCounted
+
+const VALUE = 1
+
+
+static func get_value() -> int:
+	return VALUE
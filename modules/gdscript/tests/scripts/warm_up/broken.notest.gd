@@ -0,0 +1,6 @@
+# Used by `test_gdscript_cache.h`, fails to parse.
+extends RefCounted
+
+
+func broken(:
+	pass
@@ -0,0 +1,12 @@
+# Used by `test_gdscript_cache.h`, depends on `cycle_b.notest.gd` which depends on this script.
+extends RefCounted
+
+const CycleB = preload("cycle_b.notest.gd")
+
+
+static func get_value() -> int:
+	return 2
+
+
+static func get_other() -> int:
+	return CycleB.get_value()
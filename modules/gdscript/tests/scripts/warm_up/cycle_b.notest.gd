@@ -0,0 +1,12 @@
+# Used by `test_gdscript_cache.h`, depends on `cycle_a.notest.gd` which depends on this script.
+extends RefCounted
+
+const CycleA = preload("cycle_a.notest.gd")
+
+
+static func get_value() -> int:
+	return 3
+
+
+static func get_other() -> int:
+	return CycleA.get_value()
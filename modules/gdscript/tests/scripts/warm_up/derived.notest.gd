@@ -0,0 +1,8 @@
+# Used by `test_gdscript_cache.h`.
+extends "base.notest.gd"
+
+const CycleA = preload("cycle_a.notest.gd")
+
+
+static func get_sum() -> int:
+	return get_value() + CycleA.get_value()
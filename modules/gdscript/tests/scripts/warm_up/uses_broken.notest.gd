@@ -0,0 +1,2 @@
+# Used by `test_gdscript_cache.h`, fails to analyze because its base fails to parse.
+extends "broken.notest.gd"
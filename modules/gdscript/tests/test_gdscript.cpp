@@ -31,6 +31,7 @@
 #include "test_gdscript.h"
 
 #include "../gdscript_analyzer.h"
+#include "../gdscript_bytecode_cache.h"
 #include "../gdscript_compiler.h"
 #include "../gdscript_parser.h"
 #include "../gdscript_tokenizer.h"
@@ -274,6 +275,122 @@ static void test_compiler(const String &p_code, const String &p_script_path, con
 	recursively_disassemble_functions(script, p_lines);
 }
 
+static void test_bytecode_cache(const String &p_code, const String &p_script_path) {
+	constexpr int ITERATIONS = 100;
+	const String path = ProjectSettings::get_singleton()->localize_path(p_script_path);
+
+	Vector<uint8_t> buffer;
+	uint64_t compile_usec = 0;
+	for (int i = 0; i < ITERATIONS; i++) {
+		uint64_t start = OS::get_singleton()->get_ticks_usec();
+
+		GDScriptParser parser;
+		Error err = parser.parse(p_code, path, false);
+		if (err == OK) {
+			GDScriptAnalyzer analyzer(&parser);
+			err = analyzer.analyze();
+		}
+		Ref<GDScript> script;
+		script.instantiate();
+		script->set_path(path, true);
+		if (err == OK) {
+			GDScriptCompiler compiler;
+			err = compiler.compile(&parser, script.ptr(), false);
+		}
+
+		compile_usec += OS::get_singleton()->get_ticks_usec() - start;
+
+		if (err != OK) {
+			print_line("Error compiling the script.");
+			return;
+		}
+		if (i == 0 && GDScriptBytecodeCache::serialize(script.ptr(), buffer) != OK) {
+			print_line("The script can't be stored in the bytecode cache (run with --verbose for details).");
+			return;
+		}
+	}
+
+	uint64_t load_usec = 0;
+	for (int i = 0; i < ITERATIONS; i++) {
+		uint64_t start = OS::get_singleton()->get_ticks_usec();
+
+		Ref<GDScript> script;
+		script.instantiate();
+		script->set_path(path, true);
+		Error err = GDScriptBytecodeCache::make_scripts(script.ptr(), buffer);
+		if (err == OK) {
+			err = GDScriptBytecodeCache::deserialize(script.ptr(), buffer);
+		}
+
+		load_usec += OS::get_singleton()->get_ticks_usec() - start;
+
+		if (err != OK) {
+			print_line(vformat("Error loading the script from the bytecode cache: %s", error_names[err]));
+			return;
+		}
+		if (i == ITERATIONS - 1) {
+			Vector<uint8_t> round_trip;
+			GDScriptBytecodeCache::serialize(script.ptr(), round_trip);
+			print_line(round_trip == buffer ? "Round trip: OK" : "Round trip: MISMATCH");
+		}
+	}
+
+	print_line(vformat("Cache entry size: %d bytes", buffer.size()));
+	print_line(vformat("Parse and compile: %.3f ms per load", compile_usec / 1000.0 / ITERATIONS));
+	print_line(vformat("Bytecode cache: %.3f ms per load", load_usec / 1000.0 / ITERATIONS));
+}
+
+// Runs many coroutines that await the same signal, to measure the cost of suspending and resuming them.
+// The script must define a `tick` signal and an `actor()` method that awaits it in a loop.
+static void test_await(const String &p_code, const String &p_script_path) {
+	constexpr int ACTORS = 10000;
+	constexpr int FRAMES = 100;
+	const String path = ProjectSettings::get_singleton()->localize_path(p_script_path);
+
+	GDScriptParser parser;
+	Error err = parser.parse(p_code, path, false);
+	if (err == OK) {
+		GDScriptAnalyzer analyzer(&parser);
+		err = analyzer.analyze();
+	}
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_path(path, true);
+	if (err == OK) {
+		GDScriptCompiler compiler;
+		err = compiler.compile(&parser, script.ptr(), false);
+	}
+	if (err != OK) {
+		print_line("Error compiling the script.");
+		return;
+	}
+	if (!script->has_method(SNAME("actor")) || !script->has_script_signal(SNAME("tick"))) {
+		print_line("This test expects the script to define a `tick` signal and an `actor()` method.");
+		return;
+	}
+
+	Ref<RefCounted> object;
+	object.instantiate();
+	object->set_script(script);
+
+	uint64_t start = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ACTORS; i++) {
+		object->call(SNAME("actor"));
+	}
+	uint64_t start_usec = OS::get_singleton()->get_ticks_usec() - start;
+
+	start = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < FRAMES; i++) {
+		object->emit_signal(SNAME("tick"));
+	}
+	uint64_t frames_usec = OS::get_singleton()->get_ticks_usec() - start;
+
+	print_line(vformat("Started %d coroutines in %.3f ms", ACTORS, start_usec / 1000.0));
+	print_line(vformat("Resumed all coroutines in %.3f ms per frame", frames_usec / 1000.0 / FRAMES));
+
+	object->set_script(Variant());
+}
+
 void test(TestType p_type) {
 	List<String> cmdlargs = OS::get_singleton()->get_cmdline_args();
 
@@ -340,6 +457,13 @@ void test(TestType p_type) {
 			break;
 		case TEST_BYTECODE:
 			print_line("Not implemented.");
+			break;
+		case TEST_BYTECODE_CACHE:
+			test_bytecode_cache(code, test);
+			break;
+		case TEST_AWAIT:
+			test_await(code, test);
+			break;
 	}
 
 	finish_language();
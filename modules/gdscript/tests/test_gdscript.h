@@ -42,6 +42,8 @@ enum TestType {
 	TEST_PARSER,
 	TEST_COMPILER,
 	TEST_BYTECODE,
+	TEST_BYTECODE_CACHE,
+	TEST_AWAIT,
 };
 
 void test(TestType p_type);
@@ -0,0 +1,220 @@
+/**************************************************************************/
+/*  test_gdscript_cache.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+
+#include "../gdscript_cache.h"
+#include "gdscript_test_runner.h"
+
+#include "core/io/dir_access.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+// The scripts are in the `warm_up` folder of the project of the other GDScript tests.
+static const char *cache_test_valid_scripts[] = {
+	"res://warm_up/base.notest.gd",
+	"res://warm_up/derived.notest.gd",
+	"res://warm_up/cycle_a.notest.gd",
+	"res://warm_up/cycle_b.notest.gd",
+};
+
+static const char *cache_test_invalid_scripts[] = {
+	"res://warm_up/broken.notest.gd",
+	"res://warm_up/uses_broken.notest.gd",
+	"res://warm_up/missing.notest.gd",
+};
+
+struct CacheTestRequest {
+	String path;
+	Error error = OK;
+	GDScriptParserRef::Status status = GDScriptParserRef::EMPTY;
+};
+
+static void cache_test_request_parsers(void *p_userdata) {
+	LocalVector<CacheTestRequest> &requests = *static_cast<LocalVector<CacheTestRequest> *>(p_userdata);
+	for (CacheTestRequest &request : requests) {
+		Ref<GDScriptParserRef> ref = GDScriptCache::get_parser(request.path, GDScriptParserRef::FULLY_SOLVED, request.error);
+		if (ref.is_valid()) {
+			request.status = ref->get_status();
+		}
+	}
+}
+
+static void cache_test_warm_up(void *p_userdata) {
+	GDScriptCache::warm_up(*static_cast<Vector<String> *>(p_userdata));
+}
+
+static void cache_test_init() {
+	Ref<DirAccess> dir = DirAccess::open("modules/gdscript/tests/scripts");
+	REQUIRE_MESSAGE(dir.is_valid(), "The GDScript test project should be found.");
+	init_language(dir->get_current_dir());
+}
+
+static bool cache_test_is_valid(const String &p_path) {
+	for (const char *path : cache_test_valid_scripts) {
+		if (p_path == path) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static Vector<String> cache_test_all_scripts() {
+	Vector<String> paths;
+	for (const char *path : cache_test_valid_scripts) {
+		paths.push_back(path);
+	}
+	for (const char *path : cache_test_invalid_scripts) {
+		paths.push_back(path);
+	}
+	return paths;
+}
+
+// Requests each of the scripts from several threads at once, each thread going through them in a different order.
+static void cache_test_request_from_threads(const Vector<String> &p_paths, LocalVector<CacheTestRequest> *r_requests, int p_thread_count) {
+	Thread *threads = memnew_arr(Thread, p_thread_count);
+	for (int i = 0; i < p_thread_count; i++) {
+		for (int j = 0; j < p_paths.size(); j++) {
+			CacheTestRequest request;
+			request.path = p_paths[(i + j) % p_paths.size()];
+			r_requests[i].push_back(request);
+		}
+		threads[i].start(cache_test_request_parsers, &r_requests[i]);
+	}
+	for (int i = 0; i < p_thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+	memdelete_arr(threads);
+}
+
+TEST_SUITE("[Modules][GDScript][GDScriptCache]") {
+	TEST_CASE("Requesting scripts while they warm up") {
+		cache_test_init();
+		ERR_PRINT_OFF;
+
+		constexpr int THREAD_COUNT = 4;
+		Vector<String> paths = cache_test_all_scripts();
+		Thread warm_up_thread;
+		warm_up_thread.start(cache_test_warm_up, &paths);
+		LocalVector<CacheTestRequest> requests[THREAD_COUNT];
+		cache_test_request_from_threads(paths, requests, THREAD_COUNT);
+		warm_up_thread.wait_to_finish();
+
+		ERR_PRINT_ON;
+
+		for (const LocalVector<CacheTestRequest> &thread_requests : requests) {
+			for (const CacheTestRequest &request : thread_requests) {
+				if (cache_test_is_valid(request.path)) {
+					CHECK_MESSAGE(request.error == OK, vformat(R"("%s" should be analyzed.)", request.path));
+					CHECK_MESSAGE(request.status == GDScriptParserRef::FULLY_SOLVED, vformat(R"("%s" should be fully solved.)", request.path));
+				} else {
+					CHECK_MESSAGE(request.error != OK, vformat(R"("%s" should fail.)", request.path));
+				}
+			}
+		}
+		for (const String &path : paths) {
+			CHECK_MESSAGE(GDScriptCache::take_warmed_up_parser(path).is_valid() == cache_test_is_valid(path), vformat(R"(Only valid scripts should be kept after warming up, "%s" is wrong.)", path));
+		}
+
+		finish_language();
+	}
+
+	TEST_CASE("Scripts failing to load while warming up") {
+		cache_test_init();
+		ERR_PRINT_OFF;
+
+		Vector<String> paths;
+		paths.push_back("res://warm_up/uses_broken.notest.gd");
+		paths.push_back("res://warm_up/missing.notest.gd");
+		paths.push_back("res://warm_up/base.notest.gd");
+		GDScriptCache::warm_up(paths);
+
+		// The broken base is found through the script extending it.
+		CHECK(GDScriptCache::take_warmed_up_parser("res://warm_up/broken.notest.gd").is_null());
+		CHECK(GDScriptCache::take_warmed_up_parser("res://warm_up/uses_broken.notest.gd").is_null());
+		CHECK(GDScriptCache::take_warmed_up_parser("res://warm_up/missing.notest.gd").is_null());
+		CHECK(GDScriptCache::take_warmed_up_parser("res://warm_up/base.notest.gd").is_valid());
+
+		// The errors are reported when the scripts are loaded.
+		Error error = OK;
+		Ref<GDScriptParserRef> ref = GDScriptCache::get_parser("res://warm_up/broken.notest.gd", GDScriptParserRef::FULLY_SOLVED, error);
+		CHECK(error == ERR_PARSE_ERROR);
+		ref = GDScriptCache::get_parser("res://warm_up/uses_broken.notest.gd", GDScriptParserRef::FULLY_SOLVED, error);
+		CHECK(error != OK);
+		ref = GDScriptCache::get_parser("res://warm_up/missing.notest.gd", GDScriptParserRef::FULLY_SOLVED, error);
+		CHECK(error == ERR_FILE_NOT_FOUND);
+		ref.unref();
+
+		ERR_PRINT_ON;
+		finish_language();
+	}
+
+	TEST_CASE("Waiting for a script raised by another thread") {
+		cache_test_init();
+		ERR_PRINT_OFF;
+
+		// Threads requesting the same script wait for the one raising it. Each round starts from scratch, since the parsers
+		// are freed with the last request holding them. The cyclic scripts make threads wait for each other's parsers.
+		constexpr int THREAD_COUNT = 4;
+		constexpr int ROUNDS = 20;
+		Vector<String> failing;
+		failing.push_back("res://warm_up/uses_broken.notest.gd");
+		failing.push_back("res://warm_up/broken.notest.gd");
+		Vector<String> cyclic;
+		cyclic.push_back("res://warm_up/cycle_a.notest.gd");
+		cyclic.push_back("res://warm_up/cycle_b.notest.gd");
+		for (int round = 0; round < ROUNDS; round++) {
+			LocalVector<CacheTestRequest> failing_requests[THREAD_COUNT];
+			cache_test_request_from_threads(failing, failing_requests, THREAD_COUNT);
+			for (const LocalVector<CacheTestRequest> &thread_requests : failing_requests) {
+				for (const CacheTestRequest &request : thread_requests) {
+					CHECK_MESSAGE(request.error != OK, vformat(R"(Every thread should see "%s" fail.)", request.path));
+				}
+			}
+
+			LocalVector<CacheTestRequest> cyclic_requests[THREAD_COUNT];
+			cache_test_request_from_threads(cyclic, cyclic_requests, THREAD_COUNT);
+			for (const LocalVector<CacheTestRequest> &thread_requests : cyclic_requests) {
+				for (const CacheTestRequest &request : thread_requests) {
+					CHECK_MESSAGE(request.error == OK, vformat(R"(Every thread should see "%s" analyzed.)", request.path));
+				}
+			}
+		}
+
+		ERR_PRINT_ON;
+		finish_language();
+	}
+}
+
+} // namespace GDScriptTests
@@ -30,6 +30,8 @@
 
 #include "rigid_body_2d.h"
 
+#include "core/os/frame_arena.h"
+
 void RigidBody2D::_body_enter_tree(ObjectID p_id) {
 	Object *obj = ObjectDB::get_instance(p_id);
 	Node *node = Object::cast_to<Node>(obj);
@@ -190,9 +192,11 @@ void RigidBody2D::_body_state_changed(PhysicsDirectBodyState2D *p_state) {
 			}
 		}
 
-		_RigidBody2DInOut *toadd = (_RigidBody2DInOut *)alloca(p_state->get_contact_count() * sizeof(_RigidBody2DInOut));
+		FrameLocalVector<_RigidBody2DInOut> toadd;
+		toadd.resize(p_state->get_contact_count());
 		int toadd_count = 0; //state->get_contact_count();
-		RigidBody2D_RemoveAction *toremove = (RigidBody2D_RemoveAction *)alloca(rc * sizeof(RigidBody2D_RemoveAction));
+		FrameLocalVector<RigidBody2D_RemoveAction> toremove;
+		toremove.resize(rc);
 		int toremove_count = 0;
 
 		//put the ones to add
@@ -30,6 +30,8 @@
 
 #include "rigid_body_3d.h"
 
+#include "core/os/frame_arena.h"
+
 void RigidBody3D::_body_enter_tree(ObjectID p_id) {
 	Object *obj = ObjectDB::get_instance(p_id);
 	Node *node = Object::cast_to<Node>(obj);
@@ -190,9 +192,11 @@ void RigidBody3D::_body_state_changed(PhysicsDirectBodyState3D *p_state) {
 			}
 		}
 
-		_RigidBodyInOut *toadd = (_RigidBodyInOut *)alloca(p_state->get_contact_count() * sizeof(_RigidBodyInOut));
+		FrameLocalVector<_RigidBodyInOut> toadd;
+		toadd.resize(p_state->get_contact_count());
 		int toadd_count = 0;
-		RigidBody3D_RemoveAction *toremove = (RigidBody3D_RemoveAction *)alloca(rc * sizeof(RigidBody3D_RemoveAction));
+		FrameLocalVector<RigidBody3D_RemoveAction> toremove;
+		toremove.resize(rc);
 		int toremove_count = 0;
 
 		//put the ones to add
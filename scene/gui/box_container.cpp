@@ -30,6 +30,7 @@
 
 #include "box_container.h"
 
+#include "core/os/frame_arena.h"
 #include "scene/gui/label.h"
 #include "scene/gui/margin_container.h"
 #include "scene/theme/theme_db.h"
@@ -52,7 +53,7 @@ void BoxContainer::_resort() {
 	int stretch_min = 0;
 	int stretch_avail = 0;
 	float stretch_ratio_total = 0.0;
-	HashMap<Control *, _MinSizeCache> min_size_cache;
+	FrameHashMap<Control *, _MinSizeCache> min_size_cache;
 
 	for (int i = 0; i < get_child_count(); i++) {
 		Control *c = as_sortable_control(get_child(i));
@@ -30,6 +30,7 @@
 
 #include "flow_container.h"
 
+#include "core/os/frame_arena.h"
 #include "scene/gui/texture_rect.h"
 #include "scene/theme/theme_db.h"
 
@@ -50,9 +51,9 @@ void FlowContainer::_resort() {
 
 	bool rtl = is_layout_rtl();
 
-	HashMap<Control *, Size2i> children_minsize_cache;
+	FrameHashMap<Control *, Size2i> children_minsize_cache;
 
-	Vector<_LineData> lines_data;
+	FrameLocalVector<_LineData> lines_data;
 
 	Vector2i ofs;
 	int line_height = 0;
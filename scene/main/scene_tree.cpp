@@ -36,6 +36,7 @@
 #include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 #include "node.h"
 #include "scene/animation/tween.h"
@@ -1032,11 +1033,14 @@ void SceneTree::_process_group(ProcessGroup *p_group, bool p_physics) {
 		}
 	}
 
-	// Make a copy, so if nodes are added/removed from process, this does not break
-	Vector<Node *> nodes_copy = nodes;
-
-	uint32_t node_count = nodes_copy.size();
-	Node **nodes_ptr = (Node **)nodes_copy.ptr(); // Force cast, pointer will not change.
+	// Make a copy, so if nodes are added/removed from process, this does not break.
+	// The copy is a frame scratch buffer, so changing `nodes` while processing doesn't
+	// duplicate it on the heap.
+	uint32_t node_count = nodes.size();
+	FrameLocalVector<Node *> nodes_copy;
+	nodes_copy.resize(node_count);
+	memcpy(nodes_copy.ptr(), nodes.ptr(), node_count * sizeof(Node *));
+	Node **nodes_ptr = nodes_copy.ptr();
 
 	for (uint32_t i = 0; i < node_count; i++) {
 		Node *n = nodes_ptr[i];
@@ -31,6 +31,7 @@
 #pragma once
 
 #include "core/templates/paged_allocator.h"
+#include "core/templates/parallel.h"
 #include "servers/rendering/renderer_rd/cluster_builder_rd.h"
 #include "servers/rendering/renderer_rd/effects/fsr2.h"
 #include "servers/rendering/renderer_rd/effects/resolve.h"
@@ -530,8 +531,8 @@ class RenderForwardClustered : public RendererSceneRenderRD {
 		};
 
 		void sort_by_key() {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr(), elements.size());
+			// Lists of large scenes are long enough to be worth sorting on the worker threads.
+			Parallel::sort(elements.ptr(), elements.size(), SortByKey());
 		}
 
 		void sort_by_key_range(uint32_t p_from, uint32_t p_size) {
@@ -547,8 +548,7 @@ class RenderForwardClustered : public RendererSceneRenderRD {
 
 		void sort_by_depth() { //used for shadows
 
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByDepth> sorter;
-			sorter.sort(elements.ptr(), elements.size());
+			Parallel::sort(elements.ptr(), elements.size(), SortByDepth());
 		}
 
 		struct SortByReverseDepthAndPriority {
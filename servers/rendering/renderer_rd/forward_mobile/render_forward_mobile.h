@@ -31,6 +31,7 @@
 #pragma once
 
 #include "core/templates/paged_allocator.h"
+#include "core/templates/parallel.h"
 #include "servers/rendering/renderer_rd/forward_mobile/scene_shader_forward_mobile.h"
 #include "servers/rendering/renderer_rd/renderer_scene_render_rd.h"
 
@@ -301,8 +302,8 @@ private:
 		};
 
 		void sort_by_key() {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr(), elements.size());
+			// Lists of large scenes are long enough to be worth sorting on the worker threads.
+			Parallel::sort(elements.ptr(), elements.size(), SortByKey());
 		}
 
 		void sort_by_key_range(uint32_t p_from, uint32_t p_size) {
@@ -318,8 +319,7 @@ private:
 
 		void sort_by_depth() { //used for shadows
 
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByDepth> sorter;
-			sorter.sort(elements.ptr(), elements.size());
+			Parallel::sort(elements.ptr(), elements.size(), SortByDepth());
 		}
 
 		struct SortByReverseDepthAndPriority {
@@ -0,0 +1,134 @@
+/**************************************************************************/
+/*  benchmark_dictionary.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/io/json.h"
+#include "core/os/os.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/ordered_hash_map.h"
+#include "core/variant/variant.h"
+
+#include "tests/test_macros.h"
+
+// Run with `--test dictionary-benchmark`.
+// Compares OrderedHashMap, which backs Dictionary, with HashMap for the same keys.
+
+namespace BenchmarkDictionary {
+
+template <typename TMap>
+static uint64_t small_maps(int p_count) {
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_count; i++) {
+		TMap map;
+		map[Variant("id")] = i;
+		map[Variant("name")] = "item";
+		map[Variant("x")] = 1.0;
+		map[Variant("y")] = 2.0;
+	}
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+template <typename TMap>
+static int64_t large_map(int p_count, uint64_t &r_insert, uint64_t &r_lookup, uint64_t &r_iterate) {
+	TMap map;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_count; i++) {
+		map[Variant(i)] = i;
+	}
+	r_insert = OS::get_singleton()->get_ticks_usec() - begin;
+
+	int64_t sum = 0;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_count; i++) {
+		sum += int64_t(*map.getptr(Variant(i)));
+	}
+	r_lookup = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int pass = 0; pass < 10; pass++) {
+		for (const KeyValue<Variant, Variant> &E : map) {
+			sum += int64_t(E.value);
+		}
+	}
+	r_iterate = OS::get_singleton()->get_ticks_usec() - begin;
+
+	return sum;
+}
+
+static void benchmark() {
+	typedef HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator> ChainedMap;
+	typedef OrderedHashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator> CompactMap;
+
+	print_line("Small maps, 200000 x 4 keys (usec):");
+	print_line(vformat("  HashMap %d, OrderedHashMap %d", small_maps<ChainedMap>(200000), small_maps<CompactMap>(200000)));
+
+	uint64_t insert = 0;
+	uint64_t lookup = 0;
+	uint64_t iterate = 0;
+	print_line("Large map, 1000000 keys (usec):");
+	int64_t sum = large_map<ChainedMap>(1000000, insert, lookup, iterate);
+	print_line(vformat("  HashMap: insert %d, lookup %d, iterate x10 %d", insert, lookup, iterate));
+	sum += large_map<CompactMap>(1000000, insert, lookup, iterate);
+	print_line(vformat("  OrderedHashMap: insert %d, lookup %d, iterate x10 %d", insert, lookup, iterate));
+
+	Array items;
+	for (int i = 0; i < 20000; i++) {
+		Dictionary item;
+		item["id"] = i;
+		item["name"] = vformat("item_%d", i);
+		item["position"] = varray(i * 0.5, i * 1.5, -i);
+		item["flags"] = Dictionary({ { "visible", true }, { "locked", i % 2 == 0 } });
+		items.push_back(item);
+	}
+	const String json_text = JSON::stringify(items);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	JSON json;
+	json.parse(json_text);
+	const uint64_t parse = OS::get_singleton()->get_ticks_usec() - begin;
+
+	const Array parsed = json.get_data();
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < parsed.size(); i++) {
+		const Dictionary item = parsed[i];
+		for (const Variant &key : item.keys()) {
+			sum += item[key].get_type();
+		}
+		sum += int64_t(item["id"]);
+	}
+	const uint64_t access = OS::get_singleton()->get_ticks_usec() - begin;
+
+	print_line(vformat("Dictionary: JSON parse of %d KiB %d usec, iteration and lookup %d usec (checksum %d).", json_text.length() / 1024, parse, access, sum));
+}
+
+REGISTER_TEST_COMMAND("dictionary-benchmark", &benchmark);
+
+} // namespace BenchmarkDictionary
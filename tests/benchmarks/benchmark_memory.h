@@ -0,0 +1,184 @@
+/**************************************************************************/
+/*  benchmark_memory.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/io/json.h"
+#include "core/math/expression.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
+#include "core/os/size_class_allocator.h"
+#include "scene/main/node.h"
+#include "scene/resources/packed_scene.h"
+
+#include "tests/test_macros.h"
+
+#include <stdlib.h>
+
+// Run with `--test memory-benchmark`.
+// Compare the output of builds with `memory_allocator=system` and `memory_allocator=size_class`.
+
+namespace BenchmarkMemory {
+
+struct SystemBackend {
+	static void *alloc(size_t p_bytes) { return malloc(p_bytes); }
+	static void free(void *p_ptr) { ::free(p_ptr); }
+};
+
+struct SizeClassBackend {
+	static void *alloc(size_t p_bytes) { return SizeClassAllocator::alloc(p_bytes); }
+	static void free(void *p_ptr) { SizeClassAllocator::free(p_ptr); }
+};
+
+template <typename T>
+static void churn(void *p_userdata, uint32_t p_index) {
+	// Keep a window of live blocks with mostly small, some medium sizes.
+	constexpr uint32_t WINDOW = 512;
+	void *live[WINDOW] = {};
+	uint32_t state = p_index * 2654435761u + 1;
+	for (uint32_t i = 0; i < 400000; i++) {
+		state = state * 1664525u + 1013904223u;
+		const uint32_t slot = (state >> 8) % WINDOW;
+		if (live[slot]) {
+			T::free(live[slot]);
+		}
+		const size_t size = (state & 7) == 0 ? 256 + (state >> 20) % 4096 : 8 + (state >> 24) % 120;
+		live[slot] = T::alloc(size);
+		*(uint8_t *)live[slot] = 1;
+	}
+	for (void *mem : live) {
+		if (mem) {
+			T::free(mem);
+		}
+	}
+}
+
+template <typename T>
+static uint64_t churn_threads(uint32_t p_threads) {
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(churn<T>, nullptr, p_threads, p_threads, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+static void scene_instantiation(void *p_userdata, uint32_t p_index) {
+	const Ref<PackedScene> &scene = *(const Ref<PackedScene> *)p_userdata;
+	for (int i = 0; i < 20; i++) {
+		memdelete(scene->instantiate());
+	}
+}
+
+static void json_parse(void *p_userdata, uint32_t p_index) {
+	const String &text = *(const String *)p_userdata;
+	for (int i = 0; i < 5; i++) {
+		JSON json;
+		json.parse(text);
+	}
+}
+
+static void string_ops(void *p_userdata, uint32_t p_index) {
+	// Same Variant operators and String methods that GDScript uses.
+	Ref<Expression> expression;
+	expression.instantiate();
+	expression->parse("(\"item_%d_%s\" % [i, name] + \",\" + str(i * 3)).split(\",\")[0].to_upper().replace(\"ITEM\", \"it\")", { "i", "name" });
+	Array inputs;
+	inputs.resize(2);
+	inputs[1] = "node";
+	for (int i = 0; i < 20000; i++) {
+		inputs[0] = i;
+		expression->execute(inputs);
+	}
+}
+
+static uint64_t workload(void (*p_task)(void *, uint32_t), void *p_userdata, uint32_t p_threads) {
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	if (p_threads == 1) {
+		p_task(p_userdata, 0);
+	} else {
+		WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(p_task, p_userdata, p_threads, p_threads, true);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	}
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+static void benchmark() {
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+	print_line("Memory::alloc_static backend: size_class");
+#else
+	print_line("Memory::alloc_static backend: system");
+#endif
+
+	const uint32_t threads = MAX(1, WorkerThreadPool::get_singleton()->get_thread_count());
+
+	print_line("Allocation churn, direct (usec):");
+	for (uint32_t count : { 1u, threads }) {
+		print_line(vformat("  %d thread(s): malloc %d, size class %d", count, churn_threads<SystemBackend>(count), churn_threads<SizeClassBackend>(count)));
+	}
+
+	Node *root = memnew(Node);
+	for (int i = 0; i < 200; i++) {
+		Node *child = memnew(Node);
+		child->set_name(vformat("Child%d", i));
+		child->set_meta("tag", vformat("value_%d", i));
+		root->add_child(child);
+		child->set_owner(root);
+	}
+	Ref<PackedScene> scene;
+	scene.instantiate();
+	scene->pack(root);
+	memdelete(root);
+
+	Array items;
+	for (int i = 0; i < 2000; i++) {
+		Dictionary item;
+		item["id"] = i;
+		item["name"] = vformat("item_%d", i);
+		item["position"] = varray(i * 0.5, i * 1.5, -i);
+		item["tags"] = varray("a", "bb", "ccc");
+		items.push_back(item);
+	}
+	String json_text = JSON::stringify(items);
+
+	print_line("Engine workloads through Memory (usec):");
+	for (uint32_t count : { 1u, threads }) {
+		print_line(vformat("  %d thread(s): scene instantiation %d, JSON parse %d, string ops %d", count,
+				workload(scene_instantiation, &scene, count),
+				workload(json_parse, &json_text, count),
+				workload(string_ops, nullptr, count)));
+	}
+
+	const SizeClassAllocator::Stats stats = SizeClassAllocator::get_stats();
+	print_line(vformat("Size class allocator: %d live allocations, %d KiB in spans, %d KiB in large blocks, %d thread caches.",
+			stats.allocation_count, stats.span_bytes / 1024, stats.large_bytes / 1024, stats.thread_cache_count));
+}
+
+REGISTER_TEST_COMMAND("memory-benchmark", &benchmark);
+
+} // namespace BenchmarkMemory
@@ -0,0 +1,121 @@
+/**************************************************************************/
+/*  benchmark_parallel.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/random_number_generator.h"
+#include "core/os/os.h"
+#include "core/templates/parallel.h"
+#include "core/templates/sort_array.h"
+
+#include "tests/test_macros.h"
+
+// Run with `--test parallel-benchmark`.
+// Parallel algorithms against their serial counterparts, on the main pool.
+
+namespace BenchmarkParallel {
+
+static LocalVector<int> make_random_ints(int p_count, int p_range, uint64_t p_seed) {
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(p_seed);
+	LocalVector<int> values;
+	values.resize(p_count);
+	for (int &value : values) {
+		value = rng->randi_range(0, p_range);
+	}
+	return values;
+}
+
+template <typename T>
+static bool equals(const LocalVector<T> &p_a, const LocalVector<T> &p_b) {
+	if (p_a.size() != p_b.size()) {
+		return false;
+	}
+	for (uint32_t i = 0; i < p_a.size(); i++) {
+		if (p_a[i] != p_b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void benchmark() {
+	const int count = 4000000;
+	const LocalVector<int> values = make_random_ints(count, INT32_MAX - 1, 9);
+
+	print_line(vformat("Sort of %d ints with %d pool threads (usec):", count, WorkerThreadPool::get_singleton()->get_thread_count()));
+	LocalVector<int> sorted = values;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	SortArray<int> sorter;
+	sorter.sort(sorted.ptr(), sorted.size());
+	const uint64_t serial = OS::get_singleton()->get_ticks_usec() - begin;
+
+	sorted = values;
+	begin = OS::get_singleton()->get_ticks_usec();
+	Parallel::sort(sorted.ptr(), sorted.size());
+	print_line(vformat("  SortArray %d, Parallel::sort %d", serial, OS::get_singleton()->get_ticks_usec() - begin));
+
+	Array array;
+	array.resize(count / 4);
+	for (int i = 0; i < array.size(); i++) {
+		array[i] = values[i];
+	}
+	Array array_copy = array.duplicate();
+	begin = OS::get_singleton()->get_ticks_usec();
+	array_copy.sort();
+	const uint64_t array_serial = OS::get_singleton()->get_ticks_usec() - begin;
+	begin = OS::get_singleton()->get_ticks_usec();
+	array.sort_parallel();
+	print_line(vformat("Array of %d ints: sort %d, sort_parallel %d", array.size(), array_serial, OS::get_singleton()->get_ticks_usec() - begin));
+
+	LocalVector<int64_t> sums;
+	sums.resize(count);
+	begin = OS::get_singleton()->get_ticks_usec();
+	int64_t running = 0;
+	for (int i = 0; i < count; i++) {
+		running += values[i];
+		sums[i] = running;
+	}
+	const uint64_t scan_serial = OS::get_singleton()->get_ticks_usec() - begin;
+
+	LocalVector<int64_t> wide;
+	wide.resize(count);
+	for (int i = 0; i < count; i++) {
+		wide[i] = values[i];
+	}
+	begin = OS::get_singleton()->get_ticks_usec();
+	Parallel::inclusive_scan(wide.ptr(), wide.ptr(), count);
+	print_line(vformat("Inclusive scan of %d int64s: serial %d, Parallel::inclusive_scan %d (%s)", count, scan_serial, OS::get_singleton()->get_ticks_usec() - begin, equals(wide, sums) ? "ok" : "MISMATCH"));
+}
+
+REGISTER_TEST_COMMAND("parallel-benchmark", &benchmark);
+
+} // namespace BenchmarkParallel
@@ -0,0 +1,74 @@
+/**************************************************************************/
+/*  benchmark_signals.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/object/object.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+// Run with `--test signal-benchmark`.
+// Cost of emitting a signal with no connections, one, and several.
+
+namespace BenchmarkSignals {
+
+class Receiver : public Object {
+public:
+	int calls = 0;
+
+	void count() {
+		calls++;
+	}
+};
+
+static void benchmark() {
+	const int emissions = 1000000;
+	for (int connections : { 0, 1, 10 }) {
+		Object emitter;
+		emitter.add_user_signal(MethodInfo("benchmark_signal"));
+		Receiver receivers[10];
+		for (int i = 0; i < connections; i++) {
+			emitter.connect("benchmark_signal", callable_mp(&receivers[i], &Receiver::count));
+		}
+
+		const StringName signal_name = "benchmark_signal";
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < emissions; i++) {
+			emitter.emit_signal(signal_name);
+		}
+		const uint64_t time = OS::get_singleton()->get_ticks_usec() - begin;
+		print_line(vformat("%d emissions with %d connection(s): %d usec (%.1f nsec per emission).", emissions, connections, time, time * 1000.0 / emissions));
+	}
+}
+
+REGISTER_TEST_COMMAND("signal-benchmark", &benchmark);
+
+} // namespace BenchmarkSignals
@@ -0,0 +1,105 @@
+/**************************************************************************/
+/*  benchmark_string.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/io/json.h"
+#include "core/os/os.h"
+#include "core/string/ustring.h"
+
+#include "tests/test_macros.h"
+
+// Run with `--test string-benchmark`.
+// Concatenation, split, one character substrings, formatting and JSON round trips.
+
+namespace BenchmarkString {
+
+static void benchmark() {
+	const int count = 200000;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	int64_t checksum = 0;
+	for (int i = 0; i < count; i++) {
+		String label = "Item ";
+		label += itos(i);
+		label += ": ";
+		label += i % 2 ? "on" : "off";
+		checksum += label.length();
+	}
+	print_line(vformat("Concatenation of %d short labels: %d usec", count, OS::get_singleton()->get_ticks_usec() - begin));
+
+	String csv;
+	for (int i = 0; i < 20000; i++) {
+		csv += vformat("%d,x,name_%d,%s,", i, i % 100, i % 3 ? "a" : "bc");
+	}
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int pass = 0; pass < 10; pass++) {
+		checksum += csv.split(",").size();
+	}
+	print_line(vformat("Split of a %d character line x10: %d usec", csv.length(), OS::get_singleton()->get_ticks_usec() - begin));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int pass = 0; pass < 10; pass++) {
+		for (int i = 0; i < csv.length(); i++) {
+			checksum += csv.substr(i, 1).length();
+		}
+	}
+	print_line(vformat("One character substrings x10: %d usec", OS::get_singleton()->get_ticks_usec() - begin));
+
+	Dictionary format_values;
+	format_values["name"] = "Godot";
+	format_values["x"] = 1.5;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count / 4; i++) {
+		checksum += vformat("%s at (%d, %.2f)", "node", i, i * 0.5).length();
+		checksum += String("{name} at {x}").format(format_values).length();
+	}
+	print_line(vformat("vformat and format x%d: %d usec", count / 4, OS::get_singleton()->get_ticks_usec() - begin));
+
+	Array items;
+	for (int i = 0; i < 10000; i++) {
+		Dictionary item;
+		item["id"] = i;
+		item["x"] = i * 0.5;
+		item["tag"] = i % 2 ? "a" : "b";
+		item["name"] = vformat("item_%d", i);
+		items.push_back(item);
+	}
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int pass = 0; pass < 5; pass++) {
+		const String json_text = JSON::stringify(items);
+		const Array parsed = JSON::parse_string(json_text);
+		checksum += parsed.size();
+	}
+	print_line(vformat("JSON round trip of %d objects x5: %d usec (checksum %d)", items.size(), OS::get_singleton()->get_ticks_usec() - begin, checksum));
+}
+
+REGISTER_TEST_COMMAND("string-benchmark", &benchmark);
+
+} // namespace BenchmarkString
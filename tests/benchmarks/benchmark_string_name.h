@@ -0,0 +1,132 @@
+/**************************************************************************/
+/*  benchmark_string_name.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/io/resource.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+// Run with `--test stringname-benchmark`.
+// Interning and resource loading from one thread, then from many at once.
+
+namespace BenchmarkStringName {
+
+static constexpr int THREAD_COUNT = 16;
+
+struct Work {
+	LocalVector<String> texts;
+	LocalVector<String> paths;
+	int repeat = 0;
+	int thread_count = 0;
+	SafeNumeric<uint32_t> loaded;
+};
+
+static void intern_thread(void *p_userdata) {
+	Work *work = static_cast<Work *>(p_userdata);
+	// Same total amount of work regardless of the thread count.
+	const int repeat = work->repeat / work->thread_count;
+	for (int pass = 0; pass < repeat; pass++) {
+		for (const String &text : work->texts) {
+			StringName name(text);
+		}
+	}
+}
+
+static void load_thread(void *p_userdata) {
+	Work *work = static_cast<Work *>(p_userdata);
+	const int repeat = work->repeat / work->thread_count;
+	for (int pass = 0; pass < repeat; pass++) {
+		for (const String &path : work->paths) {
+			Ref<Resource> resource = ResourceLoader::load(path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+			if (resource.is_valid()) {
+				work->loaded.increment();
+			}
+		}
+	}
+}
+
+static uint64_t run(Thread::Callback p_callback, Work &p_work, int p_thread_count) {
+	p_work.thread_count = p_thread_count;
+	Thread threads[THREAD_COUNT];
+
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_thread_count; i++) {
+		threads[i].start(p_callback, &p_work);
+	}
+	for (int i = 0; i < p_thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+static void benchmark() {
+	Work work;
+	for (int i = 0; i < 2000; i++) {
+		work.texts.push_back(vformat("benchmark_property_%d", i));
+	}
+
+	// Text resources with many properties, every one of them becomes a StringName when loaded.
+	for (int i = 0; i < 32; i++) {
+		Ref<Resource> resource;
+		resource.instantiate();
+		resource->set_name(vformat("Resource %d", i));
+		for (int j = 0; j < 100; j++) {
+			resource->set_meta(vformat("benchmark_meta_%d_%d", i % 4, j), j);
+		}
+		const String path = TestUtils::get_temp_path(vformat("stringname_benchmark_%d.tres", i));
+		ResourceSaver::save(resource, path);
+		work.paths.push_back(path);
+	}
+
+	print_line(vformat("StringName interning, %d names (usec):", work.texts.size()));
+	work.repeat = 320;
+	for (int threads : { 1, THREAD_COUNT }) {
+		print_line(vformat("  %d thread(s): %d", threads, run(intern_thread, work, threads)));
+	}
+
+	print_line(vformat("Resource loading, %d text resources (usec):", work.paths.size()));
+	work.repeat = 32;
+	for (int threads : { 1, THREAD_COUNT }) {
+		work.loaded.set(0);
+		const uint64_t time = run(load_thread, work, threads);
+		print_line(vformat("  %d thread(s): %d (%d loads)", threads, time, work.loaded.get()));
+	}
+}
+
+REGISTER_TEST_COMMAND("stringname-benchmark", &benchmark);
+
+} // namespace BenchmarkStringName
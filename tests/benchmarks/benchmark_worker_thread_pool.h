@@ -0,0 +1,129 @@
+/**************************************************************************/
+/*  benchmark_worker_thread_pool.h                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+// Run with `--test scheduler-benchmark`.
+// Fine-grained parallel-for, fork/join and chains of dependent tasks on the main pool.
+
+namespace BenchmarkWorkerThreadPool {
+
+static LocalVector<float> values;
+static SafeNumeric<uint32_t> chain_links;
+
+static void parallel_for(void *p_arg, uint32_t p_index) {
+	values[p_index] = values[p_index] * 0.5f + 1.0f;
+}
+
+static void chain_link(void *p_arg) {
+	chain_links.increment();
+}
+
+struct Fibonacci {
+	int n = 0;
+	int64_t result = 0;
+};
+
+static void fibonacci(void *p_arg) {
+	Fibonacci *fib = (Fibonacci *)p_arg;
+	if (fib->n < 10) {
+		int64_t a = 0;
+		int64_t b = 1;
+		for (int i = 0; i < fib->n; i++) {
+			const int64_t next = a + b;
+			a = b;
+			b = next;
+		}
+		fib->result = a;
+		return;
+	}
+
+	Fibonacci first;
+	first.n = fib->n - 1;
+	Fibonacci second;
+	second.n = fib->n - 2;
+	const WorkerThreadPool::TaskID first_task = WorkerThreadPool::get_singleton()->add_native_task(fibonacci, &first, true);
+	const WorkerThreadPool::TaskID second_task = WorkerThreadPool::get_singleton()->add_native_task(fibonacci, &second, true);
+	// Newest first, since a pool thread can't wait for a task older than its current one.
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(second_task);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(first_task);
+	fib->result = first.result + second.result;
+}
+
+static void benchmark() {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	print_line(vformat("Scheduler benchmark, %d threads.", pool->get_thread_count()));
+
+	// Fine-grained parallel-for, the same amount of work split into groups of decreasing size.
+	const uint32_t total_elements = 1 << 22;
+	values.resize(total_elements);
+	for (uint32_t elements : { 1u << 22, 1u << 16, 1u << 10, 1u << 6 }) {
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (uint32_t done = 0; done < total_elements; done += elements) {
+			const WorkerThreadPool::GroupID group = pool->add_native_group_task(parallel_for, nullptr, elements, -1, true);
+			pool->wait_for_group_task_completion(group);
+		}
+		print_line(vformat("  Parallel-for, %d groups of %d elements: %d usec", total_elements / elements, elements, OS::get_singleton()->get_ticks_usec() - begin));
+	}
+
+	// Fork/join, a task for every call to a recursive function.
+	for (int n : { 20, 25 }) {
+		Fibonacci fib;
+		fib.n = n;
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		const WorkerThreadPool::TaskID task = pool->add_native_task(fibonacci, &fib, true);
+		pool->wait_for_task_completion(task);
+		print_line(vformat("  Fork/join Fibonacci of %d: %d usec", n, OS::get_singleton()->get_ticks_usec() - begin));
+	}
+
+	// Dependencies, a chain of continuations.
+	chain_links.set(0);
+	LocalVector<WorkerThreadPool::TaskID> chain;
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	chain.push_back(pool->add_native_task(chain_link, nullptr, true));
+	for (int i = 1; i < 10000; i++) {
+		chain.push_back(pool->add_native_task_after({ chain[i - 1] }, chain_link, nullptr));
+	}
+	for (const WorkerThreadPool::TaskID &task : chain) {
+		pool->wait_for_task_completion(task);
+	}
+	print_line(vformat("  Chain of %d continuations: %d usec", chain_links.get(), OS::get_singleton()->get_ticks_usec() - begin));
+
+	values.clear();
+}
+
+REGISTER_TEST_COMMAND("scheduler-benchmark", &benchmark);
+
+} // namespace BenchmarkWorkerThreadPool
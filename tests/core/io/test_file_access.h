@@ -198,4 +198,51 @@ TEST_CASE("[FileAccess] Get/Store floating point half precision values") {
 	}
 }
 
+TEST_CASE("[FileAccess] Compressed files") {
+	const String file_path = OS::get_singleton()->get_cache_path().path_join("compressed_file_test.bin");
+
+	// Large enough to span many blocks, so they are compressed and decompressed in parallel.
+	Vector<uint8_t> data;
+	data.resize(600 * 1024 + 123);
+	uint8_t *data_ptrw = data.ptrw();
+	for (int i = 0; i < data.size(); i++) {
+		data_ptrw[i] = (i * 7 + i / 1000) & 0xFF;
+	}
+	const uint8_t patch[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	memcpy(data_ptrw + 10, patch, 8);
+
+	Ref<FileAccess> fw = FileAccess::open_compressed(file_path, FileAccess::WRITE, FileAccess::COMPRESSION_ZSTD);
+	REQUIRE(fw.is_valid());
+	for (int i = 0; i < data.size(); i += 1000) {
+		fw->store_buffer(data.ptr() + i, MIN(1000, data.size() - i));
+	}
+	// Write into a block which has already been compressed.
+	fw->seek(10);
+	fw->store_buffer(patch, 8);
+	fw->seek_end();
+	CHECK(fw->get_position() == uint64_t(data.size()));
+	fw->close();
+
+	Ref<FileAccess> f = FileAccess::open_compressed(file_path, FileAccess::READ, FileAccess::COMPRESSION_ZSTD);
+	REQUIRE(f.is_valid());
+	CHECK(f->get_length() == uint64_t(data.size()));
+	CHECK_MESSAGE(f->get_buffer(data.size()) == data, "Reading the whole file sequentially should return the written data.");
+	CHECK_FALSE(f->eof_reached());
+
+	bool random_reads_match = true;
+	for (const int position : { 300 * 1024 + 5, 17, 590 * 1024, 4095, 123 * 1024 }) {
+		f->seek(position);
+		random_reads_match = random_reads_match && f->get_buffer(5000) == data.slice(position, position + 5000);
+		random_reads_match = random_reads_match && f->get_position() == uint64_t(position + 5000);
+	}
+	CHECK_MESSAGE(random_reads_match, "Reading after seeking should return the written data.");
+
+	f->seek(data.size() - 10);
+	CHECK(f->get_buffer(20).size() == 10);
+	CHECK(f->eof_reached());
+	f->close();
+
+	DirAccess::remove_file_or_error(file_path);
+}
+
 } // namespace TestFileAccess
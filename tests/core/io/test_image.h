@@ -31,6 +31,8 @@
 #pragma once
 
 #include "core/io/image.h"
+#include "core/io/image_compress_scheduler.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 
 #include "tests/test_utils.h"
@@ -416,6 +418,165 @@ TEST_CASE("[Image] Custom mipmaps") {
 	}
 }
 
+static bool colors_within_tolerance(const Color &p_a, const Color &p_b, float p_tolerance) {
+	return Math::abs(p_a.r - p_b.r) <= p_tolerance && Math::abs(p_a.g - p_b.g) <= p_tolerance && Math::abs(p_a.b - p_b.b) <= p_tolerance && Math::abs(p_a.a - p_b.a) <= p_tolerance;
+}
+
+TEST_CASE("[Image] Mipmap generation on large images") {
+	// Large enough to be split across worker threads, with an odd mipmap width to exercise the scalar tail.
+	const int width = 1026;
+	const int height = 512;
+
+	for (Image::Format format : { Image::FORMAT_RGBA8, Image::FORMAT_RGBAF }) {
+		Ref<Image> image = memnew(Image(width, height, false, format));
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				image->set_pixel(x, y, Color(((x * 7 + y * 3) % 256) / 255.0, ((x * 13) % 256) / 255.0, ((y * 11) % 256) / 255.0, ((x ^ y) % 256) / 255.0));
+			}
+		}
+
+		Ref<Image> mipmapped = image->duplicate();
+		mipmapped->generate_mipmaps();
+
+		int64_t mip_offset = 0;
+		int64_t mip_size = 0;
+		mipmapped->get_mipmap_offset_and_size(1, mip_offset, mip_size);
+		Ref<Image> mip = Image::create_from_data(width / 2, height / 2, false, format, mipmapped->get_data().slice(mip_offset, mip_offset + mip_size));
+
+		// Byte formats round to the nearest representable value.
+		const float tolerance = format == Image::FORMAT_RGBA8 ? 1.0f / 255.0f : (float)CMP_EPSILON;
+		bool matches = true;
+		for (int y = 0; y < height / 2 && matches; y++) {
+			for (int x = 0; x < width / 2 && matches; x++) {
+				const Color a = image->get_pixel(x * 2, y * 2);
+				const Color b = image->get_pixel(x * 2 + 1, y * 2);
+				const Color c = image->get_pixel(x * 2, y * 2 + 1);
+				const Color d = image->get_pixel(x * 2 + 1, y * 2 + 1);
+				const Color expected = (a + b + c + d) * 0.25;
+				matches = colors_within_tolerance(mip->get_pixel(x, y), expected, tolerance);
+			}
+		}
+		CHECK_MESSAGE(matches, vformat("The first mipmap of a large %s image should be the average of the source pixels.", Image::get_format_name(format)));
+	}
+}
+
+TEST_CASE("[Image] Resizing large images") {
+	// Every row of the source is identical, so every row of the result must be too (up to rounding),
+	// regardless of how the rows were split across threads.
+	const int width = 700;
+	const int height = 600;
+	Ref<Image> image = memnew(Image(width, height, false, Image::FORMAT_RGBA8));
+	for (int x = 0; x < width; x++) {
+		const Color color = Color((x % 256) / 255.0, ((x * 5) % 256) / 255.0, ((x * 9) % 256) / 255.0, 1.0);
+		for (int y = 0; y < height; y++) {
+			image->set_pixel(x, y, color);
+		}
+	}
+
+	for (int i = 0; i < 5; i++) {
+		const Image::Interpolation interpolation = static_cast<Image::Interpolation>(i);
+		for (const Size2i &size : { Size2i(1000, 900), Size2i(333, 300) }) {
+			Ref<Image> image_resized = image->duplicate();
+			image_resized->resize(size.x, size.y, interpolation);
+			REQUIRE(image_resized->get_size() == size);
+
+			bool rows_match = true;
+			for (int y = 1; y < size.y && rows_match; y++) {
+				for (int x = 0; x < size.x && rows_match; x++) {
+					rows_match = colors_within_tolerance(image_resized->get_pixel(x, y), image_resized->get_pixel(x, 0), 1.5f / 255.0f);
+				}
+			}
+			CHECK_MESSAGE(rows_match, vformat("Resizing with interpolation %d to %s should produce identical rows.", i, size));
+		}
+	}
+
+	// Nearest-neighbor scaling must pick exact source pixels.
+	Ref<Image> image_nearest = image->duplicate();
+	image_nearest->resize(350, 300, Image::INTERPOLATE_NEAREST);
+	bool nearest_matches = true;
+	for (int x = 0; x < 350 && nearest_matches; x++) {
+		nearest_matches = image_nearest->get_pixel(x, 299) == image->get_pixel(x * width / 350, 598);
+	}
+	CHECK_MESSAGE(nearest_matches, "Nearest-neighbor resizing should sample the expected source pixels.");
+}
+
+static void _test_resize_in_task(void *p_userdata, uint32_t p_index) {
+	Ref<Image> *images = static_cast<Ref<Image> *>(p_userdata);
+	images[p_index]->resize(800, 700, Image::INTERPOLATE_BILINEAR);
+}
+
+TEST_CASE("[Image] Resizing large images from worker threads") {
+	// More concurrent resizes than pool threads; each one must run inline instead of waiting on the pool.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	REQUIRE(pool != nullptr);
+	const uint32_t count = MAX(pool->get_thread_count(), 1) * 2;
+	Vector<Ref<Image>> images;
+	for (uint32_t i = 0; i < count; i++) {
+		Ref<Image> image = memnew(Image(600, 600, false, Image::FORMAT_RGBA8));
+		image->fill(Color(1, 0, 0));
+		images.push_back(image);
+	}
+
+	WorkerThreadPool::GroupID group = pool->add_native_group_task(&_test_resize_in_task, images.ptrw(), count, -1, true);
+	pool->wait_for_group_task_completion(group);
+
+	bool resized = true;
+	for (const Ref<Image> &image : images) {
+		resized = resized && image->get_size() == Size2i(800, 700) && image->get_pixel(799, 699) == Color(1, 0, 0);
+	}
+	CHECK_MESSAGE(resized, "Images resized from worker threads should be fully processed.");
+}
+
+static void _test_compress_job(const ImageCompressScheduler::Job &p_job, void *p_userdata) {
+	// Each fake 16-byte block stores the color of its top-left and bottom-right source pixels.
+	uint8_t *dst = p_job.dst;
+	for (uint32_t y = 0; y < p_job.height; y += 4) {
+		for (uint32_t x = 0; x < p_job.width; x += 4) {
+			memset(dst, 0, 16);
+			memcpy(dst, p_job.src + (y * p_job.width + x) * 4, 4);
+			memcpy(dst + 4, p_job.src + ((y + 3) * p_job.width + x + 3) * 4, 4);
+			dst += 16;
+		}
+	}
+}
+
+TEST_CASE("[Image] Block compression scheduling") {
+	// Neither dimension is a multiple of the block size, and the image is large enough to be split into several jobs.
+	const int width = 602;
+	const int height = 437;
+	Vector<uint8_t> data;
+	data.resize(width * height * 4);
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			uint8_t *pixel = data.ptrw() + (y * width + x) * 4;
+			pixel[0] = x % 251;
+			pixel[1] = y % 251;
+			pixel[2] = 0;
+			pixel[3] = 255;
+		}
+	}
+	Ref<Image> image = memnew(Image(width, height, false, Image::FORMAT_RGBA8, data));
+
+	const int padded_width = 604;
+	const int padded_height = 440;
+	Vector<uint8_t> dst;
+	dst.resize(Image::get_image_data_size(padded_width, padded_height, Image::FORMAT_DXT5, false));
+	REQUIRE(dst.size() == padded_width * padded_height);
+	ImageCompressScheduler::compress(image.ptr(), padded_width, padded_height, Image::FORMAT_DXT5, dst.ptrw(), &_test_compress_job, nullptr);
+
+	bool blocks_match = true;
+	const uint8_t *block = dst.ptr();
+	for (int y = 0; y < padded_height && blocks_match; y += 4) {
+		for (int x = 0; x < padded_width && blocks_match; x += 4) {
+			const int last_x = MIN(x + 3, width - 1);
+			const int last_y = MIN(y + 3, height - 1);
+			blocks_match = block[0] == x % 251 && block[1] == y % 251 && block[4] == last_x % 251 && block[5] == last_y % 251;
+			block += 16;
+		}
+	}
+	CHECK_MESSAGE(blocks_match, "Every block should be compressed exactly once, from edge-padded source pixels.");
+}
+
 TEST_CASE("[Image] Convert image") {
 	for (int format = Image::FORMAT_RF; format < Image::FORMAT_RGBE9995; format++) {
 		for (int new_format = Image::FORMAT_RF; new_format < Image::FORMAT_RGBE9995; new_format++) {
@@ -31,6 +31,7 @@
 #pragma once
 
 #include "core/io/resource.h"
+#include "core/io/resource_format_binary.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/os/os.h"
@@ -111,6 +112,118 @@ TEST_CASE("[Resource] Saving and loading") {
 			"The loaded child resource name should be equal to the expected value.");
 }
 
+TEST_CASE("[Resource] Deduplicating identical subresources on binary save") {
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_name("Root");
+	Ref<Resource> child_a = memnew(Resource);
+	child_a->set_name("Identical child");
+	Ref<Resource> child_b = memnew(Resource);
+	child_b->set_name("Identical child");
+	Ref<Resource> child_c = memnew(Resource);
+	child_c->set_name("Different child");
+	resource->set_meta("a", child_a);
+	resource->set_meta("b", child_b);
+	resource->set_meta("c", child_c);
+
+	const String save_path_plain = TestUtils::get_temp_path("resource_plain.res");
+	const String save_path_dedup = TestUtils::get_temp_path("resource_dedup.res");
+	ResourceSaver::save(resource, save_path_plain);
+	ResourceSaver::save(resource, save_path_dedup, ResourceSaver::FLAG_DEDUPLICATE_SUBRESOURCES);
+
+	const Ref<Resource> &loaded_plain = ResourceLoader::load(save_path_plain, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	CHECK_MESSAGE(
+			loaded_plain->get_meta("a") != loaded_plain->get_meta("b"),
+			"Identical subresources should stay distinct without the deduplication flag.");
+
+	const Ref<Resource> &loaded_dedup = ResourceLoader::load(save_path_dedup, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	CHECK_MESSAGE(
+			loaded_dedup->get_meta("a") == loaded_dedup->get_meta("b"),
+			"Identical subresources should be stored once with the deduplication flag.");
+	CHECK_MESSAGE(
+			Ref<Resource>(loaded_dedup->get_meta("a"))->get_name() == "Identical child",
+			"The deduplicated subresource should keep its properties.");
+	CHECK_MESSAGE(
+			Ref<Resource>(loaded_dedup->get_meta("c"))->get_name() == "Different child",
+			"Different subresources should not be merged.");
+	CHECK_MESSAGE(
+			FileAccess::get_file_as_bytes(save_path_dedup).size() < FileAccess::get_file_as_bytes(save_path_plain).size(),
+			"The deduplicated file should be smaller.");
+}
+
+TEST_CASE("[Resource] Threaded binary save") {
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_name("Hello world");
+	Array array;
+	array.push_back(42);
+	resource->set_meta("array", array);
+	Ref<Resource> child_resource = memnew(Resource);
+	child_resource->set_name("I'm a child resource");
+	resource->set_meta("other_resource", child_resource);
+
+	const String save_path = TestUtils::get_temp_path("resource_threaded.res");
+	WorkerThreadPool::TaskID task = ResourceFormatSaverBinary::singleton->save_threaded(resource, save_path);
+	REQUIRE(task != WorkerThreadPool::INVALID_TASK_ID);
+
+	// Modifying the resource after the snapshot must not affect the saved file.
+	resource->set_name("Changed name");
+	array.push_back(43);
+
+	CHECK(ResourceFormatSaverBinary::singleton->wait_for_threaded_save(task) == OK);
+	CHECK_FALSE(FileAccess::exists(save_path + ".tmp"));
+
+	const Ref<Resource> &loaded_resource = ResourceLoader::load(save_path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	CHECK_MESSAGE(
+			loaded_resource->get_name() == "Hello world",
+			"The loaded resource name should match the snapshot.");
+	CHECK_MESSAGE(
+			Array(loaded_resource->get_meta("array")).size() == 1,
+			"The loaded array should match the snapshot.");
+	const Ref<Resource> &loaded_child_resource = loaded_resource->get_meta("other_resource");
+	CHECK_MESSAGE(
+			loaded_child_resource->get_name() == "I'm a child resource",
+			"The loaded child resource name should be equal to the expected value.");
+}
+
+TEST_CASE("[Resource] Threaded binary save matches synchronous save") {
+	Ref<Resource> external_resource = memnew(Resource);
+	external_resource->set_name("External");
+	const String external_path = TestUtils::get_temp_path("resource_parity_external.res");
+	REQUIRE(ResourceSaver::save(external_resource, external_path) == OK);
+	external_resource->set_path(external_path);
+
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_name("Root");
+	Ref<Resource> child_a = memnew(Resource);
+	child_a->set_name("Identical child");
+	Ref<Resource> child_b = memnew(Resource);
+	child_b->set_name("Identical child");
+	Ref<Resource> skipped = memnew(Resource);
+	skipped->set_meta("_skip_save_", true);
+	Array array;
+	array.push_back(child_a);
+	array.push_back(external_resource);
+	Dictionary dictionary;
+	dictionary[child_b] = skipped;
+	resource->set_meta("array", array);
+	resource->set_meta("dictionary", dictionary);
+	resource->set_meta("external", external_resource);
+
+	for (const uint32_t flags : { 0u, uint32_t(ResourceSaver::FLAG_DEDUPLICATE_SUBRESOURCES) }) {
+		const String sync_path = TestUtils::get_temp_path("resource_parity_sync.res");
+		const String threaded_path = TestUtils::get_temp_path("resource_parity_threaded.res");
+		REQUIRE(ResourceFormatSaverBinary::singleton->save(resource, sync_path, flags) == OK);
+		WorkerThreadPool::TaskID task = ResourceFormatSaverBinary::singleton->save_threaded(resource, threaded_path, flags);
+		REQUIRE(task != WorkerThreadPool::INVALID_TASK_ID);
+		REQUIRE(ResourceFormatSaverBinary::singleton->wait_for_threaded_save(task) == OK);
+
+		const Vector<uint8_t> sync_bytes = FileAccess::get_file_as_bytes(sync_path);
+		CHECK_FALSE(sync_bytes.is_empty());
+		CHECK_MESSAGE(
+				sync_bytes == FileAccess::get_file_as_bytes(threaded_path),
+				"The threaded save should write exactly the same bytes as the synchronous save.");
+	}
+}
+
 TEST_CASE("[Resource] Breaking circular references on save") {
 	Ref<Resource> resource_a = memnew(Resource);
 	resource_a->set_name("A");
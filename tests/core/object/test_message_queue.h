@@ -0,0 +1,189 @@
+/**************************************************************************/
+/*  test_message_queue.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/object/message_queue.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMessageQueue {
+
+static LocalVector<int> received;
+static CallQueue *reentrant_queue = nullptr;
+
+static void record_value(int p_value) {
+	received.push_back(p_value);
+}
+
+static void record_and_push_again(int p_remaining) {
+	received.push_back(p_remaining);
+	CHECK(reentrant_queue->flush() == ERR_BUSY);
+	if (p_remaining > 0) {
+		reentrant_queue->push_callable(callable_mp_static(&record_and_push_again), p_remaining - 1);
+	}
+}
+
+TEST_CASE("[CallQueue] Calls are flushed in push order") {
+	for (bool multi_producer : { false, true }) {
+		CallQueue queue(nullptr, 8192, String(), multi_producer);
+		received.clear();
+
+		// Enough to span several pages.
+		for (int i = 0; i < 2000; i++) {
+			queue.push_callable(callable_mp_static(&record_value), i);
+		}
+		CHECK(queue.has_messages());
+		CHECK(queue.flush() == OK);
+		CHECK_FALSE(queue.has_messages());
+
+		REQUIRE(received.size() == 2000);
+		bool in_order = true;
+		for (int i = 0; i < 2000; i++) {
+			in_order &= received[i] == i;
+		}
+		CHECK(in_order);
+	}
+}
+
+TEST_CASE("[CallQueue] Calls pushed while flushing run in the same flush") {
+	for (bool multi_producer : { false, true }) {
+		CallQueue queue(nullptr, 8192, String(), multi_producer);
+		reentrant_queue = &queue;
+		received.clear();
+
+		queue.push_callable(callable_mp_static(&record_and_push_again), 500);
+		CHECK(queue.flush() == OK);
+		CHECK(received.size() == 501);
+		CHECK(received[500] == 0);
+		CHECK_FALSE(queue.has_messages());
+		reentrant_queue = nullptr;
+	}
+}
+
+TEST_CASE("[CallQueue] Clear drops pending calls") {
+	for (bool multi_producer : { false, true }) {
+		CallQueue queue(nullptr, 8192, String(), multi_producer);
+		received.clear();
+
+		for (int i = 0; i < 1000; i++) {
+			queue.push_callable(callable_mp_static(&record_value), i);
+		}
+		queue.clear();
+		CHECK_FALSE(queue.has_messages());
+		queue.push_callable(callable_mp_static(&record_value), 42);
+		CHECK(queue.flush() == OK);
+		REQUIRE(received.size() == 1);
+		CHECK(received[0] == 42);
+	}
+}
+
+TEST_CASE("[CallQueue] Statistics leave pending calls in the multi-producer mode") {
+	CallQueue queue(nullptr, 8192, String(), true);
+	received.clear();
+
+	for (int i = 0; i < 3; i++) {
+		queue.push_callable(callable_mp_static(&record_value), i);
+	}
+	queue.statistics();
+	CHECK(queue.has_messages());
+	CHECK(queue.flush() == OK);
+	CHECK(received.size() == 3);
+}
+
+static const int PRODUCER_COUNT = 8;
+
+struct Producers {
+	CallQueue *queue = nullptr;
+	int calls = 0;
+	SafeNumeric<int> started;
+	SafeNumeric<int> finished;
+};
+
+static int last_sequence[PRODUCER_COUNT];
+static int out_of_order = 0;
+
+static void record_sequence(int p_producer, int p_sequence) {
+	if (last_sequence[p_producer] + 1 != p_sequence) {
+		out_of_order++;
+	}
+	last_sequence[p_producer] = p_sequence;
+}
+
+static void producer_thread(void *p_userdata) {
+	Producers *producers = static_cast<Producers *>(p_userdata);
+	const int producer = producers->started.postincrement();
+	const Callable callable = callable_mp_static(&record_sequence);
+	for (int i = 0; i < producers->calls; i++) {
+		producers->queue->push_callable(callable, producer, i);
+	}
+	producers->finished.increment();
+}
+
+static void run_producers(CallQueue &p_queue, int p_calls) {
+	Producers producers;
+	producers.queue = &p_queue;
+	producers.calls = p_calls;
+	for (int &sequence : last_sequence) {
+		sequence = -1;
+	}
+	out_of_order = 0;
+
+	Thread threads[PRODUCER_COUNT];
+	for (Thread &thread : threads) {
+		thread.start(producer_thread, &producers);
+	}
+	// Flush while the producers push, as the main thread does every frame.
+	while (producers.finished.get() < PRODUCER_COUNT) {
+		p_queue.flush();
+	}
+	for (Thread &thread : threads) {
+		thread.wait_to_finish();
+	}
+	p_queue.flush();
+}
+
+TEST_CASE("[CallQueue] Pushing from multiple threads while flushing") {
+	for (bool multi_producer : { false, true }) {
+		CallQueue queue(nullptr, 8192, String(), multi_producer);
+		run_producers(queue, 20000);
+
+		CHECK(out_of_order == 0);
+		bool all_received = true;
+		for (int sequence : last_sequence) {
+			all_received &= sequence == 19999;
+		}
+		CHECK(all_received);
+		CHECK_FALSE(queue.has_messages());
+	}
+}
+
+} // namespace TestMessageQueue
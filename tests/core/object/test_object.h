@@ -30,9 +30,12 @@
 
 #pragma once
 
+#include "core/object/callable_method_pointer.h"
 #include "core/object/class_db.h"
 #include "core/object/object.h"
 #include "core/object/script_language.h"
+#include "core/os/thread.h"
+#include "core/templates/safe_refcount.h"
 
 #include "tests/test_macros.h"
 
@@ -465,6 +468,133 @@ TEST_CASE("[Object] Signals") {
 	}
 }
 
+class _SignalReceiver : public Object {
+public:
+	Object *emitter = nullptr;
+	_SignalReceiver *other = nullptr;
+	int calls = 0;
+
+	void count() {
+		calls++;
+	}
+
+	void disconnect_other() {
+		calls++;
+		emitter->disconnect("my_signal", callable_mp(other, &_SignalReceiver::count));
+	}
+
+	void connect_other() {
+		calls++;
+		emitter->connect("my_signal", callable_mp(other, &_SignalReceiver::count));
+	}
+
+	void delete_other() {
+		calls++;
+		memdelete(other);
+		other = nullptr;
+	}
+};
+
+TEST_CASE("[Object] Signal emission only reaches the connections made before it") {
+	Object emitter;
+	emitter.add_user_signal(MethodInfo("my_signal"));
+	_SignalReceiver first;
+	_SignalReceiver second;
+	first.emitter = &emitter;
+	first.other = &second;
+
+	SUBCASE("Every connection is called once per emission") {
+		emitter.connect("my_signal", callable_mp(&first, &_SignalReceiver::count));
+		emitter.connect("my_signal", callable_mp(&second, &_SignalReceiver::count));
+		emitter.emit_signal("my_signal");
+		emitter.emit_signal("my_signal");
+		CHECK(first.calls == 2);
+		CHECK(second.calls == 2);
+	}
+
+	SUBCASE("One-shot connections are only called once") {
+		emitter.connect("my_signal", callable_mp(&first, &_SignalReceiver::count), Object::CONNECT_ONE_SHOT);
+		emitter.connect("my_signal", callable_mp(&second, &_SignalReceiver::count));
+		emitter.emit_signal("my_signal");
+		emitter.emit_signal("my_signal");
+		CHECK(first.calls == 1);
+		CHECK(second.calls == 2);
+		CHECK_FALSE(emitter.is_connected("my_signal", callable_mp(&first, &_SignalReceiver::count)));
+	}
+
+	SUBCASE("Disconnecting during emission takes effect on the next emission") {
+		emitter.connect("my_signal", callable_mp(&first, &_SignalReceiver::disconnect_other));
+		emitter.connect("my_signal", callable_mp(&second, &_SignalReceiver::count));
+		emitter.emit_signal("my_signal");
+		CHECK(second.calls == 1);
+		ERR_PRINT_OFF;
+		emitter.emit_signal("my_signal");
+		ERR_PRINT_ON;
+		CHECK(first.calls == 2);
+		CHECK(second.calls == 1);
+	}
+
+	SUBCASE("Connecting during emission takes effect on the next emission") {
+		emitter.connect("my_signal", callable_mp(&first, &_SignalReceiver::connect_other));
+		emitter.emit_signal("my_signal");
+		CHECK(second.calls == 0);
+		ERR_PRINT_OFF;
+		emitter.emit_signal("my_signal");
+		ERR_PRINT_ON;
+		CHECK(second.calls == 1);
+	}
+
+	SUBCASE("Targets deleted during emission are skipped") {
+		_SignalReceiver *deleted = memnew(_SignalReceiver);
+		first.other = deleted;
+		emitter.connect("my_signal", callable_mp(&first, &_SignalReceiver::delete_other));
+		emitter.connect("my_signal", callable_mp(deleted, &_SignalReceiver::count));
+		emitter.connect("my_signal", callable_mp(&second, &_SignalReceiver::count));
+		emitter.emit_signal("my_signal");
+		CHECK(first.calls == 1);
+		CHECK(second.calls == 1);
+		CHECK(first.other == nullptr);
+	}
+}
+
+class _ThreadedSignalReceiver : public Object {
+public:
+	SafeNumeric<uint32_t> calls;
+
+	void count() {
+		calls.increment();
+	}
+};
+
+static constexpr uint32_t THREADED_SIGNAL_EMISSIONS = 1000;
+
+static void _emit_from_thread(void *p_emitter) {
+	for (uint32_t i = 0; i < THREADED_SIGNAL_EMISSIONS; i++) {
+		static_cast<Object *>(p_emitter)->emit_signal(SNAME("my_signal"));
+	}
+}
+
+TEST_CASE("[Object] Signals emitted from several threads at once") {
+	Object emitter;
+	emitter.add_user_signal(MethodInfo("my_signal"));
+	_ThreadedSignalReceiver first;
+	_ThreadedSignalReceiver second;
+	emitter.connect("my_signal", callable_mp(&first, &_ThreadedSignalReceiver::count));
+	emitter.connect("my_signal", callable_mp(&second, &_ThreadedSignalReceiver::count));
+
+	constexpr uint32_t THREAD_COUNT = 4;
+	Thread threads[THREAD_COUNT];
+	for (Thread &thread : threads) {
+		thread.start(_emit_from_thread, &emitter);
+	}
+	for (Thread &thread : threads) {
+		thread.wait_to_finish();
+	}
+
+	CHECK(first.calls.get() == THREAD_COUNT * THREADED_SIGNAL_EMISSIONS);
+	CHECK(second.calls.get() == THREAD_COUNT * THREADED_SIGNAL_EMISSIONS);
+}
+
 class NotificationObject1 : public Object {
 	GDCLASS(NotificationObject1, Object);
 
@@ -0,0 +1,187 @@
+/**************************************************************************/
+/*  test_frame_arena.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/os/frame_arena.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFrameArena {
+
+TEST_CASE("[FrameArena] Scratch vectors and maps") {
+	FrameArena::begin_frame();
+
+	FrameLocalVector<int> numbers;
+	FrameLocalVector<String> strings;
+	for (int i = 0; i < 10000; i++) {
+		numbers.push_back(i);
+		if (i % 10 == 0) {
+			strings.push_back(itos(i));
+		}
+	}
+
+	bool numbers_valid = true;
+	for (int i = 0; i < 10000; i++) {
+		numbers_valid &= numbers[i] == i;
+	}
+	CHECK(numbers_valid);
+	CHECK(strings.size() == 1000);
+	CHECK(strings[999] == "9990");
+
+	FrameHashMap<int, String> map;
+	for (int i = 0; i < 1000; i++) {
+		map[i] = itos(i * 2);
+	}
+	CHECK(map.size() == 1000);
+	CHECK(map[500] == "1000");
+	map.erase(500);
+	CHECK_FALSE(map.has(500));
+}
+
+TEST_CASE("[FrameArena] Latest allocation is reclaimed") {
+	FrameArena::begin_frame();
+
+	void *first = FrameArena::alloc(100);
+	FrameArena::free(first);
+	void *second = FrameArena::alloc(100);
+	CHECK_MESSAGE(first == second, "Freeing the latest allocation should make its memory available again.");
+
+	// Growing the latest allocation happens in place.
+	void *grown = FrameArena::realloc(second, 1000);
+	CHECK(grown == second);
+	FrameArena::free(grown);
+}
+
+TEST_CASE("[FrameArena] Memory stays valid for one more frame") {
+	FrameArena::begin_frame();
+
+	uint8_t *mem = (uint8_t *)FrameArena::alloc(64);
+	memset(mem, 0xAB, 64);
+
+	FrameArena::begin_frame();
+	uint8_t *other = (uint8_t *)FrameArena::alloc(64);
+	memset(other, 0xCD, 64);
+	CHECK_MESSAGE(mem[63] == 0xAB, "Memory from the previous frame should be kept.");
+
+	FrameArena::free(other);
+	FrameArena::free(mem);
+
+	FrameArena::begin_frame();
+	uint8_t *reused = (uint8_t *)FrameArena::alloc(64);
+	CHECK_MESSAGE(reused == mem, "The buffer of two frames ago should be rewound once its memory is freed.");
+	FrameArena::free(reused);
+}
+
+static bool _is_filled(const uint8_t *p_memory, size_t p_size, uint8_t p_value) {
+	for (size_t i = 0; i < p_size; i++) {
+		if (p_memory[i] != p_value) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[FrameArena] Nested iterations keep memory in use") {
+	FrameArena::begin_frame();
+	uint8_t *outer = (uint8_t *)FrameArena::alloc(256);
+	memset(outer, 0x11, 256);
+
+	// Like Main::iteration() running again before the outer frame is done with its memory.
+	for (int i = 0; i < 4; i++) {
+		FrameArena::begin_frame();
+		uint8_t *inner = (uint8_t *)FrameArena::alloc(256);
+		memset(inner, 0x22, 256);
+		FrameArena::free(inner);
+	}
+
+	CHECK_MESSAGE(_is_filled(outer, 256, 0x11), "Memory still in use should not be rewound by nested frames.");
+	FrameArena::free(outer);
+}
+
+struct LaggingThreadData {
+	Semaphore allocated;
+	Semaphore frames_advanced;
+	bool intact = false;
+	bool overlaps = true;
+};
+
+static void _lagging_thread(void *p_userdata) {
+	LaggingThreadData *data = (LaggingThreadData *)p_userdata;
+
+	uint8_t *first = (uint8_t *)FrameArena::alloc(256);
+	memset(first, 0x33, 256);
+	data->allocated.post();
+
+	// The main thread moves two frames ahead while this one still uses its memory.
+	data->frames_advanced.wait();
+	uint8_t *second = (uint8_t *)FrameArena::alloc(256);
+	memset(second, 0x44, 256);
+
+	data->intact = _is_filled(first, 256, 0x33);
+	data->overlaps = second < first + 256 && first < second + 256;
+	FrameArena::free(second);
+	FrameArena::free(first);
+}
+
+TEST_CASE("[FrameArena] Threads not in step with frames keep memory in use") {
+	LaggingThreadData data;
+	Thread thread;
+	thread.start(_lagging_thread, &data);
+
+	data.allocated.wait();
+	FrameArena::begin_frame();
+	FrameArena::begin_frame();
+	data.frames_advanced.post();
+	thread.wait_to_finish();
+
+	CHECK_MESSAGE(data.intact, "Memory still in use by a thread should not be rewound when frames advance.");
+	CHECK_FALSE_MESSAGE(data.overlaps, "New allocations should not overlap memory still in use.");
+}
+
+TEST_CASE("[FrameArena] Falls back to the heap when a buffer is full") {
+	FrameArena::begin_frame();
+
+	const size_t size = FrameArena::MAX_BUFFER_SIZE + 1;
+	uint8_t *mem = (uint8_t *)FrameArena::alloc(size);
+	REQUIRE(mem != nullptr);
+	mem[0] = 1;
+	mem[size - 1] = 2;
+
+	mem = (uint8_t *)FrameArena::realloc(mem, size * 2);
+	REQUIRE(mem != nullptr);
+	CHECK(mem[0] == 1);
+	CHECK(mem[size - 1] == 2);
+	FrameArena::free(mem);
+}
+
+} // namespace TestFrameArena
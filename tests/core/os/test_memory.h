@@ -0,0 +1,153 @@
+/**************************************************************************/
+/*  test_memory.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/object/worker_thread_pool.h"
+#include "core/os/size_class_allocator.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMemory {
+
+TEST_CASE("[SizeClassAllocator] Size classes") {
+	for (size_t size = 0; size <= SizeClassAllocator::MAX_SMALL_SIZE; size++) {
+		const uint32_t size_class = SizeClassAllocator::get_size_class(size);
+		if (SizeClassAllocator::get_class_size(size_class) < size) {
+			FAIL(vformat("Size class is too small for %d bytes.", (int64_t)size));
+		}
+		if (size_class > 0 && SizeClassAllocator::get_class_size(size_class - 1) >= size) {
+			FAIL(vformat("A smaller size class fits %d bytes.", (int64_t)size));
+		}
+	}
+	CHECK(SizeClassAllocator::get_class_size(SizeClassAllocator::SIZE_CLASS_COUNT - 1) == SizeClassAllocator::MAX_SMALL_SIZE);
+}
+
+TEST_CASE("[SizeClassAllocator] Allocation, reallocation and alignment") {
+	const size_t sizes[] = { 0, 1, 15, 16, 17, 100, 1000, 1025, 4000, 8192, 8193, 100000, 1000000 };
+
+	for (size_t size : sizes) {
+		uint8_t *mem = (uint8_t *)SizeClassAllocator::alloc(size);
+		REQUIRE(mem != nullptr);
+		CHECK(((uintptr_t)mem % alignof(max_align_t)) == 0);
+		CHECK(SizeClassAllocator::get_usable_size(mem) >= size);
+		for (size_t i = 0; i < size; i++) {
+			mem[i] = uint8_t(i * 7);
+		}
+
+		// Grow across size classes and into a large block, then shrink back.
+		const size_t new_sizes[] = { size * 2 + 1, size + 20000, size / 3 + 1 };
+		size_t valid = size;
+		for (size_t new_size : new_sizes) {
+			mem = (uint8_t *)SizeClassAllocator::realloc(mem, new_size);
+			REQUIRE(mem != nullptr);
+			CHECK(SizeClassAllocator::get_usable_size(mem) >= new_size);
+			valid = MIN(valid, new_size);
+			bool intact = true;
+			for (size_t i = 0; i < valid; i++) {
+				intact &= mem[i] == uint8_t(i * 7);
+			}
+			CHECK_MESSAGE(intact, vformat("Reallocating to %d bytes should keep the contents.", (int64_t)new_size));
+		}
+		SizeClassAllocator::free(mem);
+	}
+
+	CHECK(SizeClassAllocator::realloc(SizeClassAllocator::alloc(64), 0) == nullptr);
+}
+
+static LocalVector<void *> cross_thread_blocks;
+
+static void allocate_on_worker(void *p_userdata, uint32_t p_index) {
+	cross_thread_blocks[p_index] = SizeClassAllocator::alloc(16 + (p_index % 64) * 32);
+	memset(cross_thread_blocks[p_index], int(p_index), 16);
+}
+
+TEST_CASE("[SizeClassAllocator] Freeing blocks of other threads") {
+	const uint32_t count = 10000;
+	cross_thread_blocks.resize(count);
+
+#ifndef SIZE_CLASS_ALLOCATOR_ENABLED
+	const uint64_t count_before = SizeClassAllocator::get_stats().allocation_count;
+#endif
+
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(allocate_on_worker, nullptr, count, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+#ifndef SIZE_CLASS_ALLOCATOR_ENABLED
+	// Only exact when nothing else allocates through the allocator at the same time.
+	CHECK(SizeClassAllocator::get_stats().allocation_count == count_before + count);
+#endif
+
+	bool intact = true;
+	for (uint32_t i = 0; i < count; i++) {
+		intact &= *(uint8_t *)cross_thread_blocks[i] == uint8_t(i);
+		SizeClassAllocator::free(cross_thread_blocks[i]);
+	}
+	CHECK(intact);
+#ifndef SIZE_CLASS_ALLOCATOR_ENABLED
+	CHECK(SizeClassAllocator::get_stats().allocation_count == count_before);
+#endif
+
+	cross_thread_blocks.reset();
+}
+
+TEST_CASE("[SizeClassAllocator] Returning spans to the system") {
+	const uint32_t count = 1000;
+	const size_t size = 6000;
+	LocalVector<void *> blocks;
+	blocks.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		blocks[i] = SizeClassAllocator::alloc(size);
+		REQUIRE(blocks[i] != nullptr);
+	}
+	const uint64_t span_bytes_used = SizeClassAllocator::get_stats().span_bytes;
+
+	for (void *block : blocks) {
+		SizeClassAllocator::free(block);
+	}
+	const uint64_t span_bytes_freed = SizeClassAllocator::get_stats().span_bytes;
+
+	// The blocks filled dozens of spans. Only the blocks kept in the thread cache and one spare span may stay.
+	CHECK_MESSAGE(
+			span_bytes_freed + SizeClassAllocator::SPAN_SIZE * 32 < span_bytes_used,
+			"Spans whose blocks were all freed should be returned to the system.");
+
+	// Large blocks don't come from spans, so they don't need to be aligned to them.
+	void *large = SizeClassAllocator::alloc(SizeClassAllocator::MAX_SMALL_SIZE + 1);
+	REQUIRE(large != nullptr);
+#ifndef SIZE_CLASS_ALLOCATOR_ENABLED
+	// Only exact when nothing else allocates through the allocator at the same time.
+	CHECK(SizeClassAllocator::get_stats().span_bytes == span_bytes_freed);
+#endif
+	CHECK(SizeClassAllocator::get_usable_size(large) == SizeClassAllocator::MAX_SMALL_SIZE + 1);
+	SizeClassAllocator::free(large);
+}
+
+} // namespace TestMemory
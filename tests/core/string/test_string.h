@@ -2084,6 +2084,40 @@ TEST_CASE("[String][URL] Parse URL") {
 #undef CHECK_URL
 }
 
+TEST_CASE("[String] Shared one character strings") {
+	const String a = String::chr('a');
+	const String text = "banana";
+	CHECK(a == "a");
+	CHECK(a.length() == 1);
+	CHECK(String("a").ptr() == a.ptr());
+	CHECK(text.substr(1, 1).ptr() == a.ptr());
+	CHECK(String::chr(U'\u00e9') == U"\u00e9");
+	CHECK(String::chr(U'\u4e2d') == U"\u4e2d");
+	CHECK(String::chr(0).is_empty());
+
+	// Writing to a shared string copies it first.
+	String modified = String::chr('a');
+	modified[0] = 'b';
+	CHECK(modified == "b");
+	CHECK(a == "a");
+	CHECK(String::chr('a') == "a");
+
+	String appended = a;
+	appended += "pple";
+	CHECK(appended == "apple");
+	CHECK(a == "a");
+
+	String resized = a;
+	resized.resize(0);
+	CHECK(resized.is_empty());
+	CHECK(a == "a");
+
+	const Vector<String> parts = String("a,b,c").split(",");
+	REQUIRE(parts.size() == 3);
+	CHECK(parts[0].ptr() == a.ptr());
+	CHECK(parts[2] == "c");
+}
+
 TEST_CASE("[Stress][String] Empty via ' == String()'") {
 	for (int i = 0; i < 100000; ++i) {
 		String str = "Hello World!";
@@ -0,0 +1,119 @@
+/**************************************************************************/
+/*  test_string_name.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/os/thread.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	const StringName from_cstring("test_string_name_interning");
+	const StringName from_string(String("test_string_name_interning"));
+	const StringName from_static = SNAME("test_string_name_interning");
+
+	CHECK(from_cstring == from_string);
+	CHECK(from_cstring == from_static);
+	CHECK(from_cstring.data_unique_pointer() == from_string.data_unique_pointer());
+	CHECK(from_cstring != StringName("test_string_name_interning_2"));
+	CHECK(String(from_string) == "test_string_name_interning");
+	CHECK(StringName().is_empty());
+	CHECK(StringName("") == StringName());
+}
+
+TEST_CASE("[StringName] Search") {
+	const StringName name("test_string_name_search");
+
+	CHECK(StringName::search("test_string_name_search") == name);
+	CHECK(StringName::search(U"test_string_name_search") == name);
+	CHECK(StringName::search(String("test_string_name_search")) == name);
+	CHECK(StringName::search("test_string_name_search_missing") == StringName());
+}
+
+TEST_CASE("[StringName] Names are released once unreferenced") {
+	const String text = "test_string_name_released";
+	{
+		StringName name(text);
+		CHECK(StringName::search(text) == name);
+	}
+
+	// The thread cache of the current thread may keep a recent name alive,
+	// so push it out with names that map to every cache slot.
+	for (int i = 0; i < 4096; i++) {
+		StringName filler(vformat("test_string_name_filler_%d", i));
+	}
+	CHECK(StringName::search(text) == StringName());
+}
+
+struct ThreadedInterning {
+	LocalVector<String> texts;
+	LocalVector<StringName> expected;
+	SafeNumeric<uint32_t> mismatches;
+};
+
+static void interning_thread(void *p_userdata) {
+	ThreadedInterning *data = static_cast<ThreadedInterning *>(p_userdata);
+	for (int pass = 0; pass < 20; pass++) {
+		for (uint32_t i = 0; i < data->texts.size(); i++) {
+			if (StringName(data->texts[i]) != data->expected[i]) {
+				data->mismatches.increment();
+			}
+			// Short-lived names, created and released concurrently.
+			StringName temporary(data->texts[i] + "_temporary");
+			if (temporary != StringName(data->texts[i] + "_temporary")) {
+				data->mismatches.increment();
+			}
+		}
+	}
+}
+
+TEST_CASE("[StringName] Interning from multiple threads") {
+	ThreadedInterning data;
+	for (int i = 0; i < 500; i++) {
+		data.texts.push_back(vformat("test_string_name_threaded_%d", i));
+		data.expected.push_back(StringName(data.texts[i]));
+	}
+
+	Thread threads[8];
+	for (Thread &thread : threads) {
+		thread.start(interning_thread, &data);
+	}
+	for (Thread &thread : threads) {
+		thread.wait_to_finish();
+	}
+
+	CHECK(data.mismatches.get() == 0);
+	CHECK(StringName::search("test_string_name_threaded_0_temporary") == StringName());
+}
+
+} // namespace TestStringName
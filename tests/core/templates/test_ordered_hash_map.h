@@ -0,0 +1,205 @@
+/**************************************************************************/
+/*  test_ordered_hash_map.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/templates/ordered_hash_map.h"
+
+#include "tests/test_macros.h"
+
+namespace TestOrderedHashMap {
+
+TEST_CASE("[OrderedHashMap] List initialization") {
+	OrderedHashMap<int, String> map{ { 0, "A" }, { 1, "B" }, { 2, "C" }, { 3, "D" }, { 4, "E" } };
+
+	CHECK(map.size() == 5);
+	CHECK(map[0] == "A");
+	CHECK(map[1] == "B");
+	CHECK(map[2] == "C");
+	CHECK(map[3] == "D");
+	CHECK(map[4] == "E");
+}
+
+TEST_CASE("[OrderedHashMap] Insert and overwrite element") {
+	OrderedHashMap<int, int> map;
+	OrderedHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map.has(42));
+	CHECK(map.find(42));
+
+	map.insert(42, 1234);
+	CHECK(map.size() == 1);
+	CHECK(map[42] == 1234);
+}
+
+TEST_CASE("[OrderedHashMap] Erase keeps insertion order") {
+	OrderedHashMap<int, int> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(i, i * 10);
+	}
+	for (int i = 0; i < 100; i += 3) {
+		CHECK(map.erase(i));
+	}
+	CHECK_FALSE(map.erase(0));
+	CHECK(map.size() == 66);
+
+	int expected = 1;
+	for (const KeyValue<int, int> &E : map) {
+		CHECK(E.key == expected);
+		CHECK(E.value == expected * 10);
+		expected += expected % 3 == 1 ? 1 : 2;
+	}
+	CHECK(expected == 100);
+
+	map.insert(0, 0);
+	CHECK(map.last()->key == 0);
+}
+
+TEST_CASE("[OrderedHashMap] Lookup after many insertions and erasures") {
+	OrderedHashMap<int, int> map;
+	for (int i = 0; i < 5000; i++) {
+		map.insert(i, -i);
+	}
+	for (int i = 0; i < 5000; i += 2) {
+		map.erase(i);
+	}
+	for (int i = 0; i < 5000; i++) {
+		if (i % 2) {
+			const int *value = map.getptr(i);
+			REQUIRE(value != nullptr);
+			CHECK(*value == -i);
+		} else {
+			CHECK_FALSE(map.has(i));
+		}
+	}
+
+	for (int i = 0; i < 5000; i++) {
+		map.erase(i);
+	}
+	CHECK(map.is_empty());
+	CHECK_FALSE(map.begin());
+}
+
+TEST_CASE("[OrderedHashMap] References stay valid while growing") {
+	OrderedHashMap<int, String> map;
+	String &first = map[0];
+	first = "first";
+	for (int i = 1; i < 1000; i++) {
+		map[i] = itos(i);
+	}
+	CHECK(&map[0] == &first);
+	CHECK(first == "first");
+}
+
+TEST_CASE("[OrderedHashMap] Element at position") {
+	OrderedHashMap<int, int> map;
+	for (int i = 0; i < 20; i++) {
+		map.insert(i, i);
+	}
+	CHECK(map.get_at(5)->key == 5);
+
+	map.erase(2);
+	CHECK(map.get_at(5)->key == 6);
+	CHECK(map.get_at(18)->key == 19);
+	CHECK_FALSE(map.get_at(19));
+}
+
+TEST_CASE("[OrderedHashMap] Sort") {
+	OrderedHashMap<Variant, int, VariantHasher, StringLikeVariantComparator> map;
+	for (int i = 0; i < 30; i++) {
+		map.insert((i * 7) % 30, i);
+	}
+	map.erase(14);
+	const int *value = map.getptr(21);
+	map.sort();
+
+	int expected = 0;
+	for (const KeyValue<Variant, int> &E : map) {
+		if (expected == 14) {
+			expected++;
+		}
+		CHECK(int(E.key) == expected);
+		expected++;
+	}
+	CHECK(map.getptr(21) == value);
+	CHECK(*value == 3);
+}
+
+TEST_CASE("[OrderedHashMap] Copy") {
+	OrderedHashMap<int, String> map;
+	for (int i = 0; i < 50; i++) {
+		map.insert(49 - i, itos(i));
+	}
+	map.erase(10);
+
+	OrderedHashMap<int, String> copy = map;
+	CHECK(copy.size() == map.size());
+
+	OrderedHashMap<int, String>::ConstIterator it = copy.begin();
+	for (const KeyValue<int, String> &E : map) {
+		REQUIRE(it);
+		CHECK(it->key == E.key);
+		CHECK(it->value == E.value);
+		++it;
+	}
+	CHECK_FALSE(it);
+}
+
+TEST_CASE("[OrderedHashMap] References stay valid across erasures") {
+	OrderedHashMap<int, String> map;
+	for (int i = 0; i < 100; i++) {
+		map[i] = itos(i);
+	}
+	String *kept = map.getptr(99);
+
+	// Erasing most elements compacts the iteration order, but must not move the pairs.
+	for (int i = 0; i < 90; i++) {
+		map.erase(i);
+	}
+	CHECK(map.getptr(99) == kept);
+	CHECK(*kept == "99");
+
+	// Erased entries are reused instead of growing the map.
+	const uint32_t capacity = map.get_capacity();
+	for (int i = 100; i < 10000; i++) {
+		map[i] = itos(i);
+		map.erase(i - 10);
+	}
+	CHECK(map.get_capacity() == capacity);
+	CHECK(map.size() == 10);
+	CHECK(map.getptr(99) == nullptr);
+	CHECK(map.begin()->key == 9990);
+	CHECK(map.last()->key == 9999);
+}
+
+} // namespace TestOrderedHashMap
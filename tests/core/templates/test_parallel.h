@@ -0,0 +1,233 @@
+/**************************************************************************/
+/*  test_parallel.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/random_number_generator.h"
+#include "core/templates/parallel.h"
+#include "core/templates/sort_array.h"
+
+#include "tests/test_macros.h"
+
+namespace TestParallel {
+
+static LocalVector<int> make_random_ints(int p_count, int p_range, uint64_t p_seed) {
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(p_seed);
+	LocalVector<int> values;
+	values.resize(p_count);
+	for (int &value : values) {
+		value = rng->randi_range(0, p_range);
+	}
+	return values;
+}
+
+template <typename T>
+static bool equals(const LocalVector<T> &p_a, const LocalVector<T> &p_b) {
+	if (p_a.size() != p_b.size()) {
+		return false;
+	}
+	for (uint32_t i = 0; i < p_a.size(); i++) {
+		if (p_a[i] != p_b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool is_sorted(const LocalVector<int> &p_values) {
+	for (uint32_t i = 1; i < p_values.size(); i++) {
+		if (p_values[i] < p_values[i - 1]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[Parallel] for_each visits every index once") {
+	for (int count : { 0, 1, 100, 100000 }) {
+		LocalVector<SafeNumeric<uint32_t>> visits;
+		visits.resize(count);
+		Parallel::for_each(0, count, [&](int64_t i) {
+			visits[i].increment();
+		});
+
+		bool once = true;
+		for (SafeNumeric<uint32_t> &visit : visits) {
+			once = once && visit.get() == 1;
+		}
+		CHECK(once);
+	}
+}
+
+TEST_CASE("[Parallel] for_ranges covers the range without overlaps") {
+	SafeNumeric<int64_t> covered;
+	SafeNumeric<int64_t> sum;
+	Parallel::for_ranges(
+			10, 50010, [&](int64_t p_from, int64_t p_to) {
+				covered.add(p_to - p_from);
+				for (int64_t i = p_from; i < p_to; i++) {
+					sum.add(i);
+				}
+			},
+			100);
+	CHECK(covered.get() == 50000);
+	CHECK(sum.get() == (10 + 50009) * int64_t(50000) / 2);
+}
+
+TEST_CASE("[Parallel] Reduce") {
+	const LocalVector<int> values = make_random_ints(100000, 1000, 1);
+	int64_t expected = 0;
+	int expected_max = 0;
+	for (int value : values) {
+		expected += value;
+		expected_max = MAX(expected_max, value);
+	}
+
+	const int64_t sum = Parallel::reduce_ranges(
+			0, values.size(), int64_t(0), [&](int64_t p_from, int64_t p_to) {
+				int64_t partial = 0;
+				for (int64_t i = p_from; i < p_to; i++) {
+					partial += values[i];
+				}
+				return partial;
+			},
+			Parallel::Add<int64_t>(), 500);
+	CHECK(sum == expected);
+
+	const int max = Parallel::reduce(values.ptr(), values.size(), 0, [](int p_a, int p_b) { return MAX(p_a, p_b); }, 500);
+	CHECK(max == expected_max);
+	CHECK(Parallel::reduce(values.ptr(), 0, 42) == 42);
+}
+
+TEST_CASE("[Parallel] Prefix sums") {
+	for (int count : { 0, 1, 7, 100000 }) {
+		const LocalVector<int> values = make_random_ints(count, 100, 2);
+		LocalVector<int> inclusive;
+		LocalVector<int> exclusive;
+		inclusive.resize(count);
+		exclusive.resize(count);
+		Parallel::inclusive_scan(values.ptr(), inclusive.ptr(), count, 0, Parallel::Add<int>(), 500);
+		Parallel::exclusive_scan(values.ptr(), exclusive.ptr(), count, 0, Parallel::Add<int>(), 500);
+
+		bool valid = true;
+		int running = 0;
+		for (int i = 0; i < count; i++) {
+			valid = valid && exclusive[i] == running;
+			running += values[i];
+			valid = valid && inclusive[i] == running;
+		}
+		CHECK(valid);
+
+		// In place.
+		LocalVector<int> in_place = values;
+		Parallel::inclusive_scan(in_place.ptr(), in_place.ptr(), count, 0, Parallel::Add<int>(), 500);
+		CHECK(equals(in_place, inclusive));
+	}
+}
+
+TEST_CASE("[Parallel] Sort") {
+	struct Greater {
+		bool operator()(int p_a, int p_b) const { return p_a > p_b; }
+	};
+
+	for (int count : { 0, 1, 1000, 4099, 100000 }) {
+		// Few distinct values, to have plenty of ties between runs.
+		for (int range : { 10, 1000000 }) {
+			LocalVector<int> values = make_random_ints(count, range, count + range);
+			LocalVector<int> expected = values;
+			SortArray<int> sorter;
+			sorter.sort(expected.ptr(), expected.size());
+
+			Parallel::sort(values.ptr(), values.size(), _DefaultComparator<int>(), 100);
+			CHECK(equals(values, expected));
+
+			Parallel::sort(values.ptr(), values.size(), Greater(), 100);
+			bool descending = true;
+			for (uint32_t i = 1; i < values.size(); i++) {
+				descending = descending && values[i] <= values[i - 1];
+			}
+			CHECK(descending);
+		}
+	}
+}
+
+TEST_CASE("[Parallel] Sort non-trivial types") {
+	const LocalVector<int> numbers = make_random_ints(20000, 1000000, 3);
+	Vector<String> strings;
+	for (int number : numbers) {
+		strings.push_back(itos(number));
+	}
+	Vector<String> expected = strings;
+	expected.sort();
+
+	Parallel::sort(strings.ptrw(), strings.size(), _DefaultComparator<String>(), 100);
+	CHECK(strings == expected);
+}
+
+TEST_CASE("[Parallel] Array and packed array sort_parallel") {
+	const LocalVector<int> numbers = make_random_ints(10000, 1000000, 4);
+	Array array;
+	PackedInt32Array packed;
+	for (int number : numbers) {
+		array.push_back(number % 2 ? Variant(number) : Variant(number + 0.5));
+		packed.push_back(number);
+	}
+
+	Array expected = array.duplicate();
+	expected.sort();
+	array.sort_parallel();
+	CHECK(array == expected);
+
+	// Packed arrays only get it as a built-in method.
+	PackedInt32Array expected_packed = packed;
+	expected_packed.sort();
+	Variant packed_variant = packed;
+	packed_variant.call("sort_parallel");
+	CHECK(PackedInt32Array(packed_variant) == expected_packed);
+}
+
+TEST_CASE("[Parallel] Nested calls from pool threads") {
+	LocalVector<int> values[4] = {
+		make_random_ints(50000, 1000000, 5),
+		make_random_ints(50000, 1000000, 6),
+		make_random_ints(50000, 1000000, 7),
+		make_random_ints(50000, 1000000, 8),
+	};
+	Parallel::for_chunks(0, 4, 4, [&](int64_t, int64_t, int64_t p_chunk) {
+		Parallel::sort(values[p_chunk].ptr(), values[p_chunk].size(), _DefaultComparator<int>(), 100);
+	});
+	for (const LocalVector<int> &sorted : values) {
+		CHECK(is_sorted(sorted));
+	}
+}
+
+} // namespace TestParallel
@@ -31,6 +31,7 @@
 #pragma once
 
 #include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 
 #include "tests/test_macros.h"
 
@@ -172,4 +173,178 @@ TEST_CASE("[WorkerThreadPool] Run a yielding daemon as the only hope for other t
 	CHECK_MESSAGE(all_needed_yield, "All legit tasks should have needed the daemon yielding to run.");
 }
 
+struct DependencyOrder {
+	BinaryMutex mutex;
+	LocalVector<int> order;
+};
+static DependencyOrder dependency_order;
+
+static void static_ordered_test(void *p_arg) {
+	MutexLock lock(dependency_order.mutex);
+	dependency_order.order.push_back((intptr_t)p_arg);
+}
+
+static void static_counting_group_test(void *p_arg, uint32_t p_index) {
+	counter[p_index].increment();
+}
+
+TEST_CASE("[WorkerThreadPool] Run tasks after their dependencies") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	for (int iterations = 0; iterations < 100; iterations++) {
+		dependency_order.order.clear();
+		counter.clear();
+		counter.resize(100);
+
+		const WorkerThreadPool::TaskID first = pool->add_native_task(static_ordered_test, (void *)1, true);
+		const WorkerThreadPool::TaskID second = pool->add_native_task_after({ first }, static_ordered_test, (void *)2);
+		const WorkerThreadPool::TaskID third = pool->add_native_task_after({ second }, static_ordered_test, (void *)3, WorkerThreadPool::TASK_PRIORITY_LOW);
+		const WorkerThreadPool::GroupID group = pool->add_native_group_task(static_counting_group_test, nullptr, 100);
+		const WorkerThreadPool::TaskID last = pool->add_native_task_after({ third, group }, static_ordered_test, (void *)4, WorkerThreadPool::TASK_PRIORITY_CRITICAL);
+
+		const WorkerThreadPool::TaskID all = pool->when_all({ first, second, third, last });
+		CHECK(pool->wait_for_task_completion(all) == OK);
+		CHECK(pool->is_task_completed(last));
+		CHECK(pool->is_group_task_completed(group));
+
+		REQUIRE(dependency_order.order.size() == 4);
+		for (int i = 0; i < 4; i++) {
+			CHECK(dependency_order.order[i] == i + 1);
+		}
+		bool all_run_once = true;
+		for (int i = 0; i < 100; i++) {
+			all_run_once &= counter[i].get() == 1;
+		}
+		CHECK(all_run_once);
+
+		pool->wait_for_task_completion(first);
+		pool->wait_for_task_completion(second);
+		pool->wait_for_task_completion(third);
+		pool->wait_for_task_completion(last);
+		pool->wait_for_group_task_completion(group);
+
+		// Dependencies that were already awaited count as completed.
+		const WorkerThreadPool::TaskID after_awaited = pool->add_native_task_after({ first, group }, static_ordered_test, (void *)5);
+		CHECK(pool->wait_for_task_completion(after_awaited) == OK);
+		CHECK(dependency_order.order[4] == 5);
+	}
+}
+
+struct ForkJoinFibonacci {
+	int n = 0;
+	int64_t result = 0;
+};
+
+static void fork_join_fibonacci(void *p_arg) {
+	ForkJoinFibonacci *fibonacci = (ForkJoinFibonacci *)p_arg;
+	if (fibonacci->n < 10) {
+		int64_t a = 0;
+		int64_t b = 1;
+		for (int i = 0; i < fibonacci->n; i++) {
+			const int64_t next = a + b;
+			a = b;
+			b = next;
+		}
+		fibonacci->result = a;
+		return;
+	}
+
+	ForkJoinFibonacci first;
+	first.n = fibonacci->n - 1;
+	ForkJoinFibonacci second;
+	second.n = fibonacci->n - 2;
+	const WorkerThreadPool::TaskID first_task = WorkerThreadPool::get_singleton()->add_native_task(fork_join_fibonacci, &first, true);
+	const WorkerThreadPool::TaskID second_task = WorkerThreadPool::get_singleton()->add_native_task(fork_join_fibonacci, &second, true);
+	// Newest first, since a pool thread can't wait for a task older than its current one.
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(second_task);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(first_task);
+	fibonacci->result = first.result + second.result;
+}
+
+TEST_CASE("[WorkerThreadPool] Fork and join tasks from pool threads") {
+	ForkJoinFibonacci fibonacci;
+	fibonacci.n = 20;
+	const WorkerThreadPool::TaskID task = WorkerThreadPool::get_singleton()->add_native_task(fork_join_fibonacci, &fibonacci, true);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+	CHECK(fibonacci.result == 6765);
+}
+
+static void static_nested_group_test(void *p_arg, uint32_t p_index) {
+	counter[1].add(p_index);
+}
+
+static void static_nesting_group_test(void *p_arg, uint32_t p_index) {
+	// Waiting pool threads help with the elements, so this completes even when every thread is in here.
+	const WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(static_nested_group_test, nullptr, 100, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	counter[0].increment();
+}
+
+TEST_CASE("[WorkerThreadPool] Wait for group tasks from pool threads") {
+	counter.clear();
+	counter.resize(2);
+	const int count = WorkerThreadPool::get_singleton()->get_thread_count() * 4;
+	const WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(static_nesting_group_test, nullptr, count, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	CHECK(counter[0].get() == count);
+	CHECK(counter[1].get() == count * 4950);
+}
+
+TEST_CASE("[WorkerThreadPool] Parse CPU lists") {
+	CHECK(WorkerThreadPool::parse_cpu_list("", 16) == Vector<int>());
+	CHECK(WorkerThreadPool::parse_cpu_list("3", 16) == Vector<int>({ 3 }));
+	CHECK(WorkerThreadPool::parse_cpu_list("0-3, 8,10 - 11", 16) == Vector<int>({ 0, 1, 2, 3, 8, 10, 11 }));
+	CHECK(WorkerThreadPool::parse_cpu_list("2,1-3", 16) == Vector<int>({ 2, 1, 3 }));
+	CHECK(WorkerThreadPool::parse_cpu_list("0-15", 16).size() == 16);
+	CHECK(WorkerThreadPool::parse_cpu_list("0") == Vector<int>({ 0 }));
+
+	ERR_PRINT_OFF;
+	CHECK(WorkerThreadPool::parse_cpu_list("0-a", 16).is_empty());
+	CHECK(WorkerThreadPool::parse_cpu_list("4-2", 16).is_empty());
+	CHECK(WorkerThreadPool::parse_cpu_list("-1", 16).is_empty());
+	CHECK(WorkerThreadPool::parse_cpu_list("8-16", 16).is_empty());
+	CHECK(WorkerThreadPool::parse_cpu_list("0,1000000000", 16).is_empty());
+	ERR_PRINT_ON;
+}
+
+static void static_telemetry_test(void *p_arg) {
+	counter[0].increment();
+}
+
+TEST_CASE("[WorkerThreadPool] Telemetry of a dedicated pool") {
+	counter.clear();
+	counter.resize(1);
+
+	WorkerThreadPool::PoolSettings settings;
+	settings.cpu_affinity = { 0 };
+	settings.pin_threads = true;
+	settings.measure_task_times = true;
+	WorkerThreadPool *pool = memnew(WorkerThreadPool(false));
+	pool->init(settings);
+	CHECK(pool->get_thread_count() == 1);
+
+	LocalVector<WorkerThreadPool::TaskID> tasks;
+	for (int i = 0; i < 50; i++) {
+		tasks.push_back(pool->add_native_task(static_telemetry_test, nullptr, true));
+	}
+	for (WorkerThreadPool::TaskID task : tasks) {
+		pool->wait_for_task_completion(task);
+	}
+	CHECK(counter[0].get() == 50);
+
+	const WorkerThreadPool::Telemetry telemetry = pool->get_telemetry();
+	CHECK(telemetry.queued_tasks == 0);
+	CHECK(telemetry.processed_tasks == 50);
+	uint64_t waits = 0;
+	uint64_t runs = 0;
+	for (int i = 0; i < WorkerThreadPool::Telemetry::HISTOGRAM_BUCKETS; i++) {
+		waits += telemetry.wait_usec_histogram[i];
+		runs += telemetry.run_usec_histogram[i];
+	}
+	CHECK(waits == 50);
+	CHECK(runs == 50);
+
+	pool->finish();
+	memdelete(pool);
+}
+
 } // namespace TestWorkerThreadPool
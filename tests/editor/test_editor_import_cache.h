@@ -0,0 +1,108 @@
+/**************************************************************************/
+/*  test_editor_import_cache.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#ifdef TOOLS_ENABLED
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/resource_importer.h"
+#include "editor/import/editor_import_cache.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace TestEditorImportCache {
+
+class TestImporter : public ResourceImporter {
+public:
+	bool dependencies_known = true;
+	String dependency;
+
+	virtual String get_importer_name() const override { return "test"; }
+	virtual String get_visible_name() const override { return "Test"; }
+	virtual void get_recognized_extensions(List<String> *p_extensions) const override {}
+	virtual String get_save_extension() const override { return "res"; }
+	virtual String get_resource_type() const override { return "Resource"; }
+	virtual void get_import_options(const String &p_path, List<ImportOption> *r_options, int p_preset = 0) const override {}
+	virtual bool get_option_visibility(const String &p_path, const String &p_option, const HashMap<StringName, Variant> &p_options) const override { return true; }
+	virtual Error import(ResourceUID::ID p_source_id, const String &p_source_file, const String &p_save_path, const HashMap<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files = nullptr, Variant *r_metadata = nullptr) override { return OK; }
+
+	virtual bool get_import_dependencies(const String &p_source_file, const HashMap<StringName, Variant> &p_options, List<String> *r_dependencies) const override {
+		if (!dependency.is_empty()) {
+			r_dependencies->push_back(dependency);
+		}
+		return dependencies_known;
+	}
+};
+
+static void _write_file(const String &p_path, const String &p_contents) {
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE);
+	REQUIRE(f.is_valid());
+	f->store_string(p_contents);
+}
+
+TEST_CASE("[EditorImportCache] Dependencies are part of the key") {
+	const String source_path = TestUtils::get_temp_path("import_cache_source.txt");
+	const String dependency_path = TestUtils::get_temp_path("import_cache_dependency.txt");
+	_write_file(source_path, "source");
+	_write_file(dependency_path, "dependency");
+
+	Ref<TestImporter> importer = memnew(TestImporter);
+	importer->dependency = dependency_path;
+	const List<ResourceImporter::ImportOption> options;
+	const HashMap<StringName, Variant> params;
+
+	const String key = EditorImportCache::get_key(source_path, importer, options, params, ResourceUID::INVALID_ID);
+	CHECK_FALSE(key.is_empty());
+	CHECK_MESSAGE(
+			EditorImportCache::get_key(source_path, importer, options, params, ResourceUID::INVALID_ID) == key,
+			"The key should be stable while no file changes.");
+
+	_write_file(dependency_path, "changed dependency");
+	CHECK_MESSAGE(
+			EditorImportCache::get_key(source_path, importer, options, params, ResourceUID::INVALID_ID) != key,
+			"Changing a dependency should change the key, so the file is imported again.");
+
+	DirAccess::remove_absolute(dependency_path);
+	CHECK_MESSAGE(
+			EditorImportCache::get_key(source_path, importer, options, params, ResourceUID::INVALID_ID) != key,
+			"Removing a dependency should change the key.");
+
+	importer->dependencies_known = false;
+	CHECK_MESSAGE(
+			EditorImportCache::get_key(source_path, importer, options, params, ResourceUID::INVALID_ID).is_empty(),
+			"Importers with unknown dependencies should never be cached.");
+}
+
+} // namespace TestEditorImportCache
+
+#endif // TOOLS_ENABLED
@@ -83,13 +83,17 @@
 #include "tests/core/math/test_vector4.h"
 #include "tests/core/math/test_vector4i.h"
 #include "tests/core/object/test_class_db.h"
+#include "tests/core/object/test_message_queue.h"
 #include "tests/core/object/test_method_bind.h"
 #include "tests/core/object/test_object.h"
 #include "tests/core/object/test_undo_redo.h"
+#include "tests/core/os/test_frame_arena.h"
+#include "tests/core/os/test_memory.h"
 #include "tests/core/os/test_os.h"
 #include "tests/core/string/test_fuzzy_search.h"
 #include "tests/core/string/test_node_path.h"
 #include "tests/core/string/test_string.h"
+#include "tests/core/string/test_string_name.h"
 #include "tests/core/string/test_translation.h"
 #include "tests/core/string/test_translation_server.h"
 #include "tests/core/templates/test_a_hash_map.h"
@@ -100,7 +104,9 @@
 #include "tests/core/templates/test_local_vector.h"
 #include "tests/core/templates/test_lru.h"
 #include "tests/core/templates/test_oa_hash_map.h"
+#include "tests/core/templates/test_ordered_hash_map.h"
 #include "tests/core/templates/test_paged_array.h"
+#include "tests/core/templates/test_parallel.h"
 #include "tests/core/templates/test_rid.h"
 #include "tests/core/templates/test_vector.h"
 #include "tests/core/test_crypto.h"
@@ -112,6 +118,7 @@
 #include "tests/core/variant/test_dictionary.h"
 #include "tests/core/variant/test_variant.h"
 #include "tests/core/variant/test_variant_utility.h"
+#include "tests/editor/test_editor_import_cache.h"
 #include "tests/scene/test_animation.h"
 #include "tests/scene/test_audio_stream_wav.h"
 #include "tests/scene/test_bit_map.h"
@@ -144,6 +151,15 @@
 #include "tests/servers/test_text_server.h"
 #include "tests/test_validate_testing.h"
 
+// Benchmarks, run as test commands, e.g. `--test memory-benchmark`. They are not part of the test suite.
+#include "tests/benchmarks/benchmark_dictionary.h"
+#include "tests/benchmarks/benchmark_memory.h"
+#include "tests/benchmarks/benchmark_parallel.h"
+#include "tests/benchmarks/benchmark_signals.h"
+#include "tests/benchmarks/benchmark_string.h"
+#include "tests/benchmarks/benchmark_string_name.h"
+#include "tests/benchmarks/benchmark_worker_thread_pool.h"
+
 #ifndef ADVANCED_GUI_DISABLED
 #include "tests/scene/test_code_edit.h"
 #include "tests/scene/test_color_picker.h"